@@ -11,10 +11,13 @@
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/utilities/checkpoint.h>
 
 #include "kvstore/kvstore.hpp"
 #include "utils/file.hpp"
 
+#include <atomic>
 #include <iostream>
 
 namespace kvstore {
@@ -23,6 +26,8 @@ struct KVStore::impl {
   std::filesystem::path storage;
   std::unique_ptr<rocksdb::DB> db;
   rocksdb::Options options;
+  // Used to give the table files created by `IngestMultiple` unique names.
+  std::atomic<uint64_t> ingested_files{0};
 };
 
 KVStore::KVStore(std::filesystem::path storage) : pimpl_(std::make_unique<impl>()) {
@@ -62,6 +67,27 @@ bool KVStore::PutMultiple(const std::map<std::string, std::string> &items) {
   return s.ok();
 }
 
+bool KVStore::IngestMultiple(const std::map<std::string, std::string> &items) {
+  if (items.empty()) return true;
+  auto path = pimpl_->storage / ("ingest_" + std::to_string(pimpl_->ingested_files++) + ".sst");
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), pimpl_->options);
+  auto s = writer.Open(path.string());
+  // The items are sorted by the map, which is required by the writer.
+  for (auto it = items.begin(); s.ok() && it != items.end(); ++it) {
+    s = writer.Put(it->first, it->second);
+  }
+  if (s.ok()) s = writer.Finish();
+  if (s.ok()) {
+    rocksdb::IngestExternalFileOptions options;
+    options.move_files = true;
+    s = pimpl_->db->IngestExternalFile({path.string()}, options);
+  }
+  // The file is left behind only if it wasn't moved into the storage.
+  std::error_code error_code;
+  std::filesystem::remove(path, error_code);
+  return s.ok();
+}
+
 std::optional<std::string> KVStore::Get(const std::string &key) const noexcept {
   std::string value;
   auto s = pimpl_->db->Get(rocksdb::ReadOptions(), key, &value);
@@ -212,4 +238,11 @@ bool KVStore::CompactRange(const std::string &begin_prefix, const std::string &e
   return s.ok();
 }
 
+bool KVStore::CreateCheckpoint(const std::filesystem::path &checkpoint_directory) {
+  rocksdb::Checkpoint *checkpoint_ptr = nullptr;
+  if (!rocksdb::Checkpoint::Create(pimpl_->db.get(), &checkpoint_ptr).ok()) return false;
+  std::unique_ptr<rocksdb::Checkpoint> checkpoint(checkpoint_ptr);
+  return checkpoint->CreateCheckpoint(checkpoint_directory.string()).ok();
+}
+
 }  // namespace kvstore
@@ -82,6 +82,19 @@ class KVStore final {
    */
   std::optional<std::string> Get(const std::string &key) const noexcept;
 
+  /**
+   * Store values under the given keys by writing them into a new table file
+   * which is then ingested directly into the storage. This skips the write
+   * ahead log and the memtable, so it is cheaper than `PutMultiple` for large
+   * batches of keys that aren't overwritten often.
+   *
+   * @param items
+   *
+   * @return true if the items have been successfully stored.
+   *         In case of any error false is going to be returned.
+   */
+  bool IngestMultiple(const std::map<std::string, std::string> &items);
+
   /**
    * Deletes the key and corresponding value from storage.
    *
@@ -152,6 +165,18 @@ class KVStore final {
    */
   bool CompactRange(const std::string &begin_prefix, const std::string &end_prefix);
 
+  /**
+   * Create a consistent copy of the storage in a new directory. The immutable
+   * data files are hard-linked when possible, so the checkpoint is cheap and
+   * doesn't block writers for long.
+   *
+   * @param checkpoint_directory - Directory in which the checkpoint is
+   *                               created, it must not exist.
+   *
+   * @return - true if the checkpoint was created successfully, false otherwise.
+   */
+  bool CreateCheckpoint(const std::filesystem::path &checkpoint_directory);
+
   /**
    * Custom prefix-based iterator over kvstore.
    *
@@ -32,6 +32,12 @@ bool KVStore::PutMultiple(const std::map<std::string, std::string> &items) {
       "dummy kvstore");
 }
 
+bool KVStore::IngestMultiple(const std::map<std::string, std::string> &items) {
+  LOG_FATAL(
+      "Unsupported operation (KVStore::IngestMultiple) -- this is a "
+      "dummy kvstore");
+}
+
 std::optional<std::string> KVStore::Get(const std::string &key) const noexcept {
   LOG_FATAL("Unsupported operation (KVStore::Get) -- this is a dummy kvstore");
 }
@@ -108,4 +114,10 @@ bool KVStore::CompactRange(const std::string &begin_prefix, const std::string &e
       "dummy kvstore");
 }
 
+bool KVStore::CreateCheckpoint(const std::filesystem::path &checkpoint_directory) {
+  LOG_FATAL(
+      "Unsupported operation (KVStore::CreateCheckpoint) -- this is a "
+      "dummy kvstore");
+}
+
 }  // namespace kvstore
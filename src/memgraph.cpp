@@ -160,7 +160,9 @@ DEFINE_VALIDATED_int32(anchor_num, 11,
 
                        
 //TODO: extend features 
-DEFINE_bool(real_time_flag, false, "Controls whether the historical storage reclaim old history on stratup.");
+DEFINE_bool(real_time_flag, false,
+            "Stamp the history with hybrid clock (wall-clock milliseconds + logical counter) timestamps instead "
+            "of the logical commit timestamps. History query bounds are then given in milliseconds.");
 DEFINE_bool(retention_on_startup, false, "Controls whether the historical storage reclaim old history on stratup.");
 DEFINE_VALIDATED_uint64(retention_interval_sec, 60,
                         "Reclaim history interval (in seconds). Set "
@@ -186,6 +188,15 @@ DEFINE_bool(allow_load_csv, true, "Controls whether LOAD CSV clause is allowed i
 // Storage flags.
 DEFINE_VALIDATED_uint64(storage_gc_cycle_sec, 30, "Storage garbage collector interval (in seconds).",
                         FLAG_IN_RANGE(1, 24 * 3600));
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_uint64(storage_gc_history_chain_length, 0,
+              "Migrate committed versions to the history store as soon as they are this deep in their version chain, "
+              "even if an older transaction is still running. Temporal reads then stop walking the chain there. "
+              "Set to 0 to migrate only when the versions are garbage collected.");
+DEFINE_uint64(storage_gc_history_ingest_batch_size, 0,
+              "Write the history migrated by the GC in batches of this many records as table files that are "
+              "ingested directly into the history store, bypassing its WAL and memtable. Smaller batches are "
+              "written normally. Set to 0 to disable the ingestion.");
 // NOTE: The `storage_properties_on_edges` flag must be the same here and in
 // `mg_import_csv`. If you change it, make sure to change it there as well.
 DEFINE_bool(storage_properties_on_edges, true, "Controls whether edges have properties."); //hjm begins before:false
@@ -199,12 +210,43 @@ DEFINE_bool(storage_wal_enabled, false,
             "WAL periodic snapshots must be enabled.");
 DEFINE_VALIDATED_uint64(storage_snapshot_retention_count, 3, "The number of snapshots that should always be kept.",
                         FLAG_IN_RANGE(1, 1000000));
+DEFINE_VALIDATED_uint64(storage_items_per_batch, storage::Config::Durability().items_per_batch,
+                        "The number of edges and vertices stored in a batch in a snapshot file.",
+                        FLAG_IN_RANGE(1, 1000000000));
+DEFINE_VALIDATED_uint64(storage_snapshot_thread_count, storage::Config::Durability().snapshot_thread_count,
+                        "The number of threads used to create and load snapshots.", FLAG_IN_RANGE(1, 1024));
+DEFINE_VALIDATED_uint64(storage_snapshot_incremental_chain_length,
+                        storage::Config::Durability().snapshot_incremental_chain_length,
+                        "The number of incremental snapshots, containing only the objects changed since the previous "
+                        "snapshot, created after each full snapshot. Set to 0 to always create full snapshots.",
+                        FLAG_IN_RANGE(0, 1000000));
+DEFINE_VALIDATED_uint64(storage_recovery_thread_count, storage::Config::Durability().recovery_thread_count,
+                        "The number of threads used to replay WAL files and recreate indices during recovery.",
+                        FLAG_IN_RANGE(1, 1024));
 DEFINE_VALIDATED_uint64(storage_wal_file_size_kib, storage::Config::Durability().wal_file_size_kibibytes,
                         "Minimum file size of each WAL file.", FLAG_IN_RANGE(1, 1000 * 1024));
 DEFINE_VALIDATED_uint64(storage_wal_file_flush_every_n_tx, storage::Config::Durability().wal_file_flush_every_n_tx,
                         "Issue a 'fsync' call after this amount of transactions are written to the "
                         "WAL file. Set to 1 for fully synchronous operation.",
                         FLAG_IN_RANGE(1, 1000000));
+DEFINE_VALIDATED_uint64(storage_wal_block_size_kib, storage::Config::Durability().wal_block_size_kibibytes,
+                        "Minimum size of the blocks of transactions written to the WAL file. Set to 0 to write "
+                        "every transaction as its own block.",
+                        FLAG_IN_RANGE(0, 64 * 1024));
+DEFINE_bool(storage_wal_compression, storage::Config::Durability().wal_compression,
+            "Controls whether the blocks written to the WAL file are compressed (using zlib).");
+DEFINE_bool(storage_wal_group_commit, storage::Config::Durability().wal_group_commit,
+            "Controls whether a commit waits until its WAL records are synced. The changes become visible to "
+            "other transactions only after the sync. Concurrent commits are synced together with a single "
+            "'fsync' call issued outside of the storage engine lock.");
+DEFINE_VALIDATED_uint64(storage_wal_group_commit_max_batch, storage::Config::Durability().wal_group_commit_max_batch,
+                        "Maximum number of transactions that wait for a group commit before the WAL is synced.",
+                        FLAG_IN_RANGE(1, 1000000));
+DEFINE_VALIDATED_uint64(storage_wal_group_commit_max_delay_us,
+                        storage::Config::Durability().wal_group_commit_max_delay.count(),
+                        "Maximum time (in microseconds) a group commit waits for other transactions to join before "
+                        "the WAL is synced.",
+                        FLAG_IN_RANGE(0, 1000000));
 DEFINE_bool(storage_snapshot_on_exit, false, "Controls whether the storage creates another snapshot on exit.");
 
 DEFINE_bool(telemetry_enabled, false,
@@ -1142,15 +1184,27 @@ int main(int argc, char **argv) {
 
   // Main storage and execution engines initialization
   storage::Config db_config{
-      .gc = {.type = storage::Config::Gc::Type::PERIODIC, .interval = std::chrono::seconds(FLAGS_storage_gc_cycle_sec)},
+      .gc = {.type = storage::Config::Gc::Type::PERIODIC,
+             .interval = std::chrono::seconds(FLAGS_storage_gc_cycle_sec),
+             .history_chain_length_limit = FLAGS_storage_gc_history_chain_length,
+             .history_ingest_batch_size = FLAGS_storage_gc_history_ingest_batch_size},
       .items = {.properties_on_edges = FLAGS_storage_properties_on_edges,
                 .AnchorNum=FLAGS_anchor_num,
                 .realTimeFlag=FLAGS_real_time_flag},
       .durability = {.storage_directory = FLAGS_data_directory,
                      .recover_on_startup = FLAGS_storage_recover_on_startup,
                      .snapshot_retention_count = FLAGS_storage_snapshot_retention_count,
+                     .items_per_batch = FLAGS_storage_items_per_batch,
+                     .snapshot_thread_count = FLAGS_storage_snapshot_thread_count,
+                     .snapshot_incremental_chain_length = FLAGS_storage_snapshot_incremental_chain_length,
+                     .recovery_thread_count = FLAGS_storage_recovery_thread_count,
                      .wal_file_size_kibibytes = FLAGS_storage_wal_file_size_kib,
                      .wal_file_flush_every_n_tx = FLAGS_storage_wal_file_flush_every_n_tx,
+                     .wal_block_size_kibibytes = FLAGS_storage_wal_block_size_kib,
+                     .wal_compression = FLAGS_storage_wal_compression,
+                     .wal_group_commit = FLAGS_storage_wal_group_commit,
+                     .wal_group_commit_max_batch = FLAGS_storage_wal_group_commit_max_batch,
+                     .wal_group_commit_max_delay = std::chrono::microseconds(FLAGS_storage_wal_group_commit_max_delay_us),
                      .snapshot_on_exit = FLAGS_storage_snapshot_on_exit},
       .transaction = {.isolation_level = ParseIsolationLevel()},
       .rocksdb_retention = {.retention_on_startup = FLAGS_retention_on_startup,
@@ -15,17 +15,26 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <map>
 #include <optional>
 #include <regex>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "helpers.hpp"
 #include "query/serialization/property_value.hpp"
 #include "storage/v2/history_delta.hpp"
+#include "storage/v2/hybrid_clock.hpp"
 #include "storage/v2/storage.hpp"
 #include "utils/exceptions.hpp"
 #include "utils/logging.hpp"
 #include "utils/message.hpp"
+#include "utils/parallel.hpp"
 #include "utils/string.hpp"
 #include "utils/timer.hpp"
 #include "version.hpp"
@@ -52,6 +61,14 @@ bool ValidateIdTypeOptions(const char *flagname, const std::string &value) {
   return true;
 }
 
+bool ValidatePositive(const char *flagname, uint64_t value) {
+  if (value == 0) {
+    printf("The argument '%s' must be positive\n", flagname);
+    return false;
+  }
+  return true;
+}
+
 // Memgraph flags.
 // NOTE: These flags must be identical as the flags in the main Memgraph binary.
 // They are used to automatically load the same configuration as the main
@@ -59,6 +76,9 @@ bool ValidateIdTypeOptions(const char *flagname, const std::string &value) {
 // CSV file on a correctly set-up Memgraph installation.
 DEFINE_string(data_directory, "mg_data", "Path to directory in which to save all permanent data.");
 DEFINE_bool(storage_properties_on_edges, true, "Controls whether relationships have properties.");//hjm begin
+DEFINE_bool(real_time_flag, false,
+            "Stamp the history with hybrid clock (wall-clock milliseconds + logical counter) timestamps instead "
+            "of the logical commit timestamps. History query bounds are then given in milliseconds.");
 
 // CSV import flags.
 DEFINE_string(array_delimiter, ";", "Delimiter between elements of array values.");
@@ -80,6 +100,12 @@ DEFINE_string(id_type, "STRING",
               "Which data type should be used to store the supplied node IDs. "
               "Possible options are: STRING/INTEGER");
 DEFINE_validator(id_type, &ValidateIdTypeOptions);
+DEFINE_uint64(thread_count, std::max(std::thread::hardware_concurrency(), 1U),
+              "Number of threads used to parse the CSV files and create the nodes and relationships.");
+DEFINE_validator(thread_count, &ValidatePositive);
+DEFINE_uint64(chunk_size, 4 * 1024 * 1024,
+              "Size (in bytes) of the chunks in which the CSV files are read. The chunks are parsed in parallel.");
+DEFINE_validator(chunk_size, &ValidatePositive);
 // Arguments `--nodes` and `--relationships` can be input multiple times and are
 // handled with custom parsing.
 DEFINE_string(nodes, "",
@@ -87,14 +113,19 @@ DEFINE_string(nodes, "",
               "the first supplied file, all other files supplied in a single flag will "
               "be treated as data files. Additional labels can be specified for the node "
               "files. The flag can be specified multiple times (useful for differently "
-              "formatted node files). The format of this argument is: "
-              "[<label>[:<label>]...=]<file>[,<file>][,<file>]...");
+              "formatted node files). Files with TT_TS and TT_TE columns are versioned, "
+              "each row is a version of the node with the given ID that was valid from "
+              "TT_TS until TT_TE. The row with an empty TT_TE is the current version, the "
+              "other versions are written into the history store. The format of this "
+              "argument is: [<label>[:<label>]...=]<file>[,<file>][,<file>]...");
 DEFINE_string(relationships, "",
               "Files that should be parsed for relationships. The CSV header will be "
               "loaded from the first supplied file, all other files supplied in a single "
               "flag will be treated as data files. The relationship type can be "
               "specified for the relationship files. The flag can be specified multiple "
-              "times (useful for differently formatted relationship files). The format "
+              "times (useful for differently formatted relationship files). Versioned "
+              "files are supported in the same way as for nodes, the versions of a "
+              "relationship are matched by its nodes and type. The format "
               "of this argument is: [<type>=]<file>[,<file>][,<file>]...");
 
 std::vector<std::string> ParseRepeatedFlag(const std::string &flagname, int argc, char *argv[]) {
@@ -159,6 +190,10 @@ struct hash<NodeId> {
 
 }  // namespace std
 
+// Versioned relationships don't have IDs, their versions are matched by the
+// start node, the type and the end node.
+using RelationshipKey = std::tuple<storage::Gid, std::string, storage::Gid>;
+
 // Exception used to indicate that something went wrong during data loading.
 class LoadException : public utils::BasicException {
  public:
@@ -418,103 +453,416 @@ std::string GetIdSpace(const std::string &type) {
 }
 
 /// @throw LoadException
-void ProcessNodeRow(storage::Storage *store, const std::vector<Field> &fields, const std::vector<std::string> &row,
-                    const std::vector<std::string> &additional_labels,
-                    std::unordered_map<NodeId, storage::Gid> *node_id_map) {
+uint64_t StringToTimestamp(const std::string &value) {
+  auto timestamp = StringToInt(value);
+  if (timestamp < 0) throw LoadException("'{}' isn't a valid timestamp", value);
+  // The real-time history is stamped with hybrid clock timestamps, the rows
+  // carry wall-clock milliseconds.
+  if (FLAGS_real_time_flag) return storage::HybridClock::LowerBound(timestamp);
+  return timestamp;
+}
+
+// Transaction time of a row of a versioned file. The current version of an
+// object has no end, all of the other versions are historical.
+struct TransactionTime {
+  std::optional<uint64_t> tt_ts;
+  std::optional<uint64_t> tt_te;
+};
+
+bool IsTransactionTimeField(const Field &field) { return field.type == "TT_TS" || field.type == "TT_TE"; }
+
+/// @throw LoadException
+void ProcessTransactionTimeField(const Field &field, const std::string &value, TransactionTime *time) {
+  auto &timestamp = field.type == "TT_TS" ? time->tt_ts : time->tt_te;
+  if (timestamp) throw LoadException("Only one {} must be specified", field.type);
+  if (!value.empty()) timestamp = StringToTimestamp(value);
+}
+
+/// Returns true if the row is a historical version of an object.
+/// @throw LoadException
+bool IsHistoricalVersion(const TransactionTime &time) {
+  if (!time.tt_te) return false;
+  if (!time.tt_ts) throw LoadException("TT_TS must be set if TT_TE is set");
+  if (*time.tt_ts >= *time.tt_te) throw LoadException("TT_TS must be before TT_TE");
+  return true;
+}
+
+/// @throw LoadException
+void CheckRowSize(std::vector<std::string> *row, const std::vector<Field> &header) {
+  if ((!FLAGS_ignore_extra_columns && row->size() != header.size()) ||
+      (FLAGS_ignore_extra_columns && row->size() < header.size()))
+    throw LoadException(
+        "Expected as many values as there are header fields (found {}, "
+        "expected {})",
+        row->size(), header.size());
+  if (row->size() > header.size()) {
+    row->resize(header.size());
+  }
+}
+
+// Rows of a CSV file that are parsed together.
+struct CsvChunk {
+  std::string data;
+  // Line number of the first row in the file.
+  uint64_t first_line;
+};
+
+/// Splits a CSV stream into chunks of whole rows so that the chunks can be
+/// parsed independently. Quoted fields can contain line feeds, so the quoting
+/// is tracked in the same way as in `ReadRow` and the stream is split only
+/// after a line feed that isn't inside of a quoted field.
+class ChunkReader final {
+ public:
+  ChunkReader(std::istream *stream, uint64_t chunk_size, uint64_t first_line)
+      : stream_(stream), chunk_size_(chunk_size), next_line_(first_line) {}
+
+  /// Returns the next chunk, std::nullopt once the whole stream is read.
+  std::optional<CsvChunk> NextChunk() {
+    while (true) {
+      if (!at_end_) {
+        auto size = buffer_.size();
+        buffer_.resize(size + chunk_size_);
+        stream_->read(buffer_.data() + size, static_cast<std::streamsize>(chunk_size_));
+        buffer_.resize(size + stream_->gcount());
+        at_end_ = !*stream_;
+      }
+      Scan();
+      size_t end = at_end_ ? buffer_.size() : rows_end_;
+      if (end == 0) {
+        if (at_end_) return std::nullopt;
+        // The row doesn't fit into a single chunk.
+        continue;
+      }
+      CsvChunk chunk{buffer_.substr(0, end), next_line_};
+      next_line_ += std::count(chunk.data.begin(), chunk.data.end(), '\n');
+      buffer_.erase(0, end);
+      scanned_ -= end;
+      rows_end_ = 0;
+      return chunk;
+    }
+  }
+
+ private:
+  // Advances the parser state over the unscanned part of the buffer and
+  // remembers where the last complete row ends.
+  void Scan() {
+    // The delimiter and the (escaped) quote are looked up ahead, so they
+    // mustn't be cut by the end of the data read so far.
+    const auto lookahead = std::max(FLAGS_quote.size() * 2, FLAGS_delimiter.size());
+    const auto limit = at_end_ ? buffer_.size() : std::max(buffer_.size(), lookahead) - lookahead;
+    while (scanned_ < limit) {
+      auto c = buffer_[scanned_];
+      if (c == '\n' && state_ != CsvParserState::QUOTING) {
+        state_ = CsvParserState::INITIAL_FIELD;
+        rows_end_ = ++scanned_;
+        continue;
+      }
+      if (c == '\n' || c == '\r') {
+        ++scanned_;
+        continue;
+      }
+      switch (state_) {
+        case CsvParserState::INITIAL_FIELD:
+        case CsvParserState::NEXT_FIELD: {
+          if (SubstringStartsWith(buffer_, scanned_, FLAGS_quote)) {
+            state_ = CsvParserState::QUOTING;
+            scanned_ += FLAGS_quote.size();
+          } else if (SubstringStartsWith(buffer_, scanned_, FLAGS_delimiter)) {
+            state_ = CsvParserState::NEXT_FIELD;
+            scanned_ += FLAGS_delimiter.size();
+          } else {
+            state_ = CsvParserState::NOT_QUOTING;
+            ++scanned_;
+          }
+          break;
+        }
+        case CsvParserState::QUOTING: {
+          if (!SubstringStartsWith(buffer_, scanned_, FLAGS_quote)) {
+            ++scanned_;
+          } else if (SubstringStartsWith(buffer_, scanned_ + FLAGS_quote.size(), FLAGS_quote)) {
+            scanned_ += FLAGS_quote.size() * 2;
+          } else {
+            state_ = CsvParserState::EXPECT_DELIMITER;
+            scanned_ += FLAGS_quote.size();
+          }
+          break;
+        }
+        case CsvParserState::NOT_QUOTING:
+        case CsvParserState::EXPECT_DELIMITER: {
+          // Invalid data after a quoted field is reported by `ReadRow`.
+          if (SubstringStartsWith(buffer_, scanned_, FLAGS_delimiter)) {
+            state_ = CsvParserState::NEXT_FIELD;
+            scanned_ += FLAGS_delimiter.size();
+          } else {
+            ++scanned_;
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  std::istream *stream_;
+  uint64_t chunk_size_;
+  uint64_t next_line_;
+  std::string buffer_;
+  bool at_end_{false};
+  // Position in the buffer up to which the parser state is known.
+  size_t scanned_{0};
+  // Position in the buffer after the last complete row, 0 if there is none.
+  size_t rows_end_{0};
+  CsvParserState state_{CsvParserState::INITIAL_FIELD};
+};
+
+/// Reads the file in chunks and parses the chunks on `FLAGS_thread_count`
+/// threads with `parse_chunk`. At most `FLAGS_thread_count` chunks are loaded
+/// at once, `load_chunks` is called with the parsed chunks in the order in
+/// which they appear in the file.
+/// @throw LoadException
+template <typename TParse, typename TLoad>
+void ProcessFileInChunks(const std::string &path, std::optional<std::vector<Field>> *header,
+                         const TParse &parse_chunk, const TLoad &load_chunks) {
+  std::ifstream file(path);
+  MG_ASSERT(file, "Unable to open '{}'", path);
+  uint64_t first_line = 1;
+  if (!*header) {
+    try {
+      auto [fields, header_lines] = ReadHeader(file);
+      first_line += header_lines;
+      header->emplace(std::move(fields));
+    } catch (const LoadException &e) {
+      throw LoadException("Couldn't process row 1 of '{}' because of: {}", path, e.what());
+    }
+  }
+  ChunkReader reader(&file, FLAGS_chunk_size, first_line);
+  std::vector<CsvChunk> chunks;
+  while (true) {
+    chunks.clear();
+    while (chunks.size() < FLAGS_thread_count) {
+      auto chunk = reader.NextChunk();
+      if (!chunk) break;
+      chunks.push_back(std::move(*chunk));
+    }
+    if (chunks.empty()) break;
+    std::vector<std::invoke_result_t<TParse, const CsvChunk &>> parsed(chunks.size());
+    utils::RunInParallel(FLAGS_thread_count, chunks.size(),
+                         [&](uint64_t i) { parsed[i] = parse_chunk(chunks[i]); });
+    load_chunks(&parsed);
+  }
+}
+
+/// Calls `parse_row(row, row_number)` for all rows of the chunk.
+/// @throw LoadException
+template <typename TFunc>
+void ForEachRow(const CsvChunk &chunk, const std::string &path, const std::vector<Field> &header,
+                const TFunc &parse_row) {
+  std::istringstream stream(chunk.data);
+  uint64_t row_number = chunk.first_line;
+  try {
+    while (true) {
+      auto [row, lines_count] = ReadRow(stream);
+      if (lines_count == 0) break;
+      CheckRowSize(&row, header);
+      parse_row(row, row_number);
+      row_number += lines_count;
+    }
+  } catch (const LoadException &e) {
+    throw LoadException("Couldn't process row {} of '{}' because of: {}", row_number, path, e.what());
+  }
+}
+
+// Versioned data collected while loading the files. It is written into the
+// history store after all of the files are loaded, see
+// `storage::Storage::ImportHistory`.
+struct ImportedHistory {
+  // Starts of the current versions of the versioned objects.
+  std::vector<std::pair<storage::Gid, uint64_t>> vertex_starts;
+  std::vector<std::pair<storage::Gid, uint64_t>> edge_starts;
+  // Historical versions, the objects are resolved once all files are loaded.
+  std::vector<std::pair<NodeId, history_delta::ImportedVersion>> vertex_versions;
+  std::vector<std::pair<RelationshipKey, history_delta::ImportedVersion>> edge_versions;
+  // Current versions of the versioned relationships.
+  std::map<RelationshipKey, storage::Gid> relationships;
+};
+
+// A parsed row of a nodes file.
+struct NodeRow {
+  uint64_t row_number;
   std::optional<NodeId> id;
-  auto acc = store->Access();
-  auto node = acc.CreateVertex();
+  std::vector<std::string> labels;
+  std::map<std::string, storage::PropertyValue> properties;
+  TransactionTime time;
+  // Set for the duplicate nodes that should be skipped.
+  bool skip{false};
+};
+
+// Parsed rows of a chunk of a nodes file.
+struct NodesChunk {
+  // Rows of the current versions, the nodes are created from them.
+  std::vector<NodeRow> rows;
+  std::vector<std::pair<NodeId, history_delta::ImportedVersion>> versions;
+};
+
+/// @throw LoadException
+void ProcessNodeRow(const std::vector<Field> &fields, const std::vector<std::string> &row, uint64_t row_number,
+                    const std::vector<std::string> &additional_labels, NodesChunk *chunk) {
+  NodeRow node{.row_number = row_number};
+  auto add_label = [&](const std::string &label) {
+    if (std::find(node.labels.begin(), node.labels.end(), label) != node.labels.end())
+      throw LoadException("The label '{}' already exists", label);
+    node.labels.push_back(label);
+  };
+  auto add_property = [&](const std::string &name, storage::PropertyValue value) {
+    if (!node.properties.emplace(name, std::move(value)).second)
+      throw LoadException("The property '{}' already exists", name);
+  };
   for (size_t i = 0; i < row.size(); ++i) {
     const auto &field = fields[i];
     const auto &value = row[i];
     if (utils::StartsWith(field.type, "ID")) {
-      if (id) throw LoadException("Only one node ID must be specified");
+      if (node.id) throw LoadException("Only one node ID must be specified");
       if (FLAGS_id_type == "INTEGER") {
         // Call `StringToInt` to verify that the ID is a valid integer.
         StringToInt(value);
       }
-      NodeId node_id{value, GetIdSpace(field.type)};
-      auto it = node_id_map->find(node_id);
-      if (it != node_id_map->end()) {
-        if (FLAGS_skip_duplicate_nodes) {
-          spdlog::warn(utils::MessageWithLink("Skipping duplicate node with ID '{}'.", node_id, "https://memgr.ph/csv"));
-          return;
-        } else {
-          throw LoadException("Node with ID '{}' already exists", node_id);
-        }
-      }
-      node_id_map->emplace(node_id, node.Gid());
+      node.id.emplace(NodeId{value, GetIdSpace(field.type)});
       if (!field.name.empty()) {
-        storage::PropertyValue pv_id;
         if (FLAGS_id_type == "INTEGER") {
-          pv_id = storage::PropertyValue(StringToInt(node_id.id));
+          add_property(field.name, storage::PropertyValue(StringToInt(value)));
         } else {
-          pv_id = storage::PropertyValue(node_id.id);
+          add_property(field.name, storage::PropertyValue(value));
         }
-        auto old_node_property = node.SetProperty(acc.NameToProperty(field.name), pv_id);
-        if (!old_node_property.HasValue()) throw LoadException("Couldn't add property '{}' to the node", field.name);
-        if (!old_node_property->IsNull()) throw LoadException("The property '{}' already exists", field.name);
       }
-      id = node_id;
     } else if (field.type == "LABEL") {
-      for (const auto &label : utils::Split(value, FLAGS_array_delimiter)) {
+      for (const auto &label : utils::Split(value, FLAGS_array_delimiter)) add_label(label);
+    } else if (IsTransactionTimeField(field)) {
+      ProcessTransactionTimeField(field, value, &node.time);
+    } else if (field.type != "IGNORE") {
+      add_property(field.name, StringToValue(value, field.type));
+    }
+  }
+  for (const auto &label : additional_labels) add_label(label);
+
+  if (!IsHistoricalVersion(node.time)) {
+    chunk->rows.push_back(std::move(node));
+    return;
+  }
+  // The node itself is created from its current version.
+  if (!node.id) throw LoadException("A historical version of a node must have an ID");
+  auto data = nlohmann::json::object();
+  data["SP"] = nlohmann::json::object();
+  for (const auto &[name, value] : node.properties) {
+    data["SP"][name] = query::serialization::SerializePropertyValue(value);
+  }
+  std::vector<std::pair<std::string, std::string>> labels;
+  for (const auto &label : node.labels) labels.emplace_back("AL", label);
+  data["L"] = labels;
+  chunk->versions.emplace_back(*node.id,
+                               history_delta::ImportedVersion{0, *node.time.tt_ts, *node.time.tt_te, std::move(data)});
+}
+
+/// Creates the nodes of the chunk in a single transaction. Returns the gids of
+/// the created nodes in the order of the rows.
+/// @throw LoadException
+std::vector<storage::Gid> CreateNodes(storage::Storage *store, const NodesChunk &chunk, const std::string &path) {
+  std::vector<storage::Gid> gids;
+  gids.reserve(chunk.rows.size());
+  auto acc = store->Access();
+  for (const auto &row : chunk.rows) {
+    if (row.skip) {
+      gids.emplace_back();
+      continue;
+    }
+    try {
+      auto node = acc.CreateVertex();
+      for (const auto &label : row.labels) {
         auto node_label = node.AddLabel(acc.NameToLabel(label));
         if (!node_label.HasValue()) throw LoadException("Couldn't add label '{}' to the node", label);
         if (!*node_label) throw LoadException("The label '{}' already exists", label);
       }
-    } else if (field.type != "IGNORE") {
-      auto old_node_property = node.SetProperty(acc.NameToProperty(field.name), StringToValue(value, field.type));
-      if (!old_node_property.HasValue()) throw LoadException("Couldn't add property '{}' to the node", field.name);
-      if (!old_node_property->IsNull()) throw LoadException("The property '{}' already exists", field.name);
+      for (const auto &[name, value] : row.properties) {
+        auto old_node_property = node.SetProperty(acc.NameToProperty(name), value);
+        if (!old_node_property.HasValue()) throw LoadException("Couldn't add property '{}' to the node", name);
+        if (!old_node_property->IsNull()) throw LoadException("The property '{}' already exists", name);
+      }
+      gids.push_back(node.Gid());
+    } catch (const LoadException &e) {
+      throw LoadException("Couldn't process row {} of '{}' because of: {}", row.row_number, path, e.what());
     }
   }
-  for (const auto &label : additional_labels) {
-    auto node_label = node.AddLabel(acc.NameToLabel(label));
-    if (!node_label.HasValue()) throw LoadException("Couldn't add label '{}' to the node", label);
-    if (!*node_label) throw LoadException("The label '{}' already exists", label);
-  }
-  if (acc.Commit().HasError()) throw LoadException("Couldn't store the node");
+  // The chunks only create new nodes, so their transactions never conflict.
+  if (acc.Commit().HasError()) throw LoadException("Couldn't store the nodes of '{}'", path);
+  return gids;
 }
 
+/// @throw LoadException
 void ProcessNodes(storage::Storage *store, const std::string &nodes_path, std::optional<std::vector<Field>> *header,
                   std::unordered_map<NodeId, storage::Gid> *node_id_map,
-                  const std::vector<std::string> &additional_labels) {
-  std::ifstream nodes_file(nodes_path);
-  MG_ASSERT(nodes_file, "Unable to open '{}'", nodes_path);
-  uint64_t row_number = 1;
-  try {
-    if (!*header) {
-      auto [fields, header_lines] = ReadHeader(nodes_file);
-      row_number += header_lines;
-      header->emplace(std::move(fields));
+                  const std::vector<std::string> &additional_labels, ImportedHistory *history) {
+  auto parse_chunk = [&](const CsvChunk &chunk) {
+    NodesChunk nodes;
+    ForEachRow(chunk, nodes_path, **header, [&](const auto &row, uint64_t row_number) {
+      ProcessNodeRow(**header, row, row_number, additional_labels, &nodes);
+    });
+    return nodes;
+  };
+  auto load_chunks = [&](std::vector<NodesChunk> *chunks) {
+    // The IDs are checked in the order of the rows, so the first node with a
+    // duplicate ID is the one that is kept.
+    std::unordered_set<NodeId> ids;
+    for (auto &chunk : *chunks) {
+      for (auto &row : chunk.rows) {
+        if (!row.id || (!node_id_map->contains(*row.id) && ids.insert(*row.id).second)) continue;
+        if (!FLAGS_skip_duplicate_nodes) {
+          throw LoadException("Couldn't process row {} of '{}' because of: Node with ID '{}' already exists",
+                              row.row_number, nodes_path, *row.id);
+        }
+        spdlog::warn(utils::MessageWithLink("Skipping duplicate node with ID '{}'.", *row.id, "https://memgr.ph/csv"));
+        row.skip = true;
+      }
     }
-    while (true) {
-      auto [row, lines_count] = ReadRow(nodes_file);
-      if (lines_count == 0) break;
-      if ((!FLAGS_ignore_extra_columns && row.size() != (*header)->size()) ||
-          (FLAGS_ignore_extra_columns && row.size() < (*header)->size()))
-        throw LoadException(
-            "Expected as many values as there are header fields (found {}, "
-            "expected {})",
-            row.size(), (*header)->size());
-      if (row.size() > (*header)->size()) {
-        row.resize((*header)->size());
+    std::vector<std::vector<storage::Gid>> gids(chunks->size());
+    utils::RunInParallel(FLAGS_thread_count, chunks->size(),
+                         [&](uint64_t i) { gids[i] = CreateNodes(store, (*chunks)[i], nodes_path); });
+    for (size_t i = 0; i < chunks->size(); ++i) {
+      auto &chunk = (*chunks)[i];
+      for (size_t j = 0; j < chunk.rows.size(); ++j) {
+        const auto &row = chunk.rows[j];
+        if (row.skip) continue;
+        if (row.id) node_id_map->emplace(*row.id, gids[i][j]);
+        if (row.time.tt_ts) history->vertex_starts.emplace_back(gids[i][j], *row.time.tt_ts);
       }
-      ProcessNodeRow(store, **header, row, additional_labels, node_id_map);
-      row_number += lines_count;
+      std::move(chunk.versions.begin(), chunk.versions.end(), std::back_inserter(history->vertex_versions));
     }
-  } catch (const LoadException &e) {
-    LOG_FATAL("Couldn't process row {} of '{}' because of: {}", row_number, nodes_path, e.what());
-  }
+  };
+  ProcessFileInChunks(nodes_path, header, parse_chunk, load_chunks);
 }
 
+// A parsed row of a relationships file.
+struct RelationshipRow {
+  uint64_t row_number;
+  storage::Gid start_id;
+  storage::Gid end_id;
+  std::string type;
+  std::map<std::string, storage::PropertyValue> properties;
+  TransactionTime time;
+};
+
+// Parsed rows of a chunk of a relationships file.
+struct RelationshipsChunk {
+  // Rows of the current versions, the relationships are created from them.
+  std::vector<RelationshipRow> rows;
+  std::vector<std::pair<RelationshipKey, history_delta::ImportedVersion>> versions;
+};
+
 /// @throw LoadException
-void ProcessRelationshipsRow(storage::Storage *store, const std::vector<Field> &fields,
-                             const std::vector<std::string> &row, std::optional<std::string> relationship_type,
-                             const std::unordered_map<NodeId, storage::Gid> &node_id_map) {
+void ProcessRelationshipsRow(const std::vector<Field> &fields, const std::vector<std::string> &row,
+                             uint64_t row_number, std::optional<std::string> relationship_type,
+                             const std::unordered_map<NodeId, storage::Gid> &node_id_map, RelationshipsChunk *chunk) {
   std::optional<storage::Gid> start_id;
   std::optional<storage::Gid> end_id;
   std::map<std::string, storage::PropertyValue> properties;
+  TransactionTime time;
   for (size_t i = 0; i < row.size(); ++i) {
     const auto &field = fields[i];
     const auto &value = row[i];
@@ -556,6 +904,8 @@ void ProcessRelationshipsRow(storage::Storage *store, const std::vector<Field> &
     } else if (field.type == "TYPE") {
       if (relationship_type) throw LoadException("Only one relationship TYPE must be specified");
       relationship_type = value;
+    } else if (IsTransactionTimeField(field)) {
+      ProcessTransactionTimeField(field, value, &time);
     } else if (field.type != "IGNORE") {
       auto [it, inserted] = properties.emplace(field.name, StringToValue(value, field.type));
       if (!inserted) throw LoadException("The property '{}' already exists", field.name);
@@ -565,63 +915,164 @@ void ProcessRelationshipsRow(storage::Storage *store, const std::vector<Field> &
   if (!end_id) throw LoadException("END_ID must be set");
   if (!relationship_type) throw LoadException("Relationship TYPE must be set");
 
+  if (!IsHistoricalVersion(time)) {
+    chunk->rows.push_back(
+        RelationshipRow{row_number, *start_id, *end_id, std::move(*relationship_type), std::move(properties), time});
+    return;
+  }
+  // Historical versions are kept only for edges with properties.
+  if (!FLAGS_storage_properties_on_edges)
+    throw LoadException("Historical versions of relationships require properties on edges");
+  auto data = nlohmann::json::object();
+  data["SP"] = nlohmann::json::object();
+  for (const auto &[name, value] : properties) {
+    data["SP"][name] = query::serialization::SerializePropertyValue(value);
+  }
+  data["Fid"] = start_id->AsUint();
+  data["Tid"] = end_id->AsUint();
+  chunk->versions.emplace_back(RelationshipKey{*start_id, std::move(*relationship_type), *end_id},
+                               history_delta::ImportedVersion{0, *time.tt_ts, *time.tt_te, std::move(data)});
+}
+
+/// Creates the relationships of the rows [begin, end) in a single transaction
+/// and appends the gids of the created relationships to `gids`. Returns false
+/// if a concurrent transaction holds one of the endpoints, nothing is created
+/// in that case.
+/// @throw LoadException
+bool CreateRelationships(storage::Storage *store, const RelationshipsChunk &chunk, size_t begin, size_t end,
+                         const std::string &path, std::vector<storage::Gid> *gids) {
+  std::vector<storage::Gid> created;
   auto acc = store->Access();
-  auto from_node = acc.FindVertex(*start_id, storage::View::NEW);
-  if (!from_node) throw LoadException("From node must be in the storage");
-  auto to_node = acc.FindVertex(*end_id, storage::View::NEW);
-  if (!to_node) throw LoadException("To node must be in the storage");
-
-  auto relationship = acc.CreateEdge(&*from_node, &*to_node, acc.NameToEdgeType(*relationship_type));
-  if (!relationship.HasValue()) throw LoadException("Couldn't create the relationship");
-
-  for (const auto &property : properties) {
-    auto ret = relationship->SetProperty(acc.NameToProperty(property.first), property.second);
-    if (!ret.HasValue()) {
-      if (ret.GetError() != storage::Error::PROPERTIES_DISABLED) {
-        throw LoadException("Couldn't add property '{}' to the relationship", property.first);
-      } else {
-        throw LoadException(
-            "Couldn't add property '{}' to the relationship because properties "
-            "on edges are disabled",
-            property.first);
+  for (auto i = begin; i < end; ++i) {
+    const auto &row = chunk.rows[i];
+    try {
+      auto from_node = acc.FindVertex(row.start_id, storage::View::NEW);
+      if (!from_node) throw LoadException("From node must be in the storage");
+      auto to_node = acc.FindVertex(row.end_id, storage::View::NEW);
+      if (!to_node) throw LoadException("To node must be in the storage");
+
+      auto relationship = acc.CreateEdge(&*from_node, &*to_node, acc.NameToEdgeType(row.type));
+      if (!relationship.HasValue()) {
+        if (relationship.GetError() == storage::Error::SERIALIZATION_ERROR) return false;
+        throw LoadException("Couldn't create the relationship");
+      }
+
+      for (const auto &property : row.properties) {
+        auto ret = relationship->SetProperty(acc.NameToProperty(property.first), property.second);
+        if (!ret.HasValue()) {
+          if (ret.GetError() != storage::Error::PROPERTIES_DISABLED) {
+            throw LoadException("Couldn't add property '{}' to the relationship", property.first);
+          } else {
+            throw LoadException(
+                "Couldn't add property '{}' to the relationship because properties "
+                "on edges are disabled",
+                property.first);
+          }
+        }
       }
+      created.push_back(relationship->Gid());
+    } catch (const LoadException &e) {
+      throw LoadException("Couldn't process row {} of '{}' because of: {}", row.row_number, path, e.what());
     }
   }
+  if (acc.Commit().HasError()) throw LoadException("Couldn't store the relationships of '{}'", path);
+  gids->insert(gids->end(), created.begin(), created.end());
+  return true;
+}
 
-  if (acc.Commit().HasError()) throw LoadException("Couldn't store the relationship");
+/// Creates the relationships of the chunk. Returns the gids of the created
+/// relationships in the order of the rows.
+/// @throw LoadException
+std::vector<storage::Gid> CreateRelationships(storage::Storage *store, const RelationshipsChunk &chunk,
+                                              const std::string &path) {
+  // The chunks are loaded concurrently and relationships that share an
+  // endpoint can't be created by two transactions at the same time, so the
+  // transactions are kept short.
+  constexpr size_t kRelationshipsPerTransaction = 128;
+  std::vector<storage::Gid> gids;
+  gids.reserve(chunk.rows.size());
+  for (size_t begin = 0; begin < chunk.rows.size(); begin += kRelationshipsPerTransaction) {
+    auto end = std::min(chunk.rows.size(), begin + kRelationshipsPerTransaction);
+    if (CreateRelationships(store, chunk, begin, end, path, &gids)) continue;
+    // Only the conflicting relationships wait for the other chunks.
+    for (auto i = begin; i < end; ++i) {
+      while (!CreateRelationships(store, chunk, i, i + 1, path, &gids)) std::this_thread::yield();
+    }
+  }
+  return gids;
 }
 
+/// @throw LoadException
 void ProcessRelationships(storage::Storage *store, const std::string &relationships_path,
                           const std::optional<std::string> &relationship_type,
                           std::optional<std::vector<Field>> *header,
-                          const std::unordered_map<NodeId, storage::Gid> &node_id_map) {
-  std::ifstream relationships_file(relationships_path);
-  MG_ASSERT(relationships_file, "Unable to open '{}'", relationships_path);
-  uint64_t row_number = 1;
-  try {
-    if (!*header) {
-      auto [fields, header_lines] = ReadHeader(relationships_file);
-      row_number += header_lines;
-      header->emplace(std::move(fields));
-    }
-    while (true) {
-      auto [row, lines_count] = ReadRow(relationships_file);
-      if (lines_count == 0) break;
-      if ((!FLAGS_ignore_extra_columns && row.size() != (*header)->size()) ||
-          (FLAGS_ignore_extra_columns && row.size() < (*header)->size()))
-        throw LoadException(
-            "Expected as many values as there are header fields (found {}, "
-            "expected {})",
-            row.size(), (*header)->size());
-      if (row.size() > (*header)->size()) {
-        row.resize((*header)->size());
+                          const std::unordered_map<NodeId, storage::Gid> &node_id_map, ImportedHistory *history) {
+  auto parse_chunk = [&](const CsvChunk &chunk) {
+    RelationshipsChunk relationships;
+    ForEachRow(chunk, relationships_path, **header, [&](const auto &row, uint64_t row_number) {
+      ProcessRelationshipsRow(**header, row, row_number, relationship_type, node_id_map, &relationships);
+    });
+    return relationships;
+  };
+  auto load_chunks = [&](std::vector<RelationshipsChunk> *chunks) {
+    std::vector<std::vector<storage::Gid>> gids(chunks->size());
+    utils::RunInParallel(FLAGS_thread_count, chunks->size(), [&](uint64_t i) {
+      gids[i] = CreateRelationships(store, (*chunks)[i], relationships_path);
+    });
+    const bool versioned = std::any_of((*header)->begin(), (*header)->end(), IsTransactionTimeField);
+    for (size_t i = 0; i < chunks->size(); ++i) {
+      auto &chunk = (*chunks)[i];
+      for (size_t j = 0; versioned && j < chunk.rows.size(); ++j) {
+        const auto &row = chunk.rows[j];
+        // The historical versions are matched with the current relationship
+        // by the endpoints and the type.
+        RelationshipKey key{row.start_id, row.type, row.end_id};
+        if (!history->relationships.emplace(key, gids[i][j]).second) {
+          throw LoadException(
+              "Couldn't process row {} of '{}' because of: The versioned relationship isn't the only one of its "
+              "type between its nodes",
+              row.row_number, relationships_path);
+        }
+        if (row.time.tt_ts) history->edge_starts.emplace_back(gids[i][j], *row.time.tt_ts);
       }
-      ProcessRelationshipsRow(store, **header, row, relationship_type, node_id_map);
-      row_number += lines_count;
+      std::move(chunk.versions.begin(), chunk.versions.end(), std::back_inserter(history->edge_versions));
     }
-  } catch (const LoadException &e) {
-    LOG_FATAL("Couldn't process row {} of '{}' because of: {}", row_number, relationships_path, e.what());
+  };
+  ProcessFileInChunks(relationships_path, header, parse_chunk, load_chunks);
+}
+
+/// Resolves the objects of the historical versions and writes them into the
+/// history store.
+/// @throw LoadException
+void ImportHistory(storage::Storage *store, const std::unordered_map<NodeId, storage::Gid> &node_id_map,
+                   ImportedHistory *history) {
+  std::vector<history_delta::ImportedVersion> vertex_versions;
+  vertex_versions.reserve(history->vertex_versions.size());
+  for (auto &[node_id, version] : history->vertex_versions) {
+    auto it = node_id_map.find(node_id);
+    if (it == node_id_map.end()) throw LoadException("Node with ID '{}' has no current version", node_id);
+    version.gid = it->second.AsUint();
+    vertex_versions.push_back(std::move(version));
   }
+  std::vector<history_delta::ImportedVersion> edge_versions;
+  edge_versions.reserve(history->edge_versions.size());
+  for (auto &[key, version] : history->edge_versions) {
+    auto it = history->relationships.find(key);
+    if (it == history->relationships.end()) {
+      throw LoadException("Relationship of type '{}' between nodes with gids {} and {} has no current version",
+                          std::get<1>(key), std::get<0>(key).AsUint(), std::get<2>(key).AsUint());
+    }
+    version.gid = it->second.AsUint();
+    edge_versions.push_back(std::move(version));
+  }
+  if (vertex_versions.empty() && edge_versions.empty() && history->vertex_starts.empty() &&
+      history->edge_starts.empty())
+    return;
+  spdlog::info("Writing {} node and {} relationship versions into the history store", vertex_versions.size(),
+               edge_versions.size());
+  if (!store->ImportHistory(std::move(vertex_versions), std::move(edge_versions), history->vertex_starts,
+                            history->edge_starts))
+    throw LoadException("Couldn't write the history");
 }
 
 struct NodesArgument {
@@ -698,8 +1149,9 @@ int main(int argc, char *argv[]) {
   }
 
   std::unordered_map<NodeId, storage::Gid> node_id_map;
+  ImportedHistory history;
   storage::Storage store{{
-      .items = {.properties_on_edges = FLAGS_storage_properties_on_edges},
+      .items = {.properties_on_edges = FLAGS_storage_properties_on_edges, .realTimeFlag = FLAGS_real_time_flag},
       .durability = {.storage_directory = FLAGS_data_directory,
                      .recover_on_startup = false,
                      .snapshot_wal_mode = storage::Config::Durability::SnapshotWalMode::DISABLED,
@@ -708,24 +1160,30 @@ int main(int argc, char *argv[]) {
 
   utils::Timer load_timer;
 
-  // Process all nodes files.
-  for (const auto &value : nodes) {
-    auto [files, additional_labels] = ParseNodesArgument(value);
-    std::optional<std::vector<Field>> header;
-    for (const auto &nodes_file : files) {
-      spdlog::info("Loading {}", nodes_file);
-      ProcessNodes(&store, nodes_file, &header, &node_id_map, additional_labels);
+  try {
+    // Process all nodes files.
+    for (const auto &value : nodes) {
+      auto [files, additional_labels] = ParseNodesArgument(value);
+      std::optional<std::vector<Field>> header;
+      for (const auto &nodes_file : files) {
+        spdlog::info("Loading {}", nodes_file);
+        ProcessNodes(&store, nodes_file, &header, &node_id_map, additional_labels, &history);
+      }
     }
-  }
 
-  // Process all relationships files.
-  for (const auto &value : relationships) {
-    auto [files, type] = ParseRelationshipsArgument(value);
-    std::optional<std::vector<Field>> header;
-    for (const auto &relationships_file : files) {
-      spdlog::info("Loading {}", relationships_file);
-      ProcessRelationships(&store, relationships_file, type, &header, node_id_map);
+    // Process all relationships files.
+    for (const auto &value : relationships) {
+      auto [files, type] = ParseRelationshipsArgument(value);
+      std::optional<std::vector<Field>> header;
+      for (const auto &relationships_file : files) {
+        spdlog::info("Loading {}", relationships_file);
+        ProcessRelationships(&store, relationships_file, type, &header, node_id_map, &history);
+      }
     }
+
+    ImportHistory(&store, node_id_map, &history);
+  } catch (const LoadException &e) {
+    LOG_FATAL("{}", e.what());
   }
 
   double load_sec = load_timer.Elapsed().count();
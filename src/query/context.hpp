@@ -23,6 +23,8 @@
 
 namespace query {
 
+class CompiledExpressionCache;
+
 struct EvaluationContext {
   /// Memory for allocations during evaluation of a *single* Pull call.
   ///
@@ -72,6 +74,19 @@ struct ExecutionContext {
   ExecutionStats execution_stats;
   TriggerContextCollector *trigger_context_collector{nullptr};
   utils::AsyncTimer timer;
+  /// Resource which enforces the memory limit of the query while it's
+  /// pulled, nullptr if the query has no memory limit.
+  const utils::LimitedMemoryResource *memory_limit{nullptr};
+  /// Set in the contexts of parallel workers. The scan of `morsel_symbol`
+  /// yields only the vertices in `morsel` instead of reading the storage.
+  std::optional<Symbol> morsel_symbol;
+  const std::vector<TypedValue> *morsel{nullptr};
+  /// Set in the contexts of parallel workers to the timer of the query, which
+  /// can't be copied into `timer`.
+  const utils::AsyncTimer *query_timer{nullptr};
+  /// Compiled expressions of the executed plan, nullptr if expressions are
+  /// only interpreted.
+  CompiledExpressionCache *compiled_expressions{nullptr};
   // wzy edit begin: add std::string addition
   // std::optional<std::string> addition;
   // std::optional<std::string> addition_right;
@@ -99,7 +114,7 @@ static_assert(std::is_move_constructible_v<ExecutionContext>, "ExecutionContext
 
 inline bool MustAbort(const ExecutionContext &context) noexcept {
   return (context.is_shutting_down != nullptr && context.is_shutting_down->load(std::memory_order_acquire)) ||
-         context.timer.IsExpired();
+         context.timer.IsExpired() || (context.query_timer != nullptr && context.query_timer->IsExpired());
 }
 
 inline plan::ProfilingStatsWithTotalTime GetStatsWithTotalTime(const ExecutionContext &context) {
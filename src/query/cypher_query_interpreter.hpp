@@ -17,6 +17,7 @@
 #include "query/frontend/semantic/required_privileges.hpp"
 #include "query/frontend/semantic/symbol_generator.hpp"
 #include "query/frontend/stripped.hpp"
+#include "query/interpret/compiled_expression.hpp"
 #include "query/plan/planner.hpp"
 #include "utils/flag_validation.hpp"
 #include "utils/timer.hpp"
@@ -25,6 +26,8 @@
 DECLARE_bool(query_cost_planner);
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DECLARE_int32(query_plan_cache_ttl);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_bool(query_compile_expressions);
 
 namespace query {
 
@@ -59,6 +62,7 @@ class CachedPlan {
   double cost() const { return plan_->GetCost(); }
   const auto &symbol_table() const { return plan_->GetSymbolTable(); }
   const auto &ast_storage() const { return plan_->GetAstStorage(); }
+  auto &compiled_expressions() { return compiled_expressions_; }
 
   //hjm begin
   const auto &getHistoryInfo() const { return plan_->getHistoryInfo(); }
@@ -72,6 +76,8 @@ class CachedPlan {
  private:
   std::unique_ptr<LogicalPlan> plan_;
   utils::Timer cache_timer_;
+  // Filters and projections of the plan, compiled when first executed.
+  CompiledExpressionCache compiled_expressions_;
 };
 
 struct CachedQuery {
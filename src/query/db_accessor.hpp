@@ -348,6 +348,11 @@ class DbAccessor final {
     return accessor_->GetHistoryDelta();
   }
 
+  void VisitVertexPropertyVersions(storage::Gid gid, storage::PropertyId property, uint64_t c_ts, uint64_t c_te,
+                                   const history_delta::PropertyVersionVisitor &visitor) {
+    accessor_->VisitVertexPropertyVersions(gid, property, c_ts, c_te, visitor);
+  }
+
   void FinalizeTransaction() { accessor_->FinalizeTransaction(); }
 
   VerticesIterable Vertices(storage::View view) { return VerticesIterable(accessor_->Vertices(view)); }
@@ -475,6 +480,23 @@ class DbAccessor final {
     return accessor_->ApproximateVertexCount(label, property, lower, upper);
   }
 
+  int64_t EdgesCount() const { return accessor_->ApproximateEdgeCount(); }
+
+  std::optional<storage::LabelStatistics> GetLabelStatistics(storage::LabelId label) const {
+    return accessor_->GetLabelStatistics(label);
+  }
+
+  std::optional<storage::EdgeTypeStatistics> GetEdgeTypeStatistics(storage::EdgeTypeId edge_type) const {
+    return accessor_->GetEdgeTypeStatistics(edge_type);
+  }
+
+  std::optional<storage::PropertyStatistics> GetPropertyStatistics(storage::LabelId label,
+                                                                   storage::PropertyId property) const {
+    return accessor_->GetPropertyStatistics(label, property);
+  }
+
+  storage::StatisticsStore &Statistics() { return accessor_->Statistics(); }
+
   storage::IndicesInfo ListAllIndices() const { return accessor_->ListAllIndices(); }
 
   storage::ConstraintsInfo ListAllConstraints() const { return accessor_->ListAllConstraints(); }
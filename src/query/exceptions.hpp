@@ -230,4 +230,10 @@ class VersionInfoInMulticommandTxException : public QueryException {
       : QueryException("Version info query not allowed in multicommand transactions.") {}
 };
 
+class AnalyzeGraphInMulticommandTxException : public QueryException {
+ public:
+  AnalyzeGraphInMulticommandTxException()
+      : QueryException("Analyze graph query not allowed in multicommand transactions.") {}
+};
+
 }  // namespace query
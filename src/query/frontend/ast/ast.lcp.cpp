@@ -289,3 +289,6 @@ const utils::TypeInfo query::VersionQuery::kType{
 
 const utils::TypeInfo query::SnapshotQuery::kType{
     0x6BABD81EA8CF62C1ULL, "SnapshotQuery", &query::Query::kType};
+
+const utils::TypeInfo query::AnalyzeGraphQuery::kType{
+    0xF029E12E20EF4042ULL, "AnalyzeGraphQuery", &query::Query::kType};
@@ -95,6 +95,7 @@ class StreamQuery;
 class SettingQuery;
 class VersionQuery;
 class SnapshotQuery;
+class AnalyzeGraphQuery;
 
 using TreeCompositeVisitor = ::utils::CompositeVisitor<
     SingleQuery, CypherUnion, NamedExpression, OrOperator, XorOperator, AndOperator, NotOperator, AdditionOperator,
@@ -129,6 +130,7 @@ template <class TResult>
 class QueryVisitor : public ::utils::Visitor<TResult, CypherQuery, ExplainQuery, ProfileQuery, IndexQuery, AuthQuery,
                                              InfoQuery, ConstraintQuery, DumpQuery, ReplicationQuery, LockPathQuery,
                                              FreeMemoryQuery, TriggerQuery, IsolationLevelQuery, CreateSnapshotQuery,
-                                             StreamQuery, SettingQuery, VersionQuery, SnapshotQuery> {};
+                                             StreamQuery, SettingQuery, VersionQuery, SnapshotQuery,
+                                             AnalyzeGraphQuery> {};
 
 }  // namespace query
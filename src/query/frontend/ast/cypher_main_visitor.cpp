@@ -882,6 +882,19 @@ antlrcpp::Any CypherMainVisitor::visitSnapshotQuery(MemgraphCypher::SnapshotQuer
   return snapshot_query;
 }
 
+antlrcpp::Any CypherMainVisitor::visitAnalyzeGraphQuery(MemgraphCypher::AnalyzeGraphQueryContext *ctx) {
+  auto *analyze_graph_query = storage_->Create<AnalyzeGraphQuery>();
+  analyze_graph_query->action_ = ctx->DELETE() ? AnalyzeGraphQuery::Action::DELETE : AnalyzeGraphQuery::Action::ANALYZE;
+  analyze_graph_query->all_labels_ = ctx->ASTERISK() != nullptr;
+  if (ctx->listOfLabelNames()) {
+    for (auto *label_name : ctx->listOfLabelNames()->labelName()) {
+      analyze_graph_query->labels_.push_back(label_name->accept(this).as<std::string>());
+    }
+  }
+  query_ = analyze_graph_query;
+  return analyze_graph_query;
+}
+
 antlrcpp::Any CypherMainVisitor::visitCypherUnion(MemgraphCypher::CypherUnionContext *ctx) {
   bool distinct = !ctx->ALL();
   auto *cypher_union = storage_->Create<CypherUnion>(distinct);
@@ -369,6 +369,11 @@ class CypherMainVisitor : public antlropencypher::MemgraphCypherBaseVisitor {
    */
   antlrcpp::Any visitSnapshotQuery(MemgraphCypher::SnapshotQueryContext *ctx) override;
 
+  /**
+   * @return AnalyzeGraphQuery*
+   */
+  antlrcpp::Any visitAnalyzeGraphQuery(MemgraphCypher::AnalyzeGraphQueryContext *ctx) override;
+
   /**
    * @return CypherUnion*
    */
@@ -22,6 +22,7 @@ import Cypher ;
 memgraphCypherKeyword : cypherKeyword
                       | AFTER
                       | ALTER
+                      | ANALYZE
                       | ASYNC
                       | AUTH
                       | BAD
@@ -51,10 +52,12 @@ memgraphCypherKeyword : cypherKeyword
                       | FROM
                       | GLOBAL
                       | GRANT
+                      | GRAPH
                       | HEADER
                       | IDENTIFIED
                       | ISOLATION
                       | KAFKA
+                      | LABELS
                       | LEVEL
                       | LOAD
                       | LOCK
@@ -80,6 +83,7 @@ memgraphCypherKeyword : cypherKeyword
                       | SETTINGS
                       | SNAPSHOT
                       | START
+                      | STATISTICS
                       | STATS
                       | STREAM
                       | STREAMS
@@ -122,6 +126,7 @@ query : cypherQuery
       | settingQuery
       | versionQuery
       | snapshotQuery
+      | analyzeGraphQuery
       ;
 
 authQuery : createRole
@@ -366,3 +371,7 @@ showSettings : SHOW DATABASE SETTINGS ;
 versionQuery : SHOW VERSION ;
 
 snapshotQuery : SNAPSHOT ;
+
+analyzeGraphQuery : ANALYZE GRAPH ( ON LABELS ( listOfLabelNames | ASTERISK ) ) ? ( DELETE STATISTICS ) ? ;
+
+listOfLabelNames : ':' labelName ( ',' ':' labelName )* ;
@@ -27,6 +27,7 @@ UNDERSCORE : '_' ;
 
 AFTER               : A F T E R ;
 ALTER               : A L T E R ;
+ANALYZE             : A N A L Y Z E ;
 ASYNC               : A S Y N C ;
 AUTH                : A U T H ;
 BAD                 : B A D ;
@@ -59,12 +60,14 @@ FREE_MEMORY         : F R E E UNDERSCORE M E M O R Y ;
 FROM                : F R O M ;
 GLOBAL              : G L O B A L ;
 GRANT               : G R A N T ;
+GRAPH               : G R A P H ;
 GRANTS              : G R A N T S ;
 HEADER              : H E A D E R ;
 IDENTIFIED          : I D E N T I F I E D ;
 IGNORE              : I G N O R E ;
 ISOLATION           : I S O L A T I O N ;
 KAFKA               : K A F K A ;
+LABELS              : L A B E L S ;
 LEVEL               : L E V E L ;
 LOAD                : L O A D ;
 LOCK                : L O C K ;
@@ -94,6 +97,7 @@ SETTING             : S E T T I N G ;
 SETTINGS            : S E T T I N G S ;
 SNAPSHOT            : S N A P S H O T ;
 START               : S T A R T ;
+STATISTICS          : S T A T I S T I C S ;
 STATS               : S T A T S ;
 STOP                : S T O P ;
 STREAM              : S T R E A M ;
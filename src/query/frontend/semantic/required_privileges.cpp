@@ -82,6 +82,8 @@ class PrivilegeExtractor : public QueryVisitor<void>, public HierarchicalTreeVis
 
   void Visit(SnapshotQuery &snapshot_query) override { AddPrivilege(AuthQuery::Privilege::SNAPSHOT); }
 
+  void Visit(AnalyzeGraphQuery &analyze_graph_query) override { AddPrivilege(AuthQuery::Privilege::STATS); }
+
   bool PreVisit(Create & /*unused*/) override {
     AddPrivilege(AuthQuery::Privilege::CREATE);
     return false;
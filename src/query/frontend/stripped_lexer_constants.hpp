@@ -204,7 +204,11 @@ const trie::Trie kKeywords = {"union",
                               "pulsar",
                               "service_url",
                               "version",
-                              "websocket"};
+                              "websocket",
+                              "analyze",
+                              "graph",
+                              "labels",
+                              "statistics"};
 
 // Unicode codepoints that are allowed at the start of the unescaped name.
 const std::bitset<kBitsetSize> kUnescapedNameAllowedStarts(
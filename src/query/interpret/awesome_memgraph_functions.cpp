@@ -16,6 +16,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <functional>
+#include <optional>
 #include <random>
 #include <string_view>
 #include <type_traits>
@@ -95,6 +96,7 @@ struct String {};
 struct Map {};
 struct Edge {};
 struct Vertex {};
+struct HistoryVertex {};
 struct Path {};
 struct Date {};
 struct LocalTime {};
@@ -127,6 +129,8 @@ bool ArgIsType(const TypedValue &arg) {
     return arg.IsMap();
   } else if constexpr (std::is_same_v<ArgType, Vertex>) {
     return arg.IsVertex();
+  } else if constexpr (std::is_same_v<ArgType, HistoryVertex>) {
+    return arg.IsHistoryVertex();
   } else if constexpr (std::is_same_v<ArgType, Edge>) {
     return arg.IsEdge();
   } else if constexpr (std::is_same_v<ArgType, Path>) {
@@ -175,6 +179,8 @@ constexpr const char *ArgTypeName() {
     return "map";
   } else if constexpr (std::is_same_v<ArgType, Vertex>) {
     return "node";
+  } else if constexpr (std::is_same_v<ArgType, HistoryVertex>) {
+    return "history node";
   } else if constexpr (std::is_same_v<ArgType, Edge>) {
     return "relationship";
   } else if constexpr (std::is_same_v<ArgType, Path>) {
@@ -1082,6 +1088,133 @@ void MapNumericParameters(auto &parameter_mappings, const auto &input_parameters
   }
 }
 
+// Time bound of a temporal aggregation. Integers are taken as they are,
+// `localDateTime()` values are converted to milliseconds, the same as the bounds
+// of the history queries.
+uint64_t HistoryBound(const TypedValue &value) {
+  if (value.IsLocalDateTime()) return value.ValueLocalDateTime().MicrosecondsSinceEpoch() / 1000;
+  return value.ValueInt();
+}
+
+// Calls `visitor` with the versions of the property (2nd argument) of the node
+// (1st argument) that are alive between the 3rd and the 4th argument, from the
+// newest to the oldest version. The versions are folded straight from the
+// delta chain and the history store, they are never materialized as
+// `HistoryVertex` rows. Returns false if the node is null.
+template <class TVisitor>
+bool VisitPropertyVersions(const char *name, const TypedValue *args, int64_t nargs, const FunctionContext &ctx,
+                           TVisitor &&visitor) {
+  FType<Or<Null, Vertex, HistoryVertex>, String, Or<NonNegativeInteger, LocalDateTime>,
+        Or<NonNegativeInteger, LocalDateTime>>(name, args, nargs);
+  if (args[0].IsNull()) return false;
+  auto *dba = ctx.db_accessor;
+  const auto gid = args[0].IsVertex() ? args[0].ValueVertex().Gid() : args[0].ValueHistoryVertex().gid;
+  dba->VisitVertexPropertyVersions(gid, dba->NameToProperty(args[1].ValueString()), HistoryBound(args[2]),
+                                   HistoryBound(args[3]),
+                                   [&](uint64_t tt_ts, uint64_t tt_te, const storage::PropertyValue &value) {
+                                     return visitor(tt_ts, tt_te, TypedValue(value, ctx.memory));
+                                   });
+  return true;
+}
+
+TypedValue TtVersionCount(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  int64_t count = 0;
+  auto counted = VisitPropertyVersions("ttVersionCount", args, nargs, ctx, [&](auto, auto, const auto &) {
+    ++count;
+    return true;
+  });
+  if (!counted) return TypedValue(ctx.memory);
+  return TypedValue(count, ctx.memory);
+}
+
+// The average of the values weighted by the time during which they were set.
+TypedValue TtAvg(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  double weighted_sum = 0;
+  double total_duration = 0;
+  VisitPropertyVersions("ttAvg", args, nargs, ctx, [&](uint64_t tt_ts, uint64_t tt_te, const TypedValue &value) {
+    if (value.IsNull()) return true;
+    if (!value.IsNumeric()) throw QueryRuntimeException("Only numeric values allowed in ttAvg.");
+    const auto duration = static_cast<double>(tt_te - tt_ts);
+    weighted_sum += (value.IsInt() ? static_cast<double>(value.ValueInt()) : value.ValueDouble()) * duration;
+    total_duration += duration;
+    return true;
+  });
+  if (total_duration == 0) return TypedValue(ctx.memory);
+  return TypedValue(weighted_sum / total_duration, ctx.memory);
+}
+
+template <bool kMax>
+TypedValue TtMinMax(const char *name, const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  TypedValue result(ctx.memory);
+  VisitPropertyVersions(name, args, nargs, ctx, [&](auto, auto, const TypedValue &value) {
+    if (value.IsNull()) return true;
+    if (!value.IsBool() && !value.IsNumeric() && !value.IsString()) {
+      throw QueryRuntimeException("Only boolean, numeric and string values are allowed in {}.", name);
+    }
+    if (result.IsNull()) {
+      result = value;
+      return true;
+    }
+    try {
+      TypedValue comparison_result = kMax ? value > result : value < result;
+      if (comparison_result.ValueBool()) result = value;
+    } catch (const TypedValueException &) {
+      throw QueryRuntimeException("Unable to get {} of '{}' and '{}'.", name, value.type(), result.type());
+    }
+    return true;
+  });
+  return result;
+}
+
+TypedValue TtMin(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  return TtMinMax<false>("ttMin", args, nargs, ctx);
+}
+
+TypedValue TtMax(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  return TtMinMax<true>("ttMax", args, nargs, ctx);
+}
+
+// The value at the start of the window.
+TypedValue TtFirst(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  TypedValue first(ctx.memory);
+  VisitPropertyVersions("ttFirst", args, nargs, ctx, [&](auto, auto, const TypedValue &value) {
+    first = value;
+    return true;
+  });
+  return first;
+}
+
+// The value at the end of the window, only the newest version is read.
+TypedValue TtLast(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  TypedValue last(ctx.memory);
+  VisitPropertyVersions("ttLast", args, nargs, ctx, [&](auto, auto, const TypedValue &value) {
+    last = value;
+    return false;
+  });
+  return last;
+}
+
+// The change points of the value inside the window, as a list of maps with the
+// time of the change and the new value, ordered by time.
+TypedValue TtChanges(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
+  TypedValue::TVector changes(ctx.memory);
+  std::optional<std::pair<uint64_t, TypedValue>> newer;
+  auto visited = VisitPropertyVersions("ttChanges", args, nargs, ctx,
+                                       [&](uint64_t tt_ts, auto, const TypedValue &value) {
+                                         if (newer && !TypedValue::BoolEqual{}(newer->second, value)) {
+                                           TypedValue::TMap change(ctx.memory);
+                                           change.emplace("time", TypedValue(static_cast<int64_t>(newer->first)));
+                                           change.emplace("value", std::move(newer->second));
+                                           changes.emplace_back(std::move(change));
+                                         }
+                                         newer.emplace(tt_ts, value);
+                                         return true;
+                                       });
+  if (!visited) return TypedValue(ctx.memory);
+  std::reverse(changes.begin(), changes.end());
+  return TypedValue(std::move(changes));
+}
+
 TypedValue Date(const TypedValue *args, int64_t nargs, const FunctionContext &ctx) {
   FType<Optional<Or<String, Map>>>("date", args, nargs);
   if (nargs == 0) {
@@ -1264,6 +1397,15 @@ std::function<TypedValue(const TypedValue *, int64_t, const FunctionContext &ctx
   if (function_name == "LOCALDATETIME") return LocalDateTime;
   if (function_name == "DURATION") return Duration;
 
+  // Functions over the history of the properties
+  if (function_name == "TTVERSIONCOUNT") return TtVersionCount;
+  if (function_name == "TTAVG") return TtAvg;
+  if (function_name == "TTMIN") return TtMin;
+  if (function_name == "TTMAX") return TtMax;
+  if (function_name == "TTFIRST") return TtFirst;
+  if (function_name == "TTLAST") return TtLast;
+  if (function_name == "TTCHANGES") return TtChanges;
+
   return nullptr;
 }
 
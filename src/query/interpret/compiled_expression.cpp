@@ -0,0 +1,526 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/interpret/compiled_expression.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "query/context.hpp"
+#include "utils/typeinfo.hpp"
+#include "utils/logging.hpp"
+
+namespace query {
+
+namespace {
+
+using Type = CompiledValue::Type;
+using Op = CompiledExpression::Op;
+
+void SetNull(CompiledValue *value) { value->type = Type::Null; }
+
+void SetBool(CompiledValue *value, bool bool_v) {
+  value->type = Type::Bool;
+  value->bool_v = bool_v;
+}
+
+void SetInt(CompiledValue *value, int64_t int_v) {
+  value->type = Type::Int;
+  value->int_v = int_v;
+}
+
+void SetDouble(CompiledValue *value, double double_v) {
+  value->type = Type::Double;
+  value->double_v = double_v;
+}
+
+bool IsNumeric(const CompiledValue &value) { return value.type == Type::Int || value.type == Type::Double; }
+
+bool IsLogical(const CompiledValue &value) { return value.type == Type::Bool || value.type == Type::Null; }
+
+double ToDouble(const CompiledValue &value) {
+  return value.type == Type::Int ? static_cast<double>(value.int_v) : value.double_v;
+}
+
+bool FromPropertyValue(const storage::PropertyValue &value, CompiledValue *result) {
+  switch (value.type()) {
+    case storage::PropertyValue::Type::Null:
+      SetNull(result);
+      return true;
+    case storage::PropertyValue::Type::Bool:
+      SetBool(result, value.ValueBool());
+      return true;
+    case storage::PropertyValue::Type::Int:
+      SetInt(result, value.ValueInt());
+      return true;
+    case storage::PropertyValue::Type::Double:
+      SetDouble(result, value.ValueDouble());
+      return true;
+    case storage::PropertyValue::Type::String:
+      result->type = Type::String;
+      result->string_v = value.ValueString();
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool FromTypedValue(const TypedValue &value, CompiledValue *result) {
+  switch (value.type()) {
+    case TypedValue::Type::Null:
+      SetNull(result);
+      return true;
+    case TypedValue::Type::Bool:
+      SetBool(result, value.ValueBool());
+      return true;
+    case TypedValue::Type::Int:
+      SetInt(result, value.ValueInt());
+      return true;
+    case TypedValue::Type::Double:
+      SetDouble(result, value.ValueDouble());
+      return true;
+    case TypedValue::Type::String:
+      result->type = Type::String;
+      result->string_v.assign(value.ValueString().data(), value.ValueString().size());
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The operations below follow the `TypedValue` operators. They return false
+// where those operators throw, and `result` may be the same object as `a`.
+
+void Equal(const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (a.type == Type::Null || b.type == Type::Null) return SetNull(result);
+  if (IsNumeric(a) && IsNumeric(b)) {
+    if (a.type == Type::Double || b.type == Type::Double) return SetBool(result, ToDouble(a) == ToDouble(b));
+    return SetBool(result, a.int_v == b.int_v);
+  }
+  if (a.type != b.type) return SetBool(result, false);
+  if (a.type == Type::Bool) return SetBool(result, a.bool_v == b.bool_v);
+  return SetBool(result, a.string_v == b.string_v);
+}
+
+bool Less(const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (a.type == Type::Bool || b.type == Type::Bool) return false;
+  if (a.type == Type::Null || b.type == Type::Null) {
+    SetNull(result);
+    return true;
+  }
+  if (a.type == Type::String || b.type == Type::String) {
+    if (a.type != b.type) return false;
+    SetBool(result, a.string_v < b.string_v);
+    return true;
+  }
+  if (a.type == Type::Double || b.type == Type::Double) {
+    SetBool(result, ToDouble(a) < ToDouble(b));
+  } else {
+    SetBool(result, a.int_v < b.int_v);
+  }
+  return true;
+}
+
+bool Not(CompiledValue *value) {
+  if (value->type == Type::Null) return true;
+  if (value->type != Type::Bool) return false;
+  value->bool_v = !value->bool_v;
+  return true;
+}
+
+bool And(const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (!IsLogical(a) || !IsLogical(b)) return false;
+  if ((a.type == Type::Bool && !a.bool_v) || (b.type == Type::Bool && !b.bool_v)) {
+    SetBool(result, false);
+  } else if (a.type == Type::Null || b.type == Type::Null) {
+    SetNull(result);
+  } else {
+    SetBool(result, true);
+  }
+  return true;
+}
+
+bool Or(const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (!IsLogical(a) || !IsLogical(b)) return false;
+  if ((a.type == Type::Bool && a.bool_v) || (b.type == Type::Bool && b.bool_v)) {
+    SetBool(result, true);
+  } else if (a.type == Type::Null || b.type == Type::Null) {
+    SetNull(result);
+  } else {
+    SetBool(result, false);
+  }
+  return true;
+}
+
+bool Xor(const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (!IsLogical(a) || !IsLogical(b)) return false;
+  if (a.type == Type::Null || b.type == Type::Null) {
+    SetNull(result);
+  } else {
+    SetBool(result, a.bool_v != b.bool_v);
+  }
+  return true;
+}
+
+bool Arithmetic(Op op, const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  if (a.type == Type::Null || b.type == Type::Null) {
+    SetNull(result);
+    return true;
+  }
+  if (op == Op::ADD && a.type == Type::String && b.type == Type::String) {
+    auto concatenated = a.string_v + b.string_v;
+    result->type = Type::String;
+    result->string_v = std::move(concatenated);
+    return true;
+  }
+  if (!IsNumeric(a) || !IsNumeric(b)) return false;
+  if (a.type == Type::Double || b.type == Type::Double) {
+    const auto lhs = ToDouble(a);
+    const auto rhs = ToDouble(b);
+    switch (op) {
+      case Op::ADD:
+        SetDouble(result, lhs + rhs);
+        return true;
+      case Op::SUBTRACT:
+        SetDouble(result, lhs - rhs);
+        return true;
+      case Op::MULTIPLY:
+        SetDouble(result, lhs * rhs);
+        return true;
+      case Op::DIVIDE:
+        SetDouble(result, lhs / rhs);
+        return true;
+      case Op::MOD:
+        SetDouble(result, std::fmod(lhs, rhs));
+        return true;
+      default:
+        LOG_FATAL("Unexpected arithmetic operation");
+    }
+  }
+  const auto lhs = a.int_v;
+  const auto rhs = b.int_v;
+  switch (op) {
+    case Op::ADD:
+      SetInt(result, lhs + rhs);
+      return true;
+    case Op::SUBTRACT:
+      SetInt(result, lhs - rhs);
+      return true;
+    case Op::MULTIPLY:
+      SetInt(result, lhs * rhs);
+      return true;
+    case Op::DIVIDE:
+      if (rhs == 0) return false;
+      SetInt(result, lhs / rhs);
+      return true;
+    case Op::MOD:
+      if (rhs == 0) return false;
+      SetInt(result, lhs % rhs);
+      return true;
+    default:
+      LOG_FATAL("Unexpected arithmetic operation");
+  }
+}
+
+bool Binary(Op op, const CompiledValue &a, const CompiledValue &b, CompiledValue *result) {
+  switch (op) {
+    case Op::AND:
+      return And(a, b, result);
+    case Op::OR:
+      return Or(a, b, result);
+    case Op::XOR:
+      return Xor(a, b, result);
+    case Op::EQUAL:
+      Equal(a, b, result);
+      return true;
+    case Op::NOT_EQUAL:
+      Equal(a, b, result);
+      return Not(result);
+    case Op::LESS:
+      return Less(a, b, result);
+    case Op::GREATER_EQUAL:
+      return Less(a, b, result) && Not(result);
+    case Op::LESS_EQUAL:
+    case Op::GREATER: {
+      // a <= b is defined as a < b || a == b, and a > b as !(a <= b).
+      CompiledValue less;
+      if (!Less(a, b, &less)) return false;
+      Equal(a, b, result);
+      if (!Or(less, *result, result)) return false;
+      return op == Op::LESS_EQUAL || Not(result);
+    }
+    case Op::ADD:
+    case Op::SUBTRACT:
+    case Op::MULTIPLY:
+    case Op::DIVIDE:
+    case Op::MOD:
+      return Arithmetic(op, a, b, result);
+    default:
+      LOG_FATAL("Unexpected binary operation");
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledExpression> CompiledExpression::Compile(Expression *expression,
+                                                                const SymbolTable &symbol_table) {
+  // Single values are as cheap to evaluate with the ExpressionEvaluator.
+  if (utils::Downcast<Identifier>(expression) || utils::Downcast<PrimitiveLiteral>(expression) ||
+      utils::Downcast<ParameterLookup>(expression)) {
+    return nullptr;
+  }
+  std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+  if (!compiled->Emit(expression, symbol_table)) return nullptr;
+  MG_ASSERT(compiled->stack_size_ == 1, "Compiled expression must leave a single value on the stack");
+  return compiled;
+}
+
+void CompiledExpression::Push(Instruction instruction, int64_t stack_change) {
+  code_.push_back(instruction);
+  stack_size_ += stack_change;
+  max_stack_size_ = std::max(max_stack_size_, stack_size_);
+}
+
+bool CompiledExpression::Emit(Expression *expression, const SymbolTable &symbol_table) {
+  auto emit_binary = [&](auto *op, Op code) {
+    if (!op) return false;
+    if (!Emit(op->expression1_, symbol_table) || !Emit(op->expression2_, symbol_table)) return false;
+    Push({code}, -1);
+    return true;
+  };
+  auto emit_unary = [&](auto *op, Op code) {
+    if (!op) return false;
+    if (!Emit(op->expression_, symbol_table)) return false;
+    Push({code}, 0);
+    return true;
+  };
+  auto frame_position = [&](Expression *operand) -> std::optional<int64_t> {
+    auto *identifier = utils::Downcast<Identifier>(operand);
+    if (!identifier) return std::nullopt;
+    return symbol_table.at(*identifier).position();
+  };
+
+  if (auto *identifier = utils::Downcast<Identifier>(expression)) {
+    Push({Op::IDENTIFIER, symbol_table.at(*identifier).position()}, 1);
+    return true;
+  }
+  if (auto *literal = utils::Downcast<PrimitiveLiteral>(expression)) {
+    CompiledValue value;
+    if (!FromPropertyValue(literal->value_, &value)) return false;
+    constants_.push_back(std::move(value));
+    Push({Op::CONSTANT, static_cast<int64_t>(constants_.size() - 1)}, 1);
+    return true;
+  }
+  if (auto *parameter = utils::Downcast<ParameterLookup>(expression)) {
+    parameters_.push_back(parameter->token_position_);
+    Push({Op::PARAMETER, static_cast<int64_t>(parameters_.size() - 1)}, 1);
+    return true;
+  }
+  if (auto *lookup = utils::Downcast<PropertyLookup>(expression)) {
+    // Only properties of nodes and edges in the frame are looked up, nested
+    // lookups work on maps.
+    const auto position = frame_position(lookup->expression_);
+    if (!position) return false;
+    Push({Op::PROPERTY, *position, lookup->property_.ix}, 1);
+    return true;
+  }
+  if (auto *labels_test = utils::Downcast<LabelsTest>(expression)) {
+    const auto position = frame_position(labels_test->expression_);
+    if (!position) return false;
+    const auto first = static_cast<int64_t>(labels_.size());
+    for (const auto &label : labels_test->labels_) labels_.push_back(label.ix);
+    Push({Op::LABELS, *position, first, static_cast<int64_t>(labels_test->labels_.size())}, 1);
+    return true;
+  }
+  if (auto *op = utils::Downcast<AndOperator>(expression)) {
+    // Like the ExpressionEvaluator, the right side isn't evaluated if the
+    // left one is false.
+    if (!Emit(op->expression1_, symbol_table)) return false;
+    const auto jump = code_.size();
+    Push({Op::JUMP_IF_FALSE}, 0);
+    if (!Emit(op->expression2_, symbol_table)) return false;
+    Push({Op::AND}, -1);
+    code_[jump].arg = static_cast<int64_t>(code_.size());
+    return true;
+  }
+  return emit_unary(utils::Downcast<IsNullOperator>(expression), Op::IS_NULL) ||
+         emit_unary(utils::Downcast<NotOperator>(expression), Op::NOT) ||
+         emit_unary(utils::Downcast<UnaryMinusOperator>(expression), Op::UNARY_MINUS) ||
+         emit_unary(utils::Downcast<UnaryPlusOperator>(expression), Op::UNARY_PLUS) ||
+         emit_binary(utils::Downcast<OrOperator>(expression), Op::OR) ||
+         emit_binary(utils::Downcast<XorOperator>(expression), Op::XOR) ||
+         emit_binary(utils::Downcast<EqualOperator>(expression), Op::EQUAL) ||
+         emit_binary(utils::Downcast<NotEqualOperator>(expression), Op::NOT_EQUAL) ||
+         emit_binary(utils::Downcast<LessOperator>(expression), Op::LESS) ||
+         emit_binary(utils::Downcast<GreaterOperator>(expression), Op::GREATER) ||
+         emit_binary(utils::Downcast<LessEqualOperator>(expression), Op::LESS_EQUAL) ||
+         emit_binary(utils::Downcast<GreaterEqualOperator>(expression), Op::GREATER_EQUAL) ||
+         emit_binary(utils::Downcast<AdditionOperator>(expression), Op::ADD) ||
+         emit_binary(utils::Downcast<SubtractionOperator>(expression), Op::SUBTRACT) ||
+         emit_binary(utils::Downcast<MultiplicationOperator>(expression), Op::MULTIPLY) ||
+         emit_binary(utils::Downcast<DivisionOperator>(expression), Op::DIVIDE) ||
+         emit_binary(utils::Downcast<ModOperator>(expression), Op::MOD);
+}
+
+const CompiledExpression *CompiledExpressionCache::Get(Expression *expression, const SymbolTable &symbol_table) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto [it, inserted] = expressions_.try_emplace(expression);
+  if (inserted) it->second = CompiledExpression::Compile(expression, symbol_table);
+  return it->second.get();
+}
+
+CompiledExpressionEvaluator::CompiledExpressionEvaluator(const CompiledExpression &expression,
+                                                         const EvaluationContext &ctx, storage::View view)
+    : expression_(&expression), ctx_(&ctx), view_(view), stack_(expression.max_stack_size()) {
+  parameters_.reserve(expression.parameters().size());
+  for (const auto token_position : expression.parameters()) {
+    CompiledValue value;
+    if (FromPropertyValue(ctx.parameters.AtTokenPosition(token_position), &value)) {
+      parameters_.emplace_back(std::move(value));
+    } else {
+      parameters_.emplace_back(std::nullopt);
+    }
+  }
+}
+
+std::optional<bool> CompiledExpressionEvaluator::EvaluateFilter(Frame &frame) {
+  ++evaluations_;
+  if (Run(frame)) {
+    const auto &result = stack_[0];
+    if (result.type == Type::Null) return false;
+    if (result.type == Type::Bool) return result.bool_v;
+  }
+  ++fallbacks_;
+  return std::nullopt;
+}
+
+std::optional<TypedValue> CompiledExpressionEvaluator::Evaluate(Frame &frame, utils::MemoryResource *memory) {
+  ++evaluations_;
+  if (!Run(frame)) {
+    ++fallbacks_;
+    return std::nullopt;
+  }
+  const auto &result = stack_[0];
+  switch (result.type) {
+    case Type::Null:
+      return TypedValue(memory);
+    case Type::Bool:
+      return TypedValue(result.bool_v, memory);
+    case Type::Int:
+      return TypedValue(result.int_v, memory);
+    case Type::Double:
+      return TypedValue(result.double_v, memory);
+    case Type::String:
+      break;
+  }
+  return TypedValue(result.string_v, memory);
+}
+
+bool CompiledExpressionEvaluator::Run(Frame &frame) {
+  const auto &code = expression_->code();
+  auto &elems = frame.elems();
+  size_t size = 0;
+  for (size_t pc = 0; pc < code.size(); ++pc) {
+    const auto &instruction = code[pc];
+    switch (instruction.op) {
+      case Op::CONSTANT:
+        stack_[size++] = expression_->constants()[instruction.arg];
+        break;
+      case Op::PARAMETER: {
+        const auto &parameter = parameters_[instruction.arg];
+        if (!parameter) return false;
+        stack_[size++] = *parameter;
+        break;
+      }
+      case Op::IDENTIFIER:
+        if (!FromTypedValue(elems[instruction.arg], &stack_[size])) return false;
+        ++size;
+        break;
+      case Op::PROPERTY:
+        if (!LoadProperty(elems[instruction.arg], instruction.arg2, &stack_[size])) return false;
+        ++size;
+        break;
+      case Op::LABELS:
+        if (!LoadLabels(elems[instruction.arg], instruction, &stack_[size])) return false;
+        ++size;
+        break;
+      case Op::JUMP_IF_FALSE: {
+        const auto &top = stack_[size - 1];
+        if (top.type == Type::Bool && !top.bool_v) pc = instruction.arg - 1;
+        break;
+      }
+      case Op::IS_NULL:
+        SetBool(&stack_[size - 1], stack_[size - 1].type == Type::Null);
+        break;
+      case Op::NOT:
+        if (!Not(&stack_[size - 1])) return false;
+        break;
+      case Op::UNARY_MINUS:
+      case Op::UNARY_PLUS: {
+        auto &top = stack_[size - 1];
+        if (top.type != Type::Null && !IsNumeric(top)) return false;
+        if (instruction.op == Op::UNARY_MINUS) {
+          if (top.type == Type::Int) top.int_v = -top.int_v;
+          if (top.type == Type::Double) top.double_v = -top.double_v;
+        }
+        break;
+      }
+      default:
+        --size;
+        if (!Binary(instruction.op, stack_[size - 1], stack_[size], &stack_[size - 1])) return false;
+        break;
+    }
+  }
+  return true;
+}
+
+bool CompiledExpressionEvaluator::LoadProperty(const TypedValue &value, int64_t property_ix,
+                                               CompiledValue *result) const {
+  const auto property = ctx_->properties[property_ix];
+  switch (value.type()) {
+    case TypedValue::Type::Null:
+      SetNull(result);
+      return true;
+    case TypedValue::Type::Vertex: {
+      auto maybe_value = value.ValueVertex().GetProperty(view_, property);
+      return maybe_value.HasValue() && FromPropertyValue(*maybe_value, result);
+    }
+    case TypedValue::Type::Edge: {
+      auto maybe_value = value.ValueEdge().GetProperty(view_, property);
+      return maybe_value.HasValue() && FromPropertyValue(*maybe_value, result);
+    }
+    default:
+      return false;
+  }
+}
+
+bool CompiledExpressionEvaluator::LoadLabels(const TypedValue &value,
+                                             const CompiledExpression::Instruction &instruction,
+                                             CompiledValue *result) const {
+  if (value.IsNull()) {
+    SetNull(result);
+    return true;
+  }
+  if (!value.IsVertex()) return false;
+  const auto &labels = expression_->labels();
+  for (auto i = instruction.arg2; i < instruction.arg2 + instruction.arg3; ++i) {
+    auto has_label = value.ValueVertex().HasLabel(view_, ctx_->labels[labels[i]]);
+    if (has_label.HasError()) return false;
+    if (!*has_label) {
+      SetBool(result, false);
+      return true;
+    }
+  }
+  SetBool(result, true);
+  return true;
+}
+
+}  // namespace query
@@ -0,0 +1,173 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "query/frontend/ast/ast.hpp"
+#include "query/frontend/semantic/symbol_table.hpp"
+#include "query/interpret/frame.hpp"
+#include "query/typed_value.hpp"
+#include "storage/v2/property_value.hpp"
+
+namespace query {
+
+struct EvaluationContext;
+
+/// Scalar value on the stack of a `CompiledExpression`. Only nulls, booleans,
+/// numbers and strings are represented, everything else makes the evaluation
+/// fall back to the `ExpressionEvaluator`.
+struct CompiledValue {
+  enum class Type : uint8_t { Null, Bool, Int, Double, String };
+
+  Type type{Type::Null};
+  union {
+    bool bool_v;
+    int64_t int_v;
+    double double_v;
+  };
+  std::string string_v;
+};
+
+/// An expression lowered to a flat sequence of stack machine instructions.
+///
+/// The program only refers to frame positions, `PropertyIx`/`LabelIx`
+/// indices, parameter token positions and literals, so it doesn't depend on
+/// the execution and is compiled once per cached plan. Expressions are
+/// compiled if they consist of literals, parameters, identifiers, property
+/// lookups and label tests on identifiers, boolean, comparison and arithmetic
+/// operators and `IS NULL`.
+class CompiledExpression final {
+ public:
+  enum class Op : uint8_t {
+    CONSTANT,
+    PARAMETER,
+    IDENTIFIER,
+    PROPERTY,
+    LABELS,
+    JUMP_IF_FALSE,
+    IS_NULL,
+    NOT,
+    UNARY_MINUS,
+    UNARY_PLUS,
+    AND,
+    OR,
+    XOR,
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    GREATER,
+    LESS_EQUAL,
+    GREATER_EQUAL,
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    MOD,
+  };
+
+  struct Instruction {
+    Op op;
+    // CONSTANT: index into `constants_`, PARAMETER: index into `parameters_`,
+    // IDENTIFIER, PROPERTY, LABELS: frame position, JUMP_IF_FALSE: target.
+    int64_t arg{0};
+    // PROPERTY: `PropertyIx::ix`, LABELS: first index into `labels_`.
+    int64_t arg2{0};
+    // LABELS: number of labels.
+    int64_t arg3{0};
+  };
+
+  /// Returns nullptr if the expression (or a part of it) isn't supported, or
+  /// if it is so simple that compiling it wouldn't pay off.
+  static std::unique_ptr<CompiledExpression> Compile(Expression *expression, const SymbolTable &symbol_table);
+
+  const auto &code() const { return code_; }
+  const auto &constants() const { return constants_; }
+  const auto &parameters() const { return parameters_; }
+  const auto &labels() const { return labels_; }
+  size_t max_stack_size() const { return max_stack_size_; }
+
+ private:
+  CompiledExpression() = default;
+
+  bool Emit(Expression *expression, const SymbolTable &symbol_table);
+  void Push(Instruction instruction, int64_t stack_change);
+
+  std::vector<Instruction> code_;
+  std::vector<CompiledValue> constants_;
+  // token positions of the looked up parameters
+  std::vector<int64_t> parameters_;
+  std::vector<int64_t> labels_;
+  size_t stack_size_{0};
+  size_t max_stack_size_{0};
+};
+
+/// Compiled expressions of a single plan, compiled on first use and kept for
+/// as long as the plan is cached.
+class CompiledExpressionCache final {
+ public:
+  /// Returns the compiled `expression` or nullptr if it can't be compiled.
+  const CompiledExpression *Get(Expression *expression, const SymbolTable &symbol_table);
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<const Expression *, std::unique_ptr<CompiledExpression>> expressions_;
+};
+
+/// Runs a `CompiledExpression` during a single execution. The parameters are
+/// resolved when the evaluator is constructed.
+///
+/// When a value in the frame or in the storage isn't supported by the
+/// compiled code, or when the operation would raise an error, the evaluation
+/// returns std::nullopt and the caller should evaluate the expression with the
+/// `ExpressionEvaluator`, which produces the result (or the error message).
+/// Nothing is modified before that happens, so falling back is always safe.
+class CompiledExpressionEvaluator final {
+ public:
+  CompiledExpressionEvaluator(const CompiledExpression &expression, const EvaluationContext &ctx, storage::View view);
+
+  /// Evaluates the expression as a filter: Null is false and std::nullopt is
+  /// also returned for results which aren't booleans.
+  std::optional<bool> EvaluateFilter(Frame &frame);
+
+  std::optional<TypedValue> Evaluate(Frame &frame, utils::MemoryResource *memory);
+
+  /// False once the expression mostly falls back, so the caller can stop
+  /// trying it.
+  bool IsUseful() const { return fallbacks_ < kMaxFallbacks || fallbacks_ < evaluations_ / 2; }
+
+ private:
+  static constexpr uint64_t kMaxFallbacks = 64;
+
+  bool Run(Frame &frame);
+  bool LoadProperty(const TypedValue &value, int64_t property_ix, CompiledValue *result) const;
+  bool LoadLabels(const TypedValue &value, const CompiledExpression::Instruction &instruction,
+                  CompiledValue *result) const;
+
+  const CompiledExpression *expression_;
+  const EvaluationContext *ctx_;
+  storage::View view_;
+  // Parameters which can't be represented make the evaluation fall back.
+  std::vector<std::optional<CompiledValue>> parameters_;
+  std::vector<CompiledValue> stack_;
+  uint64_t evaluations_{0};
+  uint64_t fallbacks_{0};
+};
+
+}  // namespace query
@@ -13,13 +13,17 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <optional>
+#include <random>
+#include <set>
 
 #include "glue/communication.hpp"
 #include "memory/memory_control.hpp"
@@ -38,6 +42,11 @@
 //wzy add begin
 #include "query/frontend/stripped.hpp"
 //wzy add end
+
+DEFINE_VALIDATED_HIDDEN_uint64(query_statistics_sample_size, 100000U,
+                               "Number of values of every property which ANALYZE GRAPH samples to estimate the "
+                               "number of distinct values and to build the histogram.",
+                               FLAG_IN_RANGE(1, std::numeric_limits<uint64_t>::max()));
 #include "query/interpret/eval.hpp"
 #include "query/metadata.hpp"
 #include "query/plan/planner.hpp"
@@ -46,6 +55,7 @@
 #include "query/stream/common.hpp"
 #include "query/trigger.hpp"
 #include "query/typed_value.hpp"
+#include "storage/v2/hybrid_clock.hpp"
 #include "storage/v2/property_value.hpp"
 #include "utils/algorithm.hpp"
 #include "utils/csv_parsing.hpp"
@@ -236,6 +246,8 @@ class ReplQueryHandler final : public query::ReplicationQueryHandler {
       if (repl_info.timeout) {
         replica.timeout = *repl_info.timeout;
       }
+      replica.pending_transactions = repl_info.pending_transactions;
+      replica.lag_ms = repl_info.lag_ms;
 
       return replica;
     };
@@ -500,7 +512,7 @@ Callback HandleReplicationQuery(ReplicationQuery *repl_query, const Parameters &
       return callback;
     }
     case ReplicationQuery::Action::SHOW_REPLICAS: {
-      callback.header = {"name", "socket_address", "sync_mode", "timeout"};
+      callback.header = {"name", "socket_address", "sync_mode", "timeout", "pending_transactions", "lag_ms"};
       callback.fn = [handler = ReplQueryHandler{interpreter_context->db}, replica_nfields = callback.header.size()] {
         const auto &replicas = handler.ShowReplicas();
         auto typed_replicas = std::vector<std::vector<TypedValue>>{};
@@ -519,12 +531,13 @@ Callback HandleReplicationQuery(ReplicationQuery *repl_query, const Parameters &
               typed_replica.emplace_back(TypedValue("async"));
               break;
           }
-          typed_replica.emplace_back(TypedValue(static_cast<int64_t>(replica.sync_mode)));
           if (replica.timeout) {
             typed_replica.emplace_back(TypedValue(*replica.timeout));
           } else {
             typed_replica.emplace_back(TypedValue());
           }
+          typed_replica.emplace_back(TypedValue(static_cast<int64_t>(replica.pending_transactions)));
+          typed_replica.emplace_back(TypedValue(static_cast<int64_t>(replica.lag_ms)));
 
           typed_replicas.emplace_back(std::move(typed_replica));
         }
@@ -898,6 +911,7 @@ PullPlan::PullPlan(const std::shared_ptr<CachedPlan> plan, const Parameters &par
   ctx_.evaluation_context.parameters = parameters;
   ctx_.evaluation_context.properties = NamesToProperties(plan->ast_storage().properties_, dba);
   ctx_.evaluation_context.labels = NamesToLabels(plan->ast_storage().labels_, dba);
+  if (FLAGS_query_compile_expressions) ctx_.compiled_expressions = &plan->compiled_expressions();
   if (interpreter_context->config.execution_timeout_sec > 0) {
     ctx_.timer = utils::AsyncTimer{interpreter_context->config.execution_timeout_sec};
   }
@@ -938,8 +952,10 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
   if (memory_limit_) {
     maybe_limited_resource.emplace(&pool_memory, *memory_limit_);
     ctx_.evaluation_context.memory = &*maybe_limited_resource;
+    ctx_.memory_limit = &*maybe_limited_resource;
   } else {
     ctx_.evaluation_context.memory = &pool_memory;
+    ctx_.memory_limit = nullptr;
   }
 
   // Returns true if a result was pulled.
@@ -1011,6 +1027,14 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
 }
 
 using RWType = plan::ReadWriteTypeChecker::RWType;
+
+// Time bound of a history query. Integers are taken as they are, temporal
+// values (e.g. `localDateTime()`) are converted to milliseconds.
+// @throw storage::PropertyValueException
+int64_t HistoryBound(const storage::PropertyValue &value) {
+  if (value.IsTemporalData()) return value.ValueTemporalData().microseconds / 1000;
+  return value.ValueInt();
+}
 }  // namespace
 
 InterpreterContext::InterpreterContext(storage::Storage *db, const InterpreterConfig config,
@@ -1123,8 +1147,18 @@ PreparedQuery PrepareCypherQuery(ParsedQuery parsed_query, std::map<std::string,
     auto history_infos=plan->getHistoryInfo();
     if(history_infos->first!=0){
       // std::cout<<"0123456789 history_infos:"<<history_infos->first<<" "<<parsed_query.parameters.AtTokenPosition(history_infos->first).ValueInt()<<"\n";
-      interpreter_context->addition=parsed_query.parameters.AtTokenPosition(history_infos->first).ValueInt();
-      interpreter_context->addition_right=parsed_query.parameters.AtTokenPosition(history_infos->second).ValueInt();
+      int64_t left = HistoryBound(parsed_query.parameters.AtTokenPosition(history_infos->first));
+      int64_t right = HistoryBound(parsed_query.parameters.AtTokenPosition(history_infos->second));
+      // With real-time history the bounds are wall-clock milliseconds and they
+      // have to cover every hybrid clock timestamp assigned in those
+      // milliseconds. AS OF keeps equal bounds.
+      if (interpreter_context->db->UsesHybridClock()) {
+        const auto as_of = left == right;
+        left = static_cast<int64_t>(as_of ? storage::HybridClock::UpperBound(left) : storage::HybridClock::LowerBound(left));
+        right = static_cast<int64_t>(storage::HybridClock::UpperBound(right));
+      }
+      interpreter_context->addition=left;
+      interpreter_context->addition_right=right;
     }
   }catch(...){
 
@@ -1539,6 +1573,299 @@ PreparedQuery PrepareSnapshotQuery(ParsedQuery parsed_query, const bool in_expli
       RWType::NONE};
 }
 
+// Number of buckets of the equi-depth histograms of the property values.
+constexpr size_t kStatisticsHistogramBuckets = 64;
+// Without a list of labels, `ANALYZE GRAPH` refreshes only the statistics of
+// the labels (and edge types) whose count changed by more than this fraction
+// since they were analyzed.
+constexpr double kStatisticsStaleFraction = 0.1;
+
+bool IsStale(uint64_t analyzed_count, uint64_t count) {
+  const auto difference = analyzed_count > count ? analyzed_count - count : count - analyzed_count;
+  return static_cast<double>(difference) > kStatisticsStaleFraction * static_cast<double>(analyzed_count);
+}
+
+// Reservoir sample of the values of a property of the vertices with a label.
+struct PropertySample {
+  uint64_t count{0};
+  std::vector<storage::PropertyValue> values;
+};
+
+// The histograms hold values of a single group of mutually comparable types.
+std::optional<size_t> HistogramGroup(const storage::PropertyValue &value) {
+  switch (value.type()) {
+    case storage::PropertyValue::Type::Bool:
+      return 0;
+    case storage::PropertyValue::Type::Int:
+    case storage::PropertyValue::Type::Double:
+      return 1;
+    case storage::PropertyValue::Type::String:
+      return 2;
+    default:
+      return std::nullopt;
+  }
+}
+
+storage::PropertyStatistics MakePropertyStatistics(PropertySample sample) {
+  storage::PropertyStatistics statistics;
+  statistics.count = sample.count;
+  auto &values = sample.values;
+  if (values.empty()) return statistics;
+  std::sort(values.begin(), values.end());
+
+  // GEE estimate of the number of distinct values: the values that appear
+  // once in the sample are scaled by sqrt(count / sample size), which is exact
+  // when the sample holds all values.
+  uint64_t singletons = 0;
+  uint64_t repeated = 0;
+  for (size_t i = 0; i < values.size();) {
+    auto j = i + 1;
+    while (j < values.size() && values[j] == values[i]) ++j;
+    if (j - i == 1) {
+      ++singletons;
+    } else {
+      ++repeated;
+    }
+    i = j;
+  }
+  const auto scale = std::sqrt(static_cast<double>(sample.count) / static_cast<double>(values.size()));
+  statistics.distinct_values =
+      std::min(sample.count, static_cast<uint64_t>(std::llround(scale * static_cast<double>(singletons))) + repeated);
+
+  std::array<std::vector<storage::PropertyValue>, 3> groups;
+  for (auto &value : values) {
+    if (auto group = HistogramGroup(value)) groups[*group].push_back(std::move(value));
+  }
+  auto &histogram_values = *std::max_element(groups.begin(), groups.end(),
+                                             [](const auto &a, const auto &b) { return a.size() < b.size(); });
+  if (histogram_values.empty()) return statistics;
+  statistics.histogram_count = static_cast<uint64_t>(std::llround(
+      static_cast<double>(sample.count) * static_cast<double>(histogram_values.size()) / static_cast<double>(values.size())));
+  const auto buckets = std::min(kStatisticsHistogramBuckets, histogram_values.size());
+  statistics.bounds.reserve(buckets);
+  for (size_t bucket = 1; bucket <= buckets; ++bucket) {
+    statistics.bounds.push_back(histogram_values[bucket * histogram_values.size() / buckets - 1]);
+  }
+  return statistics;
+}
+
+struct LabelCollector {
+  storage::LabelStatistics statistics;
+  double history_span{0};
+  std::map<storage::PropertyId, PropertySample> properties;
+};
+
+struct EdgeTypeCollector {
+  storage::EdgeTypeStatistics statistics;
+};
+
+std::vector<std::vector<TypedValue>> AnalyzeGraph(AnalyzeGraphQuery *analyze_graph_query, DbAccessor *dba) {
+  auto &store = dba->Statistics();
+  const auto view = storage::View::OLD;
+
+  // The labels to analyze, all of them if std::nullopt.
+  std::optional<std::set<storage::LabelId>> labels;
+  bool analyze_edge_types = true;
+  if (!analyze_graph_query->labels_.empty()) {
+    labels.emplace();
+    for (const auto &label : analyze_graph_query->labels_) labels->insert(dba->NameToLabel(label));
+  } else if (!analyze_graph_query->all_labels_) {
+    // Refresh only the missing and stale statistics.
+    std::map<storage::LabelId, uint64_t> counts;
+    for (auto vertex : dba->Vertices(view)) {
+      auto maybe_labels = vertex.Labels(view);
+      if (maybe_labels.HasError()) continue;
+      for (const auto &label : *maybe_labels) ++counts[label];
+    }
+    labels.emplace();
+    for (const auto &[label, count] : counts) {
+      auto statistics = store.GetLabelStatistics(dba->LabelToName(label));
+      if (!statistics || IsStale(statistics->vertex_count, count)) labels->insert(label);
+    }
+    const auto analyzed_edge_count = store.AnalyzedEdgeCount();
+    analyze_edge_types = analyzed_edge_count == 0 || IsStale(analyzed_edge_count, dba->EdgesCount());
+  }
+
+  std::map<storage::LabelId, LabelCollector> label_collectors;
+  if (labels) {
+    for (const auto &label : *labels) label_collectors.emplace(label, LabelCollector{});
+  }
+  std::map<storage::EdgeTypeId, EdgeTypeCollector> edge_type_collectors;
+  auto &history = dba->GetHistoryDelta();
+  std::mt19937_64 random_generator{0};
+  const auto sample_size = FLAGS_query_statistics_sample_size;
+
+  std::map<storage::EdgeTypeId, uint64_t> degrees;
+  auto collect_edge_type_degrees = [&](auto &&edges, bool out) {
+    degrees.clear();
+    for (const auto &edge : edges) ++degrees[edge.EdgeType()];
+    for (const auto &[edge_type, degree] : degrees) {
+      auto &statistics = edge_type_collectors[edge_type].statistics;
+      if (out) {
+        statistics.edge_count += degree;
+        ++statistics.source_count;
+        statistics.out_degree.Add(degree);
+      } else {
+        ++statistics.destination_count;
+        statistics.in_degree.Add(degree);
+      }
+    }
+  };
+
+  for (auto vertex : dba->Vertices(view)) {
+    if (analyze_edge_types) {
+      auto maybe_out_edges = vertex.OutEdges(view);
+      auto maybe_in_edges = vertex.InEdges(view);
+      if (maybe_out_edges.HasError() || maybe_in_edges.HasError()) continue;
+      collect_edge_type_degrees(*maybe_out_edges, true);
+      collect_edge_type_degrees(*maybe_in_edges, false);
+    }
+
+    auto maybe_labels = vertex.Labels(view);
+    if (maybe_labels.HasError() || maybe_labels->empty()) continue;
+    std::vector<LabelCollector *> collectors;
+    for (const auto &label : *maybe_labels) {
+      if (labels && !labels->contains(label)) continue;
+      collectors.push_back(&label_collectors[label]);
+    }
+    if (collectors.empty()) continue;
+
+    auto maybe_out_degree = vertex.OutDegree(view);
+    auto maybe_in_degree = vertex.InDegree(view);
+    auto maybe_properties = vertex.Properties(view);
+    if (maybe_out_degree.HasError() || maybe_in_degree.HasError() || maybe_properties.HasError()) continue;
+    std::optional<std::pair<uint64_t, uint64_t>> history_span;
+    if (history) history_span = history->VertexHistorySpan(vertex.Gid().AsUint());
+
+    for (auto *collector : collectors) {
+      auto &statistics = collector->statistics;
+      ++statistics.vertex_count;
+      statistics.out_degree.Add(*maybe_out_degree);
+      statistics.in_degree.Add(*maybe_in_degree);
+      if (history_span) {
+        ++statistics.vertices_with_history;
+        collector->history_span += static_cast<double>(history_span->second - history_span->first);
+      }
+      for (const auto &[property, value] : *maybe_properties) {
+        auto &sample = collector->properties[property];
+        ++sample.count;
+        if (sample.values.size() < sample_size) {
+          sample.values.push_back(value);
+        } else if (auto index = random_generator() % sample.count; index < sample_size) {
+          sample.values[index] = value;
+        }
+      }
+    }
+  }
+
+  std::vector<std::vector<TypedValue>> results;
+  for (auto &[label, collector] : label_collectors) {
+    auto &statistics = collector.statistics;
+    const auto &label_name = dba->LabelToName(label);
+    if (statistics.vertex_count == 0) {
+      store.ClearLabelStatistics(label_name);
+      continue;
+    }
+    statistics.out_degree.Finish(statistics.vertex_count);
+    statistics.in_degree.Finish(statistics.vertex_count);
+    if (statistics.vertices_with_history != 0) {
+      statistics.average_history_span = collector.history_span / static_cast<double>(statistics.vertices_with_history);
+    }
+    results.push_back({TypedValue("label"), TypedValue(label_name), TypedValue(),
+                       TypedValue(static_cast<int64_t>(statistics.vertex_count)), TypedValue(),
+                       TypedValue(statistics.out_degree.average), TypedValue(statistics.in_degree.average),
+                       TypedValue(static_cast<int64_t>(statistics.vertices_with_history))});
+    std::map<std::string, storage::PropertyStatistics> properties;
+    for (auto &[property, sample] : collector.properties) {
+      auto property_statistics = MakePropertyStatistics(std::move(sample));
+      results.push_back({TypedValue("label"), TypedValue(label_name), TypedValue(dba->PropertyToName(property)),
+                         TypedValue(static_cast<int64_t>(property_statistics.count)),
+                         TypedValue(static_cast<int64_t>(property_statistics.distinct_values)), TypedValue(),
+                         TypedValue(), TypedValue()});
+      properties.emplace(dba->PropertyToName(property), std::move(property_statistics));
+    }
+    store.SetLabelStatistics(label_name, statistics, properties);
+  }
+
+  if (analyze_edge_types) {
+    std::map<std::string, storage::EdgeTypeStatistics> edge_types;
+    for (auto &[edge_type, collector] : edge_type_collectors) {
+      auto &statistics = collector.statistics;
+      statistics.out_degree.Finish(statistics.source_count);
+      statistics.in_degree.Finish(statistics.destination_count);
+      const auto &edge_type_name = dba->EdgeTypeToName(edge_type);
+      results.push_back({TypedValue("edge_type"), TypedValue(edge_type_name), TypedValue(),
+                         TypedValue(static_cast<int64_t>(statistics.edge_count)), TypedValue(),
+                         TypedValue(statistics.out_degree.average), TypedValue(statistics.in_degree.average),
+                         TypedValue()});
+      edge_types.emplace(edge_type_name, statistics);
+    }
+    store.SetEdgeTypeStatistics(edge_types);
+  }
+  return results;
+}
+
+PreparedQuery PrepareAnalyzeGraphQuery(ParsedQuery parsed_query, const bool in_explicit_transaction,
+                                       InterpreterContext *interpreter_context, DbAccessor *dba) {
+  if (in_explicit_transaction) {
+    throw AnalyzeGraphInMulticommandTxException();
+  }
+
+  auto *analyze_graph_query = utils::Downcast<AnalyzeGraphQuery>(parsed_query.query);
+  MG_ASSERT(analyze_graph_query);
+
+  // The statistics influence computed plan costs.
+  auto invalidate_plan_cache = [plan_cache = &interpreter_context->plan_cache] {
+    auto access = plan_cache->access();
+    for (auto &kv : access) {
+      access.remove(kv.first);
+    }
+  };
+
+  std::vector<std::string> header;
+  std::function<std::vector<std::vector<TypedValue>>()> handler;
+  switch (analyze_graph_query->action_) {
+    case AnalyzeGraphQuery::Action::ANALYZE:
+      header = {"type", "name", "property", "count", "distinct_values", "avg_out_degree", "avg_in_degree",
+                "with_history"};
+      handler = [analyze_graph_query, dba] { return AnalyzeGraph(analyze_graph_query, dba); };
+      break;
+    case AnalyzeGraphQuery::Action::DELETE:
+      header = {"label"};
+      handler = [analyze_graph_query, dba] {
+        auto &store = dba->Statistics();
+        std::vector<std::vector<TypedValue>> results;
+        if (analyze_graph_query->labels_.empty()) {
+          for (const auto &label : store.AnalyzedLabels()) results.push_back({TypedValue(label)});
+          store.Clear();
+        } else {
+          for (const auto &label : analyze_graph_query->labels_) {
+            store.ClearLabelStatistics(label);
+            results.push_back({TypedValue(label)});
+          }
+        }
+        return results;
+      };
+      break;
+  }
+
+  return PreparedQuery{std::move(header), std::move(parsed_query.required_privileges),
+                       [handler = std::move(handler), invalidate_plan_cache = std::move(invalidate_plan_cache),
+                        pull_plan = std::shared_ptr<PullPlanVector>(nullptr)](
+                           AnyStream *stream, std::optional<int> n) mutable -> std::optional<QueryHandlerResult> {
+                         if (!pull_plan) {
+                           pull_plan = std::make_shared<PullPlanVector>(handler());
+                           invalidate_plan_cache();
+                         }
+
+                         if (pull_plan->Pull(stream, n)) {
+                           return QueryHandlerResult::COMMIT;
+                         }
+                         return std::nullopt;
+                       },
+                       RWType::R};
+}
+
 TriggerEventType ToTriggerEventType(const TriggerQuery::EventType event_type) {
   switch (event_type) {
     case TriggerQuery::EventType::ANY:
@@ -2154,7 +2481,7 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
     if (!in_explicit_transaction_ &&
         (utils::Downcast<CypherQuery>(parsed_query.query) || utils::Downcast<ExplainQuery>(parsed_query.query) ||
          utils::Downcast<ProfileQuery>(parsed_query.query) || utils::Downcast<DumpQuery>(parsed_query.query) ||
-         utils::Downcast<TriggerQuery>(parsed_query.query))) {
+         utils::Downcast<TriggerQuery>(parsed_query.query) || utils::Downcast<AnalyzeGraphQuery>(parsed_query.query))) {
       db_accessor_ =
           std::make_unique<storage::Storage::Accessor>(interpreter_context_->db->Access(GetIsolationLevelOverride()));
       execution_db_accessor_.emplace(db_accessor_.get());
@@ -2225,6 +2552,9 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
       prepared_query = PrepareVersionQuery(std::move(parsed_query), in_explicit_transaction_);
     } else if (utils::Downcast<SnapshotQuery>(parsed_query.query)) {
       prepared_query = PrepareSnapshotQuery(std::move(parsed_query), in_explicit_transaction_, interpreter_context_);
+    } else if (utils::Downcast<AnalyzeGraphQuery>(parsed_query.query)) {
+      prepared_query = PrepareAnalyzeGraphQuery(std::move(parsed_query), in_explicit_transaction_, interpreter_context_,
+                                                &*execution_db_accessor_);
     } else {
       LOG_FATAL("Should not get here -- unknown query type!");
     }
@@ -127,6 +127,8 @@ class ReplicationQueryHandler {
     std::string socket_address;
     ReplicationQuery::SyncMode sync_mode;
     std::optional<double> timeout;
+    uint64_t pending_transactions;
+    uint64_t lag_ms;
   };
 
   /// @throw QueryRuntimeException if an error ocurred.
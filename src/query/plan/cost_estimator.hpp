@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "query/frontend/ast/ast.hpp"
 #include "query/parameters.hpp"
 #include "query/plan/operator.hpp"
@@ -42,6 +45,12 @@ namespace query::plan {
  * for all plans for a single query part, and query part reordering is not
  * allowed.
  *
+ * When the graph was analyzed by `ANALYZE GRAPH`, the expansions are estimated
+ * by the average degree of the label of the expanded vertex and the number of
+ * edges of the expanded edge types, and the lookups by a property value by the
+ * number of distinct values of the property. This makes the plans starting from
+ * the side of the pattern with the lower degrees cheaper.
+ *
  * This kind of cost estimation can only be used for comparing logical plans.
  * It's aim is to estimate cost(A) to be less then cost(B) in every case where
  * actual query execution for plan A is less then that of plan B. It can NOT be
@@ -61,6 +70,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     static constexpr double kFilter{1.5};
     static constexpr double kEdgeUniquenessFilter{1.5};
     static constexpr double kUnwind{1.3};
+    static constexpr double kHashJoin{1.5};
   };
 
   struct CardParam {
@@ -68,6 +78,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     static constexpr double kExpandVariable{9.0};
     static constexpr double kFilter{0.25};
     static constexpr double kEdgeUniquenessFilter{0.95};
+    static constexpr double kHashJoin{0.25};
   };
 
   struct MiscParam {
@@ -88,6 +99,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   }
 
   bool PostVisit(ScanAllByLabel &scan_all_by_label) override {
+    symbol_labels_[scan_all_by_label.output_symbol_] = scan_all_by_label.label_;
     cardinality_ *= db_accessor_->VerticesCount(scan_all_by_label.label_);
     // ScanAll performs some work for every element that is produced
     IncrementCost(CostParam::kScanAllByLabel);
@@ -98,11 +110,15 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     // This cardinality estimation depends on the property value (expression).
     // If it's a constant, we can evaluate cardinality exactly, otherwise
     // we estimate
+    symbol_labels_[logical_op.output_symbol_] = logical_op.label_;
     auto property_value = ConstPropertyValue(logical_op.expression_);
     double factor = 1.0;
     if (property_value)
       // get the exact influence based on ScanAll(label, property, value)
       factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_, property_value.value());
+    else if (const auto &statistics = db_accessor_->GetPropertyStatistics(logical_op.label_, logical_op.property_))
+      // estimate the influence by the number of distinct values
+      factor = statistics->EstimateEqual();
     else
       // estimate the influence as ScanAll(label, property) * filtering
       factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_) * CardParam::kFilter;
@@ -117,6 +133,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   bool PostVisit(ScanAllByLabelPropertyRange &logical_op) override {
     // this cardinality estimation depends on Bound expressions.
     // if they are literals we can evaluate cardinality properly
+    symbol_labels_[logical_op.output_symbol_] = logical_op.label_;
     auto lower = BoundToPropertyValue(logical_op.lower_bound_);
     auto upper = BoundToPropertyValue(logical_op.upper_bound_);
 
@@ -140,6 +157,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   }
 
   bool PostVisit(ScanAllByLabelProperty &logical_op) override {
+    symbol_labels_[logical_op.output_symbol_] = logical_op.label_;
     const auto factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_);
     cardinality_ *= factor;
     IncrementCost(CostParam::MakeScanAllByLabelProperty);
@@ -148,6 +166,12 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
 
   // TODO: Cost estimate ScanAllById?
 
+  bool PostVisit(Expand &expand) override {
+    cardinality_ *= ExpandCardinality(expand);
+    IncrementCost(CostParam::kExpand);
+    return true;
+  }
+
 // For the given op first increments the cardinality and then cost.
 #define POST_VISIT_CARD_FIRST(NAME)     \
   bool PostVisit(NAME &) override {     \
@@ -156,7 +180,6 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     return true;                        \
   }
 
-  POST_VISIT_CARD_FIRST(Expand);
   POST_VISIT_CARD_FIRST(ExpandVariable);
 
 #undef POST_VISIT_CARD_FIRST
@@ -193,6 +216,21 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     return true;
   }
 
+  bool PreVisit(HashJoin &op) override {
+    // Both inputs are pulled once, the right one is built into a hash table
+    // and the left one probes it. The join keys are estimated like a Filter
+    // on the product of the inputs.
+    op.left_op_->Accept(*this);
+    const auto left_cardinality = cardinality_;
+    cardinality_ = 1;
+    op.right_op_->Accept(*this);
+    const auto right_cardinality = cardinality_;
+    cardinality_ = left_cardinality + right_cardinality;
+    IncrementCost(CostParam::kHashJoin);
+    cardinality_ = left_cardinality * right_cardinality * CardParam::kHashJoin;
+    return false;
+  }
+
   bool Visit(Once &) override { return true; }
 
   auto cost() const { return cost_; }
@@ -211,8 +249,55 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   TDbAccessor *db_accessor_;
   const Parameters &parameters;
 
+  // labels of the vertices produced by the scans, used to look up the degree
+  // statistics of the expanded vertices
+  std::unordered_map<Symbol, storage::LabelId> symbol_labels_;
+
   void IncrementCost(double param) { cost_ += param * cardinality_; }
 
+  // Estimates the number of edges expanded from a single vertex. Without the
+  // statistics of the label of the input vertex or of the edge types, it falls
+  // back to `CardParam::kExpand`.
+  double ExpandCardinality(const Expand &expand) {
+    const auto &common = expand.common_;
+    if (common.existing_node) return CardParam::kExpand;
+
+    // the share of the expanded edge types in all edges and the average
+    // degree of all vertices over those edge types
+    std::optional<double> edge_type_share;
+    std::optional<double> edge_type_degree;
+    if (!common.edge_types.empty()) {
+      double edge_count = 0;
+      bool analyzed = true;
+      for (const auto &edge_type : common.edge_types) {
+        const auto &statistics = db_accessor_->GetEdgeTypeStatistics(edge_type);
+        if (!statistics) {
+          analyzed = false;
+          break;
+        }
+        edge_count += statistics->edge_count;
+      }
+      if (analyzed) {
+        const auto all_edge_count = static_cast<double>(db_accessor_->EdgesCount());
+        const auto vertex_count = static_cast<double>(db_accessor_->VerticesCount());
+        edge_type_share = all_edge_count > 0 ? std::min(edge_count / all_edge_count, 1.0) : 0.0;
+        edge_type_degree = vertex_count > 0 ? edge_count / vertex_count : 0.0;
+      }
+    }
+
+    if (auto it = symbol_labels_.find(expand.input_symbol_); it != symbol_labels_.end()) {
+      if (const auto &statistics = db_accessor_->GetLabelStatistics(it->second)) {
+        double degree = 0;
+        if (common.direction != EdgeAtom::Direction::IN) degree += statistics->out_degree.average;
+        if (common.direction != EdgeAtom::Direction::OUT) degree += statistics->in_degree.average;
+        if (common.edge_types.empty()) return degree;
+        if (edge_type_share) return degree * *edge_type_share;
+      }
+    }
+    if (edge_type_degree) return *edge_type_degree * (common.direction == EdgeAtom::Direction::BOTH ? 2 : 1);
+    return CardParam::kExpand;
+  }
+
   // converts an optional ScanAll range bound into a property value
   // if the bound is present and is a constant expression convertible to
   // a property value. otherwise returns nullopt
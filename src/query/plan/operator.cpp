@@ -12,11 +12,18 @@
 #include "query/plan/operator.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdio>
+#include <exception>
 #include <limits>
+#include <mutex>
+#include <numeric>
 #include <queue>
 #include <random>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -34,24 +41,55 @@
 #include "query/frontend/semantic/symbol_table.hpp"
 #include "query/interpret/eval.hpp"
 #include "query/path.hpp"
+#include "query/plan/preprocess.hpp"
 #include "query/plan/scoped_profile.hpp"
 #include "query/procedure/cypher_types.hpp"
 #include "query/procedure/mg_procedure_impl.hpp"
 #include "query/procedure/module.hpp"
+#include "query/serialization/property_value.hpp"
 #include "storage/v2/property_value.hpp"
 #include "utils/algorithm.hpp"
 #include "utils/csv_parsing.hpp"
 #include "utils/event_counter.hpp"
 #include "utils/exceptions.hpp"
+#include "utils/flag_validation.hpp"
 #include "utils/fnv.hpp"
 #include "utils/likely.hpp"
 #include "utils/logging.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/on_scope_exit.hpp"
 #include "utils/pmr/unordered_map.hpp"
 #include "utils/pmr/unordered_set.hpp"
 #include "utils/pmr/vector.hpp"
 #include "utils/readable_size.hpp"
 #include "utils/string.hpp"
+#include "utils/sysinfo/memory.hpp"
 #include "utils/temporal.hpp"
+#include "utils/thread_pool.hpp"
+
+DEFINE_VALIDATED_HIDDEN_uint64(query_parallel_workers, 1U,
+                               "Number of threads which execute an aggregation over a read-only scan. "
+                               "1 executes it on the session thread only.",
+                               FLAG_IN_RANGE(1, 1024));
+DEFINE_VALIDATED_HIDDEN_uint64(query_parallel_morsel_size, 10000U,
+                               "Number of scanned vertices which a parallel worker takes at once.",
+                               FLAG_IN_RANGE(1, std::numeric_limits<uint64_t>::max()));
+DEFINE_VALIDATED_HIDDEN_uint64(query_order_by_spill_rows, 1000000U,
+                               "Number of rows which ORDER BY without LIMIT keeps in memory before it writes them "
+                               "sorted to a temporary file.",
+                               FLAG_IN_RANGE(1, std::numeric_limits<uint64_t>::max()));
+DEFINE_VALIDATED_HIDDEN_uint64(query_hash_table_spill_size, 0U,
+                               "Number of groups which an aggregation, or rows which DISTINCT, keeps in memory before "
+                               "writing them to temporary files. They are also written when the memory limit is close. "
+                               "0 derives the number from the memory available to the query.",
+                               FLAG_IN_RANGE(0, std::numeric_limits<uint64_t>::max()));
+DEFINE_VALIDATED_HIDDEN_uint64(query_filter_batch_size, 1024U,
+                               "Number of input rows which a Filter over a read-only scan evaluates at once. "
+                               "Set to 1 to evaluate filters row by row.",
+                               FLAG_IN_RANGE(1, 1U << 20U));
+DEFINE_HIDDEN_bool(query_factorize_expand, true,
+                   "Let an aggregation count the edges of the last expansion, and DISTINCT visit the vertices at "
+                   "their ends once per expanded vertex, instead of pulling a row for every edge.");
 
 // #include "communication/bolt/v1/value.hpp"
 // #include "storage/v2/storage.hpp"
@@ -114,6 +152,7 @@ extern const Event UnwindOperator;
 extern const Event DistinctOperator;
 extern const Event UnionOperator;
 extern const Event CartesianOperator;
+extern const Event HashJoinOperator;
 extern const Event CallProcedureOperator;
 }  // namespace EventCounter
 
@@ -483,6 +522,13 @@ class ScanAllCursor : public Cursor {
     SCOPED_PROFILE_OP(op_name_);
 
     if (MustAbort(context)) throw HintedAbortError();
+
+    if (context.morsel && context.morsel_symbol == output_symbol_) {
+      // A parallel worker only scans the vertices of the morsel it took.
+      if (morsel_pos_ == context.morsel->size()) return false;
+      frame[output_symbol_] = (*context.morsel)[morsel_pos_++];
+      return true;
+    }
   
     if(context.addition){
       if(count==0){
@@ -554,12 +600,14 @@ class ScanAllCursor : public Cursor {
     input_cursor_->Reset();
     vertices_ = std::nullopt;
     vertices_it_ = std::nullopt;
+    morsel_pos_ = 0;
   }
 
  private:
   const Symbol output_symbol_;
   const UniqueCursorPtr input_cursor_;
   TVerticesFun get_vertices_;
+  size_t morsel_pos_{0};
   std::optional<typename std::result_of<TVerticesFun(Frame &, ExecutionContext &)>::type::value_type> vertices_;
   std::optional<decltype(vertices_.value().begin())> vertices_it_;
   const char *op_name_;
@@ -1054,6 +1102,10 @@ void addHistoryDeleteEdges(uint64_t vertex_gid,std::vector<storage::EdgeTypeId>
       auto edge_ie_flag=direction == EdgeAtom::Direction::IN?ie_type=="AIE":ie_type=="AOE";//判断是否是需要的入边或者出边
       if(!edge_ie_flag)continue;
       if(!check_edges(edge_types,edge_type)) continue;//判断边的类型是否是需要的
+      //the edge lifetime index can rule the edge out without touching its versions
+      std::string tmp(edge_id);
+      auto gid=(uint64_t)std::stoull(tmp);
+      if(!context.db_accessor->GetHistoryDelta()->EdgeHistoryIntersects(gid,historyContext_.c_ts,historyContext_.c_te)) continue;
 
       //加入数据库中的顶点
       auto expand_vid = direction==EdgeAtom::Direction::IN?from_gid:to_gid;//需要expand的节点，判断历史数据
@@ -1062,8 +1114,6 @@ void addHistoryDeleteEdges(uint64_t vertex_gid,std::vector<storage::EdgeTypeId>
       // VertexAccessor expand_vertex;
       if(!expand_vertex)return;
       //还原边 只需要还原kv中被删除的边即可
-      std::string tmp(edge_id);
-      auto gid=(uint64_t)std::stoi(tmp);
       auto current_edge1=storage::HistoryEdge(context.db_accessor->IdToGid(gid),from_gid,to_gid,edge_type,nullptr);//hjm edit new 
       bool history_flag=false;
       auto before_flag=context.db_accessor->FindHistoryEdgeFlag(gid,historyContext_.c_ts,historyContext_.c_te);
@@ -1390,6 +1440,89 @@ auto ExpandFromHistoryVertex( storage::HistoryVertex &vertex, EdgeAtom::Directio
   return iter::chain.from_iterable(std::move(chain_elements));
 }
 
+/// Returns the constraint of the history query (`TT AS OF`, `TT FROM ... TO`)
+/// that is being executed.
+history_delta::historyContext MakeHistoryContext(const ExecutionContext &context) {
+  history_delta::historyContext history_context;
+  history_context.c_ts = (uint64_t)(*context.addition);
+  history_context.c_te = (uint64_t)(*context.addition_right);
+  history_context.types = history_context.c_ts == history_context.c_te ? "as of" : "from to";
+  return history_context;
+}
+
+/// Gid of a vertex or an edge that comes either from the current graph or
+/// from the history store.
+storage::Gid HistoryValueGid(const TypedValue &value) {
+  switch (value.type()) {
+    case TypedValue::Type::Vertex:
+      return value.ValueVertex().Gid();
+    case TypedValue::Type::HistoryVertex:
+      return value.ValueHistoryVertex().gid;
+    case TypedValue::Type::Edge:
+      return value.ValueEdge().Gid();
+    case TypedValue::Type::HistoryEdge:
+      return value.ValueHistoryEdge().gid;
+    default:
+      throw QueryRuntimeException("Expected a vertex or an edge, got {}.", value.type());
+  }
+}
+
+/// Returns the gid of the endpoint of `edge` (current or history edge) that
+/// isn't `vertex_gid`.
+storage::Gid HistoryEdgeOtherEnd(const TypedValue &edge, storage::Gid vertex_gid) {
+  storage::Gid from_gid;
+  storage::Gid to_gid;
+  if (edge.IsEdge()) {
+    from_gid = edge.ValueEdge().From().Gid();
+    to_gid = edge.ValueEdge().To().Gid();
+  } else {
+    from_gid = edge.ValueHistoryEdge().from_gid;
+    to_gid = edge.ValueHistoryEdge().to_gid;
+  }
+  return from_gid == vertex_gid ? to_gid : from_gid;
+}
+
+EdgeAtom::Direction ReverseDirection(EdgeAtom::Direction direction) {
+  switch (direction) {
+    case EdgeAtom::Direction::IN:
+      return EdgeAtom::Direction::OUT;
+    case EdgeAtom::Direction::OUT:
+      return EdgeAtom::Direction::IN;
+    case EdgeAtom::Direction::BOTH:
+      return EdgeAtom::Direction::BOTH;
+  }
+}
+
+/// Historical adjacency of `vertex` (a current or a history vertex). Appends
+/// every (edge, neighbour) pair that existed at the time given by
+/// `history_context` to `expansions`. Uses the same lookup as `Expand` and
+/// `ExpandVariable`: the edges are checked against their lifetimes and each
+/// neighbour is resolved to its version valid at that time, the looked up
+/// edges are cached in the accessor for the rest of the query.
+void ExpandFromVertexHistory(const TypedValue &vertex, EdgeAtom::Direction direction,
+                             const std::vector<storage::EdgeTypeId> &edge_types,
+                             history_delta::historyContext &history_context, ExecutionContext &context,
+                             utils::MemoryResource *memory, std::list<std::pair<TypedValue, TypedValue>> *expansions) {
+  uint64_t vertex_ts = 0;
+  uint64_t vertex_te = 0;
+  auto add_edges = [&](auto &&edges) {
+    for (const auto &[edge, edge_direction] : edges) {
+      addHistoryEdge(edge, vertex_ts, vertex_te, history_context, context, edge_direction, *expansions);
+    }
+  };
+  if (vertex.IsVertex()) {
+    auto current_vertex = vertex.ValueVertex();
+    vertex_ts = current_vertex.transaction_st();
+    vertex_te = current_vertex.tt_te();
+    add_edges(ExpandFromVertex(current_vertex, direction, edge_types, memory));
+  } else {
+    auto history_vertex = vertex.ValueHistoryVertex();
+    vertex_ts = history_vertex.tt_ts;
+    vertex_te = history_vertex.tt_te;
+    add_edges(ExpandFromHistoryVertex(history_vertex, direction, edge_types, memory, context));
+  }
+}
+
 }  // namespace
 
 class ExpandVariableCursor : public Cursor {
@@ -1931,9 +2064,6 @@ class STShortestPathCursor : public query::plan::Cursor {
       // matching.
       if (source_tv.IsNull() || sink_tv.IsNull()) continue;
 
-      const auto &source = source_tv.ValueVertex();
-      const auto &sink = sink_tv.ValueVertex();
-
       int64_t lower_bound =
           self_.lower_bound_ ? EvaluateInt(&evaluator, self_.lower_bound_, "Min depth in breadth-first expansion") : 1;
       int64_t upper_bound = self_.upper_bound_
@@ -1942,6 +2072,14 @@ class STShortestPathCursor : public query::plan::Cursor {
 
       if (upper_bound < 1 || lower_bound > upper_bound) continue;
 
+      if (context.addition) {
+        if (FindHistoryPath(source_tv, sink_tv, lower_bound, upper_bound, &frame, &evaluator, context)) return true;
+        continue;
+      }
+
+      const auto &source = source_tv.ValueVertex();
+      const auto &sink = sink_tv.ValueVertex();
+
       if (FindPath(*context.db_accessor, source, sink, lower_bound, upper_bound, &frame, &evaluator, context)) {
         return true;
       }
@@ -1958,6 +2096,9 @@ class STShortestPathCursor : public query::plan::Cursor {
   UniqueCursorPtr input_cursor_;
 
   using VertexEdgeMapT = utils::pmr::unordered_map<VertexAccessor, std::optional<EdgeAccessor>>;
+  // Used for the history expansion, the vertices are identified by their gid
+  // because a vertex can be both a current and a history vertex.
+  using GidEdgeMapT = utils::pmr::unordered_map<storage::Gid, std::optional<TypedValue>>;
 
   void ReconstructPath(const VertexAccessor &midpoint, const VertexEdgeMapT &in_edge, const VertexEdgeMapT &out_edge,
                        Frame *frame, utils::MemoryResource *pull_memory) {
@@ -1980,8 +2121,29 @@ class STShortestPathCursor : public query::plan::Cursor {
     frame->at(self_.common_.edge_symbol) = std::move(result);
   }
 
-  bool ShouldExpand(const VertexAccessor &vertex, const EdgeAccessor &edge, Frame *frame,
-                    ExpressionEvaluator *evaluator) {
+  void ReconstructHistoryPath(storage::Gid midpoint, const GidEdgeMapT &in_edge, const GidEdgeMapT &out_edge,
+                              Frame *frame, utils::MemoryResource *pull_memory) {
+    utils::pmr::vector<TypedValue> result(pull_memory);
+    auto last_vertex = midpoint;
+    while (true) {
+      const auto &last_edge = in_edge.at(last_vertex);
+      if (!last_edge) break;
+      last_vertex = HistoryEdgeOtherEnd(*last_edge, last_vertex);
+      result.emplace_back(*last_edge);
+    }
+    std::reverse(result.begin(), result.end());
+    last_vertex = midpoint;
+    while (true) {
+      const auto &last_edge = out_edge.at(last_vertex);
+      if (!last_edge) break;
+      last_vertex = HistoryEdgeOtherEnd(*last_edge, last_vertex);
+      result.emplace_back(*last_edge);
+    }
+    frame->at(self_.common_.edge_symbol) = std::move(result);
+  }
+
+  template <class TVertex, class TEdge>
+  bool ShouldExpand(const TVertex &vertex, const TEdge &edge, Frame *frame, ExpressionEvaluator *evaluator) {
     if (!self_.filter_lambda_.expression) return true;
 
     frame->at(self_.filter_lambda_.inner_node_symbol) = vertex;
@@ -2124,6 +2286,94 @@ class STShortestPathCursor : public query::plan::Cursor {
       std::swap(sink_frontier, sink_next);
     }
   }
+
+  // Same as `FindPath`, but the graph is expanded as it existed at the time
+  // requested by the history query. Source and sink can be current or history
+  // vertices.
+  bool FindHistoryPath(const TypedValue &source, const TypedValue &sink, int64_t lower_bound, int64_t upper_bound,
+                       Frame *frame, ExpressionEvaluator *evaluator, ExecutionContext &context) {
+    using utils::Contains;
+
+    const auto source_gid = HistoryValueGid(source);
+    const auto sink_gid = HistoryValueGid(sink);
+    if (source_gid == sink_gid) return false;
+
+    auto history_context = MakeHistoryContext(context);
+    auto *pull_memory = evaluator->GetMemoryResource();
+    utils::pmr::vector<TypedValue> source_frontier(pull_memory);
+    utils::pmr::vector<TypedValue> sink_frontier(pull_memory);
+    utils::pmr::vector<TypedValue> source_next(pull_memory);
+    utils::pmr::vector<TypedValue> sink_next(pull_memory);
+    GidEdgeMapT in_edge(pull_memory);
+    GidEdgeMapT out_edge(pull_memory);
+    std::list<std::pair<TypedValue, TypedValue>> expansions;
+
+    // Expands all vertices of `frontier` into `next`, the reached vertices are
+    // recorded in `visited`. Returns the vertex at which the expansion met the
+    // expansion from the other side (`other_visited`).
+    auto expand_level = [&](const utils::pmr::vector<TypedValue> &frontier, utils::pmr::vector<TypedValue> *next,
+                            GidEdgeMapT *visited, const GidEdgeMapT &other_visited, EdgeAtom::Direction direction,
+                            bool from_sink) -> std::optional<storage::Gid> {
+      for (const auto &vertex : frontier) {
+        expansions.clear();
+        ExpandFromVertexHistory(vertex, direction, self_.common_.edge_types, history_context, context, pull_memory,
+                                &expansions);
+        for (const auto &[edge, next_vertex] : expansions) {
+          const auto next_gid = HistoryValueGid(next_vertex);
+          // When expanding from the sink everything is reversed, so the filter
+          // gets the vertex we expand from.
+          if (!ShouldExpand(from_sink ? vertex : next_vertex, edge, frame, evaluator) ||
+              Contains(*visited, next_gid)) {
+            continue;
+          }
+          visited->emplace(next_gid, edge);
+          if (Contains(other_visited, next_gid)) return next_gid;
+          next->push_back(next_vertex);
+        }
+      }
+      return std::nullopt;
+    };
+
+    size_t current_length = 0;
+
+    source_frontier.emplace_back(source);
+    in_edge.emplace(source_gid, std::nullopt);
+    sink_frontier.emplace_back(sink);
+    out_edge.emplace(sink_gid, std::nullopt);
+
+    while (true) {
+      if (MustAbort(context)) throw HintedAbortError();
+      // Top-down step (expansion from the source).
+      ++current_length;
+      if (current_length > upper_bound) return false;
+
+      if (auto midpoint =
+              expand_level(source_frontier, &source_next, &in_edge, out_edge, self_.common_.direction, false)) {
+        if (current_length < lower_bound) return false;
+        ReconstructHistoryPath(*midpoint, in_edge, out_edge, frame, pull_memory);
+        return true;
+      }
+
+      if (source_next.empty()) return false;
+      source_frontier.clear();
+      std::swap(source_frontier, source_next);
+
+      // Bottom-up step (expansion from the sink).
+      ++current_length;
+      if (current_length > upper_bound) return false;
+
+      if (auto midpoint = expand_level(sink_frontier, &sink_next, &out_edge, in_edge,
+                                       ReverseDirection(self_.common_.direction), true)) {
+        if (current_length < lower_bound) return false;
+        ReconstructHistoryPath(*midpoint, in_edge, out_edge, frame, pull_memory);
+        return true;
+      }
+
+      if (sink_next.empty()) return false;
+      sink_frontier.clear();
+      std::swap(sink_frontier, sink_next);
+    }
+  }
 };
 
 class SingleSourceShortestPathCursor : public query::plan::Cursor {
@@ -2133,7 +2383,10 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
         input_cursor_(self_.input()->MakeCursor(mem)),
         processed_(mem),
         to_visit_current_(mem),
-        to_visit_next_(mem) {
+        to_visit_next_(mem),
+        history_processed_(mem),
+        history_to_visit_current_(mem),
+        history_to_visit_next_(mem) {
     MG_ASSERT(!self_.common_.existing_node,
               "Single source shortest path algorithm "
               "should not be used when `existing_node` "
@@ -2145,6 +2398,8 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
     SCOPED_PROFILE_OP("SingleSourceShortestPath");
     std::cout<<"SingleSourceShortestPath\n";
 
+    if (context.addition) return PullHistory(frame, context);
+
     ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                   storage::View::OLD);
 
@@ -2263,6 +2518,9 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
     processed_.clear();
     to_visit_next_.clear();
     to_visit_current_.clear();
+    history_processed_.clear();
+    history_to_visit_next_.clear();
+    history_to_visit_current_.clear();
   }
 
  private:
@@ -2281,6 +2539,104 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
   // edge/vertex pairs we have yet to visit, for current and next depth
   utils::pmr::vector<std::pair<EdgeAccessor, VertexAccessor>> to_visit_current_;
   utils::pmr::vector<std::pair<EdgeAccessor, VertexAccessor>> to_visit_next_;
+
+  // The same structures for the history expansion. The vertices are identified
+  // by their gid because a vertex can be both a current and a history vertex.
+  history_delta::historyContext history_context_;
+  utils::pmr::unordered_map<storage::Gid, std::optional<TypedValue>> history_processed_;
+  utils::pmr::vector<std::pair<TypedValue, TypedValue>> history_to_visit_current_;
+  utils::pmr::vector<std::pair<TypedValue, TypedValue>> history_to_visit_next_;
+
+  // Same as `Pull`, but the graph is expanded as it existed at the time
+  // requested by the history query.
+  bool PullHistory(Frame &frame, ExecutionContext &context) {
+    ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                  storage::View::OLD);
+    auto *memory = history_processed_.get_allocator().GetMemoryResource();
+    std::list<std::pair<TypedValue, TypedValue>> expansions;
+
+    // for the given (edge, vertex) pair checks if they satisfy the
+    // "where" condition. if so, places them in the to_visit_ structure.
+    auto expand_pair = [this, &evaluator, &frame](const TypedValue &edge, const TypedValue &vertex) {
+      const auto vertex_gid = HistoryValueGid(vertex);
+      // if we already processed the given vertex it doesn't get expanded
+      if (history_processed_.find(vertex_gid) != history_processed_.end()) return;
+
+      frame[self_.filter_lambda_.inner_edge_symbol] = edge;
+      frame[self_.filter_lambda_.inner_node_symbol] = vertex;
+      if (self_.filter_lambda_.expression && !EvaluateFilter(evaluator, self_.filter_lambda_.expression)) return;
+
+      history_to_visit_next_.emplace_back(edge, vertex);
+      history_processed_.emplace(vertex_gid, edge);
+    };
+
+    auto expand_from_vertex = [this, &context, &expand_pair, &expansions, memory](const TypedValue &vertex) {
+      expansions.clear();
+      ExpandFromVertexHistory(vertex, self_.common_.direction, self_.common_.edge_types, history_context_, context,
+                              memory, &expansions);
+      for (const auto &[edge, next_vertex] : expansions) expand_pair(edge, next_vertex);
+    };
+
+    while (true) {
+      if (MustAbort(context)) throw HintedAbortError();
+      if (history_to_visit_current_.empty()) history_to_visit_current_.swap(history_to_visit_next_);
+
+      if (history_to_visit_current_.empty()) {
+        if (!input_cursor_->Pull(frame, context)) return false;
+
+        history_to_visit_current_.clear();
+        history_to_visit_next_.clear();
+        history_processed_.clear();
+
+        const auto &vertex_value = frame[self_.input_symbol_];
+        // it is possible that the vertex is Null due to optional matching
+        if (vertex_value.IsNull()) continue;
+        lower_bound_ = self_.lower_bound_
+                           ? EvaluateInt(&evaluator, self_.lower_bound_, "Min depth in breadth-first expansion")
+                           : 1;
+        upper_bound_ = self_.upper_bound_
+                           ? EvaluateInt(&evaluator, self_.upper_bound_, "Max depth in breadth-first expansion")
+                           : std::numeric_limits<int64_t>::max();
+
+        if (upper_bound_ < 1 || lower_bound_ > upper_bound_) continue;
+
+        history_context_ = MakeHistoryContext(context);
+        history_processed_.emplace(HistoryValueGid(vertex_value), std::nullopt);
+        expand_from_vertex(vertex_value);
+        continue;
+      }
+
+      auto expansion = history_to_visit_current_.back();
+      history_to_visit_current_.pop_back();
+
+      // create the frame value for the edges
+      auto *pull_memory = context.evaluation_context.memory;
+      utils::pmr::vector<TypedValue> edge_list(pull_memory);
+      edge_list.emplace_back(expansion.first);
+      auto last_vertex = HistoryValueGid(expansion.second);
+      while (true) {
+        last_vertex = HistoryEdgeOtherEnd(edge_list.back(), last_vertex);
+        // origin_vertex must be in processed
+        const auto &previous_edge = history_processed_.find(last_vertex)->second;
+        if (!previous_edge) break;
+
+        edge_list.emplace_back(previous_edge.value());
+      }
+
+      // expand only if what we've just expanded is less then max depth
+      if (static_cast<int64_t>(edge_list.size()) < upper_bound_) expand_from_vertex(expansion.second);
+
+      if (static_cast<int64_t>(edge_list.size()) < lower_bound_) continue;
+
+      frame[self_.common_.node_symbol] = expansion.second;
+
+      // place edges on the frame in the correct order
+      std::reverse(edge_list.begin(), edge_list.end());
+      frame[self_.common_.edge_symbol] = std::move(edge_list);
+
+      return true;
+    }
+  }
 };
 
 class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
@@ -2291,12 +2647,18 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
         total_cost_(mem),
         previous_(mem),
         yielded_vertices_(mem),
-        pq_(mem) {}
+        pq_(mem),
+        history_total_cost_(mem),
+        history_previous_(mem),
+        history_yielded_vertices_(mem),
+        history_pq_(mem) {}
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
     SCOPED_PROFILE_OP("ExpandWeightedShortestPath");
     std::cout<<"ExpandWeightedShortestPath\n";
 
+    if (context.addition) return PullHistory(frame, context);
+
     ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                   storage::View::OLD);
     auto create_state = [this](const VertexAccessor &vertex, int64_t depth) {
@@ -2308,52 +2670,16 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
     // queue.
     auto expand_pair = [this, &evaluator, &frame, &create_state](const EdgeAccessor &edge, const VertexAccessor &vertex,
                                                                  const TypedValue &total_weight, int64_t depth) {
-      auto *memory = evaluator.GetMemoryResource();
-      if (self_.filter_lambda_.expression) {
-        frame[self_.filter_lambda_.inner_edge_symbol] = edge;
-        frame[self_.filter_lambda_.inner_node_symbol] = vertex;
-
-        if (!EvaluateFilter(evaluator, self_.filter_lambda_.expression)) return;
-      }
-
-      frame[self_.weight_lambda_->inner_edge_symbol] = edge;
-      frame[self_.weight_lambda_->inner_node_symbol] = vertex;
-
-      TypedValue current_weight = self_.weight_lambda_->expression->Accept(evaluator);
-
-      if (!current_weight.IsNumeric() && !current_weight.IsDuration()) {
-        throw QueryRuntimeException("Calculated weight must be numeric or a Duration, got {}.", current_weight.type());
-      }
-
-      const auto is_valid_numeric = [&] {
-        return current_weight.IsNumeric() && (current_weight >= TypedValue(0, memory)).ValueBool();
-      };
-
-      const auto is_valid_duration = [&] {
-        return current_weight.IsDuration() && (current_weight >= TypedValue(utils::Duration(0), memory)).ValueBool();
-      };
-
-      if (!is_valid_numeric() && !is_valid_duration()) {
-        throw QueryRuntimeException("Calculated weight must be non-negative!");
-      }
+      auto next_weight = ExpansionWeight(edge, vertex, total_weight, frame, evaluator);
+      if (!next_weight) return;
 
       auto next_state = create_state(vertex, depth);
 
-      TypedValue next_weight = std::invoke([&] {
-        if (total_weight.IsNull()) {
-          return current_weight;
-        }
-
-        ValidateWeightTypes(current_weight, total_weight);
-
-        return TypedValue(current_weight, memory) + total_weight;
-      });
-
       auto found_it = total_cost_.find(next_state);
-      if (found_it != total_cost_.end() && (found_it->second.IsNull() || (found_it->second <= next_weight).ValueBool()))
+      if (found_it != total_cost_.end() && (found_it->second.IsNull() || (found_it->second <= *next_weight).ValueBool()))
         return;
 
-      pq_.push({next_weight, depth + 1, vertex, edge});
+      pq_.push({*next_weight, depth + 1, vertex, edge});
     };
 
     // Populates the priority queue structure with expansions
@@ -2480,6 +2806,10 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
     total_cost_.clear();
     yielded_vertices_.clear();
     ClearQueue();
+    history_previous_.clear();
+    history_total_cost_.clear();
+    history_yielded_vertices_.clear();
+    ClearHistoryQueue();
   }
 
  private:
@@ -2514,11 +2844,56 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
     }
   }
 
+  // Checks the filter for the expansion over `edge` to `vertex` and returns the
+  // weight of the path extended by `edge`, or std::nullopt if the expansion
+  // doesn't pass the filter.
+  template <class TEdge, class TVertex>
+  std::optional<TypedValue> ExpansionWeight(const TEdge &edge, const TVertex &vertex, const TypedValue &total_weight,
+                                            Frame &frame, ExpressionEvaluator &evaluator) {
+    auto *memory = evaluator.GetMemoryResource();
+    if (self_.filter_lambda_.expression) {
+      frame[self_.filter_lambda_.inner_edge_symbol] = edge;
+      frame[self_.filter_lambda_.inner_node_symbol] = vertex;
+
+      if (!EvaluateFilter(evaluator, self_.filter_lambda_.expression)) return std::nullopt;
+    }
+
+    frame[self_.weight_lambda_->inner_edge_symbol] = edge;
+    frame[self_.weight_lambda_->inner_node_symbol] = vertex;
+
+    TypedValue current_weight = self_.weight_lambda_->expression->Accept(evaluator);
+
+    if (!current_weight.IsNumeric() && !current_weight.IsDuration()) {
+      throw QueryRuntimeException("Calculated weight must be numeric or a Duration, got {}.", current_weight.type());
+    }
+
+    const auto is_valid_numeric = [&] {
+      return current_weight.IsNumeric() && (current_weight >= TypedValue(0, memory)).ValueBool();
+    };
+
+    const auto is_valid_duration = [&] {
+      return current_weight.IsDuration() && (current_weight >= TypedValue(utils::Duration(0), memory)).ValueBool();
+    };
+
+    if (!is_valid_numeric() && !is_valid_duration()) {
+      throw QueryRuntimeException("Calculated weight must be non-negative!");
+    }
+
+    if (total_weight.IsNull()) {
+      return current_weight;
+    }
+
+    ValidateWeightTypes(current_weight, total_weight);
+
+    return TypedValue(current_weight, memory) + total_weight;
+  }
+
   // Priority queue comparator. Keep lowest weight on top of the queue.
   class PriorityQueueComparator {
    public:
-    bool operator()(const std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>> &lhs,
-                    const std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>> &rhs) {
+    template <class TVertex, class TEdge>
+    bool operator()(const std::tuple<TypedValue, int64_t, TVertex, std::optional<TEdge>> &lhs,
+                    const std::tuple<TypedValue, int64_t, TVertex, std::optional<TEdge>> &rhs) {
       const auto &lhs_weight = std::get<0>(lhs);
       const auto &rhs_weight = std::get<0>(rhs);
       // Null defines minimum value for all types
@@ -2543,60 +2918,209 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
   void ClearQueue() {
     while (!pq_.empty()) pq_.pop();
   }
-};
-
-UniqueCursorPtr ExpandVariable::MakeCursor(utils::MemoryResource *mem) const {
-  EventCounter::IncrementCounter(EventCounter::ExpandVariableOperator);
-
-  switch (type_) {
-    case EdgeAtom::Type::BREADTH_FIRST:
-      if (common_.existing_node) {
-        return MakeUniqueCursorPtr<STShortestPathCursor>(mem, *this, mem);
-      } else {
-        return MakeUniqueCursorPtr<SingleSourceShortestPathCursor>(mem, *this, mem);
-      }
-    case EdgeAtom::Type::DEPTH_FIRST:
-      return MakeUniqueCursorPtr<ExpandVariableCursor>(mem, *this, mem);
-    case EdgeAtom::Type::WEIGHTED_SHORTEST_PATH:
-      return MakeUniqueCursorPtr<ExpandWeightedShortestPathCursor>(mem, *this, mem);
-    case EdgeAtom::Type::SINGLE:
-      LOG_FATAL("ExpandVariable should not be planned for a single expansion!");
-  }
-}
 
-class ConstructNamedPathCursor : public Cursor {
- public:
-  ConstructNamedPathCursor(const ConstructNamedPath &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input()->MakeCursor(mem)) {}
+  // The same structures for the history expansion. The vertices are identified
+  // by their gid because a vertex can be both a current and a history vertex.
+  struct HistoryWspStateHash {
+    size_t operator()(const std::pair<storage::Gid, int64_t> &key) const {
+      return utils::HashCombine<storage::Gid, int64_t>{}(key.first, key.second);
+    }
+  };
 
-  bool Pull(Frame &frame, ExecutionContext &context) override {
-    SCOPED_PROFILE_OP("ConstructNamedPath");
-    std::cout<<"ConstructNamedPath\n";
+  history_delta::historyContext history_context_;
+  utils::pmr::unordered_map<std::pair<storage::Gid, int64_t>, TypedValue, HistoryWspStateHash> history_total_cost_;
+  utils::pmr::unordered_map<std::pair<storage::Gid, int64_t>, std::optional<TypedValue>, HistoryWspStateHash>
+      history_previous_;
+  utils::pmr::unordered_set<storage::Gid> history_yielded_vertices_;
+  std::priority_queue<std::tuple<TypedValue, int64_t, TypedValue, std::optional<TypedValue>>,
+                      utils::pmr::vector<std::tuple<TypedValue, int64_t, TypedValue, std::optional<TypedValue>>>,
+                      PriorityQueueComparator>
+      history_pq_;
 
-    if (!input_cursor_->Pull(frame, context)) return false;
+  void ClearHistoryQueue() {
+    while (!history_pq_.empty()) history_pq_.pop();
+  }
 
-    auto symbol_it = self_.path_elements_.begin();
-    DMG_ASSERT(symbol_it != self_.path_elements_.end(), "Named path must contain at least one node");
+  // Same as `Pull`, but the graph is expanded as it existed at the time
+  // requested by the history query.
+  bool PullHistory(Frame &frame, ExecutionContext &context) {
+    ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                  storage::View::OLD);
+    auto *memory = history_total_cost_.get_allocator().GetMemoryResource();
+    std::list<std::pair<TypedValue, TypedValue>> expansions;
 
-    const auto &start_vertex = frame[*symbol_it++];
-    auto *pull_memory = context.evaluation_context.memory;
-    // In an OPTIONAL MATCH everything could be Null.
-    if (start_vertex.IsNull()) {
-      frame[self_.path_symbol_] = TypedValue(pull_memory);
-      return true;
-    }
+    auto create_state = [this](storage::Gid vertex, int64_t depth) {
+      return std::make_pair(vertex, upper_bound_set_ ? depth : 0);
+    };
 
-    DMG_ASSERT(start_vertex.IsVertex(), "First named path element must be a vertex");
-    query::Path path(start_vertex.ValueVertex(), pull_memory);
+    // Populates the priority queue structure with expansions
+    // from the given vertex. skips expansions that don't satisfy
+    // the "where" condition.
+    auto expand_from_vertex = [&](const TypedValue &vertex, const TypedValue &weight, int64_t depth) {
+      expansions.clear();
+      ExpandFromVertexHistory(vertex, self_.common_.direction, self_.common_.edge_types, history_context_, context,
+                              memory, &expansions);
+      for (const auto &[edge, next_vertex] : expansions) {
+        auto next_weight = ExpansionWeight(edge, next_vertex, weight, frame, evaluator);
+        if (!next_weight) continue;
+
+        auto found_it = history_total_cost_.find(create_state(HistoryValueGid(next_vertex), depth));
+        if (found_it != history_total_cost_.end() &&
+            (found_it->second.IsNull() || (found_it->second <= *next_weight).ValueBool()))
+          continue;
 
-    // If the last path element symbol was for an edge list, then
-    // the next symbol is a vertex and it should not append to the path
-    // because
-    // expansion already did it.
-    bool last_was_edge_list = false;
+        history_pq_.push({*next_weight, depth + 1, next_vertex, edge});
+      }
+    };
 
-    for (; symbol_it != self_.path_elements_.end(); symbol_it++) {
-      const auto &expansion = frame[*symbol_it];
+    while (true) {
+      if (MustAbort(context)) throw HintedAbortError();
+      if (history_pq_.empty()) {
+        if (!input_cursor_->Pull(frame, context)) return false;
+        const auto &vertex_value = frame[self_.input_symbol_];
+        if (vertex_value.IsNull()) continue;
+        if (self_.common_.existing_node) {
+          const auto &node = frame[self_.common_.node_symbol];
+          // Due to optional matching the existing node could be null.
+          // Skip expansion for such nodes.
+          if (node.IsNull()) continue;
+        }
+        if (self_.upper_bound_) {
+          upper_bound_ = EvaluateInt(&evaluator, self_.upper_bound_, "Max depth in weighted shortest path expansion");
+          upper_bound_set_ = true;
+        } else {
+          upper_bound_ = std::numeric_limits<int64_t>::max();
+          upper_bound_set_ = false;
+        }
+        if (upper_bound_ < 1)
+          throw QueryRuntimeException(
+              "Maximum depth in weighted shortest path expansion must be at "
+              "least 1.");
+
+        history_context_ = MakeHistoryContext(context);
+        history_previous_.clear();
+        history_total_cost_.clear();
+        history_yielded_vertices_.clear();
+
+        history_pq_.push({TypedValue(), 0, vertex_value, std::nullopt});
+        // We don't want to yield paths that end with the starting vertex.
+        history_yielded_vertices_.insert(HistoryValueGid(vertex_value));
+      }
+
+      while (!history_pq_.empty()) {
+        if (MustAbort(context)) throw HintedAbortError();
+        auto [current_weight, current_depth, current_vertex, current_edge] = history_pq_.top();
+        history_pq_.pop();
+
+        const auto current_gid = HistoryValueGid(current_vertex);
+        auto current_state = create_state(current_gid, current_depth);
+
+        // Check if the vertex has already been processed.
+        if (history_total_cost_.find(current_state) != history_total_cost_.end()) {
+          continue;
+        }
+        history_previous_.emplace(current_state, current_edge);
+        history_total_cost_.emplace(current_state, current_weight);
+
+        // Expand only if what we've just expanded is less than max depth.
+        if (current_depth < upper_bound_) expand_from_vertex(current_vertex, current_weight, current_depth);
+
+        // If we yielded a path for a vertex already, make the expansion but
+        // don't return the path again.
+        if (history_yielded_vertices_.find(current_gid) != history_yielded_vertices_.end()) continue;
+
+        // Reconstruct the path.
+        auto last_vertex = current_gid;
+        auto last_depth = current_depth;
+        auto *pull_memory = context.evaluation_context.memory;
+        utils::pmr::vector<TypedValue> edge_list(pull_memory);
+        while (true) {
+          // Origin_vertex must be in previous.
+          const auto &previous_edge = history_previous_.find(create_state(last_vertex, last_depth))->second;
+          if (!previous_edge) break;
+          last_vertex = HistoryEdgeOtherEnd(*previous_edge, last_vertex);
+          last_depth--;
+          edge_list.emplace_back(previous_edge.value());
+        }
+
+        // Place destination node on the frame, handle existence flag.
+        if (self_.common_.existing_node) {
+          const auto &node = frame[self_.common_.node_symbol];
+          if (HistoryValueGid(node) != current_gid)
+            continue;
+          else
+            // Prevent expanding other paths, because we found the
+            // shortest to existing node.
+            ClearHistoryQueue();
+        } else {
+          frame[self_.common_.node_symbol] = current_vertex;
+        }
+
+        if (!self_.is_reverse_) {
+          // Place edges on the frame in the correct order.
+          std::reverse(edge_list.begin(), edge_list.end());
+        }
+        frame[self_.common_.edge_symbol] = std::move(edge_list);
+        frame[self_.total_weight_.value()] = current_weight;
+        history_yielded_vertices_.insert(current_gid);
+        return true;
+      }
+    }
+  }
+};
+
+UniqueCursorPtr ExpandVariable::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::ExpandVariableOperator);
+
+  switch (type_) {
+    case EdgeAtom::Type::BREADTH_FIRST:
+      if (common_.existing_node) {
+        return MakeUniqueCursorPtr<STShortestPathCursor>(mem, *this, mem);
+      } else {
+        return MakeUniqueCursorPtr<SingleSourceShortestPathCursor>(mem, *this, mem);
+      }
+    case EdgeAtom::Type::DEPTH_FIRST:
+      return MakeUniqueCursorPtr<ExpandVariableCursor>(mem, *this, mem);
+    case EdgeAtom::Type::WEIGHTED_SHORTEST_PATH:
+      return MakeUniqueCursorPtr<ExpandWeightedShortestPathCursor>(mem, *this, mem);
+    case EdgeAtom::Type::SINGLE:
+      LOG_FATAL("ExpandVariable should not be planned for a single expansion!");
+  }
+}
+
+class ConstructNamedPathCursor : public Cursor {
+ public:
+  ConstructNamedPathCursor(const ConstructNamedPath &self, utils::MemoryResource *mem)
+      : self_(self), input_cursor_(self_.input()->MakeCursor(mem)) {}
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("ConstructNamedPath");
+    std::cout<<"ConstructNamedPath\n";
+
+    if (!input_cursor_->Pull(frame, context)) return false;
+
+    auto symbol_it = self_.path_elements_.begin();
+    DMG_ASSERT(symbol_it != self_.path_elements_.end(), "Named path must contain at least one node");
+
+    const auto &start_vertex = frame[*symbol_it++];
+    auto *pull_memory = context.evaluation_context.memory;
+    // In an OPTIONAL MATCH everything could be Null.
+    if (start_vertex.IsNull()) {
+      frame[self_.path_symbol_] = TypedValue(pull_memory);
+      return true;
+    }
+
+    DMG_ASSERT(start_vertex.IsVertex(), "First named path element must be a vertex");
+    query::Path path(start_vertex.ValueVertex(), pull_memory);
+
+    // If the last path element symbol was for an edge list, then
+    // the next symbol is a vertex and it should not append to the path
+    // because
+    // expansion already did it.
+    bool last_was_edge_list = false;
+
+    for (; symbol_it != self_.path_elements_.end(); symbol_it++) {
+      const auto &expansion = frame[*symbol_it];
       //  We can have Null (OPTIONAL MATCH), a vertex, an edge, or an edge
       //  list (variable expand or BFS).
       switch (expansion.type()) {
@@ -2664,9 +3188,307 @@ Filter::Filter(const std::shared_ptr<LogicalOperator> &input, Expression *expres
 
 ACCEPT_WITH_INPUT(Filter)
 
+namespace {
+
+// Returns true if `op` is a chain of operators which only read the graph
+// and fill the frame from their own input, down to Once. A Filter over such
+// a chain may pull its input ahead without changing the query result.
+bool IsReadOnlyScan(const LogicalOperator &op) {
+  const auto *current = &op;
+  while (!utils::IsSubtype(*current, Once::kType)) {
+    if (!utils::IsSubtype(*current, ScanAll::kType) && !utils::IsSubtype(*current, Expand::kType) &&
+        !utils::IsSubtype(*current, Filter::kType) && !utils::IsSubtype(*current, EdgeUniquenessFilter::kType)) {
+      return false;
+    }
+    current = current->input().get();
+  }
+  return true;
+}
+
+/// Filter cursor which pulls a batch of rows from its input and evaluates the
+/// filter over the whole batch. The first batch has a single row and every
+/// following one is twice as large, up to `FLAGS_query_filter_batch_size`, so
+/// a parent which needs only a few rows (e.g. `LIMIT 1`) doesn't make the
+/// cursor scan much more than the row-wise cursor would.
+///
+/// The filter is split into its top-level conjuncts. Comparisons of a node
+/// property with a literal or a parameter and label tests are evaluated in a
+/// loop over the batch, reading the property straight from the vertex and
+/// evaluating the other side only once per batch. Other conjuncts are
+/// evaluated row by row. Conjuncts are applied in their original order and a
+/// row is dropped as soon as one of them is false, so `AND` short-circuiting is
+/// kept. Rows for which a batched conjunct gives something else than a bool or
+/// Null (or can't read the vertex), and rows for which a row-wise conjunct
+/// throws, are evaluated once more with the whole filter when their turn
+/// comes, so errors are reported exactly as with the row-wise cursor.
+///
+/// Accepted rows are handed to the parent one at a time by restoring the
+/// symbols which the input writes to the frame.
+class BatchFilterCursor : public Cursor {
+ public:
+  BatchFilterCursor(const Filter &self, utils::MemoryResource *mem)
+      : self_(self), input_cursor_(self.input_->MakeCursor(mem)), rows_(mem), selected_(mem), fallback_(mem) {}
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("Filter");
+    ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                  storage::View::OLD);
+    if (!initialized_) Initialize(context);
+    if (!batched_) {
+      // History queries fill the frame through the context, so they are
+      // evaluated row by row.
+      while (input_cursor_->Pull(frame, context)) {
+        if (EvaluateFilter(evaluator, self_.expression_)) return true;
+      }
+      return false;
+    }
+    while (true) {
+      while (next_ < selected_.size()) {
+        const auto row = selected_[next_++];
+        RestoreRow(frame, row);
+        if (!fallback_[row] || EvaluateFilter(evaluator, self_.expression_)) return true;
+      }
+      if (input_exhausted_) return false;
+      FillBatch(frame, context);
+      EvaluateBatch(frame, context, &evaluator);
+    }
+  }
+
+  void Shutdown() override { input_cursor_->Shutdown(); }
+
+  void Reset() override {
+    input_cursor_->Reset();
+    rows_.clear();
+    selected_.clear();
+    fallback_.clear();
+    next_ = 0;
+    batch_size_ = 1;
+    input_exhausted_ = false;
+  }
+
+ private:
+  enum class Comparison { EQUAL, NOT_EQUAL, LESS, GREATER, LESS_EQUAL, GREATER_EQUAL };
+
+  // A conjunct of the filter. Batched conjuncts read the value of
+  // `columns_[column]`, others are evaluated through `expression`.
+  struct Conjunct {
+    Expression *expression;
+    bool batched{false};
+    size_t column{0};
+    // Set for property comparisons, otherwise the conjunct is a label test.
+    std::optional<storage::PropertyId> property;
+    Comparison comparison{Comparison::EQUAL};
+    Expression *operand{nullptr};
+    bool property_on_left{true};
+    std::vector<storage::LabelId> labels;
+  };
+
+  void Initialize(const ExecutionContext &context) {
+    initialized_ = true;
+    batched_ = !context.addition;
+    if (!batched_) return;
+    columns_ = self_.input_->ModifiedSymbols(context.symbol_table);
+    std::vector<Expression *> expressions;
+    SplitConjuncts(self_.expression_, &expressions);
+    for (auto *expression : expressions) {
+      conjuncts_.push_back(MakeConjunct(expression, context));
+    }
+  }
+
+  static void SplitConjuncts(Expression *expression, std::vector<Expression *> *conjuncts) {
+    if (auto *and_op = utils::Downcast<AndOperator>(expression)) {
+      SplitConjuncts(and_op->expression1_, conjuncts);
+      SplitConjuncts(and_op->expression2_, conjuncts);
+    } else {
+      conjuncts->push_back(expression);
+    }
+  }
+
+  std::optional<size_t> FindColumn(Expression *expression, const SymbolTable &symbol_table) const {
+    auto *identifier = utils::Downcast<Identifier>(expression);
+    if (!identifier) return std::nullopt;
+    auto found = std::find(columns_.begin(), columns_.end(), symbol_table.at(*identifier));
+    if (found == columns_.end()) return std::nullopt;
+    return found - columns_.begin();
+  }
+
+  Conjunct MakeConjunct(Expression *expression, const ExecutionContext &context) const {
+    Conjunct conjunct{expression};
+    const auto &symbol_table = context.symbol_table;
+    if (auto *labels_test = utils::Downcast<LabelsTest>(expression)) {
+      if (auto column = FindColumn(labels_test->expression_, symbol_table)) {
+        conjunct.batched = true;
+        conjunct.column = *column;
+        for (const auto &label : labels_test->labels_) {
+          conjunct.labels.push_back(context.evaluation_context.labels[label.ix]);
+        }
+      }
+      return conjunct;
+    }
+    auto make_comparison = [&](auto *op, Comparison comparison) {
+      if (!op) return false;
+      auto is_operand = [](Expression *operand) {
+        return utils::Downcast<PrimitiveLiteral>(operand) || utils::Downcast<ParameterLookup>(operand);
+      };
+      auto *lookup = utils::Downcast<PropertyLookup>(op->expression1_);
+      auto *operand = op->expression2_;
+      conjunct.property_on_left = true;
+      if (!lookup || !is_operand(operand)) {
+        lookup = utils::Downcast<PropertyLookup>(op->expression2_);
+        operand = op->expression1_;
+        conjunct.property_on_left = false;
+      }
+      if (!lookup || !is_operand(operand)) return false;
+      auto column = FindColumn(lookup->expression_, symbol_table);
+      if (!column) return false;
+      conjunct.batched = true;
+      conjunct.column = *column;
+      conjunct.property = context.evaluation_context.properties[lookup->property_.ix];
+      conjunct.comparison = comparison;
+      conjunct.operand = operand;
+      return true;
+    };
+    make_comparison(utils::Downcast<EqualOperator>(expression), Comparison::EQUAL) ||
+        make_comparison(utils::Downcast<NotEqualOperator>(expression), Comparison::NOT_EQUAL) ||
+        make_comparison(utils::Downcast<LessOperator>(expression), Comparison::LESS) ||
+        make_comparison(utils::Downcast<GreaterOperator>(expression), Comparison::GREATER) ||
+        make_comparison(utils::Downcast<LessEqualOperator>(expression), Comparison::LESS_EQUAL) ||
+        make_comparison(utils::Downcast<GreaterEqualOperator>(expression), Comparison::GREATER_EQUAL);
+    return conjunct;
+  }
+
+  void FillBatch(Frame &frame, ExecutionContext &context) {
+    if (MustAbort(context)) throw HintedAbortError();
+    rows_.clear();
+    size_t row_count = 0;
+    while (row_count < batch_size_) {
+      if (!input_cursor_->Pull(frame, context)) {
+        input_exhausted_ = true;
+        break;
+      }
+      for (const auto &symbol : columns_) rows_.emplace_back(frame[symbol]);
+      ++row_count;
+    }
+    selected_.resize(row_count);
+    std::iota(selected_.begin(), selected_.end(), 0);
+    fallback_.assign(row_count, false);
+    next_ = 0;
+    batch_size_ = std::min<uint64_t>(batch_size_ * 2, FLAGS_query_filter_batch_size);
+  }
+
+  void RestoreRow(Frame &frame, size_t row) const {
+    for (size_t i = 0; i < columns_.size(); ++i) frame[columns_[i]] = rows_[row * columns_.size() + i];
+  }
+
+  void EvaluateBatch(Frame &frame, ExecutionContext &context, ExpressionEvaluator *evaluator) {
+    // Rows for which some conjunct was Null. They can't pass the filter, but
+    // the following conjuncts are still evaluated because `null AND x`
+    // evaluates `x`.
+    utils::pmr::vector<bool> is_null(fallback_.size(), false, fallback_.get_allocator());
+    for (const auto &conjunct : conjuncts_) {
+      if (selected_.empty()) break;
+      std::optional<TypedValue> operand;
+      if (conjunct.operand) operand.emplace(conjunct.operand->Accept(*evaluator));
+      size_t kept = 0;
+      for (const auto row : selected_) {
+        if (fallback_[row]) {
+          selected_[kept++] = row;
+          continue;
+        }
+        std::optional<TypedValue> result;
+        if (conjunct.batched) {
+          result = EvaluateBatched(conjunct, rows_[row * columns_.size() + conjunct.column], operand);
+        } else {
+          RestoreRow(frame, row);
+          try {
+            result = conjunct.expression->Accept(*evaluator);
+          } catch (const QueryRuntimeException &) {
+            // Thrown again when the row is evaluated with the whole filter,
+            // after the rows before it were returned.
+          } catch (const TypedValueException &) {
+          }
+        }
+        if (!result || !(result->IsNull() || result->IsBool())) {
+          fallback_[row] = true;
+        } else if (result->IsNull()) {
+          is_null[row] = true;
+        } else if (!result->ValueBool()) {
+          continue;
+        }
+        selected_[kept++] = row;
+      }
+      selected_.resize(kept);
+    }
+    selected_.erase(
+        std::remove_if(selected_.begin(), selected_.end(), [&](auto row) { return !fallback_[row] && is_null[row]; }),
+        selected_.end());
+  }
+
+  // Returns nullopt if the conjunct can't be evaluated on `value` here.
+  static std::optional<TypedValue> EvaluateBatched(const Conjunct &conjunct, const TypedValue &value,
+                                                   const std::optional<TypedValue> &operand) {
+    if (value.IsNull()) return TypedValue();
+    if (value.type() != TypedValue::Type::Vertex) return std::nullopt;
+    const auto &vertex = value.ValueVertex();
+    if (!conjunct.property) {
+      for (const auto &label : conjunct.labels) {
+        auto has_label = vertex.HasLabel(storage::View::OLD, label);
+        if (has_label.HasError()) return std::nullopt;
+        if (!*has_label) return TypedValue(false);
+      }
+      return TypedValue(true);
+    }
+    auto maybe_property = vertex.GetProperty(storage::View::OLD, *conjunct.property);
+    if (maybe_property.HasError()) return std::nullopt;
+    const TypedValue property(std::move(*maybe_property));
+    const auto &lhs = conjunct.property_on_left ? property : *operand;
+    const auto &rhs = conjunct.property_on_left ? *operand : property;
+    try {
+      switch (conjunct.comparison) {
+        case Comparison::EQUAL:
+          return lhs == rhs;
+        case Comparison::NOT_EQUAL:
+          return lhs != rhs;
+        case Comparison::LESS:
+          return lhs < rhs;
+        case Comparison::GREATER:
+          return lhs > rhs;
+        case Comparison::LESS_EQUAL:
+          return lhs <= rhs;
+        case Comparison::GREATER_EQUAL:
+          return lhs >= rhs;
+      }
+    } catch (const TypedValueException &) {
+    }
+    return std::nullopt;
+  }
+
+  const Filter &self_;
+  const UniqueCursorPtr input_cursor_;
+  bool initialized_{false};
+  bool batched_{false};
+  std::vector<Symbol> columns_;
+  std::vector<Conjunct> conjuncts_;
+  // Values of `columns_` for each row of the batch, row after row.
+  utils::pmr::vector<TypedValue> rows_;
+  // Rows of the batch which passed the filter so far.
+  utils::pmr::vector<size_t> selected_;
+  // Rows which have to be evaluated again with the whole filter.
+  utils::pmr::vector<bool> fallback_;
+  size_t next_{0};
+  // Number of rows which the next batch pulls.
+  uint64_t batch_size_{1};
+  bool input_exhausted_{false};
+};
+
+}  // namespace
+
 UniqueCursorPtr Filter::MakeCursor(utils::MemoryResource *mem) const {
   EventCounter::IncrementCounter(EventCounter::FilterOperator);
 
+  if (FLAGS_query_filter_batch_size > 1 && IsReadOnlyScan(*input_)) {
+    return MakeUniqueCursorPtr<BatchFilterCursor>(mem, *this, mem);
+  }
   return MakeUniqueCursorPtr<FilterCursor>(mem, *this, mem);
 }
 
@@ -2682,8 +3504,23 @@ bool Filter::FilterCursor::Pull(Frame &frame, ExecutionContext &context) {
   // nodes and edges.
   ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                 storage::View::OLD);
+  if (!compiled_checked_) {
+    compiled_checked_ = true;
+    if (context.compiled_expressions && !context.addition) {
+      if (const auto *compiled = context.compiled_expressions->Get(self_.expression_, context.symbol_table)) {
+        compiled_.emplace(*compiled, context.evaluation_context, storage::View::OLD);
+      }
+    }
+  }
 
   while (input_cursor_->Pull(frame, context)) {
+    if (compiled_ && compiled_->IsUseful()) {
+      // Falls back to the AST for values the compiled filter doesn't handle.
+      if (const auto result = compiled_->EvaluateFilter(frame)) {
+        if (*result) return true;
+        continue;
+      }
+    }
     if (EvaluateFilter(evaluator, self_.expression_)) return true;
   }
   return false;
@@ -2720,11 +3557,35 @@ Produce::ProduceCursor::ProduceCursor(const Produce &self, utils::MemoryResource
 bool Produce::ProduceCursor::Pull(Frame &frame, ExecutionContext &context) {
   SCOPED_PROFILE_OP("Produce");
 
+  if (!compiled_checked_) {
+    compiled_checked_ = true;
+    if (context.compiled_expressions && !context.addition) {
+      bool any_compiled = false;
+      for (auto named_expr : self_.named_expressions_) {
+        auto &compiled = compiled_.emplace_back();
+        if (const auto *expression = context.compiled_expressions->Get(named_expr->expression_, context.symbol_table)) {
+          compiled.emplace(*expression, context.evaluation_context, storage::View::NEW);
+          any_compiled = true;
+        }
+      }
+      if (!any_compiled) compiled_.clear();
+    }
+  }
+
   if (input_cursor_->Pull(frame, context)) {
     // Produce should always yield the latest results.
     ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                   storage::View::NEW);
-    for (auto named_expr : self_.named_expressions_) named_expr->Accept(evaluator);
+    for (size_t i = 0; i < self_.named_expressions_.size(); ++i) {
+      auto *named_expr = self_.named_expressions_[i];
+      if (!compiled_.empty() && compiled_[i] && compiled_[i]->IsUseful()) {
+        if (auto value = compiled_[i]->Evaluate(frame, context.evaluation_context.memory)) {
+          frame[context.symbol_table.at(*named_expr)] = std::move(*value);
+          continue;
+        }
+      }
+      named_expr->Accept(evaluator);
+    }
 
     return true;
   }
@@ -3472,37 +4333,301 @@ TypedValue DefaultAggregationOpValue(const Aggregate::Element &element, utils::M
       return TypedValue(TypedValue::TMap(memory));
   }
 }
-}  // namespace
 
-class AggregateCursor : public Cursor {
- public:
-  AggregateCursor(const Aggregate &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input_->MakeCursor(mem)), aggregation_(mem) {}
+// Temporary file to which operators write rows that don't fit into memory.
+using SpillFile = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
 
-  bool Pull(Frame &frame, ExecutionContext &context) override {
-    SCOPED_PROFILE_OP("Aggregate");
+SpillFile MakeSpillFile() { return SpillFile(std::tmpfile(), &std::fclose); }
 
-    if (!pulled_all_input_) {
-      ProcessAll(&frame, &context);
-      pulled_all_input_ = true;
-      aggregation_it_ = aggregation_.begin();
+// Returns true if the value can be written to a spill file, i.e. it is a
+// property value or a vertex (which is stored by its Gid). NaN and infinite
+// doubles aren't spillable because JSON has no encoding for them.
+bool IsSpillable(const TypedValue &value, bool allow_vertex = true) {
+  switch (value.type()) {
+    case TypedValue::Type::Vertex:
+      return allow_vertex;
+    case TypedValue::Type::Double:
+      return std::isfinite(value.ValueDouble());
+    case TypedValue::Type::List:
+      return std::all_of(value.ValueList().begin(), value.ValueList().end(),
+                         [](const auto &elem) { return IsSpillable(elem, false); });
+    case TypedValue::Type::Map:
+      return std::all_of(value.ValueMap().begin(), value.ValueMap().end(),
+                         [](const auto &kv) { return IsSpillable(kv.second, false); });
+    default:
+      return value.IsPropertyValue();
+  }
+}
 
-      // in case there is no input and no group_bys we need to return true
-      // just this once
-      if (aggregation_.empty() && self_.group_by_.empty()) {
-        auto *pull_memory = context.evaluation_context.memory;
-        // place default aggregation values on the frame
-        for (const auto &elem : self_.aggregations_)
-          frame[elem.output_sym] = DefaultAggregationOpValue(elem, pull_memory);
-        // place null as remember values on the frame
-        for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = TypedValue(pull_memory);
-        return true;
-      }
-    }
+template <class TValues>
+bool AreSpillable(const TValues &values) {
+  return std::all_of(values.begin(), values.end(), [](const auto &value) { return IsSpillable(value); });
+}
 
-    if (aggregation_it_ == aggregation_.end()) return false;
+nlohmann::json SpillValue(const TypedValue &value) {
+  if (value.IsVertex()) return {{"v", value.ValueVertex().Gid().AsUint()}};
+  return {{"p", serialization::SerializePropertyValue(storage::PropertyValue(value))}};
+}
 
-    // place aggregation values on the frame
+template <class TValues>
+nlohmann::json SpillValues(const TValues &values) {
+  auto data = nlohmann::json::array();
+  for (const auto &value : values) data.push_back(SpillValue(value));
+  return data;
+}
+
+TypedValue UnspillValue(const nlohmann::json &data, DbAccessor *dba, utils::MemoryResource *memory) {
+  if (data.contains("v")) {
+    const auto gid = storage::Gid::FromUint(data["v"].get<uint64_t>());
+    auto vertex = dba->FindVertex(gid, storage::View::OLD);
+    if (!vertex) vertex = dba->FindVertex(gid, storage::View::NEW);
+    if (!vertex) throw QueryRuntimeException("Trying to read a node that doesn't exist from a temporary file.");
+    return TypedValue(*vertex, memory);
+  }
+  return TypedValue(serialization::DeserializePropertyValue(data["p"]), memory);
+}
+
+void UnspillValues(const nlohmann::json &data, DbAccessor *dba, utils::pmr::vector<TypedValue> *values) {
+  values->reserve(data.size());
+  for (const auto &value : data) {
+    values->emplace_back(UnspillValue(value, dba, values->get_allocator().GetMemoryResource()));
+  }
+}
+
+// Rows are stored as their length followed by their JSON encoding.
+void WriteSpilledRow(std::FILE *file, const nlohmann::json &row) {
+  const auto data = row.dump();
+  const uint64_t size = data.size();
+  if (std::fwrite(&size, sizeof(size), 1, file) != 1 || std::fwrite(data.data(), 1, size, file) != size) {
+    throw QueryRuntimeException("Couldn't write rows to a temporary file.");
+  }
+}
+
+std::optional<nlohmann::json> ReadSpilledRow(std::FILE *file) {
+  uint64_t size = 0;
+  if (std::fread(&size, sizeof(size), 1, file) != 1) return std::nullopt;
+  std::string data(size, '\0');
+  if (std::fread(data.data(), 1, size, file) != size) {
+    throw QueryRuntimeException("Couldn't read rows from a temporary file.");
+  }
+  return nlohmann::json::parse(data);
+}
+
+// Minimal number of groups (or rows) which Aggregate and Distinct write to
+// disk when the memory is running out.
+constexpr size_t kMinSpillRows = 1024;
+// Number of files among which Aggregate and Distinct divide spilled rows by
+// their hash.
+constexpr size_t kSpillPartitions = 16;
+// Rough number of bytes a group or a row kept by Aggregate or Distinct takes,
+// including the hash table node.
+constexpr uint64_t kEstimatedSpillRowBytes = 256;
+// Number of groups or rows kept in memory if there is no way to tell how
+// much memory the query may use.
+constexpr uint64_t kDefaultSpillRows = 10000000;
+
+// Returns the number of groups or rows which Aggregate and Distinct keep in
+// memory before writing them to disk. Unless it's set by
+// `FLAGS_query_hash_table_spill_size`, it's the number of rows which fit into
+// a quarter of the smallest of the query's memory limit, the memory limit of
+// the whole database and the total RAM.
+uint64_t SpillRowLimit(const ExecutionContext &context) {
+  if (FLAGS_query_hash_table_spill_size > 0) return FLAGS_query_hash_table_spill_size;
+  static const uint64_t total_memory = utils::sysinfo::TotalMemory().value_or(0) * 1024;
+  uint64_t memory = total_memory;
+  auto restrict_memory = [&memory](uint64_t limit) {
+    if (limit > 0 && (memory == 0 || limit < memory)) memory = limit;
+  };
+  restrict_memory(std::max<int64_t>(utils::total_memory_tracker.HardLimit(), 0));
+  if (context.memory_limit) restrict_memory(context.memory_limit->GetMaxAllocatedBytes());
+  if (memory == 0) return kDefaultSpillRows;
+  return std::max<uint64_t>(memory / 4 / kEstimatedSpillRowBytes, kMinSpillRows);
+}
+
+// Returns true if an operator holding `rows` groups or rows should write them
+// to disk, either because there are more than `SpillRowLimit` of them or the
+// memory of the database or of the query is close to its limit.
+bool ShouldSpill(size_t rows, const ExecutionContext &context) {
+  if (rows < kMinSpillRows) return false;
+  if (rows >= SpillRowLimit(context)) return true;
+  if (context.memory_limit &&
+      context.memory_limit->GetAllocatedBytes() > context.memory_limit->GetMaxAllocatedBytes() / 10 * 9) {
+    return true;
+  }
+  const auto limit = utils::total_memory_tracker.HardLimit();
+  return limit > 0 && utils::total_memory_tracker.Amount() > limit / 10 * 9;
+}
+
+// Threads shared by all queries which execute parts of a plan in parallel.
+// The session thread always works too, so the pool has one thread less.
+utils::ThreadPool &ParallelWorkerPool() {
+  static utils::ThreadPool pool(std::max<uint64_t>(FLAGS_query_parallel_workers - 1, 1));
+  return pool;
+}
+
+// The Expand at the top of the input of an Aggregate or a Distinct which
+// doesn't need a row for every expanded edge: Aggregate only needs to know how
+// many edges would be pulled for a row of the Expand's input and Distinct only
+// needs the vertices at their ends. Such an Expand isn't executed, the
+// operator pulls the Expand's input and counts or visits the edges itself.
+struct FactorizedExpand {
+  const Expand *expand{nullptr};
+  // Filter keeping the expanded edge different from the previously matched
+  // ones, nullptr if there is none.
+  const EdgeUniquenessFilter *uniqueness{nullptr};
+};
+
+// Returns the Expand at the top of `input`, optionally under an
+// EdgeUniquenessFilter, if the input only reads the graph and the symbols in
+// `used` don't refer to the expanded edge, nor to the expanded node unless
+// `node_used` is set. Returns std::nullopt if the input has to be pulled.
+std::optional<FactorizedExpand> FindFactorizedExpand(const LogicalOperator &input,
+                                                     const std::unordered_set<Symbol> &used, bool node_used) {
+  if (!IsReadOnlyScan(input)) return std::nullopt;
+  FactorizedExpand factorized;
+  const auto *op = &input;
+  if (utils::IsSubtype(*op, EdgeUniquenessFilter::kType)) {
+    factorized.uniqueness = static_cast<const EdgeUniquenessFilter *>(op);
+    op = op->input().get();
+  }
+  if (!utils::IsSubtype(*op, Expand::kType)) return std::nullopt;
+  factorized.expand = static_cast<const Expand *>(op);
+  const auto &common = factorized.expand->common_;
+  if (common.existing_node || used.count(common.edge_symbol) || (!node_used && used.count(common.node_symbol))) {
+    return std::nullopt;
+  }
+  if (factorized.uniqueness && factorized.uniqueness->expand_symbol_ != common.edge_symbol) return std::nullopt;
+  return factorized;
+}
+
+// Calls `callback` with every edge the Expand pulls for `vertex` and the
+// vertex it expands to, in the order of `ExpandCursor`.
+template <class TCallback>
+void ForEachExpandedEdge(const Expand &expand, const VertexAccessor &vertex, const TCallback &callback) {
+  const auto &common = expand.common_;
+  if (common.direction != EdgeAtom::Direction::OUT) {
+    for (const auto &edge : UnwrapEdgesResult(vertex.InEdges(expand.view_, common.edge_types))) {
+      callback(edge, edge.From());
+    }
+  }
+  if (common.direction != EdgeAtom::Direction::IN) {
+    for (const auto &edge : UnwrapEdgesResult(vertex.OutEdges(expand.view_, common.edge_types))) {
+      // Cycles were already expanded as incoming edges.
+      if (common.direction == EdgeAtom::Direction::BOTH && edge.IsCycle()) continue;
+      callback(edge, edge.To());
+    }
+  }
+}
+
+// Returns the number of edges the Expand pulls for `vertex`.
+int64_t CountExpandedEdges(const Expand &expand, const VertexAccessor &vertex) {
+  const auto &common = expand.common_;
+  if (common.edge_types.empty() && common.direction == EdgeAtom::Direction::IN) {
+    return static_cast<int64_t>(UnwrapEdgesResult(vertex.InDegree(expand.view_)));
+  }
+  if (common.edge_types.empty() && common.direction == EdgeAtom::Direction::OUT) {
+    return static_cast<int64_t>(UnwrapEdgesResult(vertex.OutDegree(expand.view_)));
+  }
+  int64_t count = 0;
+  ForEachExpandedEdge(expand, vertex, [&count](const auto &, const auto &) { ++count; });
+  return count;
+}
+
+// Returns the vertex the Expand expands to from `vertex` over `edge`.
+VertexAccessor ExpandedVertex(const Expand &expand, const EdgeAccessor &edge, const VertexAccessor &vertex) {
+  switch (expand.common_.direction) {
+    case EdgeAtom::Direction::IN:
+      return edge.From();
+    case EdgeAtom::Direction::OUT:
+      return edge.To();
+    case EdgeAtom::Direction::BOTH:
+      return edge.To() == vertex ? edge.From() : edge.To();
+  }
+  LOG_FATAL("Unknown expansion direction");
+}
+
+// Fills `excluded` with the distinct previously matched edges which the Expand
+// would pull for `vertex`, so the EdgeUniquenessFilter would drop them.
+// Returns false if one of the previous values isn't an edge, in which case
+// the filter drops all expanded edges, like `ContainsSameEdge` does.
+bool CollectExcludedEdges(const FactorizedExpand &factorized, const Frame &frame, const VertexAccessor &vertex,
+                          std::vector<EdgeAccessor> *excluded) {
+  excluded->clear();
+  if (!factorized.uniqueness) return true;
+  const auto &common = factorized.expand->common_;
+  auto add = [&](const TypedValue &value) {
+    if (value.type() != TypedValue::Type::Edge) return false;
+    const auto &edge = value.ValueEdge();
+    if (!common.edge_types.empty() &&
+        std::find(common.edge_types.begin(), common.edge_types.end(), edge.EdgeType()) == common.edge_types.end()) {
+      return true;
+    }
+    const bool expanded = (common.direction != EdgeAtom::Direction::OUT && edge.To() == vertex) ||
+                          (common.direction != EdgeAtom::Direction::IN && edge.From() == vertex);
+    if (expanded && std::find(excluded->begin(), excluded->end(), edge) == excluded->end()) excluded->push_back(edge);
+    return true;
+  };
+  for (const auto &symbol : factorized.uniqueness->previous_symbols_) {
+    const auto &value = frame[symbol];
+    if (value.type() == TypedValue::Type::List) {
+      for (const auto &elem : value.ValueList()) {
+        if (!add(elem)) return false;
+      }
+    } else if (!add(value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the symbols used by the expressions.
+template <class TExpressions>
+std::unordered_set<Symbol> UsedSymbols(const TExpressions &expressions, const SymbolTable &symbol_table) {
+  UsedSymbolsCollector collector(symbol_table);
+  for (auto *expression : expressions) {
+    if (expression) expression->Accept(collector);
+  }
+  return std::move(collector.symbols_);
+}
+}  // namespace
+
+class AggregateCursor : public Cursor {
+ public:
+  AggregateCursor(const Aggregate &self, utils::MemoryResource *mem)
+      : AggregateCursor(self, self.input_->MakeCursor(mem), mem) {}
+
+  AggregateCursor(const Aggregate &self, UniqueCursorPtr input_cursor, utils::MemoryResource *mem)
+      : self_(self), input_cursor_(std::move(input_cursor)), aggregation_(mem), pinned_(mem) {}
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("Aggregate");
+
+    if (!pulled_all_input_) {
+      ProcessAll(&frame, &context);
+      pulled_all_input_ = true;
+      aggregation_it_ = aggregation_.begin();
+
+      // in case there is no input and no group_bys we need to return true
+      // just this once
+      if (aggregation_.empty() && self_.group_by_.empty()) {
+        auto *pull_memory = context.evaluation_context.memory;
+        // place default aggregation values on the frame
+        for (const auto &elem : self_.aggregations_)
+          frame[elem.output_sym] = DefaultAggregationOpValue(elem, pull_memory);
+        // place null as remember values on the frame
+        for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = TypedValue(pull_memory);
+        return true;
+      }
+    }
+
+    // Spilled groups are merged back one partition at a time.
+    while (aggregation_it_ == aggregation_.end()) {
+      if (next_partition_ == partitions_.size()) return false;
+      LoadPartition(next_partition_++, &context);
+      aggregation_it_ = aggregation_.begin();
+    }
+
+    // place aggregation values on the frame
     auto aggregation_values_it = aggregation_it_->second.values_.begin();
     for (const auto &aggregation_elem : self_.aggregations_)
       frame[aggregation_elem.output_sym] = *aggregation_values_it++;
@@ -3515,13 +4640,21 @@ class AggregateCursor : public Cursor {
     return true;
   }
 
-  void Shutdown() override { input_cursor_->Shutdown(); }
+  void Shutdown() override {
+    input_cursor_->Shutdown();
+    if (counted_input_cursor_) counted_input_cursor_->Shutdown();
+  }
 
   void Reset() override {
     input_cursor_->Reset();
+    if (counted_input_cursor_) counted_input_cursor_->Reset();
     aggregation_.clear();
     aggregation_it_ = aggregation_.begin();
     pulled_all_input_ = false;
+    partitions_.clear();
+    next_partition_ = 0;
+    pinned_.clear();
+    spill_disabled_ = false;
   }
 
  private:
@@ -3562,6 +4695,19 @@ class AggregateCursor : public Cursor {
   // this LogicalOp pulls all from the input on it's first pull
   // this switch tracks if this has been performed
   bool pulled_all_input_{false};
+  // groups written to disk, divided by the hash of their group-by values
+  std::vector<SpillFile> partitions_;
+  size_t next_partition_{0};
+  // groups which couldn't be written to disk, merged with their partition
+  decltype(aggregation_) pinned_;
+  bool spill_disabled_{false};
+  // the Expand at the top of the input if its edges are counted instead of
+  // pulled, see `CheckCountedExpand`
+  std::optional<FactorizedExpand> counted_expand_;
+  bool counted_checked_{false};
+  // pulls the input of `counted_expand_`
+  UniqueCursorPtr counted_input_cursor_;
+  std::vector<EdgeAccessor> excluded_edges_;
 
   /**
    * Pulls from the input operator until exhausted and aggregates the
@@ -3573,13 +4719,76 @@ class AggregateCursor : public Cursor {
    * aggregation results, and not on the number of inputs.
    */
   void ProcessAll(Frame *frame, ExecutionContext *context) {
-    ExpressionEvaluator evaluator(frame, context->symbol_table, context->evaluation_context, context->db_accessor,
-                                  storage::View::NEW);
-    while (input_cursor_->Pull(*frame, *context)) {
-      ProcessOne(*frame, &evaluator);
+    CheckCountedExpand(*context);
+    if (!ProcessAllParallel(frame, context)) {
+      ExpressionEvaluator evaluator(frame, context->symbol_table, context->evaluation_context, context->db_accessor,
+                                    storage::View::NEW);
+      auto &input_cursor = counted_expand_ ? *counted_input_cursor_ : *input_cursor_;
+      while (input_cursor.Pull(*frame, *context)) {
+        const auto weight = InputWeight(*frame);
+        if (weight == 0) continue;
+        ProcessOne(*frame, &evaluator, weight);
+        if (!spill_disabled_ && ShouldSpill(aggregation_.size(), *context)) SpillGroups();
+      }
+    }
+
+    if (!partitions_.empty()) {
+      // The groups are finished when their partitions are read back.
+      SpillGroups();
+      pinned_ = std::move(aggregation_);
+      aggregation_.clear();
+      return;
     }
+    FinishAverages(context);
+  }
 
-    // calculate AVG aggregations (so far they have only been summed)
+  /**
+   * Decides, on the first pull, whether the edges of the Expand at the top of
+   * the input are counted instead of pulled. That is possible when the
+   * aggregations neither collect values nor refer to the expanded edge and
+   * node, e.g. in `MATCH (a)-->(b)-->(c) RETURN a, count(*)`: every row of the
+   * Expand's input is then aggregated once with the weight of the number of
+   * edges the Expand would pull for it, so the rows of the last hop of a
+   * multi-hop pattern are never built.
+   */
+  void CheckCountedExpand(const ExecutionContext &context) {
+    if (counted_checked_) return;
+    counted_checked_ = true;
+    if (!FLAGS_query_factorize_expand || context.addition || context.is_profile_query || context.morsel_symbol) return;
+    std::vector<Expression *> expressions(self_.group_by_.begin(), self_.group_by_.end());
+    for (const auto &elem : self_.aggregations_) {
+      if (elem.op == Aggregation::Op::COLLECT_LIST || elem.op == Aggregation::Op::COLLECT_MAP) return;
+      expressions.push_back(elem.value);
+      expressions.push_back(elem.key);
+    }
+    auto used = UsedSymbols(expressions, context.symbol_table);
+    used.insert(self_.remember_.begin(), self_.remember_.end());
+    counted_expand_ = FindFactorizedExpand(*self_.input_, used, false);
+    if (counted_expand_) {
+      auto *mem = aggregation_.get_allocator().GetMemoryResource();
+      counted_input_cursor_ = counted_expand_->expand->input()->MakeCursor(mem);
+    }
+  }
+
+  /**
+   * Returns how many times the pulled input row is aggregated: once, or the
+   * number of edges `counted_expand_` would pull for it, without the ones its
+   * EdgeUniquenessFilter would drop.
+   */
+  int64_t InputWeight(const Frame &frame) {
+    if (!counted_expand_) return 1;
+    const auto &expand = *counted_expand_->expand;
+    const auto &vertex_value = frame[expand.input_symbol_];
+    // Null due to a failed optional match, the Expand skips it.
+    if (vertex_value.IsNull()) return 0;
+    ExpectType(expand.input_symbol_, vertex_value, TypedValue::Type::Vertex);
+    const auto &vertex = vertex_value.ValueVertex();
+    if (!CollectExcludedEdges(*counted_expand_, frame, vertex, &excluded_edges_)) return 0;
+    return CountExpandedEdges(expand, vertex) - static_cast<int64_t>(excluded_edges_.size());
+  }
+
+  // calculate AVG aggregations (so far they have only been summed)
+  void FinishAverages(ExecutionContext *context) {
     for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
       if (self_.aggregations_[pos].op != Aggregation::Op::AVG) continue;
       for (auto &kv : aggregation_) {
@@ -3593,10 +4802,259 @@ class AggregateCursor : public Cursor {
     }
   }
 
+  size_t Partition(const utils::pmr::vector<TypedValue> &group_by) const {
+    return aggregation_.hash_function()(group_by) % kSpillPartitions;
+  }
+
+  /**
+   * Writes the groups to `kSpillPartitions` temporary files, chosen by the
+   * hash of their group-by values, and removes them from memory. The
+   * in-memory groups thus pre-aggregate the input between two spills, and
+   * the partial groups of the same key are merged when their partition is
+   * read back. Groups whose values can't be written stay in memory.
+   */
+  void SpillGroups() {
+    if (partitions_.empty()) {
+      for (size_t i = 0; i < kSpillPartitions; ++i) {
+        auto file = MakeSpillFile();
+        if (!file) {
+          partitions_.clear();
+          spill_disabled_ = true;
+          return;
+        }
+        partitions_.push_back(std::move(file));
+      }
+    }
+    size_t spilled = 0;
+    for (auto it = aggregation_.begin(); it != aggregation_.end();) {
+      const auto &[group_by, agg_value] = *it;
+      if (!AreSpillable(group_by) || !AreSpillable(agg_value.values_) || !AreSpillable(agg_value.remember_)) {
+        ++it;
+        continue;
+      }
+      WriteSpilledRow(partitions_[Partition(group_by)].get(),
+                      nlohmann::json::array({SpillValues(group_by), SpillValues(agg_value.values_),
+                                             std::vector<int64_t>(agg_value.counts_.begin(), agg_value.counts_.end()),
+                                             SpillValues(agg_value.remember_)}));
+      it = aggregation_.erase(it);
+      ++spilled;
+    }
+    // Don't try again if nothing can be written.
+    if (spilled == 0) spill_disabled_ = true;
+  }
+
+  /** Reads the groups of a spilled partition back into `aggregation_`. */
+  void LoadPartition(size_t partition, ExecutionContext *context) {
+    aggregation_.clear();
+    auto *file = partitions_[partition].get();
+    std::rewind(file);
+    auto *mem = aggregation_.get_allocator().GetMemoryResource();
+    while (const auto row = ReadSpilledRow(file)) {
+      utils::pmr::vector<TypedValue> group_by(mem);
+      UnspillValues((*row)[0], context->db_accessor, &group_by);
+      AggregationValue agg_value(mem);
+      UnspillValues((*row)[1], context->db_accessor, &agg_value.values_);
+      for (const auto &count : (*row)[2]) agg_value.counts_.push_back(count.get<int64_t>());
+      UnspillValues((*row)[3], context->db_accessor, &agg_value.remember_);
+      MergeGroup(group_by, agg_value);
+    }
+    partitions_[partition].reset();
+    for (const auto &[group_by, agg_value] : pinned_) {
+      if (Partition(group_by) == partition) MergeGroup(group_by, agg_value);
+    }
+    FinishAverages(context);
+  }
+
+  /**
+   * Aggregates the input on `FLAGS_query_parallel_workers` threads if it is a
+   * read-only pipeline over a scan and all aggregations can be merged.
+   * Returns false if the input has to be processed sequentially.
+   *
+   * The scan is pulled under a lock in morsels of
+   * `FLAGS_query_parallel_morsel_size` vertices. Each worker runs its own copy
+   * of the pipeline above the scan over the morsels it takes, so faster
+   * workers take more of them, and aggregates into its own partial state.
+   * The partial states are merged once all workers are done.
+   *
+   * Workers share the query's DbAccessor. The input is a read-only pipeline,
+   * so they only read through it, which the storage allows concurrently:
+   * vertices and edges are read under their own locks and the transaction
+   * isn't modified. All memory of the workers, including the memory of the
+   * scan and the evaluation memory of the session thread while the workers
+   * run, is allocated from a synchronized pool on top of the query's
+   * evaluation memory, so the query's memory limit covers it.
+   */
+  bool ProcessAllParallel(Frame *frame, ExecutionContext *context) {
+    if (FLAGS_query_parallel_workers == 1 || context->addition || context->is_profile_query ||
+        context->morsel_symbol || utils::IsSubtype(*self_.input_, Once::kType) || !IsReadOnlyScan(*self_.input_)) {
+      return false;
+    }
+    for (const auto &elem : self_.aggregations_) {
+      if (elem.op == Aggregation::Op::COLLECT_LIST || elem.op == Aggregation::Op::COLLECT_MAP) return false;
+    }
+    const auto *scan = self_.input_.get();
+    while (!utils::IsSubtype(*scan->input(), Once::kType)) scan = scan->input().get();
+    if (!utils::IsSubtype(*scan, ScanAll::kType)) return false;
+    const auto &scan_symbol = static_cast<const ScanAll *>(scan)->output_symbol_;
+
+    // Declared first so it outlives everything allocated from it.
+    utils::SynchronizedPoolResource worker_memory(128, 1024, context->evaluation_context.memory);
+    auto *evaluation_memory = context->evaluation_context.memory;
+    context->evaluation_context.memory = &worker_memory;
+    utils::OnScopeExit restore_memory([&] { context->evaluation_context.memory = evaluation_memory; });
+    const auto scan_cursor = scan->MakeCursor(&worker_memory);
+    Frame scan_frame(frame->elems().size(), &worker_memory);
+    std::copy(frame->elems().begin(), frame->elems().end(), scan_frame.elems().begin());
+    std::mutex scan_lock;
+    bool scan_exhausted = false;
+    std::exception_ptr error;
+    // Fills `morsel` with the next vertices of the scan, returns false once
+    // the scan is exhausted or a worker failed.
+    auto next_morsel = [&](std::vector<TypedValue> *morsel) {
+      morsel->clear();
+      std::lock_guard<std::mutex> guard(scan_lock);
+      if (error) return false;
+      if (MustAbort(*context)) throw HintedAbortError();
+      while (!scan_exhausted && morsel->size() < FLAGS_query_parallel_morsel_size) {
+        if (scan_cursor->Pull(scan_frame, *context)) {
+          morsel->emplace_back(scan_frame[scan_symbol]);
+        } else {
+          scan_exhausted = true;
+        }
+      }
+      return !morsel->empty();
+    };
+
+    std::vector<TypedValue> first_morsel;
+    next_morsel(&first_morsel);
+    // Small scans aren't worth waking up other threads.
+    const auto workers = scan_exhausted ? 1 : FLAGS_query_parallel_workers;
+    std::vector<std::unique_ptr<AggregateCursor>> partials;
+    std::vector<ExecutionContext> contexts;
+    std::vector<Frame> frames;
+    const auto &input = counted_expand_ ? *counted_expand_->expand->input() : *self_.input_;
+    for (size_t i = 0; i < workers; ++i) {
+      auto &partial = partials.emplace_back(
+          std::make_unique<AggregateCursor>(self_, input.MakeCursor(&worker_memory), &worker_memory));
+      partial->counted_expand_ = counted_expand_;
+      partial->counted_checked_ = true;
+      auto &worker_context = contexts.emplace_back();
+      worker_context.db_accessor = context->db_accessor;
+      worker_context.symbol_table = context->symbol_table;
+      worker_context.evaluation_context = context->evaluation_context;
+      worker_context.is_shutting_down = context->is_shutting_down;
+      worker_context.query_timer = &context->timer;
+      worker_context.morsel_symbol = scan_symbol;
+      auto &worker_frame = frames.emplace_back(frame->elems().size(), &worker_memory);
+      std::copy(frame->elems().begin(), frame->elems().end(), worker_frame.elems().begin());
+    }
+
+    auto work = [&](size_t worker, std::vector<TypedValue> morsel) {
+      auto &worker_context = contexts[worker];
+      auto &worker_frame = frames[worker];
+      auto &partial = *partials[worker];
+      ExpressionEvaluator evaluator(&worker_frame, worker_context.symbol_table, worker_context.evaluation_context,
+                                    worker_context.db_accessor, storage::View::NEW);
+      worker_context.morsel = &morsel;
+      try {
+        while (!morsel.empty() || next_morsel(&morsel)) {
+          partial.input_cursor_->Reset();
+          while (partial.input_cursor_->Pull(worker_frame, worker_context)) {
+            const auto weight = partial.InputWeight(worker_frame);
+            if (weight != 0) partial.ProcessOne(worker_frame, &evaluator, weight);
+          }
+          morsel.clear();
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(scan_lock);
+        if (!error) error = std::current_exception();
+      }
+    };
+
+    std::mutex done_lock;
+    std::condition_variable done_cv;
+    size_t running = workers - 1;
+    for (size_t worker = 1; worker < workers; ++worker) {
+      ParallelWorkerPool().AddTask([&, worker] {
+        work(worker, {});
+        std::lock_guard<std::mutex> guard(done_lock);
+        if (--running == 0) done_cv.notify_one();
+      });
+    }
+    work(0, std::move(first_morsel));
+    {
+      std::unique_lock<std::mutex> guard(done_lock);
+      done_cv.wait(guard, [&] { return running == 0; });
+    }
+    if (error) std::rethrow_exception(error);
+    for (const auto &partial : partials) Merge(*partial);
+    return true;
+  }
+
+  /** Merges the aggregation computed by a parallel worker into this one. */
+  void Merge(const AggregateCursor &partial) {
+    for (const auto &[group_by, partial_value] : partial.aggregation_) MergeGroup(group_by, partial_value);
+  }
+
+  /** Merges a partial aggregation of a group into `aggregation_`. */
+  void MergeGroup(const utils::pmr::vector<TypedValue> &group_by, const AggregationValue &partial_value) {
+    auto *mem = aggregation_.get_allocator().GetMemoryResource();
+    auto [it, inserted] = aggregation_.try_emplace(group_by, mem);
+    auto &agg_value = it->second;
+    if (inserted) {
+      agg_value.counts_.assign(partial_value.counts_.begin(), partial_value.counts_.end());
+      agg_value.values_.assign(partial_value.values_.begin(), partial_value.values_.end());
+      agg_value.remember_.assign(partial_value.remember_.begin(), partial_value.remember_.end());
+      return;
+    }
+    for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
+      const auto count = partial_value.counts_[pos];
+      if (count == 0) continue;
+      auto &value = agg_value.values_[pos];
+      const auto &other = partial_value.values_[pos];
+      if (agg_value.counts_[pos] == 0) {
+        value = other;
+        agg_value.counts_[pos] = count;
+        continue;
+      }
+      agg_value.counts_[pos] += count;
+      switch (self_.aggregations_[pos].op) {
+        case Aggregation::Op::COUNT:
+          value = agg_value.counts_[pos];
+          break;
+        case Aggregation::Op::MIN:
+          try {
+            if ((other < value).ValueBool()) value = other;
+          } catch (const TypedValueException &) {
+            throw QueryRuntimeException("Unable to get MIN of '{}' and '{}'.", other.type(), value.type());
+          }
+          break;
+        case Aggregation::Op::MAX:
+          try {
+            if ((other > value).ValueBool()) value = other;
+          } catch (const TypedValueException &) {
+            throw QueryRuntimeException("Unable to get MAX of '{}' and '{}'.", other.type(), value.type());
+          }
+          break;
+        case Aggregation::Op::AVG:
+        case Aggregation::Op::SUM:
+          value = value + other;
+          break;
+        case Aggregation::Op::COLLECT_LIST:
+          for (const auto &elem : other.ValueList()) value.ValueList().push_back(elem);
+          break;
+        case Aggregation::Op::COLLECT_MAP:
+          for (const auto &[key, elem] : other.ValueMap()) value.ValueMap().emplace(key, elem);
+          break;
+      }
+    }
+  }
+
   /**
-   * Performs a single accumulation.
+   * Performs a single accumulation of the row, as if it was pulled `weight`
+   * times.
    */
-  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator) {
+  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator, int64_t weight) {
     auto *mem = aggregation_.get_allocator().GetMemoryResource();
     utils::pmr::vector<TypedValue> group_by(mem);
     group_by.reserve(self_.group_by_.size());
@@ -3605,7 +5063,7 @@ class AggregateCursor : public Cursor {
     }
     auto &agg_value = aggregation_.try_emplace(std::move(group_by), mem).first->second;
     EnsureInitialized(frame, &agg_value);
-    Update(evaluator, &agg_value);
+    Update(evaluator, &agg_value, weight);
   }
 
   /** Ensures the new AggregationValue has been initialized. This means
@@ -3624,9 +5082,10 @@ class AggregateCursor : public Cursor {
     for (const Symbol &remember_sym : self_.remember_) agg_value->remember_.push_back(frame[remember_sym]);
   }
 
-  /** Updates the given AggregationValue with new data. Assumes that
-   * the AggregationValue has been initialized */
-  void Update(ExpressionEvaluator *evaluator, AggregateCursor::AggregationValue *agg_value) {
+  /** Updates the given AggregationValue with new data, `weight` times. Assumes
+   * that the AggregationValue has been initialized. Only COUNT, MIN, MAX, SUM
+   * and AVG are updated with a weight other than 1. */
+  void Update(ExpressionEvaluator *evaluator, AggregateCursor::AggregationValue *agg_value, int64_t weight) {
     DMG_ASSERT(self_.aggregations_.size() == agg_value->values_.size(),
                "Expected as much AggregationValue.values_ as there are "
                "aggregations.");
@@ -3643,7 +5102,7 @@ class AggregateCursor : public Cursor {
       // handle it here
       auto input_expr_ptr = agg_elem_it->value;
       if (!input_expr_ptr) {
-        *count_it += 1;
+        *count_it += weight;
         *value_it = *count_it;
         continue;
       }
@@ -3653,8 +5112,24 @@ class AggregateCursor : public Cursor {
       // Aggregations skip Null input values.
       if (input_value.IsNull()) continue;
       const auto &agg_op = agg_elem_it->op;
-      *count_it += 1;
-      if (*count_it == 1) {
+      *count_it += weight;
+      // SUM and AVG add the value once for every time the row is aggregated.
+      // An integer added to an integer sum is multiplied by the weight unless
+      // that overflows. Otherwise the value is added `weight` times, so the
+      // result is rounded, or overflows, exactly as when the rows are pulled.
+      auto add_weighted = [&](bool first) {
+        int64_t product = 0;
+        if (weight == 1 || (input_value.IsInt() && (first || value_it->IsInt()) &&
+                            !__builtin_mul_overflow(input_value.ValueInt(), weight, &product))) {
+          const auto weighted = weight == 1 ? input_value : TypedValue(product, input_value.GetMemoryResource());
+          *value_it = first ? weighted : *value_it + weighted;
+          return;
+        }
+        for (int64_t i = 0; i < weight; ++i) {
+          *value_it = first && i == 0 ? input_value : *value_it + input_value;
+        }
+      };
+      if (*count_it == weight) {
         // first value, nothing to aggregate. check type, set and continue.
         switch (agg_op) {
           case Aggregation::Op::MIN:
@@ -3664,11 +5139,11 @@ class AggregateCursor : public Cursor {
             break;
           case Aggregation::Op::SUM:
           case Aggregation::Op::AVG:
-            *value_it = input_value;
             EnsureOkForAvgSum(input_value);
+            add_weighted(true);
             break;
           case Aggregation::Op::COUNT:
-            *value_it = 1;
+            *value_it = *count_it;
             break;
           case Aggregation::Op::COLLECT_LIST:
             value_it->ValueList().push_back(input_value);
@@ -3716,7 +5191,7 @@ class AggregateCursor : public Cursor {
         // the input has been processed
         case Aggregation::Op::SUM:
           EnsureOkForAvgSum(input_value);
-          *value_it = *value_it + input_value;
+          add_weighted(false);
           break;
         case Aggregation::Op::COLLECT_LIST:
           value_it->ValueList().push_back(input_value);
@@ -3874,8 +5349,8 @@ void Limit::LimitCursor::Reset() {
 }
 
 OrderBy::OrderBy(const std::shared_ptr<LogicalOperator> &input, const std::vector<SortItem> &order_by,
-                 const std::vector<Symbol> &output_symbols)
-    : input_(input), output_symbols_(output_symbols) {
+                 const std::vector<Symbol> &output_symbols, Expression *skip, Expression *limit)
+    : input_(input), output_symbols_(output_symbols), skip_(skip), limit_(limit) {
   // split the order_by vector into two vectors of orderings and expressions
   std::vector<Ordering> ordering;
   ordering.reserve(order_by.size());
@@ -3908,6 +5383,12 @@ class OrderByCursor : public Cursor {
       ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                     storage::View::OLD);
       auto *mem = cache_.get_allocator().GetMemoryResource();
+      // With a known limit `cache_` is a heap of the best `top_k` rows so far,
+      // with the worst of them on top.
+      const auto top_k = EvaluateTopK(&evaluator);
+      const auto by_order = [this](const auto &elem1, const auto &elem2) {
+        return self_.compare_(elem1.order_by, elem2.order_by);
+      };
       while (input_cursor_->Pull(frame, context)) {
         // collect the order_by elements
         utils::pmr::vector<TypedValue> order_by(mem);
@@ -3916,34 +5397,62 @@ class OrderByCursor : public Cursor {
           order_by.emplace_back(expression_ptr->Accept(evaluator));
         }
 
+        if (top_k && cache_.size() == *top_k) {
+          if (*top_k == 0 || !self_.compare_(order_by, cache_.front().order_by)) continue;
+          std::pop_heap(cache_.begin(), cache_.end(), by_order);
+          cache_.pop_back();
+        }
+
         // collect the output elements
         utils::pmr::vector<TypedValue> output(mem);
         output.reserve(self_.output_symbols_.size());
         for (const Symbol &output_sym : self_.output_symbols_) output.emplace_back(frame[output_sym]);
 
         cache_.push_back(Element{std::move(order_by), std::move(output)});
+        if (top_k) {
+          std::push_heap(cache_.begin(), cache_.end(), by_order);
+        } else if (cache_.size() >= FLAGS_query_order_by_spill_rows && !spill_disabled_) {
+          Spill();
+        }
       }
 
-      std::sort(cache_.begin(), cache_.end(), [this](const auto &pair1, const auto &pair2) {
-        return self_.compare_(pair1.order_by, pair2.order_by);
-      });
+      if (top_k) {
+        std::sort_heap(cache_.begin(), cache_.end(), by_order);
+      } else {
+        std::sort(cache_.begin(), cache_.end(), by_order);
+      }
+      for (auto &run : runs_) run.head = ReadElement(run.file.get(), context.db_accessor);
 
       did_pull_all_ = true;
       cache_it_ = cache_.begin();
     }
 
-    if (cache_it_ == cache_.end()) return false;
-
     if (MustAbort(context)) throw HintedAbortError();
 
+    // Take the smallest of the in-memory rows and the heads of the spilled
+    // runs.
+    const Element *next = cache_it_ == cache_.end() ? nullptr : &*cache_it_;
+    SpillRun *next_run = nullptr;
+    for (auto &run : runs_) {
+      if (run.head && (!next || self_.compare_(run.head->order_by, next->order_by))) {
+        next = &*run.head;
+        next_run = &run;
+      }
+    }
+    if (!next) return false;
+
     // place the output values on the frame
-    DMG_ASSERT(self_.output_symbols_.size() == cache_it_->remember.size(),
+    DMG_ASSERT(self_.output_symbols_.size() == next->remember.size(),
                "Number of values does not match the number of output symbols "
                "in OrderBy");
     auto output_sym_it = self_.output_symbols_.begin();
-    for (const TypedValue &output : cache_it_->remember) frame[*output_sym_it++] = output;
+    for (const TypedValue &output : next->remember) frame[*output_sym_it++] = output;
 
-    cache_it_++;
+    if (next_run) {
+      next_run->head = ReadElement(next_run->file.get(), context.db_accessor);
+    } else {
+      cache_it_++;
+    }
     return true;
   }
   void Shutdown() override { input_cursor_->Shutdown(); }
@@ -3953,6 +5462,8 @@ class OrderByCursor : public Cursor {
     did_pull_all_ = false;
     cache_.clear();
     cache_it_ = cache_.begin();
+    runs_.clear();
+    spill_disabled_ = false;
   }
 
  private:
@@ -3961,6 +5472,67 @@ class OrderByCursor : public Cursor {
     utils::pmr::vector<TypedValue> remember;
   };
 
+  // A sorted part of the input written to a temporary file. Every row is
+  // stored as a pair of the order_by and the remember values.
+  struct SpillRun {
+    SpillFile file{nullptr, &std::fclose};
+    std::optional<Element> head;
+  };
+
+  // Returns the number of rows which are returned after the sort, if it's
+  // limited.
+  std::optional<size_t> EvaluateTopK(ExpressionEvaluator *evaluator) const {
+    if (!self_.limit_) return std::nullopt;
+    // Invalid values are reported by Skip and Limit, so here they just
+    // disable the optimization.
+    auto evaluate = [evaluator](Expression *expression) -> std::optional<int64_t> {
+      try {
+        auto value = expression->Accept(*evaluator);
+        if (value.IsInt() && value.ValueInt() >= 0) return value.ValueInt();
+      } catch (const QueryRuntimeException &) {
+      }
+      return std::nullopt;
+    };
+    auto limit = evaluate(self_.limit_);
+    auto skip = self_.skip_ ? evaluate(self_.skip_) : std::make_optional<int64_t>(0);
+    if (!limit || !skip) return std::nullopt;
+    // Such a limit can't be reached anyway, so the input is just sorted.
+    if (*limit > std::numeric_limits<int64_t>::max() - *skip) return std::nullopt;
+    return *limit + *skip;
+  }
+
+  // Sorts the rows in `cache_` and moves them to a new spill run. Spilling is
+  // disabled for good if some row can't be written.
+  void Spill() {
+    const auto spillable = std::all_of(cache_.begin(), cache_.end(), [](const auto &elem) {
+      return AreSpillable(elem.order_by) && AreSpillable(elem.remember);
+    });
+    SpillRun run;
+    if (spillable) run.file = MakeSpillFile();
+    if (!run.file) {
+      spill_disabled_ = true;
+      return;
+    }
+    std::sort(cache_.begin(), cache_.end(),
+              [this](const auto &elem1, const auto &elem2) { return self_.compare_(elem1.order_by, elem2.order_by); });
+    for (const auto &elem : cache_) {
+      WriteSpilledRow(run.file.get(), nlohmann::json::array({SpillValues(elem.order_by), SpillValues(elem.remember)}));
+    }
+    std::rewind(run.file.get());
+    runs_.push_back(std::move(run));
+    cache_.clear();
+  }
+
+  std::optional<Element> ReadElement(std::FILE *file, DbAccessor *dba) {
+    const auto row = ReadSpilledRow(file);
+    if (!row) return std::nullopt;
+    auto *mem = cache_.get_allocator().GetMemoryResource();
+    Element elem{utils::pmr::vector<TypedValue>(mem), utils::pmr::vector<TypedValue>(mem)};
+    UnspillValues((*row)[0], dba, &elem.order_by);
+    UnspillValues((*row)[1], dba, &elem.remember);
+    return elem;
+  }
+
   const OrderBy &self_;
   const UniqueCursorPtr input_cursor_;
   bool did_pull_all_{false};
@@ -3969,6 +5541,9 @@ class OrderByCursor : public Cursor {
   utils::pmr::vector<Element> cache_;
   // iterator over the cache_, maintains state between Pulls
   decltype(cache_.begin()) cache_it_ = cache_.begin();
+  // sorted runs which didn't fit into memory, merged with `cache_` on Pull
+  std::vector<SpillRun> runs_;
+  bool spill_disabled_{false};
 };
 
 UniqueCursorPtr OrderBy::MakeCursor(utils::MemoryResource *mem) const {
@@ -4207,29 +5782,240 @@ UniqueCursorPtr Unwind::MakeCursor(utils::MemoryResource *mem) const {
 class DistinctCursor : public Cursor {
  public:
   DistinctCursor(const Distinct &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self.input_->MakeCursor(mem)), seen_rows_(mem) {}
+      : self_(self), input_cursor_(self.input_->MakeCursor(mem)), seen_rows_(mem), visited_(mem) {}
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
     SCOPED_PROFILE_OP("Distinct");
 
-    while (true) {
-      if (!input_cursor_->Pull(frame, context)) return false;
+    CheckEndpointExpand(context);
+    while (!pulled_all_input_) {
+      const bool pulled = endpoint_expand_ ? PullEndpoint(frame, context) : input_cursor_->Pull(frame, context);
+      if (!pulled) {
+        pulled_all_input_ = true;
+        if (!partitions_.empty()) {
+          // Rows kept in memory can't be equal to the written ones.
+          seen_rows_.clear();
+          for (auto &partition : partitions_) std::rewind(partition.get());
+        }
+        break;
+      }
 
       utils::pmr::vector<TypedValue> row(seen_rows_.get_allocator().GetMemoryResource());
       row.reserve(self_.value_symbols_.size());
       for (const auto &symbol : self_.value_symbols_) row.emplace_back(frame[symbol]);
-      if (seen_rows_.insert(std::move(row)).second) return true;
+      // Once spilling, new rows are deduplicated when their partition is read.
+      if (!partitions_.empty() && AreSpillable(row)) {
+        WriteSpilledRow(partitions_[Partition(row)].get(), nlohmann::json::array({false, SpillValues(row)}));
+        continue;
+      }
+      if (seen_rows_.insert(std::move(row)).second) {
+        if (partitions_.empty() && !spill_disabled_ &&
+            ShouldSpill(seen_rows_.size(), context)) {
+          SpillRows();
+        }
+        return true;
+      }
     }
+
+    return PullSpilled(frame, context);
   }
 
-  void Shutdown() override { input_cursor_->Shutdown(); }
+  void Shutdown() override {
+    input_cursor_->Shutdown();
+    if (endpoint_input_cursor_) endpoint_input_cursor_->Shutdown();
+  }
 
   void Reset() override {
     input_cursor_->Reset();
+    if (endpoint_input_cursor_) endpoint_input_cursor_->Reset();
     seen_rows_.clear();
+    pulled_all_input_ = false;
+    partitions_.clear();
+    next_partition_ = 0;
+    spill_disabled_ = false;
+    visited_.clear();
+    endpoints_.clear();
+    next_endpoint_ = 0;
   }
 
  private:
+  /**
+   * Decides, on the first pull, whether the input is a Produce which only
+   * renames the node at the end of an Expand and symbols bound before it,
+   * possibly with Filters in between, e.g. in
+   * `MATCH (a)-->(b)-->(c) RETURN DISTINCT a, c`. The Expand and the Produce
+   * then aren't executed: for every row of the Expand's input the vertices at
+   * the ends of the expanded edges are visited directly, and only once for
+   * rows with the same key (the values of the symbols the Produce and the
+   * Filters use, and the expanded vertex), since they lead to the same
+   * results.
+   */
+  void CheckEndpointExpand(const ExecutionContext &context) {
+    if (endpoint_checked_) return;
+    endpoint_checked_ = true;
+    if (!FLAGS_query_factorize_expand || context.addition || context.is_profile_query || context.morsel_symbol ||
+        !utils::IsSubtype(*self_.input_, Produce::kType)) {
+      return;
+    }
+    const auto &produce = static_cast<const Produce &>(*self_.input_);
+    std::vector<Symbol> outputs;
+    std::vector<Symbol> sources;
+    for (const auto *named_expression : produce.named_expressions_) {
+      const auto *identifier = utils::Downcast<Identifier>(named_expression->expression_);
+      if (!identifier) return;
+      outputs.push_back(context.symbol_table.at(*named_expression));
+      sources.push_back(context.symbol_table.at(*identifier));
+    }
+    for (const auto &symbol : self_.value_symbols_) {
+      if (std::find(outputs.begin(), outputs.end(), symbol) == outputs.end()) return;
+    }
+    std::vector<const Filter *> filters;
+    const auto *op = produce.input().get();
+    std::vector<Expression *> filter_expressions;
+    while (utils::IsSubtype(*op, Filter::kType)) {
+      filters.push_back(static_cast<const Filter *>(op));
+      filter_expressions.push_back(filters.back()->expression_);
+      op = op->input().get();
+    }
+    auto used = UsedSymbols(filter_expressions, context.symbol_table);
+    used.insert(sources.begin(), sources.end());
+    endpoint_expand_ = FindFactorizedExpand(*op, used, true);
+    if (!endpoint_expand_) return;
+    used.erase(endpoint_expand_->expand->common_.node_symbol);
+    key_symbols_.assign(used.begin(), used.end());
+    output_symbols_ = std::move(outputs);
+    source_symbols_ = std::move(sources);
+    filters_ = std::move(filters);
+    endpoint_input_cursor_ =
+        endpoint_expand_->expand->input()->MakeCursor(seen_rows_.get_allocator().GetMemoryResource());
+  }
+
+  /**
+   * Places the next row of the Produce on the frame, expanding the rows of
+   * the Expand's input when all visited vertices have been returned. Returns
+   * false once the input is exhausted.
+   */
+  bool PullEndpoint(Frame &frame, ExecutionContext &context) {
+    const auto &node_symbol = endpoint_expand_->expand->common_.node_symbol;
+    // Like all filters, newly set values should not affect filtering of old
+    // nodes and edges.
+    ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                  storage::View::OLD);
+    while (true) {
+      while (next_endpoint_ < endpoints_.size()) {
+        frame[node_symbol] = endpoints_[next_endpoint_++];
+        if (std::all_of(filters_.begin(), filters_.end(),
+                        [&](const auto *filter) { return EvaluateFilter(evaluator, filter->expression_); })) {
+          for (size_t i = 0; i < output_symbols_.size(); ++i) frame[output_symbols_[i]] = frame[source_symbols_[i]];
+          return true;
+        }
+      }
+      endpoints_.clear();
+      next_endpoint_ = 0;
+      if (!endpoint_input_cursor_->Pull(frame, context)) return false;
+      VisitEndpoints(frame, context);
+    }
+  }
+
+  /**
+   * Fills `endpoints_` with the vertices at the ends of the edges the Expand
+   * pulls for the input row, leaving out the ones already visited for a row
+   * with the same key. Rows with the same key differ only in the edges the
+   * EdgeUniquenessFilter drops, so for every key only the edges dropped on
+   * all the visits so far are kept and a later visit returns the ends of the
+   * ones it doesn't drop.
+   */
+  void VisitEndpoints(const Frame &frame, const ExecutionContext &context) {
+    const auto &expand = *endpoint_expand_->expand;
+    const auto &vertex_value = frame[expand.input_symbol_];
+    // Null due to a failed optional match, the Expand skips it.
+    if (vertex_value.IsNull()) return;
+    ExpectType(expand.input_symbol_, vertex_value, TypedValue::Type::Vertex);
+    const auto &vertex = vertex_value.ValueVertex();
+    if (!CollectExcludedEdges(*endpoint_expand_, frame, vertex, &excluded_edges_)) return;
+    auto is_excluded = [this](const EdgeAccessor &edge) {
+      return std::find(excluded_edges_.begin(), excluded_edges_.end(), edge) != excluded_edges_.end();
+    };
+
+    utils::pmr::vector<TypedValue> key(visited_.get_allocator().GetMemoryResource());
+    key.reserve(key_symbols_.size() + 1);
+    for (const auto &symbol : key_symbols_) key.emplace_back(frame[symbol]);
+    key.emplace_back(vertex_value);
+    // Forgetting the visits only costs expanding the vertices again.
+    if (ShouldSpill(visited_.size(), context)) visited_.clear();
+    auto [it, inserted] = visited_.try_emplace(std::move(key));
+    auto &still_excluded = it->second;
+    if (inserted) {
+      ForEachExpandedEdge(expand, vertex, [&](const auto &edge, const auto &end) {
+        if (!is_excluded(edge)) endpoints_.push_back(end);
+      });
+      still_excluded = excluded_edges_;
+      return;
+    }
+    std::vector<EdgeAccessor> excluded;
+    for (const auto &edge : still_excluded) {
+      if (is_excluded(edge)) {
+        excluded.push_back(edge);
+      } else {
+        endpoints_.push_back(ExpandedVertex(expand, edge, vertex));
+      }
+    }
+    still_excluded = std::move(excluded);
+  }
+
+  size_t Partition(const utils::pmr::vector<TypedValue> &row) const {
+    return seen_rows_.hash_function()(row) % kSpillPartitions;
+  }
+
+  /**
+   * Moves the seen rows to `kSpillPartitions` temporary files, chosen by the
+   * hash of the row, marking them as already returned. All further rows are
+   * appended to the partitions instead of being checked in memory. Rows which
+   * can't be written stay in `seen_rows_`.
+   */
+  void SpillRows() {
+    for (size_t i = 0; i < kSpillPartitions; ++i) {
+      auto file = MakeSpillFile();
+      if (!file) {
+        partitions_.clear();
+        spill_disabled_ = true;
+        return;
+      }
+      partitions_.push_back(std::move(file));
+    }
+    for (auto it = seen_rows_.begin(); it != seen_rows_.end();) {
+      if (!AreSpillable(*it)) {
+        ++it;
+        continue;
+      }
+      WriteSpilledRow(partitions_[Partition(*it)].get(), nlohmann::json::array({true, SpillValues(*it)}));
+      it = seen_rows_.erase(it);
+    }
+  }
+
+  /**
+   * Reads the partitions one after another, returning the rows which weren't
+   * returned before spilling and which aren't duplicates within the
+   * partition. Already returned rows precede the others in each file.
+   */
+  bool PullSpilled(Frame &frame, ExecutionContext &context) {
+    while (next_partition_ < partitions_.size()) {
+      const auto spilled = ReadSpilledRow(partitions_[next_partition_].get());
+      if (!spilled) {
+        partitions_[next_partition_++].reset();
+        seen_rows_.clear();
+        continue;
+      }
+      utils::pmr::vector<TypedValue> row(seen_rows_.get_allocator().GetMemoryResource());
+      UnspillValues((*spilled)[1], context.db_accessor, &row);
+      auto [it, inserted] = seen_rows_.insert(std::move(row));
+      if (!inserted || (*spilled)[0].get<bool>()) continue;
+      for (size_t i = 0; i < self_.value_symbols_.size(); ++i) frame[self_.value_symbols_[i]] = (*it)[i];
+      return true;
+    }
+    return false;
+  }
+
   const Distinct &self_;
   const UniqueCursorPtr input_cursor_;
   // a set of already seen rows
@@ -4239,6 +6025,32 @@ class DistinctCursor : public Cursor {
                             utils::FnvCollection<utils::pmr::vector<TypedValue>, TypedValue, TypedValue::Hash>,
                             TypedValueVectorEqual>
       seen_rows_;
+  bool pulled_all_input_{false};
+  // spilled rows, divided by their hash
+  std::vector<SpillFile> partitions_;
+  size_t next_partition_{0};
+  bool spill_disabled_{false};
+  // the Expand under the input Produce if only the vertices at the ends of its
+  // edges are visited, see `CheckEndpointExpand`
+  std::optional<FactorizedExpand> endpoint_expand_;
+  bool endpoint_checked_{false};
+  // pulls the input of `endpoint_expand_`
+  UniqueCursorPtr endpoint_input_cursor_;
+  std::vector<const Filter *> filters_;
+  // the Produce's symbols and the symbols it renames
+  std::vector<Symbol> output_symbols_;
+  std::vector<Symbol> source_symbols_;
+  // symbols bound before the Expand which the Produce and the Filters use
+  std::vector<Symbol> key_symbols_;
+  // for every visited key, the edges which weren't expanded on any visit
+  utils::pmr::unordered_map<utils::pmr::vector<TypedValue>, std::vector<EdgeAccessor>,
+                            utils::FnvCollection<utils::pmr::vector<TypedValue>, TypedValue, TypedValue::Hash>,
+                            TypedValueVectorEqual>
+      visited_;
+  // vertices of the current input row which are left to return
+  std::vector<VertexAccessor> endpoints_;
+  size_t next_endpoint_{0};
+  std::vector<EdgeAccessor> excluded_edges_;
 };
 
 Distinct::Distinct(const std::shared_ptr<LogicalOperator> &input, const std::vector<Symbol> &value_symbols)
@@ -4433,6 +6245,148 @@ UniqueCursorPtr Cartesian::MakeCursor(utils::MemoryResource *mem) const {
   return MakeUniqueCursorPtr<CartesianCursor>(mem, *this, mem);
 }
 
+std::vector<Symbol> HashJoin::ModifiedSymbols(const SymbolTable &table) const {
+  auto symbols = left_op_->ModifiedSymbols(table);
+  auto right = right_op_->ModifiedSymbols(table);
+  symbols.insert(symbols.end(), right.begin(), right.end());
+  return symbols;
+}
+
+bool HashJoin::Accept(HierarchicalLogicalOperatorVisitor &visitor) {
+  if (visitor.PreVisit(*this)) {
+    left_op_->Accept(visitor) && right_op_->Accept(visitor);
+  }
+  return visitor.PostVisit(*this);
+}
+
+WITHOUT_SINGLE_INPUT(HashJoin);
+
+namespace {
+
+class HashJoinCursor : public Cursor {
+ public:
+  HashJoinCursor(const HashJoin &self, utils::MemoryResource *mem)
+      : self_(self),
+        left_op_cursor_(self.left_op_->MakeCursor(mem)),
+        right_op_cursor_(self_.right_op_->MakeCursor(mem)),
+        hash_table_(mem),
+        probe_key_(mem) {
+    MG_ASSERT(left_op_cursor_ != nullptr, "HashJoinCursor: Missing left operator cursor.");
+    MG_ASSERT(right_op_cursor_ != nullptr, "HashJoinCursor: Missing right operator cursor.");
+  }
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("HashJoin");
+
+    ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                  storage::View::OLD);
+    if (!build_done_) {
+      Build(frame, context, &evaluator);
+      build_done_ = true;
+    }
+    if (hash_table_.empty()) return false;
+
+    while (!matches_ || matches_it_ == matches_->end()) {
+      if (!left_op_cursor_->Pull(frame, context)) return false;
+      if (MustAbort(context)) throw HintedAbortError();
+      matches_ = nullptr;
+      if (!EvaluateKey(self_.left_keys_, &evaluator, &probe_key_)) continue;
+      auto found = hash_table_.find(probe_key_);
+      if (found == hash_table_.end()) continue;
+      matches_ = &found->second;
+      matches_it_ = matches_->begin();
+    }
+
+    const auto &right_row = *matches_it_++;
+    for (size_t i = 0; i < self_.right_symbols_.size(); ++i) {
+      frame[self_.right_symbols_[i]] = right_row[i];
+    }
+    return true;
+  }
+
+  void Shutdown() override {
+    left_op_cursor_->Shutdown();
+    right_op_cursor_->Shutdown();
+  }
+
+  void Reset() override {
+    left_op_cursor_->Reset();
+    right_op_cursor_->Reset();
+    hash_table_.clear();
+    matches_ = nullptr;
+    build_done_ = false;
+  }
+
+ private:
+  using RowList = utils::pmr::vector<utils::pmr::vector<TypedValue>>;
+
+  // Pulls the whole right branch and stores its rows by their keys.
+  void Build(Frame &frame, ExecutionContext &context, ExpressionEvaluator *evaluator) {
+    auto *mem = hash_table_.get_allocator().GetMemoryResource();
+    utils::pmr::vector<TypedValue> key(mem);
+    while (right_op_cursor_->Pull(frame, context)) {
+      if (MustAbort(context)) throw HintedAbortError();
+      if (!EvaluateKey(self_.right_keys_, evaluator, &key)) continue;
+      utils::pmr::vector<TypedValue> row(mem);
+      row.reserve(self_.right_symbols_.size());
+      for (const auto &symbol : self_.right_symbols_) row.emplace_back(frame[symbol]);
+      auto [it, inserted] = hash_table_.try_emplace(key, RowList(mem));
+      it->second.emplace_back(std::move(row));
+    }
+  }
+
+  // Evaluates the keys into `key`. Returns false if any of them is or
+  // contains Null, because `=` never evaluates to true for such a value while
+  // `TypedValue::BoolEqual` would consider two Nulls equal.
+  static bool EvaluateKey(const std::vector<Expression *> &keys, ExpressionEvaluator *evaluator,
+                          utils::pmr::vector<TypedValue> *key) {
+    key->clear();
+    for (auto *expression : keys) {
+      key->emplace_back(expression->Accept(*evaluator));
+      if (ContainsNull(key->back())) return false;
+    }
+    return true;
+  }
+
+  static bool ContainsNull(const TypedValue &value) {
+    switch (value.type()) {
+      case TypedValue::Type::Null:
+        return true;
+      case TypedValue::Type::List:
+        return std::any_of(value.ValueList().begin(), value.ValueList().end(), ContainsNull);
+      case TypedValue::Type::Map:
+        return std::any_of(value.ValueMap().begin(), value.ValueMap().end(),
+                           [](const auto &entry) { return ContainsNull(entry.second); });
+      default:
+        return false;
+    }
+  }
+
+  const HashJoin &self_;
+  const UniqueCursorPtr left_op_cursor_;
+  const UniqueCursorPtr right_op_cursor_;
+  // Rows of the right branch (values of the right symbols) by their keys.
+  utils::pmr::unordered_map<utils::pmr::vector<TypedValue>, RowList,
+                            // use FNV collection hashing specialized for a
+                            // vector of TypedValue
+                            utils::FnvCollection<utils::pmr::vector<TypedValue>, TypedValue, TypedValue::Hash>,
+                            TypedValueVectorEqual>
+      hash_table_;
+  utils::pmr::vector<TypedValue> probe_key_;
+  // Right rows matching the last pulled left row.
+  const RowList *matches_{nullptr};
+  RowList::const_iterator matches_it_;
+  bool build_done_{false};
+};
+
+}  // namespace
+
+UniqueCursorPtr HashJoin::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::HashJoinOperator);
+
+  return MakeUniqueCursorPtr<HashJoinCursor>(mem, *this, mem);
+}
+
 OutputTable::OutputTable(std::vector<Symbol> output_symbols, std::vector<std::vector<TypedValue>> rows)
     : output_symbols_(std::move(output_symbols)), callback_([rows](Frame *, ExecutionContext *) { return rows; }) {}
 
@@ -18,6 +18,7 @@
 #include "query/common.hpp"
 #include "query/frontend/ast/ast.hpp"
 #include "query/frontend/semantic/symbol.hpp"
+#include "query/interpret/compiled_expression.hpp"
 #include "query/typed_value.hpp"
 #include "storage/v2/id_types.hpp"
 #include "utils/bound.hpp"
@@ -117,6 +118,7 @@ class Unwind;
 class Distinct;
 class Union;
 class Cartesian;
+class HashJoin;
 class CallProcedure;
 class LoadCsv;
 
@@ -127,7 +129,7 @@ using LogicalOperatorCompositeVisitor = ::utils::CompositeVisitor<
     ConstructNamedPath, Filter, Produce, Delete, SetProperty, SetProperties,
     SetLabels, RemoveProperty, RemoveLabels, EdgeUniquenessFilter, Accumulate,
     Aggregate, Skip, Limit, OrderBy, Merge, Optional, Unwind, Distinct, Union,
-    Cartesian, CallProcedure, LoadCsv>;
+    Cartesian, HashJoin, CallProcedure, LoadCsv>;
 
 using LogicalOperatorLeafVisitor = ::utils::LeafVisitor<Once>;
 
@@ -1127,6 +1129,8 @@ private:
     std::list<TypedValue> history_add_;
     history_delta::historyContext historyContext_;
     int count;
+    bool compiled_checked_{false};
+    std::optional<CompiledExpressionEvaluator> compiled_;
   };
 };
 
@@ -1185,6 +1189,9 @@ private:
   private:
     const Produce &self_;
     const UniqueCursorPtr input_cursor_;
+    bool compiled_checked_{false};
+    // compiled named expressions, empty if none could be compiled
+    std::vector<std::optional<CompiledExpressionEvaluator>> compiled_;
   };
 };
 
@@ -1822,6 +1829,10 @@ private:
 /// For each row an arbitrary number of Frame elements can be
 /// remembered. Only these elements (defined by their Symbols)
 /// are valid for usage after the OrderBy operator.
+///
+/// If the sorted rows are followed by SKIP and LIMIT, their expressions
+/// are also given. Only the first skip + limit rows are then kept while
+/// pulling the input instead of sorting all of them.
 class OrderBy : public query::plan::LogicalOperator {
 public:
   static const utils::TypeInfo kType;
@@ -1831,7 +1842,8 @@ public:
 
   OrderBy(const std::shared_ptr<LogicalOperator> &input,
           const std::vector<SortItem> &order_by,
-          const std::vector<Symbol> &output_symbols);
+          const std::vector<Symbol> &output_symbols,
+          Expression *skip = nullptr, Expression *limit = nullptr);
   bool Accept(HierarchicalLogicalOperatorVisitor &visitor) override;
   UniqueCursorPtr MakeCursor(utils::MemoryResource *) const override;
   std::vector<Symbol> OutputSymbols(const SymbolTable &) const override;
@@ -1847,6 +1859,8 @@ public:
   TypedValueVectorCompare compare_;
   std::vector<Expression *> order_by_;
   std::vector<Symbol> output_symbols_;
+  Expression *skip_{nullptr};
+  Expression *limit_{nullptr};
 
   std::unique_ptr<LogicalOperator> Clone(AstStorage *storage) const override {
     auto object = std::make_unique<OrderBy>();
@@ -1858,6 +1872,8 @@ public:
           order_by_[i5] ? order_by_[i5]->Clone(storage) : nullptr;
     }
     object->output_symbols_ = output_symbols_;
+    object->skip_ = skip_ ? skip_->Clone(storage) : nullptr;
+    object->limit_ = limit_ ? limit_->Clone(storage) : nullptr;
     return object;
   }
 };
@@ -2159,6 +2175,67 @@ public:
   }
 };
 
+/// Operator for joining 2 input branches on equal key values.
+///
+/// On the first Pull all the rows of the right branch are pulled and stored
+/// in a hash table by the values of `right_keys`. Then the rows of the left
+/// branch are pulled one by one and every left row is combined with the
+/// stored right rows whose keys are equal to the values of `left_keys`.
+/// Rows with a Null key never match, the same as with the `=` operator.
+///
+/// The right branch must not depend on the symbols of the left branch,
+/// because it is pulled only once.
+class HashJoin : public query::plan::LogicalOperator {
+public:
+  static const utils::TypeInfo kType;
+  const utils::TypeInfo &GetTypeInfo() const override { return kType; }
+
+  HashJoin() {}
+  HashJoin(const std::shared_ptr<LogicalOperator> &left_op,
+           const std::vector<Symbol> &left_symbols,
+           const std::shared_ptr<LogicalOperator> &right_op,
+           const std::vector<Symbol> &right_symbols,
+           const std::vector<Expression *> &left_keys,
+           const std::vector<Expression *> &right_keys)
+      : left_op_(left_op), left_symbols_(left_symbols), right_op_(right_op),
+        right_symbols_(right_symbols), left_keys_(left_keys),
+        right_keys_(right_keys) {}
+
+  bool Accept(HierarchicalLogicalOperatorVisitor &visitor) override;
+  UniqueCursorPtr MakeCursor(utils::MemoryResource *) const override;
+  std::vector<Symbol> ModifiedSymbols(const SymbolTable &) const override;
+
+  bool HasSingleInput() const override;
+  std::shared_ptr<LogicalOperator> input() const override;
+  void set_input(std::shared_ptr<LogicalOperator>) override;
+
+  std::shared_ptr<query::plan::LogicalOperator> left_op_;
+  std::vector<Symbol> left_symbols_;
+  std::shared_ptr<query::plan::LogicalOperator> right_op_;
+  std::vector<Symbol> right_symbols_;
+  std::vector<Expression *> left_keys_;
+  std::vector<Expression *> right_keys_;
+
+  std::unique_ptr<LogicalOperator> Clone(AstStorage *storage) const override {
+    auto object = std::make_unique<HashJoin>();
+    object->left_op_ = left_op_ ? left_op_->Clone(storage) : nullptr;
+    object->left_symbols_ = left_symbols_;
+    object->right_op_ = right_op_ ? right_op_->Clone(storage) : nullptr;
+    object->right_symbols_ = right_symbols_;
+    object->left_keys_.resize(left_keys_.size());
+    for (auto i6 = 0; i6 < left_keys_.size(); ++i6) {
+      object->left_keys_[i6] =
+          left_keys_[i6] ? left_keys_[i6]->Clone(storage) : nullptr;
+    }
+    object->right_keys_.resize(right_keys_.size());
+    for (auto i7 = 0; i7 < right_keys_.size(); ++i7) {
+      object->right_keys_[i7] =
+          right_keys_[i7] ? right_keys_[i7]->Clone(storage) : nullptr;
+    }
+    return object;
+  }
+};
+
 /// An operator that outputs a table, producing a single row on each pull
 class OutputTable : public query::plan::LogicalOperator {
 public:
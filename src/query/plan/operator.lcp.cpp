@@ -129,6 +129,9 @@ const utils::TypeInfo query::plan::Union::kType{
 const utils::TypeInfo query::plan::Cartesian::kType{
     0x8A485EE72E6BEEC6ULL, "Cartesian", &query::plan::LogicalOperator::kType};
 
+const utils::TypeInfo query::plan::HashJoin::kType{
+    0x3E0F1D5C9B7A2486ULL, "HashJoin", &query::plan::LogicalOperator::kType};
+
 const utils::TypeInfo query::plan::OutputTable::kType{
     0x8F61EADFF2A5A29FULL, "OutputTable", &query::plan::LogicalOperator::kType};
 
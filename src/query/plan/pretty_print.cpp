@@ -241,6 +241,19 @@ bool PlanPrinter::PreVisit(query::plan::Cartesian &op) {
   return false;
 }
 
+bool PlanPrinter::PreVisit(query::plan::HashJoin &op) {
+  WithPrintLn([&op](auto &out) {
+    out << "* HashJoin {";
+    utils::PrintIterable(out, op.left_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
+    out << " : ";
+    utils::PrintIterable(out, op.right_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
+    out << "}";
+  });
+  Branch(*op.right_op_);
+  op.left_op_->Accept(*this);
+  return false;
+}
+
 #undef PRE_VISIT
 
 bool PlanPrinter::DefaultPreVisit() {
@@ -884,6 +897,24 @@ bool PlanToJsonVisitor::PreVisit(Cartesian &op) {
   return false;
 }
 
+bool PlanToJsonVisitor::PreVisit(HashJoin &op) {
+  json self;
+  self["name"] = "HashJoin";
+  self["left_symbols"] = ToJson(op.left_symbols_);
+  self["right_symbols"] = ToJson(op.right_symbols_);
+  self["left_keys"] = ToJson(op.left_keys_);
+  self["right_keys"] = ToJson(op.right_keys_);
+
+  op.left_op_->Accept(*this);
+  self["left_op"] = PopOutput();
+
+  op.right_op_->Accept(*this);
+  self["right_op"] = PopOutput();
+
+  output_ = std::move(self);
+  return false;
+}
+
 }  // namespace impl
 
 }  // namespace query::plan
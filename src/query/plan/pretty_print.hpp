@@ -80,6 +80,7 @@ class PlanPrinter : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(Merge &) override;
   bool PreVisit(Optional &) override;
   bool PreVisit(Cartesian &) override;
+  bool PreVisit(HashJoin &) override;
 
   bool PreVisit(Produce &) override;
   bool PreVisit(Accumulate &) override;
@@ -187,6 +188,7 @@ class PlanToJsonVisitor : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(Filter &) override;
   bool PreVisit(EdgeUniquenessFilter &) override;
   bool PreVisit(Cartesian &) override;
+  bool PreVisit(HashJoin &) override;
 
   bool PreVisit(ScanAll &) override;
   bool PreVisit(ScanAllByLabel &) override;
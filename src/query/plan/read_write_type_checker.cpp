@@ -54,6 +54,12 @@ bool ReadWriteTypeChecker::PreVisit(Cartesian &op) {
   return false;
 }
 
+bool ReadWriteTypeChecker::PreVisit(HashJoin &op) {
+  op.left_op_->Accept(*this);
+  op.right_op_->Accept(*this);
+  return false;
+}
+
 PRE_VISIT(Produce, RWType::NONE, true)
 PRE_VISIT(Accumulate, RWType::NONE, true)
 PRE_VISIT(Aggregate, RWType::NONE, true)
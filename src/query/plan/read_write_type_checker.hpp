@@ -72,6 +72,7 @@ class ReadWriteTypeChecker : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(Merge &) override;
   bool PreVisit(Optional &) override;
   bool PreVisit(Cartesian &) override;
+  bool PreVisit(HashJoin &) override;
 
   bool PreVisit(Produce &) override;
   bool PreVisit(Accumulate &) override;
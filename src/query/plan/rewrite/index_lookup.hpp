@@ -17,6 +17,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -203,6 +204,20 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     return true;
   }
 
+  // The join filters are moved into HashJoin, so both branches are rewritten
+  // on their own just like with Cartesian.
+  bool PreVisit(HashJoin &op) override {
+    prev_ops_.push_back(&op);
+    RewriteBranch(&op.left_op_);
+    RewriteBranch(&op.right_op_);
+    return false;
+  }
+
+  bool PostVisit(HashJoin &) override {
+    prev_ops_.pop_back();
+    return true;
+  }
+
   bool PreVisit(Union &op) override {
     prev_ops_.push_back(&op);
     RewriteBranch(&op.left_op_);
@@ -491,8 +506,42 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     return best_label;
   }
 
-  // Finds the label-property combination which has indexed the lowest amount of
-  // vertices. If the index cannot be found, nullopt is returned.
+  // Estimates the number of vertices which the lookup by the filter yields from
+  // the statistics collected by ANALYZE GRAPH. Without them, or when the
+  // filter values aren't known while planning, `vertex_count` (the number of
+  // vertices in the index) is returned.
+  int64_t EstimateIndexLookup(storage::LabelId label, storage::PropertyId property, const PropertyFilter &filter,
+                              int64_t vertex_count) {
+    const auto &statistics = db_->GetPropertyStatistics(label, property);
+    if (!statistics) return vertex_count;
+    auto to_bound = [](const auto &bound) -> std::optional<utils::Bound<storage::PropertyValue>> {
+      if (!bound) return std::nullopt;
+      auto *literal = utils::Downcast<PrimitiveLiteral>(bound->value());
+      if (!literal) return std::nullopt;
+      return utils::Bound<storage::PropertyValue>(literal->value_, bound->type());
+    };
+    std::optional<double> estimate;
+    switch (filter.type_) {
+      case PropertyFilter::Type::EQUAL:
+        estimate = statistics->EstimateEqual();
+        break;
+      case PropertyFilter::Type::IN:
+        if (auto *list = utils::Downcast<ListLiteral>(filter.value_)) {
+          estimate = statistics->EstimateEqual() * static_cast<double>(list->elements_.size());
+        }
+        break;
+      case PropertyFilter::Type::RANGE:
+        estimate = statistics->EstimateRange(to_bound(filter.lower_bound_), to_bound(filter.upper_bound_));
+        break;
+      default:
+        break;
+    }
+    if (!estimate) return vertex_count;
+    return std::min(vertex_count, static_cast<int64_t>(std::ceil(*estimate)));
+  }
+
+  // Finds the label-property combination whose lookup yields the lowest amount
+  // of vertices. If the index cannot be found, nullopt is returned.
   std::optional<LabelPropertyIndex> FindBestLabelPropertyIndex(const Symbol &symbol,
                                                                const std::unordered_set<Symbol> &bound_symbols) {
     auto are_bound = [&bound_symbols](const auto &used_symbols) {
@@ -517,7 +566,9 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
         if (!db_->LabelPropertyIndexExists(GetLabel(label), GetProperty(property))) {
           continue;
         }
-        int64_t vertex_count = db_->VerticesCount(GetLabel(label), GetProperty(property));
+        int64_t vertex_count =
+            EstimateIndexLookup(GetLabel(label), GetProperty(property), *filter.property_filter,
+                                db_->VerticesCount(GetLabel(label), GetProperty(property)));
         auto is_better_type = [&found](PropertyFilter::Type type) {
           // Order the types by the most preferred index lookup type.
           static const PropertyFilter::Type kFilterTypeOrder[] = {
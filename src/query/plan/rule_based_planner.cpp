@@ -481,7 +481,9 @@ std::unique_ptr<LogicalOperator> GenReturnBody(std::unique_ptr<LogicalOperator>
   // Like Where, OrderBy can read from symbols established by named expressions
   // in Produce, so it must come after it.
   if (!body.order_by().empty()) {
-    last_op = std::make_unique<OrderBy>(std::move(last_op), body.order_by(), body.output_symbols());
+    // OrderBy only needs to keep the rows which Skip and Limit let through.
+    last_op = std::make_unique<OrderBy>(std::move(last_op), body.order_by(), body.output_symbols(),
+                                        body.limit() ? body.skip() : nullptr, body.limit());
   }
   // Finally, Skip and Limit must come after OrderBy.
   if (body.skip()) {
@@ -548,6 +550,67 @@ std::unique_ptr<LogicalOperator> GenNamedPaths(std::unique_ptr<LogicalOperator>
   return last_op;
 }
 
+size_t CollectJoinBranch(const Matching &matching, size_t begin, const std::unordered_set<Symbol> &bound_symbols,
+                         const SymbolTable &symbol_table, std::unordered_set<Symbol> *branch_symbols) {
+  auto end = begin;
+  for (; end < matching.expansions.size(); ++end) {
+    const auto &expansion = matching.expansions[end];
+    const auto &node1_symbol = symbol_table.at(*expansion.node1->identifier_);
+    if (utils::Contains(bound_symbols, node1_symbol)) break;
+    if (end != begin && !utils::Contains(*branch_symbols, node1_symbol)) break;
+    if (expansion.edge) {
+      if (expansion.edge->IsVariable()) break;
+      const auto &node2_symbol = symbol_table.at(*expansion.node2->identifier_);
+      if (utils::Contains(bound_symbols, node2_symbol)) break;
+      branch_symbols->insert(node1_symbol);
+      branch_symbols->insert(symbol_table.at(*expansion.edge->identifier_));
+      branch_symbols->insert(node2_symbol);
+    } else {
+      branch_symbols->insert(node1_symbol);
+    }
+  }
+  return end;
+}
+
+JoinKeys ExtractJoinKeys(const std::unordered_set<Symbol> &left_symbols,
+                         const std::unordered_set<Symbol> &right_symbols, Filters &filters,
+                         const SymbolTable &symbol_table) {
+  auto uses_only = [&symbol_table](Expression *expression, const std::unordered_set<Symbol> &symbols) {
+    UsedSymbolsCollector collector(symbol_table);
+    expression->Accept(collector);
+    if (collector.symbols_.empty()) return false;
+    return std::all_of(collector.symbols_.begin(), collector.symbols_.end(),
+                       [&symbols](const auto &symbol) { return utils::Contains(symbols, symbol); });
+  };
+  JoinKeys join_keys;
+  std::unordered_set<Expression *> join_filters;
+  for (const auto &filter : filters) {
+    if (join_filters.count(filter.expression)) continue;
+    auto *equal = utils::Downcast<EqualOperator>(filter.expression);
+    if (!equal) continue;
+    if (uses_only(equal->expression1_, left_symbols) && uses_only(equal->expression2_, right_symbols)) {
+      join_keys.left.push_back(equal->expression1_);
+      join_keys.right.push_back(equal->expression2_);
+    } else if (uses_only(equal->expression2_, left_symbols) && uses_only(equal->expression1_, right_symbols)) {
+      join_keys.left.push_back(equal->expression2_);
+      join_keys.right.push_back(equal->expression1_);
+    } else {
+      continue;
+    }
+    join_filters.insert(filter.expression);
+  }
+  // The same equality may be stored both as a property filter of the left and
+  // of the right symbol.
+  for (auto filters_it = filters.begin(); filters_it != filters.end();) {
+    if (utils::Contains(join_filters, filters_it->expression)) {
+      filters_it = filters.erase(filters_it);
+    } else {
+      ++filters_it;
+    }
+  }
+  return join_keys;
+}
+
 std::unique_ptr<LogicalOperator> GenReturn(Return &ret, std::unique_ptr<LogicalOperator> input_op,
                                            SymbolTable &symbol_table, bool is_write,
                                            const std::unordered_set<Symbol> &bound_symbols, AstStorage &storage) {
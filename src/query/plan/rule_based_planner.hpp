@@ -137,6 +137,27 @@ std::unique_ptr<LogicalOperator> GenNamedPaths(std::unique_ptr<LogicalOperator>
                                                std::unordered_set<Symbol> &bound_symbols,
                                                std::unordered_map<Symbol, std::vector<Symbol>> &named_paths);
 
+// Equality expressions of a hash join, `left[i]` is evaluated on the left
+// input and compared with `right[i]` evaluated on the right one.
+struct JoinKeys {
+  std::vector<Expression *> left;
+  std::vector<Expression *> right;
+};
+
+// Collects the symbols of the consecutive expansions starting at `begin` which
+// form a pattern part independent of `bound_symbols`. The part ends before the
+// first expansion which isn't connected to it, uses a variable length edge or
+// refers to a bound symbol. Returns the index after the last collected expansion.
+size_t CollectJoinBranch(const Matching &matching, size_t begin, const std::unordered_set<Symbol> &bound_symbols,
+                         const SymbolTable &symbol_table, std::unordered_set<Symbol> *branch_symbols);
+
+// Removes from `filters` the equalities which compare an expression over
+// `left_symbols` with an expression over `right_symbols` and returns their
+// sides as join keys.
+JoinKeys ExtractJoinKeys(const std::unordered_set<Symbol> &left_symbols,
+                         const std::unordered_set<Symbol> &right_symbols, Filters &filters,
+                         const SymbolTable &symbol_table);
+
 std::unique_ptr<LogicalOperator> GenReturn(Return &ret, std::unique_ptr<LogicalOperator> input_op,
                                            SymbolTable &symbol_table, bool is_write,
                                            const std::unordered_set<Symbol> &bound_symbols, AstStorage &storage);
@@ -401,127 +422,198 @@ class RuleBasedPlanner {
     // optimizes the optional match which filters only on symbols bound in
     // regular match.
     auto last_op = impl::GenFilters(std::move(input_op), bound_symbols, filters, storage);
-    for (const auto &expansion : matching.expansions) {
+    for (size_t i = 0; i < matching.expansions.size();) {
+      const auto &expansion = matching.expansions[i];
       const auto &node1_symbol = symbol_table.at(*expansion.node1->identifier_);
-      if (bound_symbols.insert(node1_symbol).second) {
-        // We have just bound this symbol, so generate ScanAll which fills it.
-        last_op = std::make_unique<ScanAll>(std::move(last_op), node1_symbol, match_context.view);
-        match_context.new_symbols.emplace_back(node1_symbol);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
-        last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
-      }
-      // We have an edge, so generate Expand.
-      if (expansion.edge) {
-        auto *edge = expansion.edge;
-        // If the expand symbols were already bound, then we need to indicate
-        // that they exist. The Expand will then check whether the pattern holds
-        // instead of writing the expansion to symbols.
-        const auto &node_symbol = symbol_table.at(*expansion.node2->identifier_);
-        auto existing_node = utils::Contains(bound_symbols, node_symbol);
-        const auto &edge_symbol = symbol_table.at(*edge->identifier_);
-        MG_ASSERT(!utils::Contains(bound_symbols, edge_symbol), "Existing edges are not supported");
-        std::vector<storage::EdgeTypeId> edge_types;
-        edge_types.reserve(edge->edge_types_.size());
-        for (const auto &type : edge->edge_types_) {
-          edge_types.push_back(GetEdgeType(type));
+      // A part of the pattern that isn't connected to the already bound
+      // symbols is joined with them through a hash table if they are compared
+      // for equality, instead of being scanned again for every input row.
+      if (last_op && !utils::Contains(bound_symbols, node1_symbol)) {
+        std::unordered_set<Symbol> branch_symbols;
+        auto branch_end = impl::CollectJoinBranch(matching, i, bound_symbols, symbol_table, &branch_symbols);
+        auto join_keys = impl::ExtractJoinKeys(bound_symbols, branch_symbols, filters, symbol_table);
+        if (!join_keys.left.empty()) {
+          last_op = GenHashJoin(match_context, std::move(last_op), i, branch_end, std::move(join_keys), filters,
+                                named_paths);
+          i = branch_end;
+          continue;
         }
-        if (edge->IsVariable()) {
-          std::optional<ExpansionLambda> weight_lambda;
-          std::optional<Symbol> total_weight;
-
-          if (edge->type_ == EdgeAtom::Type::WEIGHTED_SHORTEST_PATH) {
-            weight_lambda.emplace(ExpansionLambda{symbol_table.at(*edge->weight_lambda_.inner_edge),
-                                                  symbol_table.at(*edge->weight_lambda_.inner_node),
-                                                  edge->weight_lambda_.expression});
+      }
+      last_op = PlanExpansion(match_context, expansion, std::move(last_op), filters, named_paths);
+      ++i;
+    }
+    MG_ASSERT(named_paths.empty(), "Expected to generate all named paths");
+    // We bound all named path symbols, so just add them to new_symbols.
+    for (const auto &named_path : matching.named_paths) {
+      MG_ASSERT(utils::Contains(bound_symbols, named_path.first), "Expected generated named path to have bound symbol");
+      match_context.new_symbols.emplace_back(named_path.first);
+    }
+    MG_ASSERT(filters.empty(), "Expected to generate all filters");
+    return last_op;
+  }
 
-            total_weight.emplace(symbol_table.at(*edge->total_weight_));
-          }
+  // Generates the operators which match a single expansion.
+  std::unique_ptr<LogicalOperator> PlanExpansion(MatchContext &match_context, const Expansion &expansion,
+                                                 std::unique_ptr<LogicalOperator> last_op, Filters &filters,
+                                                 std::unordered_map<Symbol, std::vector<Symbol>> &named_paths) {
+    auto &bound_symbols = match_context.bound_symbols;
+    auto &storage = *context_->ast_storage;
+    const auto &symbol_table = match_context.symbol_table;
+    const auto &matching = match_context.matching;
+    const auto &node1_symbol = symbol_table.at(*expansion.node1->identifier_);
+    if (bound_symbols.insert(node1_symbol).second) {
+      // We have just bound this symbol, so generate ScanAll which fills it.
+      last_op = std::make_unique<ScanAll>(std::move(last_op), node1_symbol, match_context.view);
+      match_context.new_symbols.emplace_back(node1_symbol);
+      last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+      last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
+      last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+    }
+    // We have an edge, so generate Expand.
+    if (expansion.edge) {
+      auto *edge = expansion.edge;
+      // If the expand symbols were already bound, then we need to indicate
+      // that they exist. The Expand will then check whether the pattern holds
+      // instead of writing the expansion to symbols.
+      const auto &node_symbol = symbol_table.at(*expansion.node2->identifier_);
+      auto existing_node = utils::Contains(bound_symbols, node_symbol);
+      const auto &edge_symbol = symbol_table.at(*edge->identifier_);
+      MG_ASSERT(!utils::Contains(bound_symbols, edge_symbol), "Existing edges are not supported");
+      std::vector<storage::EdgeTypeId> edge_types;
+      edge_types.reserve(edge->edge_types_.size());
+      for (const auto &type : edge->edge_types_) {
+        edge_types.push_back(GetEdgeType(type));
+      }
+      if (edge->IsVariable()) {
+        std::optional<ExpansionLambda> weight_lambda;
+        std::optional<Symbol> total_weight;
 
-          ExpansionLambda filter_lambda;
-          filter_lambda.inner_edge_symbol = symbol_table.at(*edge->filter_lambda_.inner_edge);
-          filter_lambda.inner_node_symbol = symbol_table.at(*edge->filter_lambda_.inner_node);
-          {
-            // Bind the inner edge and node symbols so they're available for
-            // inline filtering in ExpandVariable.
-            bool inner_edge_bound = bound_symbols.insert(filter_lambda.inner_edge_symbol).second;
-            bool inner_node_bound = bound_symbols.insert(filter_lambda.inner_node_symbol).second;
-            MG_ASSERT(inner_edge_bound && inner_node_bound, "An inner edge and node can't be bound from before");
-          }
-          // Join regular filters with lambda filter expression, so that they
-          // are done inline together. Semantic analysis should guarantee that
-          // lambda filtering uses bound symbols.
-          filter_lambda.expression = impl::BoolJoin<AndOperator>(
-              storage, impl::ExtractFilters(bound_symbols, filters, storage), edge->filter_lambda_.expression);
-          // At this point it's possible we have leftover filters for inline
-          // filtering (they use the inner symbols. If they were not collected,
-          // we have to remove them manually because no other filter-extraction
-          // will ever bind them again.
-          filters.erase(std::remove_if(
-                            filters.begin(), filters.end(),
-                            [e = filter_lambda.inner_edge_symbol, n = filter_lambda.inner_node_symbol](FilterInfo &fi) {
-                              return utils::Contains(fi.used_symbols, e) || utils::Contains(fi.used_symbols, n);
-                            }),
-                        filters.end());
-          // Unbind the temporarily bound inner symbols for filtering.
-          bound_symbols.erase(filter_lambda.inner_edge_symbol);
-          bound_symbols.erase(filter_lambda.inner_node_symbol);
-
-          if (total_weight) {
-            bound_symbols.insert(*total_weight);
-          }
+        if (edge->type_ == EdgeAtom::Type::WEIGHTED_SHORTEST_PATH) {
+          weight_lambda.emplace(ExpansionLambda{symbol_table.at(*edge->weight_lambda_.inner_edge),
+                                                symbol_table.at(*edge->weight_lambda_.inner_node),
+                                                edge->weight_lambda_.expression});
 
-          // TODO: Pass weight lambda.
-          MG_ASSERT(match_context.view == storage::View::OLD,
-                    "ExpandVariable should only be planned with storage::View::OLD");
-          last_op = std::make_unique<ExpandVariable>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
-                                                     edge->type_, expansion.direction, edge_types, expansion.is_flipped,
-                                                     edge->lower_bound_, edge->upper_bound_, existing_node,
-                                                     filter_lambda, weight_lambda, total_weight);
-        } else {
-          last_op = std::make_unique<Expand>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
-                                             expansion.direction, edge_types, existing_node, match_context.view);
+          total_weight.emplace(symbol_table.at(*edge->total_weight_));
         }
 
-        // Bind the expanded edge and node.
-        bound_symbols.insert(edge_symbol);
-        match_context.new_symbols.emplace_back(edge_symbol);
-        if (bound_symbols.insert(node_symbol).second) {
-          match_context.new_symbols.emplace_back(node_symbol);
+        ExpansionLambda filter_lambda;
+        filter_lambda.inner_edge_symbol = symbol_table.at(*edge->filter_lambda_.inner_edge);
+        filter_lambda.inner_node_symbol = symbol_table.at(*edge->filter_lambda_.inner_node);
+        {
+          // Bind the inner edge and node symbols so they're available for
+          // inline filtering in ExpandVariable.
+          bool inner_edge_bound = bound_symbols.insert(filter_lambda.inner_edge_symbol).second;
+          bool inner_node_bound = bound_symbols.insert(filter_lambda.inner_node_symbol).second;
+          MG_ASSERT(inner_edge_bound && inner_node_bound, "An inner edge and node can't be bound from before");
         }
+        // Join regular filters with lambda filter expression, so that they
+        // are done inline together. Semantic analysis should guarantee that
+        // lambda filtering uses bound symbols.
+        filter_lambda.expression = impl::BoolJoin<AndOperator>(
+            storage, impl::ExtractFilters(bound_symbols, filters, storage), edge->filter_lambda_.expression);
+        // At this point it's possible we have leftover filters for inline
+        // filtering (they use the inner symbols. If they were not collected,
+        // we have to remove them manually because no other filter-extraction
+        // will ever bind them again.
+        filters.erase(std::remove_if(
+                          filters.begin(), filters.end(),
+                          [e = filter_lambda.inner_edge_symbol, n = filter_lambda.inner_node_symbol](FilterInfo &fi) {
+                            return utils::Contains(fi.used_symbols, e) || utils::Contains(fi.used_symbols, n);
+                          }),
+                      filters.end());
+        // Unbind the temporarily bound inner symbols for filtering.
+        bound_symbols.erase(filter_lambda.inner_edge_symbol);
+        bound_symbols.erase(filter_lambda.inner_node_symbol);
+
+        if (total_weight) {
+          bound_symbols.insert(*total_weight);
+        }
+
+        // TODO: Pass weight lambda.
+        MG_ASSERT(match_context.view == storage::View::OLD,
+                  "ExpandVariable should only be planned with storage::View::OLD");
+        last_op = std::make_unique<ExpandVariable>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
+                                                   edge->type_, expansion.direction, edge_types, expansion.is_flipped,
+                                                   edge->lower_bound_, edge->upper_bound_, existing_node,
+                                                   filter_lambda, weight_lambda, total_weight);
+      } else {
+        last_op = std::make_unique<Expand>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
+                                           expansion.direction, edge_types, existing_node, match_context.view);
+      }
 
-        // Ensure Cyphermorphism (different edge symbols always map to
-        // different edges).
-        for (const auto &edge_symbols : matching.edge_symbols) {
-          if (edge_symbols.find(edge_symbol) == edge_symbols.end()) {
+      // Bind the expanded edge and node.
+      bound_symbols.insert(edge_symbol);
+      match_context.new_symbols.emplace_back(edge_symbol);
+      if (bound_symbols.insert(node_symbol).second) {
+        match_context.new_symbols.emplace_back(node_symbol);
+      }
+
+      // Ensure Cyphermorphism (different edge symbols always map to
+      // different edges).
+      for (const auto &edge_symbols : matching.edge_symbols) {
+        if (edge_symbols.find(edge_symbol) == edge_symbols.end()) {
+          continue;
+        }
+        std::vector<Symbol> other_symbols;
+        for (const auto &symbol : edge_symbols) {
+          if (symbol == edge_symbol || bound_symbols.find(symbol) == bound_symbols.end()) {
             continue;
           }
-          std::vector<Symbol> other_symbols;
-          for (const auto &symbol : edge_symbols) {
-            if (symbol == edge_symbol || bound_symbols.find(symbol) == bound_symbols.end()) {
-              continue;
-            }
-            other_symbols.push_back(symbol);
-          }
-          if (!other_symbols.empty()) {
-            last_op = std::make_unique<EdgeUniquenessFilter>(std::move(last_op), edge_symbol, other_symbols);
-          }
+          other_symbols.push_back(symbol);
+        }
+        if (!other_symbols.empty()) {
+          last_op = std::make_unique<EdgeUniquenessFilter>(std::move(last_op), edge_symbol, other_symbols);
         }
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
-        last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
       }
+      last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+      last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
+      last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
     }
-    MG_ASSERT(named_paths.empty(), "Expected to generate all named paths");
-    // We bound all named path symbols, so just add them to new_symbols.
-    for (const auto &named_path : matching.named_paths) {
-      MG_ASSERT(utils::Contains(bound_symbols, named_path.first), "Expected generated named path to have bound symbol");
-      match_context.new_symbols.emplace_back(named_path.first);
-    }
-    MG_ASSERT(filters.empty(), "Expected to generate all filters");
     return last_op;
   }
 
+  // Plans the expansions [begin, end) as the right branch of a `HashJoin` with
+  // `left_op` and generates the filters which became possible after the join.
+  std::unique_ptr<LogicalOperator> GenHashJoin(MatchContext &match_context, std::unique_ptr<LogicalOperator> left_op,
+                                               size_t begin, size_t end, impl::JoinKeys join_keys, Filters &filters,
+                                               std::unordered_map<Symbol, std::vector<Symbol>> &named_paths) {
+    auto &bound_symbols = match_context.bound_symbols;
+    auto &storage = *context_->ast_storage;
+    const auto &matching = match_context.matching;
+    // The right branch is planned from scratch, so it can only bind its own
+    // symbols and use the filters on them.
+    std::unordered_set<Symbol> right_bound_symbols;
+    MatchContext right_context{matching, match_context.symbol_table, right_bound_symbols, match_context.view};
+    std::unique_ptr<LogicalOperator> right_op;
+    for (auto i = begin; i < end; ++i) {
+      right_op = PlanExpansion(right_context, matching.expansions[i], std::move(right_op), filters, named_paths);
+    }
+    std::vector<Symbol> left_symbols(bound_symbols.begin(), bound_symbols.end());
+    std::vector<Symbol> right_symbols(right_bound_symbols.begin(), right_bound_symbols.end());
+    auto last_op = std::make_unique<HashJoin>(std::move(left_op), left_symbols, std::move(right_op), right_symbols,
+                                              join_keys.left, join_keys.right);
+    match_context.new_symbols.insert(match_context.new_symbols.end(), right_context.new_symbols.begin(),
+                                     right_context.new_symbols.end());
+    bound_symbols.insert(right_bound_symbols.begin(), right_bound_symbols.end());
+    // Cyphermorphism between the edges of the two branches.
+    std::unique_ptr<LogicalOperator> result = std::move(last_op);
+    for (const auto &edge_symbols : matching.edge_symbols) {
+      for (const auto &edge_symbol : right_symbols) {
+        if (!utils::Contains(edge_symbols, edge_symbol)) continue;
+        std::vector<Symbol> other_symbols;
+        for (const auto &symbol : left_symbols) {
+          if (utils::Contains(edge_symbols, symbol)) other_symbols.push_back(symbol);
+        }
+        if (!other_symbols.empty()) {
+          result = std::make_unique<EdgeUniquenessFilter>(std::move(result), edge_symbol, other_symbols);
+        }
+      }
+    }
+    result = impl::GenFilters(std::move(result), bound_symbols, filters, storage);
+    result = impl::GenNamedPaths(std::move(result), bound_symbols, named_paths);
+    return impl::GenFilters(std::move(result), bound_symbols, filters, storage);
+  }
+
   auto GenMerge(query::Merge &merge, std::unique_ptr<LogicalOperator> input_op, const Matching &matching) {
     // Copy the bound symbol set, because we don't want to use the updated
     // version when generating the create part.
@@ -17,13 +17,15 @@
 #include "query/typed_value.hpp"
 #include "storage/v2/id_types.hpp"
 #include "storage/v2/property_value.hpp"
+#include "storage/v2/statistics.hpp"
 #include "utils/bound.hpp"
 #include "utils/fnv.hpp"
 
 namespace query::plan {
 
 /// A stand in class for `TDbAccessor` which provides memoized calls to
-/// `VerticesCount`.
+/// `VerticesCount`, `EdgesCount` and to the getters of the statistics collected
+/// by `ANALYZE GRAPH`.
 template <class TDbAccessor>
 class VertexCountCache {
  public:
@@ -72,6 +74,35 @@ class VertexCountCache {
     return bounds_vertex_count.at(bounds);
   }
 
+  int64_t EdgesCount() {
+    if (!edges_count_) edges_count_ = db_->EdgesCount();
+    return *edges_count_;
+  }
+
+  const std::optional<storage::LabelStatistics> &GetLabelStatistics(storage::LabelId label) {
+    auto it = label_statistics_.find(label);
+    if (it == label_statistics_.end()) it = label_statistics_.emplace(label, db_->GetLabelStatistics(label)).first;
+    return it->second;
+  }
+
+  const std::optional<storage::EdgeTypeStatistics> &GetEdgeTypeStatistics(storage::EdgeTypeId edge_type) {
+    auto it = edge_type_statistics_.find(edge_type);
+    if (it == edge_type_statistics_.end()) {
+      it = edge_type_statistics_.emplace(edge_type, db_->GetEdgeTypeStatistics(edge_type)).first;
+    }
+    return it->second;
+  }
+
+  const std::optional<storage::PropertyStatistics> &GetPropertyStatistics(storage::LabelId label,
+                                                                          storage::PropertyId property) {
+    auto key = std::make_pair(label, property);
+    auto it = property_statistics_.find(key);
+    if (it == property_statistics_.end()) {
+      it = property_statistics_.emplace(key, db_->GetPropertyStatistics(label, property)).first;
+    }
+    return it->second;
+  }
+
   bool LabelIndexExists(storage::LabelId label) { return db_->LabelIndexExists(label); }
 
   bool LabelPropertyIndexExists(storage::LabelId label, storage::PropertyId property) {
@@ -130,6 +161,11 @@ class VertexCountCache {
   std::unordered_map<LabelPropertyKey, std::unordered_map<BoundsKey, int64_t, BoundsHash, BoundsEqual>,
                      LabelPropertyHash>
       property_bounds_vertex_count_;
+  std::optional<int64_t> edges_count_;
+  std::unordered_map<storage::LabelId, std::optional<storage::LabelStatistics>> label_statistics_;
+  std::unordered_map<storage::EdgeTypeId, std::optional<storage::EdgeTypeStatistics>> edge_type_statistics_;
+  std::unordered_map<LabelPropertyKey, std::optional<storage::PropertyStatistics>, LabelPropertyHash>
+      property_statistics_;
 };
 
 template <class TDbAccessor>
@@ -27,11 +27,22 @@ struct Config {
 
     Type type{Type::PERIODIC};
     std::chrono::milliseconds interval{std::chrono::milliseconds(1000)};
+    // If set, committed versions that sit deeper than this in a version chain
+    // are copied to the history store without waiting for the oldest active
+    // transaction to finish. 0 disables early migration.
+    uint64_t history_chain_length_limit{0};
+    // The migrated history is written in batches of at least this many records
+    // as table files that are ingested into the history store instead of
+    // going through its write ahead log and memtable. Smaller batches (the
+    // rest of a GC run) are still written normally. 0 disables the ingestion.
+    uint64_t history_ingest_batch_size{0};
   } gc;
 
   struct Items {
     bool properties_on_edges{true};
     int AnchorNum {11};
+    // Stamp the history with `HybridClock` timestamps instead of the logical
+    // commit timestamps.
     bool realTimeFlag{false};
     //for multiple anchor nums
     // std::vector<int> AnchorNumLists{10,100,1000};
@@ -51,9 +62,42 @@ struct Config {
     std::chrono::milliseconds snapshot_interval{std::chrono::minutes(2)};
     uint64_t snapshot_retention_count{3};
 
+    // Snapshots are split into batches of `items_per_batch` edges/vertices
+    // that are created and loaded on `snapshot_thread_count` threads.
+    uint64_t items_per_batch{100000};
+    uint64_t snapshot_thread_count{8};
+
+    // If greater than 0, a periodic snapshot contains only the objects changed
+    // since the previous snapshot. Every `snapshot_incremental_chain_length`
+    // incremental snapshots a full snapshot is created, which starts a new
+    // chain. The retention count applies to whole chains.
+    uint64_t snapshot_incremental_chain_length{0};
+
+    // WAL files are decoded and applied, and the indices are recreated on
+    // `recovery_thread_count` threads during recovery.
+    uint64_t recovery_thread_count{8};
+
     uint64_t wal_file_size_kibibytes{20 * 1024};
     uint64_t wal_file_flush_every_n_tx{100000};
 
+    // The WAL deltas are written in checksummed blocks of whole transactions.
+    // A block is written once it has at least `wal_block_size_kibibytes` of
+    // deltas (0 writes every transaction as its own block), when the WAL is
+    // synced and when the WAL file is finalized. Bigger blocks compress better
+    // but the not yet written transactions are lost if the process crashes.
+    uint64_t wal_block_size_kibibytes{0};
+    bool wal_compression{false};
+
+    // If enabled, a commit returns, and becomes visible to the other
+    // transactions, only after its WAL records are synced. The committers are
+    // grouped, one of them syncs the WAL for the whole group without holding
+    // the engine lock. The group is synced once it has
+    // `wal_group_commit_max_batch` transactions or after
+    // `wal_group_commit_max_delay`, whichever comes first.
+    bool wal_group_commit{false};
+    uint64_t wal_group_commit_max_batch{64};
+    std::chrono::microseconds wal_group_commit_max_delay{std::chrono::microseconds(1000)};
+
     bool snapshot_on_exit{false};
 
   } durability;
@@ -231,6 +231,10 @@ struct Delta {
   // uint64_t start_timestamp;
 	uint64_t commit_timestamp;
   nlohmann::json add_info;
+  // Set by the GC once the delta has been copied to the history store while
+  // still being linked in its chain. Temporal reads stop at such a delta and
+  // read the rest of the history from the history store.
+  std::atomic<bool> migrated{false};
   //hjm end
 
   union {
@@ -0,0 +1,178 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "storage/v2/delta.hpp"
+#include "utils/memory.hpp"
+
+namespace storage {
+
+/// Undo buffer of a single transaction.
+///
+/// Deltas are constructed in place inside chunks that are carved out of a
+/// per-buffer `utils::MonotonicBufferResource`. Chunks are never reallocated,
+/// so the address of a delta is stable for the whole lifetime of the buffer
+/// (version chains point directly into it). Appending a delta is a pointer bump
+/// in the common case and the whole buffer is released at once when the GC
+/// destroys it, instead of freeing each delta separately.
+///
+/// DeltaBuffer is not thread-safe, it is owned by a single transaction and
+/// afterwards by the GC.
+class DeltaBuffer final {
+  struct Chunk {
+    Chunk *next;
+    size_t size;
+    size_t capacity;
+
+    Delta *data() { return reinterpret_cast<Delta *>(reinterpret_cast<char *>(this) + kChunkHeaderSize); }
+  };
+
+  static constexpr size_t kChunkHeaderSize = (sizeof(Chunk) + alignof(Delta) - 1) / alignof(Delta) * alignof(Delta);
+  static constexpr size_t kInitialChunkCapacity = 8;
+  static constexpr size_t kMaxChunkCapacity = 1024;
+  // Most write transactions touch only a handful of objects, so the first
+  // upstream block is sized to hold the first chunk (and a bit more).
+  static constexpr size_t kInitialBufferSize = 2 * (kChunkHeaderSize + kInitialChunkCapacity * sizeof(Delta));
+
+ public:
+  template <class TChunk, class TDelta>
+  class IteratorBase final {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Delta;
+    using difference_type = std::ptrdiff_t;
+    using pointer = TDelta *;
+    using reference = TDelta &;
+
+    IteratorBase() = default;
+    IteratorBase(TChunk *chunk, size_t pos) : chunk_(chunk), pos_(pos) {}
+
+    reference operator*() const { return chunk_->data()[pos_]; }
+    pointer operator->() const { return &chunk_->data()[pos_]; }
+
+    IteratorBase &operator++() {
+      if (++pos_ == chunk_->size) {
+        chunk_ = chunk_->next;
+        pos_ = 0;
+      }
+      return *this;
+    }
+
+    IteratorBase operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const IteratorBase &other) const { return chunk_ == other.chunk_ && pos_ == other.pos_; }
+    bool operator!=(const IteratorBase &other) const { return !(*this == other); }
+
+   private:
+    TChunk *chunk_{nullptr};
+    size_t pos_{0};
+  };
+
+  using Iterator = IteratorBase<Chunk, Delta>;
+  using ConstIterator = IteratorBase<Chunk, const Delta>;
+
+  DeltaBuffer() : memory_(kInitialBufferSize) {}
+
+  DeltaBuffer(const DeltaBuffer &) = delete;
+  DeltaBuffer &operator=(const DeltaBuffer &) = delete;
+
+  DeltaBuffer(DeltaBuffer &&other) noexcept
+      : memory_(std::move(other.memory_)), head_(other.head_), tail_(other.tail_), size_(other.size_) {
+    other.head_ = nullptr;
+    other.tail_ = nullptr;
+    other.size_ = 0;
+  }
+
+  DeltaBuffer &operator=(DeltaBuffer &&other) noexcept {
+    if (this == &other) return *this;
+    Clear();
+    memory_ = std::move(other.memory_);
+    head_ = other.head_;
+    tail_ = other.tail_;
+    size_ = other.size_;
+    other.head_ = nullptr;
+    other.tail_ = nullptr;
+    other.size_ = 0;
+    return *this;
+  }
+
+  ~DeltaBuffer() { Clear(); }
+
+  /// Construct a new delta at the end of the buffer.
+  /// @throw std::bad_alloc
+  template <class... TArgs>
+  Delta &emplace_back(TArgs &&...args) {
+    auto *chunk = tail_;
+    if (chunk == nullptr || chunk->size == chunk->capacity) chunk = AllocateChunk();
+    auto *delta = new (chunk->data() + chunk->size) Delta(std::forward<TArgs>(args)...);
+    // The chunk is linked only after the delta was successfully constructed so
+    // that the iteration never observes an empty chunk.
+    if (chunk != tail_) {
+      if (tail_ == nullptr) {
+        head_ = chunk;
+      } else {
+        tail_->next = chunk;
+      }
+      tail_ = chunk;
+    }
+    ++chunk->size;
+    ++size_;
+    return *delta;
+  }
+
+  /// Destroy all deltas and release all of the memory back to the upstream
+  /// resource.
+  void Clear() {
+    for (auto *chunk = head_; chunk != nullptr; chunk = chunk->next) {
+      for (size_t i = 0; i < chunk->size; ++i) {
+        chunk->data()[i].~Delta();
+      }
+    }
+    head_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+    memory_.Release();
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  Iterator begin() { return Iterator(head_, 0); }
+  Iterator end() { return Iterator(); }
+  ConstIterator begin() const { return ConstIterator(head_, 0); }
+  ConstIterator end() const { return ConstIterator(); }
+
+ private:
+  Chunk *AllocateChunk() {
+    const size_t capacity =
+        tail_ == nullptr ? kInitialChunkCapacity : std::min(tail_->capacity * 2, kMaxChunkCapacity);
+    void *ptr = memory_.Allocate(kChunkHeaderSize + capacity * sizeof(Delta), alignof(Delta));
+    return new (ptr) Chunk{nullptr, 0, capacity};
+  }
+
+  utils::MonotonicBufferResource memory_;
+  Chunk *head_{nullptr};
+  Chunk *tail_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace storage
@@ -30,6 +30,7 @@
 #include "utils/logging.hpp"
 #include "utils/memory_tracker.hpp"
 #include "utils/message.hpp"
+#include "utils/parallel.hpp"
 
 namespace storage::durability {
 
@@ -71,7 +72,8 @@ std::vector<SnapshotDurabilityInfo> GetSnapshotFiles(const std::filesystem::path
       try {
         auto info = ReadSnapshotInfo(item.path());
         if (uuid.empty() || info.uuid == uuid) {
-          snapshot_files.emplace_back(item.path(), std::move(info.uuid), info.start_timestamp);
+          snapshot_files.emplace_back(item.path(), std::move(info.uuid), info.start_timestamp,
+                                      info.base_start_timestamp, info.previous_start_timestamp);
         }
       } catch (const RecoveryFailure &) {
         continue;
@@ -108,17 +110,40 @@ std::optional<std::vector<WalDurabilityInfo>> GetWalFiles(const std::filesystem:
   return std::move(wal_files);
 }
 
+// The vertices are split into `kIndexBatchesPerThread` batches per thread when
+// the indices are recreated so that the threads stay busy even if the batches
+// take a different amount of time.
+constexpr uint64_t kIndexBatchesPerThread = 4;
+constexpr uint64_t kMinIndexBatchSize = 10000;
+
 // Function used to recover all discovered indices and constraints. The
 // indices and constraints must be recovered after the data recovery is done
 // to ensure that the indices and constraints are consistent at the end of the
 // recovery process.
 void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_constraints, Indices *indices,
-                                  Constraints *constraints, utils::SkipList<Vertex> *vertices) {
+                                  Constraints *constraints, utils::SkipList<Vertex> *vertices,
+                                  uint64_t thread_count) {
   spdlog::info("Recreating indices from metadata.");
+  // The vertices are split into batches once and the batches are shared by
+  // all of the recreated indices.
+  std::optional<ParallelizedIndexCreationInfo> parallel_exec_info;
+  if (thread_count > 1 &&
+      (!indices_constraints.indices.label.empty() || !indices_constraints.indices.label_property.empty())) {
+    const auto vertices_count = vertices->size();
+    const auto batch_size = std::max(vertices_count / (thread_count * kIndexBatchesPerThread), kMinIndexBatchSize);
+    parallel_exec_info.emplace();
+    parallel_exec_info->thread_count = thread_count;
+    uint64_t count = 0;
+    auto acc = vertices->access();
+    for (const auto &vertex : acc) {
+      if (count++ % batch_size == 0) parallel_exec_info->batch_starts.push_back(vertex.gid);
+    }
+  }
+
   // Recover label indices.
   spdlog::info("Recreating {} label indices from metadata.", indices_constraints.indices.label.size());
   for (const auto &item : indices_constraints.indices.label) {
-    if (!indices->label_index.CreateIndex(item, vertices->access()))
+    if (!indices->label_index.CreateIndex(item, vertices->access(), parallel_exec_info))
       throw RecoveryFailure("The label index must be created here!");
     spdlog::info("A label index is recreated from metadata.");
   }
@@ -128,7 +153,7 @@ void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_
   spdlog::info("Recreating {} label+property indices from metadata.",
                indices_constraints.indices.label_property.size());
   for (const auto &item : indices_constraints.indices.label_property) {
-    if (!indices->label_property_index.CreateIndex(item.first, item.second, vertices->access()))
+    if (!indices->label_property_index.CreateIndex(item.first, item.second, vertices->access(), parallel_exec_info))
       throw RecoveryFailure("The label+property index must be created here!");
     spdlog::info("A label+property index is recreated from metadata.");
   }
@@ -157,15 +182,64 @@ void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_
   spdlog::info("Constraints are recreated from metadata.");
 }
 
+namespace {
+
+// Returns the paths of the snapshots that have to be loaded (in order) to
+// recover `snapshot`: the full snapshot its chain is based on followed by the
+// incremental snapshots up to `snapshot`. Returns `std::nullopt` if a
+// snapshot of the chain is missing.
+std::optional<std::vector<std::filesystem::path>> GetSnapshotChain(
+    const std::vector<SnapshotDurabilityInfo> &snapshot_files, const SnapshotDurabilityInfo &snapshot) {
+  std::vector<std::filesystem::path> chain{snapshot.path};
+  const auto *link = &snapshot;
+  while (link->IsIncremental()) {
+    auto previous = std::find_if(snapshot_files.begin(), snapshot_files.end(), [link](const auto &snapshot_file) {
+      return snapshot_file.uuid == link->uuid && snapshot_file.start_timestamp == link->previous_start_timestamp;
+    });
+    if (previous == snapshot_files.end() || previous->base_start_timestamp != link->base_start_timestamp) {
+      return std::nullopt;
+    }
+    link = &*previous;
+    chain.push_back(link->path);
+  }
+  std::reverse(chain.begin(), chain.end());
+  return chain;
+}
+
+// Loads all of the snapshots of a chain, the returned snapshot is the last
+// one with the gid generators covering the whole chain.
+// @throw RecoveryFailure
+RecoveredSnapshot LoadSnapshotChain(const std::vector<std::filesystem::path> &chain, utils::SkipList<Vertex> *vertices,
+                                    utils::SkipList<Edge> *edges,
+                                    std::deque<std::pair<std::string, uint64_t>> *epoch_history,
+                                    NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
+                                    const Config &config) {
+  std::optional<RecoveredSnapshot> recovered;
+  for (const auto &path : chain) {
+    if (recovered) spdlog::info("Applying incremental snapshot {}.", path);
+    auto snapshot = LoadSnapshot(path, vertices, edges, epoch_history, name_id_mapper, edge_count, config);
+    if (recovered) {
+      auto &info = snapshot.recovery_info;
+      info.next_vertex_id = std::max(info.next_vertex_id, recovered->recovery_info.next_vertex_id);
+      info.next_edge_id = std::max(info.next_edge_id, recovered->recovery_info.next_edge_id);
+    }
+    recovered = std::move(snapshot);
+  }
+  return std::move(*recovered);
+}
+
+}  // namespace
+
 std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_directory,
                                         const std::filesystem::path &wal_directory, std::string *uuid,
                                         std::string *epoch_id,
                                         std::deque<std::pair<std::string, uint64_t>> *epoch_history,
                                         utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges,
                                         std::atomic<uint64_t> *edge_count, NameIdMapper *name_id_mapper,
-                                        Indices *indices, Constraints *constraints, Config::Items items,
+                                        Indices *indices, Constraints *constraints, const Config &config,
                                         uint64_t *wal_seq_num) {
   utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
+  const auto thread_count = std::max(config.durability.recovery_thread_count, static_cast<uint64_t>(1));
   spdlog::info("Recovering persisted data using snapshot ({}) and WAL directory ({}).", snapshot_directory,
                wal_directory);
   if (!utils::DirExists(snapshot_directory) && !utils::DirExists(wal_directory)) {
@@ -188,14 +262,20 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     *uuid = snapshot_files.back().uuid;
     std::optional<RecoveredSnapshot> recovered_snapshot;
     for (auto it = snapshot_files.rbegin(); it != snapshot_files.rend(); ++it) {
-      const auto &[path, file_uuid, _] = *it;
-      if (file_uuid != *uuid) {
+      const auto &path = it->path;
+      if (it->uuid != *uuid) {
         spdlog::warn("The snapshot file {} isn't related to the latest snapshot file!", path);
         continue;
       }
+      auto chain = GetSnapshotChain(snapshot_files, *it);
+      if (!chain) {
+        spdlog::warn("Couldn't find all of the snapshots in the chain of the incremental snapshot {}.", path);
+        continue;
+      }
       spdlog::info("Starting snapshot recovery from {}.", path);
       try {
-        recovered_snapshot = LoadSnapshot(path, vertices, edges, epoch_history, name_id_mapper, edge_count, items);
+        recovered_snapshot = LoadSnapshotChain(*chain, vertices, edges, epoch_history, name_id_mapper, edge_count,
+                                               config);
         spdlog::info("Snapshot recovery successful!");
         break;
       } catch (const RecoveryFailure &e) {
@@ -213,7 +293,7 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     *epoch_id = std::move(recovered_snapshot->snapshot_info.epoch_id);
 
     if (!utils::DirExists(wal_directory)) {
-      RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices);
+      RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices, thread_count);
       return recovered_snapshot->recovery_info;
     }
   } else {
@@ -300,36 +380,55 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     std::optional<uint64_t> previous_seq_num;
     auto last_loaded_timestamp = snapshot_timestamp;
     spdlog::info("Trying to load WAL files.");
-    for (auto &wal_file : wal_files) {
-      if (previous_seq_num && (wal_file.seq_num - *previous_seq_num) > 1) {
-        LOG_FATAL("You are missing a WAL file with the sequence number {}!", *previous_seq_num + 1);
-      }
-      previous_seq_num = wal_file.seq_num;
-
-      if (wal_file.epoch_id != *epoch_id) {
-        // This way we skip WALs finalized only because of role change.
-        // We can also set the last timestamp to 0 if last loaded timestamp
-        // is nullopt as this can only happen if the WAL file with seq = 0
-        // does not contain any deltas and we didn't find any snapshots.
-        if (last_loaded_timestamp) {
-          epoch_history->emplace_back(wal_file.epoch_id, *last_loaded_timestamp);
-        }
-        *epoch_id = std::move(wal_file.epoch_id);
-      }
+    // The WAL files are decoded concurrently in windows of `thread_count`
+    // files and then applied one by one in order.
+    for (uint64_t window_start = 0; window_start < wal_files.size(); window_start += thread_count) {
+      const auto window_size = std::min(thread_count, wal_files.size() - window_start);
+      std::vector<DecodedWal> decoded_wals(window_size);
       try {
-        auto info = LoadWal(wal_file.path, &indices_constraints, last_loaded_timestamp, vertices, edges, name_id_mapper,
-                            edge_count, items);
-        recovery_info.next_vertex_id = std::max(recovery_info.next_vertex_id, info.next_vertex_id);
-        recovery_info.next_edge_id = std::max(recovery_info.next_edge_id, info.next_edge_id);
-        recovery_info.next_timestamp = std::max(recovery_info.next_timestamp, info.next_timestamp);
-
-        recovery_info.last_commit_timestamp = info.last_commit_timestamp;
+        // `last_loaded_timestamp` only grows while the window is applied, so
+        // it's safe to use it for skipping the old deltas while decoding.
+        utils::RunInParallel(thread_count, window_size, [&](uint64_t i) {
+          decoded_wals[i] = DecodeWal(wal_files[window_start + i].path, last_loaded_timestamp);
+        });
       } catch (const RecoveryFailure &e) {
-        LOG_FATAL("Couldn't recover WAL deltas from {} because of: {}", wal_file.path, e.what());
+        LOG_FATAL("Couldn't recover WAL deltas because of: {}", e.what());
       }
 
-      if (recovery_info.next_timestamp != 0) {
-        last_loaded_timestamp.emplace(recovery_info.next_timestamp - 1);
+      for (uint64_t i = 0; i < window_size; ++i) {
+        auto &wal_file = wal_files[window_start + i];
+        if (previous_seq_num && (wal_file.seq_num - *previous_seq_num) > 1) {
+          LOG_FATAL("You are missing a WAL file with the sequence number {}!", *previous_seq_num + 1);
+        }
+        previous_seq_num = wal_file.seq_num;
+
+        if (wal_file.epoch_id != *epoch_id) {
+          // This way we skip WALs finalized only because of role change.
+          // We can also set the last timestamp to 0 if last loaded timestamp
+          // is nullopt as this can only happen if the WAL file with seq = 0
+          // does not contain any deltas and we didn't find any snapshots.
+          if (last_loaded_timestamp) {
+            epoch_history->emplace_back(wal_file.epoch_id, *last_loaded_timestamp);
+          }
+          *epoch_id = std::move(wal_file.epoch_id);
+        }
+        try {
+          spdlog::info("Trying to load WAL file {}.", wal_file.path);
+          auto info = ApplyWal(decoded_wals[i], &indices_constraints, last_loaded_timestamp, vertices, edges,
+                               name_id_mapper, edge_count, config.items, thread_count);
+          recovery_info.next_vertex_id = std::max(recovery_info.next_vertex_id, info.next_vertex_id);
+          recovery_info.next_edge_id = std::max(recovery_info.next_edge_id, info.next_edge_id);
+          recovery_info.next_timestamp = std::max(recovery_info.next_timestamp, info.next_timestamp);
+
+          recovery_info.last_commit_timestamp = info.last_commit_timestamp;
+        } catch (const RecoveryFailure &e) {
+          LOG_FATAL("Couldn't recover WAL deltas from {} because of: {}", wal_file.path, e.what());
+        }
+        decoded_wals[i] = DecodedWal{};
+
+        if (recovery_info.next_timestamp != 0) {
+          last_loaded_timestamp.emplace(recovery_info.next_timestamp - 1);
+        }
       }
     }
     // The sequence number needs to be recovered even though `LoadWal` didn't
@@ -339,7 +438,7 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     spdlog::info("All necessary WAL files are loaded successfully.");
   }
 
-  RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices);
+  RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices, thread_count);
   return recovery_info;
 }
 
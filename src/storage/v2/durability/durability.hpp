@@ -37,12 +37,21 @@ void VerifyStorageDirectoryOwnerAndProcessUserOrDie(const std::filesystem::path
 
 // Used to capture the snapshot's data related to durability
 struct SnapshotDurabilityInfo {
-  explicit SnapshotDurabilityInfo(std::filesystem::path path, std::string uuid, const uint64_t start_timestamp)
-      : path(std::move(path)), uuid(std::move(uuid)), start_timestamp(start_timestamp) {}
+  explicit SnapshotDurabilityInfo(std::filesystem::path path, std::string uuid, const uint64_t start_timestamp,
+                                  const uint64_t base_start_timestamp, const uint64_t previous_start_timestamp)
+      : path(std::move(path)),
+        uuid(std::move(uuid)),
+        start_timestamp(start_timestamp),
+        base_start_timestamp(base_start_timestamp),
+        previous_start_timestamp(previous_start_timestamp) {}
+
+  bool IsIncremental() const { return base_start_timestamp != start_timestamp; }
 
   std::filesystem::path path;
   std::string uuid;
   uint64_t start_timestamp;
+  uint64_t base_start_timestamp;
+  uint64_t previous_start_timestamp;
 
   auto operator<=>(const SnapshotDurabilityInfo &) const = default;
 };
@@ -94,10 +103,12 @@ std::optional<std::vector<WalDurabilityInfo>> GetWalFiles(const std::filesystem:
 // Helper function used to recover all discovered indices and constraints. The
 // indices and constraints must be recovered after the data recovery is done
 // to ensure that the indices and constraints are consistent at the end of the
-// recovery process.
+// recovery process. The vertices are scanned on `thread_count` threads while
+// the indices are filled.
 /// @throw RecoveryFailure
 void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_constraints, Indices *indices,
-                                  Constraints *constraints, utils::SkipList<Vertex> *vertices);
+                                  Constraints *constraints, utils::SkipList<Vertex> *vertices,
+                                  uint64_t thread_count = 1);
 
 /// Recovers data either from a snapshot and/or WAL files.
 /// @throw RecoveryFailure
@@ -108,7 +119,7 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
                                         std::deque<std::pair<std::string, uint64_t>> *epoch_history,
                                         utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges,
                                         std::atomic<uint64_t> *edge_count, NameIdMapper *name_id_mapper,
-                                        Indices *indices, Constraints *constraints, Config::Items items,
+                                        Indices *indices, Constraints *constraints, const Config &config,
                                         uint64_t *wal_seq_num);
 
 }  // namespace storage::durability
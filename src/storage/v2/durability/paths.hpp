@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 #include "utils/timestamp.hpp"
@@ -22,6 +23,10 @@ static const std::string kSnapshotDirectory{"snapshots"};
 static const std::string kWalDirectory{"wal"};
 static const std::string kBackupDirectory{".backup"};
 static const std::string kLockFile{".lock"};
+static const std::string kHistoryDirectory{"history_deltas"};
+static const std::string kHistoryCheckpointDirectory{"history_checkpoints"};
+static const std::string kHistoryReplicationDirectory{"history_replication"};
+static const std::string kStatisticsDirectory{"statistics"};
 
 // This is the prefix used for Snapshot and WAL filenames. It is a timestamp
 // format that equals to: YYYYmmddHHMMSSffffff
@@ -34,6 +39,24 @@ inline std::string MakeSnapshotName(uint64_t start_timestamp) {
   return date_str + "_timestamp_" + std::to_string(start_timestamp);
 }
 
+// Generates the name for the checkpoint of the history store that was taken
+// together with the snapshot with the given start timestamp.
+inline std::string MakeHistoryCheckpointName(uint64_t snapshot_start_timestamp) {
+  return "snapshot_" + std::to_string(snapshot_start_timestamp);
+}
+
+// Returns the snapshot start timestamp encoded in the history checkpoint name.
+inline std::optional<uint64_t> ParseHistoryCheckpointName(const std::string &name) {
+  static const std::string kPrefix{"snapshot_"};
+  if (!name.starts_with(kPrefix) || name.size() == kPrefix.size()) return std::nullopt;
+  uint64_t timestamp = 0;
+  for (auto it = name.begin() + kPrefix.size(); it != name.end(); ++it) {
+    if (*it < '0' || *it > '9') return std::nullopt;
+    timestamp = timestamp * 10 + (*it - '0');
+  }
+  return timestamp;
+}
+
 // Generates the name for a WAL file in a well-defined sortable format.
 inline std::string MakeWalName() {
   std::string date_str = utils::Timestamp::Now().ToString(kTimestampFormat);
@@ -11,6 +11,8 @@
 
 #include "storage/v2/durability/serialization.hpp"
 
+#include <algorithm>
+
 #include "storage/v2/temporal.hpp"
 #include "utils/endian.hpp"
 
@@ -21,115 +23,136 @@ namespace storage::durability {
 //////////////////////////
 
 namespace {
-void WriteSize(Encoder *encoder, uint64_t size) {
+// The encoding is shared between all encoders that produce the file format,
+// they only differ in where the bytes end up (`TEncoder::Write`).
+template <typename TEncoder>
+void WriteSize(TEncoder *encoder, uint64_t size) {
   size = utils::HostToLittleEndian(size);
   encoder->Write(reinterpret_cast<const uint8_t *>(&size), sizeof(size));
 }
-}  // namespace
 
-void Encoder::Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version) {
-  file_.Open(path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
-  Write(reinterpret_cast<const uint8_t *>(magic.data()), magic.size());
-  auto version_encoded = utils::HostToLittleEndian(version);
-  Write(reinterpret_cast<const uint8_t *>(&version_encoded), sizeof(version_encoded));
-}
-
-void Encoder::OpenExisting(const std::filesystem::path &path) {
-  file_.Open(path, utils::OutputFile::Mode::APPEND_TO_EXISTING);
-}
-
-void Encoder::Close() {
-  if (file_.IsOpen()) {
-    file_.Close();
-  }
-}
-
-void Encoder::Write(const uint8_t *data, uint64_t size) { file_.Write(data, size); }
-
-void Encoder::WriteMarker(Marker marker) {
+template <typename TEncoder>
+void WriteMarker(TEncoder *encoder, Marker marker) {
   auto value = static_cast<uint8_t>(marker);
-  Write(&value, sizeof(value));
+  encoder->Write(&value, sizeof(value));
 }
 
-void Encoder::WriteBool(bool value) {
-  WriteMarker(Marker::TYPE_BOOL);
+template <typename TEncoder>
+void WriteBool(TEncoder *encoder, bool value) {
+  encoder->WriteMarker(Marker::TYPE_BOOL);
   if (value) {
-    WriteMarker(Marker::VALUE_TRUE);
+    encoder->WriteMarker(Marker::VALUE_TRUE);
   } else {
-    WriteMarker(Marker::VALUE_FALSE);
+    encoder->WriteMarker(Marker::VALUE_FALSE);
   }
 }
 
-void Encoder::WriteUint(uint64_t value) {
+template <typename TEncoder>
+void WriteUint(TEncoder *encoder, uint64_t value) {
   value = utils::HostToLittleEndian(value);
-  WriteMarker(Marker::TYPE_INT);
-  Write(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
+  encoder->WriteMarker(Marker::TYPE_INT);
+  encoder->Write(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
 }
 
-void Encoder::WriteDouble(double value) {
+template <typename TEncoder>
+void WriteDouble(TEncoder *encoder, double value) {
   auto value_uint = utils::MemcpyCast<uint64_t>(value);
   value_uint = utils::HostToLittleEndian(value_uint);
-  WriteMarker(Marker::TYPE_DOUBLE);
-  Write(reinterpret_cast<const uint8_t *>(&value_uint), sizeof(value_uint));
+  encoder->WriteMarker(Marker::TYPE_DOUBLE);
+  encoder->Write(reinterpret_cast<const uint8_t *>(&value_uint), sizeof(value_uint));
 }
 
-void Encoder::WriteString(const std::string_view &value) {
-  WriteMarker(Marker::TYPE_STRING);
-  WriteSize(this, value.size());
-  Write(reinterpret_cast<const uint8_t *>(value.data()), value.size());
+template <typename TEncoder>
+void WriteString(TEncoder *encoder, const std::string_view &value) {
+  encoder->WriteMarker(Marker::TYPE_STRING);
+  WriteSize(encoder, value.size());
+  encoder->Write(reinterpret_cast<const uint8_t *>(value.data()), value.size());
 }
 
-void Encoder::WritePropertyValue(const PropertyValue &value) {
-  WriteMarker(Marker::TYPE_PROPERTY_VALUE);
+template <typename TEncoder>
+void WritePropertyValue(TEncoder *encoder, const PropertyValue &value) {
+  encoder->WriteMarker(Marker::TYPE_PROPERTY_VALUE);
   switch (value.type()) {
     case PropertyValue::Type::Null: {
-      WriteMarker(Marker::TYPE_NULL);
+      encoder->WriteMarker(Marker::TYPE_NULL);
       break;
     }
     case PropertyValue::Type::Bool: {
-      WriteBool(value.ValueBool());
+      encoder->WriteBool(value.ValueBool());
       break;
     }
     case PropertyValue::Type::Int: {
-      WriteUint(utils::MemcpyCast<uint64_t>(value.ValueInt()));
+      encoder->WriteUint(utils::MemcpyCast<uint64_t>(value.ValueInt()));
       break;
     }
     case PropertyValue::Type::Double: {
-      WriteDouble(value.ValueDouble());
+      encoder->WriteDouble(value.ValueDouble());
       break;
     }
     case PropertyValue::Type::String: {
-      WriteString(value.ValueString());
+      encoder->WriteString(value.ValueString());
       break;
     }
     case PropertyValue::Type::List: {
       const auto &list = value.ValueList();
-      WriteMarker(Marker::TYPE_LIST);
-      WriteSize(this, list.size());
+      encoder->WriteMarker(Marker::TYPE_LIST);
+      WriteSize(encoder, list.size());
       for (const auto &item : list) {
-        WritePropertyValue(item);
+        encoder->WritePropertyValue(item);
       }
       break;
     }
     case PropertyValue::Type::Map: {
       const auto &map = value.ValueMap();
-      WriteMarker(Marker::TYPE_MAP);
-      WriteSize(this, map.size());
+      encoder->WriteMarker(Marker::TYPE_MAP);
+      WriteSize(encoder, map.size());
       for (const auto &item : map) {
-        WriteString(item.first);
-        WritePropertyValue(item.second);
+        encoder->WriteString(item.first);
+        encoder->WritePropertyValue(item.second);
       }
       break;
     }
     case PropertyValue::Type::TemporalData: {
       const auto temporal_data = value.ValueTemporalData();
-      WriteMarker(Marker::TYPE_TEMPORAL_DATA);
-      WriteUint(static_cast<uint64_t>(temporal_data.type));
-      WriteUint(utils::MemcpyCast<uint64_t>(temporal_data.microseconds));
+      encoder->WriteMarker(Marker::TYPE_TEMPORAL_DATA);
+      encoder->WriteUint(static_cast<uint64_t>(temporal_data.type));
+      encoder->WriteUint(utils::MemcpyCast<uint64_t>(temporal_data.microseconds));
       break;
     }
   }
 }
+}  // namespace
+
+void Encoder::Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version) {
+  file_.Open(path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
+  Write(reinterpret_cast<const uint8_t *>(magic.data()), magic.size());
+  auto version_encoded = utils::HostToLittleEndian(version);
+  Write(reinterpret_cast<const uint8_t *>(&version_encoded), sizeof(version_encoded));
+}
+
+void Encoder::OpenExisting(const std::filesystem::path &path) {
+  file_.Open(path, utils::OutputFile::Mode::APPEND_TO_EXISTING);
+}
+
+void Encoder::Close() {
+  if (file_.IsOpen()) {
+    file_.Close();
+  }
+}
+
+void Encoder::Write(const uint8_t *data, uint64_t size) { file_.Write(data, size); }
+
+void Encoder::WriteMarker(Marker marker) { durability::WriteMarker(this, marker); }
+
+void Encoder::WriteBool(bool value) { durability::WriteBool(this, value); }
+
+void Encoder::WriteUint(uint64_t value) { durability::WriteUint(this, value); }
+
+void Encoder::WriteDouble(double value) { durability::WriteDouble(this, value); }
+
+void Encoder::WriteString(const std::string_view &value) { durability::WriteString(this, value); }
+
+void Encoder::WritePropertyValue(const PropertyValue &value) { durability::WritePropertyValue(this, value); }
 
 uint64_t Encoder::GetPosition() { return file_.GetPosition(); }
 
@@ -152,6 +175,26 @@ std::pair<const uint8_t *, size_t> Encoder::CurrentFileBuffer() const { return f
 
 size_t Encoder::GetSize() { return file_.GetSize(); }
 
+int Encoder::DuplicateDescriptor() { return file_.DuplicateDescriptor(); }
+
+////////////////////////////////
+// BufferEncoder implementation.
+////////////////////////////////
+
+void BufferEncoder::Write(const uint8_t *data, uint64_t size) { buffer_.insert(buffer_.end(), data, data + size); }
+
+void BufferEncoder::WriteMarker(Marker marker) { durability::WriteMarker(this, marker); }
+
+void BufferEncoder::WriteBool(bool value) { durability::WriteBool(this, value); }
+
+void BufferEncoder::WriteUint(uint64_t value) { durability::WriteUint(this, value); }
+
+void BufferEncoder::WriteDouble(double value) { durability::WriteDouble(this, value); }
+
+void BufferEncoder::WriteString(const std::string_view &value) { durability::WriteString(this, value); }
+
+void BufferEncoder::WritePropertyValue(const PropertyValue &value) { durability::WritePropertyValue(this, value); }
+
 //////////////////////////
 // Decoder implementation.
 //////////////////////////
@@ -166,159 +209,154 @@ std::optional<Marker> CastToMarker(uint8_t value) {
   return std::nullopt;
 }
 
-std::optional<uint64_t> ReadSize(Decoder *decoder) {
+// As with the encoders, the format is decoded in the same way by all decoders,
+// they only differ in where the bytes come from (`TDecoder::Read` and
+// `TDecoder::Peek`).
+template <typename TDecoder>
+std::optional<uint64_t> ReadSize(TDecoder *decoder) {
   uint64_t size;
   if (!decoder->Read(reinterpret_cast<uint8_t *>(&size), sizeof(size))) return std::nullopt;
   size = utils::LittleEndianToHost(size);
   return size;
 }
-}  // namespace
-
-std::optional<uint64_t> Decoder::Initialize(const std::filesystem::path &path, const std::string &magic) {
-  if (!file_.Open(path)) return std::nullopt;
-  std::string file_magic(magic.size(), '\0');
-  if (!Read(reinterpret_cast<uint8_t *>(file_magic.data()), file_magic.size())) return std::nullopt;
-  if (file_magic != magic) return std::nullopt;
-  uint64_t version_encoded;
-  if (!Read(reinterpret_cast<uint8_t *>(&version_encoded), sizeof(version_encoded))) return std::nullopt;
-  return utils::LittleEndianToHost(version_encoded);
-}
-
-bool Decoder::Read(uint8_t *data, size_t size) { return file_.Read(data, size); }
 
-bool Decoder::Peek(uint8_t *data, size_t size) { return file_.Peek(data, size); }
-
-std::optional<Marker> Decoder::PeekMarker() {
+template <typename TDecoder>
+std::optional<Marker> PeekMarker(TDecoder *decoder) {
   uint8_t value;
-  if (!Peek(&value, sizeof(value))) return std::nullopt;
+  if (!decoder->Peek(&value, sizeof(value))) return std::nullopt;
   auto marker = CastToMarker(value);
   if (!marker) return std::nullopt;
   return *marker;
 }
 
-std::optional<Marker> Decoder::ReadMarker() {
+template <typename TDecoder>
+std::optional<Marker> ReadMarker(TDecoder *decoder) {
   uint8_t value;
-  if (!Read(&value, sizeof(value))) return std::nullopt;
+  if (!decoder->Read(&value, sizeof(value))) return std::nullopt;
   auto marker = CastToMarker(value);
   if (!marker) return std::nullopt;
   return *marker;
 }
 
-std::optional<bool> Decoder::ReadBool() {
-  auto marker = ReadMarker();
+template <typename TDecoder>
+std::optional<bool> ReadBool(TDecoder *decoder) {
+  auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::TYPE_BOOL) return std::nullopt;
-  auto value = ReadMarker();
+  auto value = decoder->ReadMarker();
   if (!value || (*value != Marker::VALUE_FALSE && *value != Marker::VALUE_TRUE)) return std::nullopt;
   return *value == Marker::VALUE_TRUE;
 }
 
-std::optional<uint64_t> Decoder::ReadUint() {
-  auto marker = ReadMarker();
+template <typename TDecoder>
+std::optional<uint64_t> ReadUint(TDecoder *decoder) {
+  auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::TYPE_INT) return std::nullopt;
   uint64_t value;
-  if (!Read(reinterpret_cast<uint8_t *>(&value), sizeof(value))) return std::nullopt;
+  if (!decoder->Read(reinterpret_cast<uint8_t *>(&value), sizeof(value))) return std::nullopt;
   value = utils::LittleEndianToHost(value);
   return value;
 }
 
-std::optional<double> Decoder::ReadDouble() {
-  auto marker = ReadMarker();
+template <typename TDecoder>
+std::optional<double> ReadDouble(TDecoder *decoder) {
+  auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::TYPE_DOUBLE) return std::nullopt;
   uint64_t value_int;
-  if (!Read(reinterpret_cast<uint8_t *>(&value_int), sizeof(value_int))) return std::nullopt;
+  if (!decoder->Read(reinterpret_cast<uint8_t *>(&value_int), sizeof(value_int))) return std::nullopt;
   value_int = utils::LittleEndianToHost(value_int);
   auto value = utils::MemcpyCast<double>(value_int);
   return value;
 }
 
-std::optional<std::string> Decoder::ReadString() {
-  auto marker = ReadMarker();
+template <typename TDecoder>
+std::optional<std::string> ReadString(TDecoder *decoder) {
+  auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::TYPE_STRING) return std::nullopt;
-  auto size = ReadSize(this);
+  auto size = ReadSize(decoder);
   if (!size) return std::nullopt;
   std::string value(*size, '\0');
-  if (!Read(reinterpret_cast<uint8_t *>(value.data()), *size)) return std::nullopt;
+  if (!decoder->Read(reinterpret_cast<uint8_t *>(value.data()), *size)) return std::nullopt;
   return value;
 }
 
-namespace {
-std::optional<TemporalData> ReadTemporalData(Decoder &decoder) {
-  const auto inner_marker = decoder.ReadMarker();
+template <typename TDecoder>
+std::optional<TemporalData> ReadTemporalData(TDecoder *decoder) {
+  const auto inner_marker = decoder->ReadMarker();
   if (!inner_marker || *inner_marker != Marker::TYPE_TEMPORAL_DATA) return std::nullopt;
 
-  const auto type = decoder.ReadUint();
+  const auto type = decoder->ReadUint();
   if (!type) return std::nullopt;
 
-  const auto microseconds = decoder.ReadUint();
+  const auto microseconds = decoder->ReadUint();
   if (!microseconds) return std::nullopt;
 
   return TemporalData{static_cast<TemporalType>(*type), utils::MemcpyCast<int64_t>(*microseconds)};
 }
-}  // namespace
 
-std::optional<PropertyValue> Decoder::ReadPropertyValue() {
-  auto pv_marker = ReadMarker();
+template <typename TDecoder>
+std::optional<PropertyValue> ReadPropertyValue(TDecoder *decoder) {
+  auto pv_marker = decoder->ReadMarker();
   if (!pv_marker || *pv_marker != Marker::TYPE_PROPERTY_VALUE) return std::nullopt;
 
-  auto marker = PeekMarker();
+  auto marker = PeekMarker(decoder);
   if (!marker) return std::nullopt;
   switch (*marker) {
     case Marker::TYPE_NULL: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       if (!inner_marker || *inner_marker != Marker::TYPE_NULL) return std::nullopt;
       return PropertyValue();
     }
     case Marker::TYPE_BOOL: {
-      auto value = ReadBool();
+      auto value = decoder->ReadBool();
       if (!value) return std::nullopt;
       return PropertyValue(*value);
     }
     case Marker::TYPE_INT: {
-      auto value = ReadUint();
+      auto value = decoder->ReadUint();
       if (!value) return std::nullopt;
       return PropertyValue(utils::MemcpyCast<int64_t>(*value));
     }
     case Marker::TYPE_DOUBLE: {
-      auto value = ReadDouble();
+      auto value = decoder->ReadDouble();
       if (!value) return std::nullopt;
       return PropertyValue(*value);
     }
     case Marker::TYPE_STRING: {
-      auto value = ReadString();
+      auto value = decoder->ReadString();
       if (!value) return std::nullopt;
       return PropertyValue(std::move(*value));
     }
     case Marker::TYPE_LIST: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       if (!inner_marker || *inner_marker != Marker::TYPE_LIST) return std::nullopt;
-      auto size = ReadSize(this);
+      auto size = ReadSize(decoder);
       if (!size) return std::nullopt;
       std::vector<PropertyValue> value;
       value.reserve(*size);
       for (uint64_t i = 0; i < *size; ++i) {
-        auto item = ReadPropertyValue();
+        auto item = decoder->ReadPropertyValue();
         if (!item) return std::nullopt;
         value.emplace_back(std::move(*item));
       }
       return PropertyValue(std::move(value));
     }
     case Marker::TYPE_MAP: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       if (!inner_marker || *inner_marker != Marker::TYPE_MAP) return std::nullopt;
-      auto size = ReadSize(this);
+      auto size = ReadSize(decoder);
       if (!size) return std::nullopt;
       std::map<std::string, PropertyValue> value;
       for (uint64_t i = 0; i < *size; ++i) {
-        auto key = ReadString();
+        auto key = decoder->ReadString();
         if (!key) return std::nullopt;
-        auto item = ReadPropertyValue();
+        auto item = decoder->ReadPropertyValue();
         if (!item) return std::nullopt;
         value.emplace(std::move(*key), std::move(*item));
       }
       return PropertyValue(std::move(value));
     }
     case Marker::TYPE_TEMPORAL_DATA: {
-      const auto maybe_temporal_data = ReadTemporalData(*this);
+      const auto maybe_temporal_data = ReadTemporalData(decoder);
       if (!maybe_temporal_data) return std::nullopt;
       return PropertyValue(*maybe_temporal_data);
     }
@@ -332,6 +370,9 @@ std::optional<PropertyValue> Decoder::ReadPropertyValue() {
     case Marker::SECTION_CONSTRAINTS:
     case Marker::SECTION_DELTA:
     case Marker::SECTION_EPOCH_HISTORY:
+    case Marker::SECTION_BATCHES:
+    case Marker::SECTION_DELETED:
+    case Marker::SECTION_DELTA_BLOCK:
     case Marker::SECTION_OFFSETS:
     case Marker::DELTA_VERTEX_CREATE:
     case Marker::DELTA_VERTEX_DELETE:
@@ -356,10 +397,11 @@ std::optional<PropertyValue> Decoder::ReadPropertyValue() {
   }
 }
 
-bool Decoder::SkipString() {
-  auto marker = ReadMarker();
+template <typename TDecoder>
+bool SkipString(TDecoder *decoder) {
+  auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::TYPE_STRING) return false;
-  auto maybe_size = ReadSize(this);
+  auto maybe_size = ReadSize(decoder);
   if (!maybe_size) return false;
 
   const uint64_t kBufferSize = 262144;
@@ -367,59 +409,60 @@ bool Decoder::SkipString() {
   uint64_t size = *maybe_size;
   while (size > 0) {
     uint64_t to_read = size < kBufferSize ? size : kBufferSize;
-    if (!Read(reinterpret_cast<uint8_t *>(&buffer), to_read)) return false;
+    if (!decoder->Read(reinterpret_cast<uint8_t *>(&buffer), to_read)) return false;
     size -= to_read;
   }
 
   return true;
 }
 
-bool Decoder::SkipPropertyValue() {
-  auto pv_marker = ReadMarker();
+template <typename TDecoder>
+bool SkipPropertyValue(TDecoder *decoder) {
+  auto pv_marker = decoder->ReadMarker();
   if (!pv_marker || *pv_marker != Marker::TYPE_PROPERTY_VALUE) return false;
 
-  auto marker = PeekMarker();
+  auto marker = PeekMarker(decoder);
   if (!marker) return false;
   switch (*marker) {
     case Marker::TYPE_NULL: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       return inner_marker && *inner_marker == Marker::TYPE_NULL;
     }
     case Marker::TYPE_BOOL: {
-      return !!ReadBool();
+      return !!decoder->ReadBool();
     }
     case Marker::TYPE_INT: {
-      return !!ReadUint();
+      return !!decoder->ReadUint();
     }
     case Marker::TYPE_DOUBLE: {
-      return !!ReadDouble();
+      return !!decoder->ReadDouble();
     }
     case Marker::TYPE_STRING: {
-      return SkipString();
+      return decoder->SkipString();
     }
     case Marker::TYPE_LIST: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       if (!inner_marker || *inner_marker != Marker::TYPE_LIST) return false;
-      auto size = ReadSize(this);
+      auto size = ReadSize(decoder);
       if (!size) return false;
       for (uint64_t i = 0; i < *size; ++i) {
-        if (!SkipPropertyValue()) return false;
+        if (!decoder->SkipPropertyValue()) return false;
       }
       return true;
     }
     case Marker::TYPE_MAP: {
-      auto inner_marker = ReadMarker();
+      auto inner_marker = decoder->ReadMarker();
       if (!inner_marker || *inner_marker != Marker::TYPE_MAP) return false;
-      auto size = ReadSize(this);
+      auto size = ReadSize(decoder);
       if (!size) return false;
       for (uint64_t i = 0; i < *size; ++i) {
-        if (!SkipString()) return false;
-        if (!SkipPropertyValue()) return false;
+        if (!decoder->SkipString()) return false;
+        if (!decoder->SkipPropertyValue()) return false;
       }
       return true;
     }
     case Marker::TYPE_TEMPORAL_DATA: {
-      return !!ReadTemporalData(*this);
+      return !!ReadTemporalData(decoder);
     }
 
     case Marker::TYPE_PROPERTY_VALUE:
@@ -431,6 +474,9 @@ bool Decoder::SkipPropertyValue() {
     case Marker::SECTION_CONSTRAINTS:
     case Marker::SECTION_DELTA:
     case Marker::SECTION_EPOCH_HISTORY:
+    case Marker::SECTION_BATCHES:
+    case Marker::SECTION_DELETED:
+    case Marker::SECTION_DELTA_BLOCK:
     case Marker::SECTION_OFFSETS:
     case Marker::DELTA_VERTEX_CREATE:
     case Marker::DELTA_VERTEX_DELETE:
@@ -454,6 +500,39 @@ bool Decoder::SkipPropertyValue() {
       return false;
   }
 }
+}  // namespace
+
+std::optional<uint64_t> Decoder::Initialize(const std::filesystem::path &path, const std::string &magic) {
+  if (!file_.Open(path)) return std::nullopt;
+  std::string file_magic(magic.size(), '\0');
+  if (!Read(reinterpret_cast<uint8_t *>(file_magic.data()), file_magic.size())) return std::nullopt;
+  if (file_magic != magic) return std::nullopt;
+  uint64_t version_encoded;
+  if (!Read(reinterpret_cast<uint8_t *>(&version_encoded), sizeof(version_encoded))) return std::nullopt;
+  return utils::LittleEndianToHost(version_encoded);
+}
+
+bool Decoder::Read(uint8_t *data, size_t size) { return file_.Read(data, size); }
+
+bool Decoder::Peek(uint8_t *data, size_t size) { return file_.Peek(data, size); }
+
+std::optional<Marker> Decoder::PeekMarker() { return durability::PeekMarker(this); }
+
+std::optional<Marker> Decoder::ReadMarker() { return durability::ReadMarker(this); }
+
+std::optional<bool> Decoder::ReadBool() { return durability::ReadBool(this); }
+
+std::optional<uint64_t> Decoder::ReadUint() { return durability::ReadUint(this); }
+
+std::optional<double> Decoder::ReadDouble() { return durability::ReadDouble(this); }
+
+std::optional<std::string> Decoder::ReadString() { return durability::ReadString(this); }
+
+std::optional<PropertyValue> Decoder::ReadPropertyValue() { return durability::ReadPropertyValue(this); }
+
+bool Decoder::SkipString() { return durability::SkipString(this); }
+
+bool Decoder::SkipPropertyValue() { return durability::SkipPropertyValue(this); }
 
 std::optional<uint64_t> Decoder::GetSize() { return file_.GetSize(); }
 
@@ -461,4 +540,40 @@ std::optional<uint64_t> Decoder::GetPosition() { return file_.GetPosition(); }
 
 bool Decoder::SetPosition(uint64_t position) { return !!file_.SetPosition(utils::InputFile::Position::SET, position); }
 
+////////////////////////////////
+// BufferDecoder implementation.
+////////////////////////////////
+
+BufferDecoder::BufferDecoder(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+bool BufferDecoder::Read(uint8_t *data, size_t size) {
+  if (!Peek(data, size)) return false;
+  position_ += size;
+  return true;
+}
+
+bool BufferDecoder::Peek(uint8_t *data, size_t size) {
+  if (size > size_ - position_) return false;
+  std::copy(data_ + position_, data_ + position_ + size, data);
+  return true;
+}
+
+std::optional<Marker> BufferDecoder::PeekMarker() { return durability::PeekMarker(this); }
+
+std::optional<Marker> BufferDecoder::ReadMarker() { return durability::ReadMarker(this); }
+
+std::optional<bool> BufferDecoder::ReadBool() { return durability::ReadBool(this); }
+
+std::optional<uint64_t> BufferDecoder::ReadUint() { return durability::ReadUint(this); }
+
+std::optional<double> BufferDecoder::ReadDouble() { return durability::ReadDouble(this); }
+
+std::optional<std::string> BufferDecoder::ReadString() { return durability::ReadString(this); }
+
+std::optional<PropertyValue> BufferDecoder::ReadPropertyValue() { return durability::ReadPropertyValue(this); }
+
+bool BufferDecoder::SkipString() { return durability::SkipString(this); }
+
+bool BufferDecoder::SkipPropertyValue() { return durability::SkipPropertyValue(this); }
+
 }  // namespace storage::durability
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <string_view>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/durability/marker.hpp"
@@ -76,10 +77,38 @@ class Encoder final : public BaseEncoder {
   // Get the total size of the current file.
   size_t GetSize();
 
+  // Flush the internal buffer and duplicate the file descriptor, see
+  // `utils::OutputFile::DuplicateDescriptor`.
+  int DuplicateDescriptor();
+
  private:
   utils::OutputFile file_;
 };
 
+/// Encoder that writes into a memory buffer using the same format as
+/// `Encoder`. Used to prepare data that is written to a file later.
+class BufferEncoder final : public BaseEncoder {
+ public:
+  void Write(const uint8_t *data, uint64_t size);
+
+  void WriteMarker(Marker marker) override;
+  void WriteBool(bool value) override;
+  void WriteUint(uint64_t value) override;
+  void WriteDouble(double value) override;
+  void WriteString(const std::string_view &value) override;
+  void WritePropertyValue(const PropertyValue &value) override;
+
+  uint8_t *data() { return buffer_.data(); }
+  const uint8_t *data() const { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+
+  // Remove all of the written data, the allocated memory is kept.
+  void clear() { buffer_.clear(); }
+
+ private:
+  std::vector<uint8_t> buffer_;
+};
+
 /// Decoder interface class. Used to implement streams from different sources
 /// (e.g. file and network).
 class BaseDecoder {
@@ -128,4 +157,34 @@ class Decoder final : public BaseDecoder {
   utils::InputFile file_;
 };
 
+/// Decoder that reads from a memory buffer written in the same format as
+/// `Encoder` (e.g. by `BufferEncoder`). The buffer isn't copied and must
+/// outlive the decoder.
+class BufferDecoder final : public BaseDecoder {
+ public:
+  BufferDecoder(const uint8_t *data, size_t size);
+
+  bool Read(uint8_t *data, size_t size);
+  bool Peek(uint8_t *data, size_t size);
+
+  std::optional<Marker> PeekMarker();
+
+  std::optional<Marker> ReadMarker() override;
+  std::optional<bool> ReadBool() override;
+  std::optional<uint64_t> ReadUint() override;
+  std::optional<double> ReadDouble() override;
+  std::optional<std::string> ReadString() override;
+  std::optional<PropertyValue> ReadPropertyValue() override;
+
+  bool SkipString() override;
+  bool SkipPropertyValue() override;
+
+  bool Empty() const { return position_ == size_; }
+
+ private:
+  const uint8_t *data_;
+  size_t size_;
+  size_t position_{0};
+};
+
 }  // namespace storage::durability
@@ -8,8 +8,13 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0, included in the file
 // licenses/APL.txt.
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
 #include "storage/v2/durability/snapshot.hpp"
 
 #include "storage/v2/durability/exceptions.hpp"
@@ -24,6 +29,7 @@
 #include "utils/file_locker.hpp"
 #include "utils/logging.hpp"
 #include "utils/message.hpp"
+#include "utils/parallel.hpp"
 
 namespace storage::durability {
 
@@ -40,7 +46,11 @@ namespace storage::durability {
 //     * offset to the indices section
 //     * offset to the constraints section
 //     * offset to the mapper section
+//     * offset to the epoch history section
 //     * offset to the metadata section
+//     * offset to the batches section (from version 15)
+//     * offset to the deleted objects section (from version 16, `0` for full
+//       snapshots)
 //
 // 4) Encoded edges (if properties on edges are enabled); each edge is written
 //    in the following format:
@@ -80,17 +90,81 @@ namespace storage::durability {
 //         * id
 //         * name
 //
-// 9) Metadata
+// 9) Epoch history
+//     * epoch id
+//     * last commit timestamp
+//
+// 10) Batches (from version 15); the edges and vertices are sorted by gid and
+//     split into batches that can be decoded independently
+//     * edge batches
+//         * offset of the first edge in the batch
+//         * number of edges in the batch
+//     * vertex batches
+//         * offset of the first vertex in the batch
+//         * number of vertices in the batch
+//
+// 11) Deleted objects (from version 16, only in incremental snapshots)
+//     * gids of the deleted edges
+//     * gids of the deleted vertices
+//
+// 12) Metadata
 //     * storage UUID
 //     * snapshot transaction start timestamp (required when recovering
 //       from snapshot combined with WAL to determine what deltas need to be
 //       applied)
 //     * number of edges
 //     * number of vertices
+//     * start timestamp of the full snapshot the chain is based on (from
+//       version 16)
+//     * start timestamp of the previous snapshot in the chain (from version
+//       16)
+//
+// An incremental snapshot (from version 16) contains only the edges and
+// vertices that were changed since the previous snapshot in its chain and the
+// gids of the objects that were deleted since then. The indices, constraints
+// and epoch history are always written in full.
 //
 // IMPORTANT: When changing snapshot encoding/decoding bump the snapshot/WAL
 // version in `version.hpp`.
 
+namespace {
+
+// Returns the gid of the first object of every batch when the objects are
+// split into batches of `items_per_batch` objects.
+template <typename TObj>
+std::vector<Gid> SplitIntoBatches(utils::SkipList<TObj> *objects, uint64_t items_per_batch) {
+  std::vector<Gid> batch_starts;
+  uint64_t count = 0;
+  auto acc = objects->access();
+  for (const auto &object : acc) {
+    if (count++ % items_per_batch == 0) batch_starts.push_back(object.gid);
+  }
+  return batch_starts;
+}
+
+// Same as above, for the sorted gids of the objects changed since the
+// previous snapshot.
+std::vector<Gid> SplitIntoBatches(const std::vector<Gid> &gids, uint64_t items_per_batch) {
+  std::vector<Gid> batch_starts;
+  for (uint64_t i = 0; i < gids.size(); i += items_per_batch) {
+    batch_starts.push_back(gids[i]);
+  }
+  return batch_starts;
+}
+
+// Edges or vertices of a single batch encoded in memory.
+struct EncodedBatch {
+  BufferEncoder data;
+  uint64_t count{0};
+  std::unordered_set<uint64_t> used_ids;
+  // Gids of the changed objects that don't exist anymore (incremental
+  // snapshots only).
+  std::vector<uint64_t> deleted;
+  std::string debug_info;
+};
+
+}  // namespace
+
 // Function used to read information about the snapshot file.
 SnapshotInfo ReadSnapshotInfo(const std::filesystem::path &path) {
   // Check magic and version.
@@ -125,6 +199,8 @@ SnapshotInfo ReadSnapshotInfo(const std::filesystem::path &path) {
     info.offset_mapper = read_offset();
     info.offset_epoch_history = read_offset();
     info.offset_metadata = read_offset();
+    info.offset_batches = *version >= kSnapshotBatchesVersion ? read_offset() : 0;
+    info.offset_deleted = *version >= kIncrementalSnapshotVersion ? read_offset() : 0;
   }
 
   // Read metadata.
@@ -153,6 +229,47 @@ SnapshotInfo ReadSnapshotInfo(const std::filesystem::path &path) {
     auto maybe_vertices = snapshot.ReadUint();
     if (!maybe_vertices) throw RecoveryFailure("Invalid snapshot data!");
     info.vertices_count = *maybe_vertices;
+
+    info.base_start_timestamp = info.start_timestamp;
+    info.previous_start_timestamp = info.start_timestamp;
+    if (*version >= kIncrementalSnapshotVersion) {
+      auto maybe_base = snapshot.ReadUint();
+      if (!maybe_base) throw RecoveryFailure("Invalid snapshot data!");
+      info.base_start_timestamp = *maybe_base;
+      auto maybe_previous = snapshot.ReadUint();
+      if (!maybe_previous) throw RecoveryFailure("Invalid snapshot data!");
+      info.previous_start_timestamp = *maybe_previous;
+      if (info.IsIncremental() != (info.offset_deleted != 0)) throw RecoveryFailure("Invalid snapshot data!");
+    }
+  }
+
+  // Read batches.
+  if (*version >= kSnapshotBatchesVersion) {
+    if (!snapshot.SetPosition(info.offset_batches)) throw RecoveryFailure("Couldn't read data from snapshot!");
+
+    auto marker = snapshot.ReadMarker();
+    if (!marker || *marker != Marker::SECTION_BATCHES) throw RecoveryFailure("Invalid snapshot data!");
+
+    auto read_batches = [&snapshot](std::vector<SnapshotInfo::Batch> *batches, uint64_t expected_count) {
+      auto size = snapshot.ReadUint();
+      if (!size) throw RecoveryFailure("Invalid snapshot data!");
+      uint64_t count = 0;
+      batches->reserve(*size);
+      for (uint64_t i = 0; i < *size; ++i) {
+        auto offset = snapshot.ReadUint();
+        if (!offset) throw RecoveryFailure("Invalid snapshot data!");
+        auto batch_count = snapshot.ReadUint();
+        if (!batch_count) throw RecoveryFailure("Invalid snapshot data!");
+        batches->push_back({*offset, *batch_count});
+        count += *batch_count;
+      }
+      if (count != expected_count) throw RecoveryFailure("Invalid snapshot data!");
+    };
+    read_batches(&info.edge_batches, info.offset_edges != 0 ? info.edges_count : 0);
+    read_batches(&info.vertex_batches, info.vertices_count);
+  } else {
+    if (info.offset_edges != 0) info.edge_batches.push_back({info.offset_edges, info.edges_count});
+    info.vertex_batches.push_back({info.offset_vertices, info.vertices_count});
   }
 
   return info;
@@ -161,7 +278,7 @@ SnapshotInfo ReadSnapshotInfo(const std::filesystem::path &path) {
 RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipList<Vertex> *vertices,
                                utils::SkipList<Edge> *edges,
                                std::deque<std::pair<std::string, uint64_t>> *epoch_history,
-                               NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count, Config::Items items) {
+                               NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count, const Config &config) {
   // std::cout<<"load snapshot here\n";
   RecoveryInfo ret;
   RecoveredIndicesAndConstraints indices_constraints;
@@ -183,7 +300,14 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
 
   // Read snapshot info.
   const auto info = ReadSnapshotInfo(path);
-  spdlog::info("Recovering {} vertices and {} edges.", info.vertices_count, info.edges_count);
+  // The objects of an incremental snapshot replace the objects recovered from
+  // the previous snapshots in its chain.
+  const bool incremental = info.IsIncremental();
+  if (incremental) {
+    spdlog::info("Recovering {} changed vertices and {} changed edges.", info.vertices_count, info.edges_count);
+  } else {
+    spdlog::info("Recovering {} vertices and {} edges.", info.vertices_count, info.edges_count);
+  }
   // Check for edges.
   bool snapshot_has_edges = info.offset_edges != 0;
 
@@ -225,37 +349,77 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
     return EdgeTypeId::FromUint(it->second);
   };
 
-  // Reset current edge count.
-  edge_count->store(0, std::memory_order_release);
+  // Reset current edge count, an incremental snapshot adjusts the count for
+  // the changed vertices.
+  if (!incremental) edge_count->store(0, std::memory_order_release);
+
+  // The edges and vertices are recovered batch by batch on multiple threads.
+  // The batches are sorted by gid so the gids only have to be checked within a
+  // batch and between the neighbouring batches.
+  const auto thread_count = std::max(config.durability.snapshot_thread_count, static_cast<uint64_t>(1));
+  struct BatchGids {
+    uint64_t first{0};
+    uint64_t last{0};
+  };
+  auto check_batch_gids = [](const std::vector<SnapshotInfo::Batch> &batches,
+                             const std::vector<BatchGids> &batch_gids) {
+    uint64_t last = 0;
+    bool has_last = false;
+    for (uint64_t i = 0; i < batches.size(); ++i) {
+      if (batches[i].count == 0) continue;
+      if (has_last && batch_gids[i].first <= last) throw RecoveryFailure("Invalid snapshot data!");
+      last = batch_gids[i].last;
+      has_last = true;
+    }
+    return last;
+  };
+  auto open_batch = [&path](Decoder *snapshot, const SnapshotInfo::Batch &batch) {
+    if (!snapshot->Initialize(path, kSnapshotMagic)) throw RecoveryFailure("Couldn't read snapshot magic and/or version!");
+    if (!snapshot->SetPosition(batch.offset)) throw RecoveryFailure("Couldn't read data from snapshot!");
+  };
 
-  {
-    // Recover edges.
-    auto edge_acc = edges->access();
-    uint64_t last_edge_gid = 0;
-    if (snapshot_has_edges) {
-      spdlog::info("Recovering {} edges.", info.edges_count);
-      if (!snapshot.SetPosition(info.offset_edges)) throw RecoveryFailure("Couldn't read data from snapshot!");
-      for (uint64_t i = 0; i < info.edges_count; ++i) {
+  uint64_t last_edge_gid = 0;
+  uint64_t last_vertex_gid = 0;
+
+  // Recover edges.
+  if (snapshot_has_edges) {
+    spdlog::info("Recovering {} edges in {} batches.", info.edges_count, info.edge_batches.size());
+    std::vector<BatchGids> batch_gids(info.edge_batches.size());
+    utils::RunInParallel(thread_count, info.edge_batches.size(), [&](uint64_t batch_index) {
+      const auto &batch = info.edge_batches[batch_index];
+      auto &gids = batch_gids[batch_index];
+      Decoder snapshot;
+      open_batch(&snapshot, batch);
+      auto edge_acc = edges->access();
+      for (uint64_t i = 0; i < batch.count; ++i) {
         {
           const auto marker = snapshot.ReadMarker();
           if (!marker || *marker != Marker::SECTION_EDGE) throw RecoveryFailure("Invalid snapshot data!");
         }
 
-        if (items.properties_on_edges) {
+        // Read edge GID.
+        auto gid = snapshot.ReadUint();
+        if (!gid) throw RecoveryFailure("Invalid snapshot data!");
+        if (i > 0 && *gid <= gids.last) throw RecoveryFailure("Invalid snapshot data!");
+        if (i == 0) gids.first = *gid;
+        gids.last = *gid;
+
+        if (config.items.properties_on_edges) {
           // Insert edge.
-          auto gid = snapshot.ReadUint();
-          if (!gid) throw RecoveryFailure("Invalid snapshot data!");
-          if (i > 0 && *gid <= last_edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-          last_edge_gid = *gid;
           spdlog::debug("Recovering edge {} with properties.", *gid);
           //hjm begin recover transaction time
           auto tt_ts = snapshot.ReadUint();
           auto from_gid = Gid::FromUint(*(snapshot.ReadUint()));
           auto to_gid = Gid::FromUint(*(snapshot.ReadUint()));
           //hjm end
-          // auto [it, inserted] = edge_acc.insert(Edge{Gid::FromUint(*gid), nullptr});
-          auto [it, inserted] = edge_acc.insert(Edge{Gid::FromUint(*gid), nullptr,*tt_ts,from_gid,to_gid});
-          if (!inserted) throw RecoveryFailure("The edge must be inserted here!");
+          auto [it, inserted] = edge_acc.insert(Edge{Gid::FromUint(*gid), nullptr, *tt_ts, from_gid, to_gid});
+          if (!inserted) {
+            if (!incremental) throw RecoveryFailure("The edge must be inserted here!");
+            it->transaction_st = *tt_ts;
+            it->from_gid = from_gid;
+            it->to_gid = to_gid;
+            it->properties.ClearProperties();
+          }
 
           // Recover properties.
           {
@@ -272,15 +436,12 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
               props.SetProperty(get_property_from_id(*key), *value);
             }
           }
-
         } else {
-          // Read edge GID.
-          auto gid = snapshot.ReadUint();
-          if (!gid) throw RecoveryFailure("Invalid snapshot data!");
-          if (i > 0 && *gid <= last_edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-          last_edge_gid = *gid;
-
           spdlog::debug("Ensuring edge {} doesn't have any properties.", *gid);
+          // Skip transaction time and endpoints.
+          for (int j = 0; j < 3; ++j) {
+            if (!snapshot.ReadUint()) throw RecoveryFailure("Invalid snapshot data!");
+          }
           // Read properties.
           {
             auto props_size = snapshot.ReadUint();
@@ -292,218 +453,280 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
           }
         }
       }
-      spdlog::info("Edges are recovered.");
-    }
+    });
+    last_edge_gid = check_batch_gids(info.edge_batches, batch_gids);
+    spdlog::info("Edges are recovered.");
+  }
 
-    // Recover vertices (labels and properties).
-    if (!snapshot.SetPosition(info.offset_vertices)) throw RecoveryFailure("Couldn't read data from snapshot!");
-    auto vertex_acc = vertices->access();
-    uint64_t last_vertex_gid = 0;
-    spdlog::info("Recovering {} vertices.", info.vertices_count);
-    for (uint64_t i = 0; i < info.vertices_count; ++i) {
-      {
-        auto marker = snapshot.ReadMarker();
-        if (!marker || *marker != Marker::SECTION_VERTEX) throw RecoveryFailure("Invalid snapshot data!");
-      }
+  // Recover vertices (labels and properties).
+  spdlog::info("Recovering {} vertices in {} batches.", info.vertices_count, info.vertex_batches.size());
+  {
+    std::vector<BatchGids> batch_gids(info.vertex_batches.size());
+    utils::RunInParallel(thread_count, info.vertex_batches.size(), [&](uint64_t batch_index) {
+      const auto &batch = info.vertex_batches[batch_index];
+      auto &gids = batch_gids[batch_index];
+      Decoder snapshot;
+      open_batch(&snapshot, batch);
+      auto vertex_acc = vertices->access();
+      for (uint64_t i = 0; i < batch.count; ++i) {
+        {
+          auto marker = snapshot.ReadMarker();
+          if (!marker || *marker != Marker::SECTION_VERTEX) throw RecoveryFailure("Invalid snapshot data!");
+        }
 
-      // Insert vertex.
-      auto gid = snapshot.ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid snapshot data!");
-      if (i > 0 && *gid <= last_vertex_gid) {
-        throw RecoveryFailure("Invalid snapshot data!");
-      }
-      last_vertex_gid = *gid;
-      spdlog::debug("Recovering vertex {}.", *gid);
+        // Insert vertex.
+        auto gid = snapshot.ReadUint();
+        if (!gid) throw RecoveryFailure("Invalid snapshot data!");
+        if (i > 0 && *gid <= gids.last) throw RecoveryFailure("Invalid snapshot data!");
+        if (i == 0) gids.first = *gid;
+        gids.last = *gid;
+        spdlog::debug("Recovering vertex {}.", *gid);
 
-      //hjm begin 
-      auto tt_ts = snapshot.ReadUint();
-      //hjm end
-      auto [it, inserted] = vertex_acc.insert(Vertex{Gid::FromUint(*gid), nullptr,*tt_ts});
-      if (!inserted) throw RecoveryFailure("The vertex must be inserted here!");
+        //hjm begin
+        auto tt_ts = snapshot.ReadUint();
+        //hjm end
+        auto [it, inserted] = vertex_acc.insert(Vertex{Gid::FromUint(*gid), nullptr, *tt_ts});
+        if (!inserted) {
+          if (!incremental) throw RecoveryFailure("The vertex must be inserted here!");
+          it->transaction_st = *tt_ts;
+          it->labels.clear();
+          it->properties.ClearProperties();
+        }
 
-      // Recover labels.
-      spdlog::trace("Recovering labels for vertex {}.", *gid);
-      {
-        auto labels_size = snapshot.ReadUint();
-        if (!labels_size) throw RecoveryFailure("Invalid snapshot data!");
-        auto &labels = it->labels;
-        labels.reserve(*labels_size);
-        for (uint64_t j = 0; j < *labels_size; ++j) {
-          auto label = snapshot.ReadUint();
-          if (!label) throw RecoveryFailure("Invalid snapshot data!");
-          SPDLOG_TRACE("Recovered label \"{}\" for vertex {}.", name_id_mapper->IdToName(snapshot_id_map.at(*label)),
-                       *gid);
-          labels.emplace_back(get_label_from_id(*label));
+        // Recover labels.
+        spdlog::trace("Recovering labels for vertex {}.", *gid);
+        {
+          auto labels_size = snapshot.ReadUint();
+          if (!labels_size) throw RecoveryFailure("Invalid snapshot data!");
+          auto &labels = it->labels;
+          labels.reserve(*labels_size);
+          for (uint64_t j = 0; j < *labels_size; ++j) {
+            auto label = snapshot.ReadUint();
+            if (!label) throw RecoveryFailure("Invalid snapshot data!");
+            SPDLOG_TRACE("Recovered label \"{}\" for vertex {}.", name_id_mapper->IdToName(snapshot_id_map.at(*label)),
+                         *gid);
+            labels.emplace_back(get_label_from_id(*label));
+          }
         }
-      }
 
-      // Recover properties.
-      spdlog::trace("Recovering properties for vertex {}.", *gid);
-      {
-        auto props_size = snapshot.ReadUint();
-        if (!props_size) throw RecoveryFailure("Invalid snapshot data!");
-        auto &props = it->properties;
-        for (uint64_t j = 0; j < *props_size; ++j) {
-          auto key = snapshot.ReadUint();
-          if (!key) throw RecoveryFailure("Invalid snapshot data!");
-          auto value = snapshot.ReadPropertyValue();
-          if (!value) throw RecoveryFailure("Invalid snapshot data!");
-          SPDLOG_TRACE("Recovered property \"{}\" with value \"{}\" for vertex {}.",
-                       name_id_mapper->IdToName(snapshot_id_map.at(*key)), *value, *gid);
-          props.SetProperty(get_property_from_id(*key), *value);
+        // Recover properties.
+        spdlog::trace("Recovering properties for vertex {}.", *gid);
+        {
+          auto props_size = snapshot.ReadUint();
+          if (!props_size) throw RecoveryFailure("Invalid snapshot data!");
+          auto &props = it->properties;
+          for (uint64_t j = 0; j < *props_size; ++j) {
+            auto key = snapshot.ReadUint();
+            if (!key) throw RecoveryFailure("Invalid snapshot data!");
+            auto value = snapshot.ReadPropertyValue();
+            if (!value) throw RecoveryFailure("Invalid snapshot data!");
+            SPDLOG_TRACE("Recovered property \"{}\" with value \"{}\" for vertex {}.",
+                         name_id_mapper->IdToName(snapshot_id_map.at(*key)), *value, *gid);
+            props.SetProperty(get_property_from_id(*key), *value);
+          }
         }
-      }
 
-      // Skip in edges.
-      {
-        auto in_size = snapshot.ReadUint();
-        if (!in_size) throw RecoveryFailure("Invalid snapshot data!");
-        for (uint64_t j = 0; j < *in_size; ++j) {
-          auto edge_gid = snapshot.ReadUint();
-          if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-          auto from_gid = snapshot.ReadUint();
-          if (!from_gid) throw RecoveryFailure("Invalid snapshot data!");
-          auto edge_type = snapshot.ReadUint();
-          if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
+        // Skip in and out edges.
+        for (int direction = 0; direction < 2; ++direction) {
+          auto edges_size = snapshot.ReadUint();
+          if (!edges_size) throw RecoveryFailure("Invalid snapshot data!");
+          for (uint64_t j = 0; j < *edges_size; ++j) {
+            auto edge_gid = snapshot.ReadUint();
+            if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
+            auto other_gid = snapshot.ReadUint();
+            if (!other_gid) throw RecoveryFailure("Invalid snapshot data!");
+            auto edge_type = snapshot.ReadUint();
+            if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
+          }
         }
       }
+    });
+    last_vertex_gid = check_batch_gids(info.vertex_batches, batch_gids);
+  }
+  spdlog::info("Vertices are recovered.");
 
-      // Skip out edges.
-      auto out_size = snapshot.ReadUint();
-      if (!out_size) throw RecoveryFailure("Invalid snapshot data!");
-      for (uint64_t j = 0; j < *out_size; ++j) {
-        auto edge_gid = snapshot.ReadUint();
-        if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-        auto to_gid = snapshot.ReadUint();
-        if (!to_gid) throw RecoveryFailure("Invalid snapshot data!");
-        auto edge_type = snapshot.ReadUint();
-        if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
-      }
-    }
-    spdlog::info("Vertices are recovered.");
+  // Recover vertices (in/out edges). All vertices have to be inserted before
+  // the connectivity can be recovered.
+  spdlog::info("Recovering connectivity.");
+  {
+    std::vector<uint64_t> batch_last_edge_gids(info.vertex_batches.size(), 0);
+    utils::RunInParallel(thread_count, info.vertex_batches.size(), [&](uint64_t batch_index) {
+      const auto &batch = info.vertex_batches[batch_index];
+      auto &batch_last_edge_gid = batch_last_edge_gids[batch_index];
+      Decoder snapshot;
+      open_batch(&snapshot, batch);
+      auto vertex_acc = vertices->access();
+      auto edge_acc = edges->access();
+      auto vertex_it = vertex_acc.end();
+      for (uint64_t i = 0; i < batch.count; ++i) {
+        {
+          auto marker = snapshot.ReadMarker();
+          if (!marker || *marker != Marker::SECTION_VERTEX) throw RecoveryFailure("Invalid snapshot data!");
+        }
 
-    // Recover vertices (in/out edges).
-    spdlog::info("Recovering connectivity.");
-    if (!snapshot.SetPosition(info.offset_vertices)) throw RecoveryFailure("Couldn't read data from snapshot!");
-    for (auto &vertex : vertex_acc) {
-      {
-        auto marker = snapshot.ReadMarker();
-        if (!marker || *marker != Marker::SECTION_VERTEX) throw RecoveryFailure("Invalid snapshot data!");
-      }
+        // Find vertex, the vertices of a batch are consecutive in the skip list
+        // unless the snapshot is incremental.
+        auto gid = snapshot.ReadUint();
+        if (!gid) throw RecoveryFailure("Invalid snapshot data!");
+        if (i == 0 || incremental) {
+          vertex_it = vertex_acc.find(Gid::FromUint(*gid));
+        } else {
+          ++vertex_it;
+        }
+        if (vertex_it == vertex_acc.end() || vertex_it->gid.AsUint() != *gid) {
+          throw RecoveryFailure("Invalid snapshot data!");
+        }
+        auto &vertex = *vertex_it;
+        if (incremental) {
+          edge_count->fetch_sub(vertex.out_edges.size(), std::memory_order_acq_rel);
+          vertex.in_edges.clear();
+          vertex.out_edges.clear();
+        }
+        spdlog::trace("Recovering connectivity for vertex {}.", vertex.gid.AsUint());
+        //hjm begin
+        auto tt_ts = snapshot.ReadUint();
+        if (!tt_ts) throw RecoveryFailure("Invalid snapshot data!");
+        //hjm end
 
-      spdlog::trace("Recovering connectivity for vertex {}.", vertex.gid.AsUint());
-      // Check vertex.
-      auto gid = snapshot.ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid snapshot data!");
-      if (gid != vertex.gid.AsUint()) throw RecoveryFailure("Invalid snapshot data!");
-      //hjm begin
-      auto tt_ts=snapshot.ReadUint();
-      //hjm end
-      
-      // Skip labels.
-      {
-        auto labels_size = snapshot.ReadUint();
-        if (!labels_size) throw RecoveryFailure("Invalid snapshot data!");
-        for (uint64_t j = 0; j < *labels_size; ++j) {
-          auto label = snapshot.ReadUint();
-          if (!label) throw RecoveryFailure("Invalid snapshot data!");
+        // Skip labels.
+        {
+          auto labels_size = snapshot.ReadUint();
+          if (!labels_size) throw RecoveryFailure("Invalid snapshot data!");
+          for (uint64_t j = 0; j < *labels_size; ++j) {
+            auto label = snapshot.ReadUint();
+            if (!label) throw RecoveryFailure("Invalid snapshot data!");
+          }
         }
-      }
 
-      // Skip properties.
-      {
-        auto props_size = snapshot.ReadUint();
-        if (!props_size) throw RecoveryFailure("Invalid snapshot data!");
-        for (uint64_t j = 0; j < *props_size; ++j) {
-          auto key = snapshot.ReadUint();
-          if (!key) throw RecoveryFailure("Invalid snapshot data!");
-          auto value = snapshot.SkipPropertyValue();
-          if (!value) throw RecoveryFailure("Invalid snapshot data!");
+        // Skip properties.
+        {
+          auto props_size = snapshot.ReadUint();
+          if (!props_size) throw RecoveryFailure("Invalid snapshot data!");
+          for (uint64_t j = 0; j < *props_size; ++j) {
+            auto key = snapshot.ReadUint();
+            if (!key) throw RecoveryFailure("Invalid snapshot data!");
+            auto value = snapshot.SkipPropertyValue();
+            if (!value) throw RecoveryFailure("Invalid snapshot data!");
+          }
         }
-      }
 
-      // Recover in edges.
-      {
-        spdlog::trace("Recovering inbound edges for vertex {}.", vertex.gid.AsUint());
-        auto in_size = snapshot.ReadUint();
-        if (!in_size) throw RecoveryFailure("Invalid snapshot data!");
-        vertex.in_edges.reserve(*in_size);
-        for (uint64_t j = 0; j < *in_size; ++j) {
-          auto edge_gid = snapshot.ReadUint();
-          if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-          last_edge_gid = std::max(last_edge_gid, *edge_gid);
-
-          auto from_gid = snapshot.ReadUint();
-          if (!from_gid) throw RecoveryFailure("Invalid snapshot data!");
-          auto edge_type = snapshot.ReadUint();
-          if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
-
-          auto from_vertex = vertex_acc.find(Gid::FromUint(*from_gid));
-          if (from_vertex == vertex_acc.end()) throw RecoveryFailure("Invalid from vertex!");
-
-          EdgeRef edge_ref(Gid::FromUint(*edge_gid));
-          if (items.properties_on_edges) {
+        // Returns the reference to the edge, the edge objects are shared by
+        // both of the endpoints.
+        auto get_edge_ref = [&](uint64_t edge_gid) {
+          EdgeRef edge_ref(Gid::FromUint(edge_gid));
+          if (config.items.properties_on_edges) {
             if (snapshot_has_edges) {
-              auto edge = edge_acc.find(Gid::FromUint(*edge_gid));
+              auto edge = edge_acc.find(Gid::FromUint(edge_gid));
               if (edge == edge_acc.end()) throw RecoveryFailure("Invalid edge!");
               edge_ref = EdgeRef(&*edge);
             } else {
-              auto [edge, inserted] = edge_acc.insert(Edge{Gid::FromUint(*edge_gid), nullptr});
+              auto [edge, inserted] = edge_acc.insert(Edge{Gid::FromUint(edge_gid), nullptr});
               edge_ref = EdgeRef(&*edge);
             }
           }
-          SPDLOG_TRACE("Recovered inbound edge {} with label \"{}\" from vertex {}.", *edge_gid,
-                       name_id_mapper->IdToName(snapshot_id_map.at(*edge_type)), from_vertex->gid.AsUint());
-          vertex.in_edges.emplace_back(get_edge_type_from_id(*edge_type), &*from_vertex, edge_ref);
+          return edge_ref;
+        };
+
+        // Recover in edges.
+        {
+          spdlog::trace("Recovering inbound edges for vertex {}.", vertex.gid.AsUint());
+          auto in_size = snapshot.ReadUint();
+          if (!in_size) throw RecoveryFailure("Invalid snapshot data!");
+          vertex.in_edges.reserve(*in_size);
+          for (uint64_t j = 0; j < *in_size; ++j) {
+            auto edge_gid = snapshot.ReadUint();
+            if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
+            batch_last_edge_gid = std::max(batch_last_edge_gid, *edge_gid);
+
+            auto from_gid = snapshot.ReadUint();
+            if (!from_gid) throw RecoveryFailure("Invalid snapshot data!");
+            auto edge_type = snapshot.ReadUint();
+            if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
+
+            auto from_vertex = vertex_acc.find(Gid::FromUint(*from_gid));
+            if (from_vertex == vertex_acc.end()) throw RecoveryFailure("Invalid from vertex!");
+
+            auto edge_ref = get_edge_ref(*edge_gid);
+            SPDLOG_TRACE("Recovered inbound edge {} with label \"{}\" from vertex {}.", *edge_gid,
+                         name_id_mapper->IdToName(snapshot_id_map.at(*edge_type)), from_vertex->gid.AsUint());
+            vertex.in_edges.emplace_back(get_edge_type_from_id(*edge_type), &*from_vertex, edge_ref);
+          }
         }
-      }
 
-      // Recover out edges.
-      {
-        spdlog::trace("Recovering outbound edges for vertex {}.", vertex.gid.AsUint());
-        auto out_size = snapshot.ReadUint();
-        if (!out_size) throw RecoveryFailure("Invalid snapshot data!");
-        vertex.out_edges.reserve(*out_size);
-        for (uint64_t j = 0; j < *out_size; ++j) {
-          auto edge_gid = snapshot.ReadUint();
-          if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
-          last_edge_gid = std::max(last_edge_gid, *edge_gid);
-
-          auto to_gid = snapshot.ReadUint();
-          if (!to_gid) throw RecoveryFailure("Invalid snapshot data!");
-          auto edge_type = snapshot.ReadUint();
-          if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
-
-          auto to_vertex = vertex_acc.find(Gid::FromUint(*to_gid));
-          if (to_vertex == vertex_acc.end()) throw RecoveryFailure("Invalid to vertex!");
-
-          EdgeRef edge_ref(Gid::FromUint(*edge_gid));
-          if (items.properties_on_edges) {
-            if (snapshot_has_edges) {
-              auto edge = edge_acc.find(Gid::FromUint(*edge_gid));
-              if (edge == edge_acc.end()) throw RecoveryFailure("Invalid edge!");
-              edge_ref = EdgeRef(&*edge);
-            } else {
-              auto [edge, inserted] = edge_acc.insert(Edge{Gid::FromUint(*edge_gid), nullptr});
-              edge_ref = EdgeRef(&*edge);
-            }
+        // Recover out edges.
+        {
+          spdlog::trace("Recovering outbound edges for vertex {}.", vertex.gid.AsUint());
+          auto out_size = snapshot.ReadUint();
+          if (!out_size) throw RecoveryFailure("Invalid snapshot data!");
+          vertex.out_edges.reserve(*out_size);
+          for (uint64_t j = 0; j < *out_size; ++j) {
+            auto edge_gid = snapshot.ReadUint();
+            if (!edge_gid) throw RecoveryFailure("Invalid snapshot data!");
+            batch_last_edge_gid = std::max(batch_last_edge_gid, *edge_gid);
+
+            auto to_gid = snapshot.ReadUint();
+            if (!to_gid) throw RecoveryFailure("Invalid snapshot data!");
+            auto edge_type = snapshot.ReadUint();
+            if (!edge_type) throw RecoveryFailure("Invalid snapshot data!");
+
+            auto to_vertex = vertex_acc.find(Gid::FromUint(*to_gid));
+            if (to_vertex == vertex_acc.end()) throw RecoveryFailure("Invalid to vertex!");
+
+            auto edge_ref = get_edge_ref(*edge_gid);
+            SPDLOG_TRACE("Recovered outbound edge {} with label \"{}\" to vertex {}.", *edge_gid,
+                         name_id_mapper->IdToName(snapshot_id_map.at(*edge_type)), to_vertex->gid.AsUint());
+            vertex.out_edges.emplace_back(get_edge_type_from_id(*edge_type), &*to_vertex, edge_ref);
           }
-          SPDLOG_TRACE("Recovered outbound edge {} with label \"{}\" to vertex {}.", *edge_gid,
-                       name_id_mapper->IdToName(snapshot_id_map.at(*edge_type)), to_vertex->gid.AsUint());
-          vertex.out_edges.emplace_back(get_edge_type_from_id(*edge_type), &*to_vertex, edge_ref);
+          // Increment edge count. We only increment the count here because the
+          // information is duplicated in in_edges.
+          edge_count->fetch_add(*out_size, std::memory_order_acq_rel);
         }
-        // Increment edge count. We only increment the count here because the
-        // information is duplicated in in_edges.
-        edge_count->fetch_add(*out_size, std::memory_order_acq_rel);
       }
+    });
+    for (auto gid : batch_last_edge_gids) {
+      last_edge_gid = std::max(last_edge_gid, gid);
+    }
+  }
+  spdlog::info("Connectivity is recovered.");
+
+  // Remove the deleted objects. Their neighbours were changed as well, so
+  // none of the recovered vertices points to them anymore.
+  if (incremental) {
+    spdlog::info("Removing deleted objects.");
+    if (!snapshot.SetPosition(info.offset_deleted)) throw RecoveryFailure("Couldn't read data from snapshot!");
+
+    auto marker = snapshot.ReadMarker();
+    if (!marker || *marker != Marker::SECTION_DELETED) throw RecoveryFailure("Invalid snapshot data!");
+
+    auto edge_acc = edges->access();
+    auto size = snapshot.ReadUint();
+    if (!size) throw RecoveryFailure("Invalid snapshot data!");
+    for (uint64_t i = 0; i < *size; ++i) {
+      auto gid = snapshot.ReadUint();
+      if (!gid) throw RecoveryFailure("Invalid snapshot data!");
+      last_edge_gid = std::max(last_edge_gid, *gid);
+      edge_acc.remove(Gid::FromUint(*gid));
     }
-    spdlog::info("Connectivity is recovered.");
 
-    // Set initial values for edge/vertex ID generators.
-    ret.next_edge_id = last_edge_gid + 1;
-    ret.next_vertex_id = last_vertex_gid + 1;
+    auto vertex_acc = vertices->access();
+    size = snapshot.ReadUint();
+    if (!size) throw RecoveryFailure("Invalid snapshot data!");
+    for (uint64_t i = 0; i < *size; ++i) {
+      auto gid = snapshot.ReadUint();
+      if (!gid) throw RecoveryFailure("Invalid snapshot data!");
+      last_vertex_gid = std::max(last_vertex_gid, *gid);
+      auto vertex = vertex_acc.find(Gid::FromUint(*gid));
+      if (vertex == vertex_acc.end()) continue;
+      edge_count->fetch_sub(vertex->out_edges.size(), std::memory_order_acq_rel);
+      vertex_acc.remove(vertex->gid);
+    }
+    spdlog::info("Deleted objects are removed.");
   }
 
+  // Set initial values for edge/vertex ID generators.
+  ret.next_edge_id = last_edge_gid + 1;
+  ret.next_vertex_id = last_vertex_gid + 1;
+
   // Recover indices.
   {
     spdlog::info("Recovering metadata of indices.");
@@ -618,6 +841,9 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
       throw RecoveryFailure("Invalid snapshot data!");
     }
 
+    // The epoch history is written in full to every snapshot.
+    epoch_history->clear();
+
     for (int i = 0; i < *history_size; ++i) {
       auto maybe_epoch_id = snapshot.ReadString();
       if (!maybe_epoch_id) {
@@ -644,15 +870,20 @@ RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipLis
 void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snapshot_directory,
                     const std::filesystem::path &wal_directory, uint64_t snapshot_retention_count,
                     utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
-                    Indices *indices, Constraints *constraints, Config::Items items, const std::string &uuid,
+                    Indices *indices, Constraints *constraints, const Config &config, const std::string &uuid,
                     const std::string_view epoch_id, const std::deque<std::pair<std::string, uint64_t>> &epoch_history,
-                    utils::FileRetainer *file_retainer) {
+                    utils::FileRetainer *file_retainer, const SnapshotChanges *changes) {
   // Ensure that the storage directory exists.
   utils::EnsureDirOrDie(snapshot_directory);
 
   // Create snapshot file.
   auto path = snapshot_directory / MakeSnapshotName(transaction->start_timestamp);
-  spdlog::info("Starting snapshot creation to {}", path);
+  if (changes) {
+    spdlog::info("Starting incremental snapshot creation to {}, {} vertices and {} edges were changed", path,
+                 changes->vertices.size(), changes->edges.size());
+  } else {
+    spdlog::info("Starting snapshot creation to {}", path);
+  }
   Encoder snapshot;
   snapshot.Initialize(path, kSnapshotMagic, kVersion);
 
@@ -665,6 +896,8 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
   uint64_t offset_mapper = 0;
   uint64_t offset_metadata = 0;
   uint64_t offset_epoch_history = 0;
+  uint64_t offset_batches = 0;
+  uint64_t offset_deleted = 0;
   {
     snapshot.WriteMarker(Marker::SECTION_OFFSETS);
     offset_offsets = snapshot.GetPosition();
@@ -675,6 +908,8 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     snapshot.WriteUint(offset_mapper);
     snapshot.WriteUint(offset_epoch_history);
     snapshot.WriteUint(offset_metadata);
+    snapshot.WriteUint(offset_batches);
+    snapshot.WriteUint(offset_deleted);
   }
 
   // Object counters.
@@ -687,8 +922,69 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     used_ids.insert(mapping.AsUint());
     snapshot.WriteUint(mapping.AsUint());
   };
+  auto write_batch_mapping = [](EncodedBatch *batch, auto mapping) {
+    batch->used_ids.insert(mapping.AsUint());
+    batch->data.WriteUint(mapping.AsUint());
+  };
+
+  // The edges and vertices are split into batches by gid. Each batch is
+  // encoded into memory by one of the threads and the encoded batches are
+  // then written to the snapshot in gid order. At most `thread_count` batches
+  // are kept in memory at once.
+  const auto thread_count = std::max(config.durability.snapshot_thread_count, static_cast<uint64_t>(1));
+  const auto items_per_batch = std::max(config.durability.items_per_batch, static_cast<uint64_t>(1));
+  std::vector<SnapshotInfo::Batch> edge_batches;
+  std::vector<SnapshotInfo::Batch> vertex_batches;
+  std::vector<uint64_t> deleted_edges;
+  std::vector<uint64_t> deleted_vertices;
+  // `encode(from, to, batch)` has to encode all visible objects with a gid
+  // in the range [from, to).
+  auto write_batches = [&](const std::vector<Gid> &batch_starts, const auto &encode,
+                           std::vector<SnapshotInfo::Batch> *batches, std::vector<uint64_t> *deleted,
+                           std::ofstream *debug_output) {
+    uint64_t count = 0;
+    for (uint64_t first = 0; first < batch_starts.size(); first += thread_count) {
+      std::vector<EncodedBatch> encoded(std::min(thread_count, static_cast<uint64_t>(batch_starts.size() - first)));
+      utils::RunInParallel(thread_count, encoded.size(), [&](uint64_t i) {
+        const auto index = first + i;
+        const auto to = index + 1 < batch_starts.size() ? std::optional<Gid>(batch_starts[index + 1]) : std::nullopt;
+        encode(batch_starts[index], to, &encoded[i]);
+      });
+      for (auto &batch : encoded) {
+        deleted->insert(deleted->end(), batch.deleted.begin(), batch.deleted.end());
+        if (batch.count == 0) continue;
+        batches->push_back({snapshot.GetPosition(), batch.count});
+        snapshot.Write(batch.data.data(), batch.data.size());
+        used_ids.merge(batch.used_ids);
+        if (prinfFlag) *debug_output << batch.debug_info;
+        count += batch.count;
+      }
+    }
+    return count;
+  };
+  // Calls `encode(object, batch)` for the objects with a gid in the range
+  // [from, to), `encode` returns whether the object is visible. An
+  // incremental snapshot visits only the changed objects and records the
+  // ones that aren't visible anymore as deleted.
+  auto for_each_object = [](auto *objects, const std::vector<Gid> *changed, Gid from, std::optional<Gid> to,
+                            EncodedBatch *batch, const auto &encode) {
+    auto acc = objects->access();
+    if (changed == nullptr) {
+      for (auto it = acc.find_equal_or_greater(from); it != acc.end() && (!to || it->gid < *to); ++it) {
+        encode(*it, batch);
+      }
+      return;
+    }
+    for (auto gid = std::lower_bound(changed->begin(), changed->end(), from);
+         gid != changed->end() && (!to || *gid < *to); ++gid) {
+      auto it = acc.find(*gid);
+      if (it == acc.end() || !encode(*it, batch)) batch->deleted.push_back(gid->AsUint());
+    }
+  };
+  const auto *changed_edges = changes ? &changes->edges : nullptr;
+  const auto *changed_vertices = changes ? &changes->vertices : nullptr;
 
-  // Store all edges.
+  // Store all (or only the changed) edges.
   std::ofstream ofs_edge;
   std::ofstream ofs_vertex;
 
@@ -696,10 +992,9 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     ofs_edge.open("/home/hjm/history_info/current_edge_time.txt",std::ios::out);
     ofs_vertex.open("/home/hjm/history_info/current_vertex_time.txt",std::ios::out);
   }
-  if (items.properties_on_edges) {
+  if (config.items.properties_on_edges) {
     offset_edges = snapshot.GetPosition();
-    auto acc = edges->access();
-    for (auto &edge : acc) {
+    auto encode_edge = [&](Edge &edge, EncodedBatch *batch) {
       // The edge visibility check must be done here manually because we don't
       // allow direct access to the edges through the public API.
       bool is_visible = true;
@@ -729,15 +1024,15 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
           }
         }
       });
-      if (!is_visible) continue;
+      if (!is_visible) return false;
       EdgeRef edge_ref(&edge);
       // Here we create an edge accessor that we will use to get the
       // properties of the edge. The accessor is created with an invalid
       // type and invalid from/to pointers because we don't know them here,
       // but that isn't an issue because we won't use that part of the API
       // here.
-      auto ea =
-          EdgeAccessor{edge_ref, EdgeTypeId::FromUint(0UL), nullptr, nullptr, transaction, indices, constraints, items};
+      auto ea = EdgeAccessor{
+          edge_ref, EdgeTypeId::FromUint(0UL), nullptr, nullptr, transaction, indices, constraints, config.items};
 
       // Get edge data.
       auto maybe_props = ea.Properties(View::OLD);
@@ -745,34 +1040,43 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
 
       // Store the edge.
       {
-        snapshot.WriteMarker(Marker::SECTION_EDGE);
-        snapshot.WriteUint(edge.gid.AsUint());
-        //hjm begin 
-        if(prinfFlag)ofs_edge<<std::to_string(edge.gid.AsUint())<<"####"<<std::to_string(edge.transaction_st)<<"####"<<std::to_string(edge.from_gid.AsUint())<<"####"<<std::to_string(edge.to_gid.AsUint())<<"\n";
-        snapshot.WriteUint(edge.transaction_st);
-        snapshot.WriteUint(edge.from_gid.AsUint());
-        snapshot.WriteUint(edge.to_gid.AsUint());
+        batch->data.WriteMarker(Marker::SECTION_EDGE);
+        batch->data.WriteUint(edge.gid.AsUint());
+        //hjm begin
+        if (prinfFlag)
+          batch->debug_info += std::to_string(edge.gid.AsUint()) + "####" + std::to_string(edge.transaction_st) +
+                               "####" + std::to_string(edge.from_gid.AsUint()) + "####" +
+                               std::to_string(edge.to_gid.AsUint()) + "\n";
+        batch->data.WriteUint(edge.transaction_st);
+        batch->data.WriteUint(edge.from_gid.AsUint());
+        batch->data.WriteUint(edge.to_gid.AsUint());
         //hjm end
         const auto &props = maybe_props.GetValue();
-        snapshot.WriteUint(props.size());
+        batch->data.WriteUint(props.size());
         for (const auto &item : props) {
-          write_mapping(item.first);
-          snapshot.WritePropertyValue(item.second);
+          write_batch_mapping(batch, item.first);
+          batch->data.WritePropertyValue(item.second);
         }
       }
 
-      ++edges_count;
-    }
+      ++batch->count;
+      return true;
+    };
+    auto encode_edges = [&](Gid from, std::optional<Gid> to, EncodedBatch *batch) {
+      for_each_object(edges, changed_edges, from, to, batch, encode_edge);
+    };
+    auto batch_starts = changed_edges ? SplitIntoBatches(*changed_edges, items_per_batch)
+                                      : SplitIntoBatches(edges, items_per_batch);
+    edges_count = write_batches(batch_starts, encode_edges, &edge_batches, &deleted_edges, &ofs_edge);
   }
 
-  // Store all vertices.
+  // Store all (or only the changed) vertices.
   {
     offset_vertices = snapshot.GetPosition();
-    auto acc = vertices->access();
-    for (auto &vertex : acc) {
+    auto encode_vertex = [&](Vertex &vertex, EncodedBatch *batch) {
       // The visibility check is implemented for vertices so we use it here.
-      auto va = VertexAccessor::Create(&vertex, transaction, indices, constraints, items, View::OLD);
-      if (!va) continue;
+      auto va = VertexAccessor::Create(&vertex, transaction, indices, constraints, config.items, View::OLD);
+      if (!va) return false;
 
       // Get vertex data.
       // TODO (mferencevic): All of these functions could be written into a
@@ -788,41 +1092,50 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
 
       // Store the vertex.
       {
-        snapshot.WriteMarker(Marker::SECTION_VERTEX);
-        snapshot.WriteUint(vertex.gid.AsUint());
-        //hjm begin 
-        if(prinfFlag) ofs_vertex<<std::to_string(vertex.gid.AsUint())<<"####"<<std::to_string(vertex.transaction_st)<<"\n";
-        snapshot.WriteUint(vertex.transaction_st);
+        batch->data.WriteMarker(Marker::SECTION_VERTEX);
+        batch->data.WriteUint(vertex.gid.AsUint());
+        //hjm begin
+        if (prinfFlag)
+          batch->debug_info +=
+              std::to_string(vertex.gid.AsUint()) + "####" + std::to_string(vertex.transaction_st) + "\n";
+        batch->data.WriteUint(vertex.transaction_st);
         //hjm end
         const auto &labels = maybe_labels.GetValue();
-        snapshot.WriteUint(labels.size());
+        batch->data.WriteUint(labels.size());
         for (const auto &item : labels) {
-          write_mapping(item);
+          write_batch_mapping(batch, item);
         }
         const auto &props = maybe_props.GetValue();
-        snapshot.WriteUint(props.size());
+        batch->data.WriteUint(props.size());
         for (const auto &item : props) {
-          write_mapping(item.first);
-          snapshot.WritePropertyValue(item.second);
+          write_batch_mapping(batch, item.first);
+          batch->data.WritePropertyValue(item.second);
         }
         const auto &in_edges = maybe_in_edges.GetValue();
-        snapshot.WriteUint(in_edges.size());
+        batch->data.WriteUint(in_edges.size());
         for (const auto &item : in_edges) {
-          snapshot.WriteUint(item.Gid().AsUint());
-          snapshot.WriteUint(item.FromVertex().Gid().AsUint());
-          write_mapping(item.EdgeType());
+          batch->data.WriteUint(item.Gid().AsUint());
+          batch->data.WriteUint(item.FromVertex().Gid().AsUint());
+          write_batch_mapping(batch, item.EdgeType());
         }
         const auto &out_edges = maybe_out_edges.GetValue();
-        snapshot.WriteUint(out_edges.size());
+        batch->data.WriteUint(out_edges.size());
         for (const auto &item : out_edges) {
-          snapshot.WriteUint(item.Gid().AsUint());
-          snapshot.WriteUint(item.ToVertex().Gid().AsUint());
-          write_mapping(item.EdgeType());
+          batch->data.WriteUint(item.Gid().AsUint());
+          batch->data.WriteUint(item.ToVertex().Gid().AsUint());
+          write_batch_mapping(batch, item.EdgeType());
         }
       }
 
-      ++vertices_count;
-    }
+      ++batch->count;
+      return true;
+    };
+    auto encode_vertices = [&](Gid from, std::optional<Gid> to, EncodedBatch *batch) {
+      for_each_object(vertices, changed_vertices, from, to, batch, encode_vertex);
+    };
+    auto batch_starts = changed_vertices ? SplitIntoBatches(*changed_vertices, items_per_batch)
+                                         : SplitIntoBatches(vertices, items_per_batch);
+    vertices_count = write_batches(batch_starts, encode_vertices, &vertex_batches, &deleted_vertices, &ofs_vertex);
   }
   if(prinfFlag){
     ofs_edge.close();
@@ -905,6 +1218,31 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     }
   }
 
+  // Write batches.
+  {
+    offset_batches = snapshot.GetPosition();
+    snapshot.WriteMarker(Marker::SECTION_BATCHES);
+    for (const auto *batches : {&edge_batches, &vertex_batches}) {
+      snapshot.WriteUint(batches->size());
+      for (const auto &[offset, count] : *batches) {
+        snapshot.WriteUint(offset);
+        snapshot.WriteUint(count);
+      }
+    }
+  }
+
+  // Write deleted objects.
+  if (changes) {
+    offset_deleted = snapshot.GetPosition();
+    snapshot.WriteMarker(Marker::SECTION_DELETED);
+    for (const auto *deleted : {&deleted_edges, &deleted_vertices}) {
+      snapshot.WriteUint(deleted->size());
+      for (auto gid : *deleted) {
+        snapshot.WriteUint(gid);
+      }
+    }
+  }
+
   // Write metadata.
   {
     offset_metadata = snapshot.GetPosition();
@@ -914,6 +1252,8 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     snapshot.WriteUint(transaction->start_timestamp);
     snapshot.WriteUint(edges_count);
     snapshot.WriteUint(vertices_count);
+    snapshot.WriteUint(changes ? changes->base_start_timestamp : transaction->start_timestamp);
+    snapshot.WriteUint(changes ? changes->previous_start_timestamp : transaction->start_timestamp);
   }
 
   // Write true offsets.
@@ -926,14 +1266,19 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     snapshot.WriteUint(offset_mapper);
     snapshot.WriteUint(offset_epoch_history);
     snapshot.WriteUint(offset_metadata);
+    snapshot.WriteUint(offset_batches);
+    snapshot.WriteUint(offset_deleted);
   }
 
   // Finalize snapshot file.
   snapshot.Finalize();
   spdlog::info("Snapshot creation successful!");
 
-  // Ensure exactly `snapshot_retention_count` snapshots exist.
-  std::vector<std::pair<uint64_t, std::filesystem::path>> old_snapshot_files;
+  // Ensure exactly `snapshot_retention_count` snapshot chains exist. A chain
+  // is a full snapshot together with the incremental snapshots based on it
+  // and it is kept or deleted as a whole.
+  std::vector<std::tuple<uint64_t, uint64_t, std::filesystem::path>> old_snapshot_files;
+  std::set<uint64_t> retained_bases{changes ? changes->base_start_timestamp : transaction->start_timestamp};
   {
     std::error_code error_code;
     for (const auto &item : std::filesystem::directory_iterator(snapshot_directory, error_code)) {
@@ -942,7 +1287,7 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
       try {
         auto info = ReadSnapshotInfo(item.path());
         if (info.uuid != uuid) continue;
-        old_snapshot_files.emplace_back(info.start_timestamp, item.path());
+        old_snapshot_files.emplace_back(info.start_timestamp, info.base_start_timestamp, item.path());
       } catch (const RecoveryFailure &e) {
         spdlog::warn("Found a corrupt snapshot file {} becuase of: {}", item.path(), e.what());
         continue;
@@ -955,18 +1300,21 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
                                  snapshot_retention_count, error_code.message(), "https://memgr.ph/snapshots"));
     }
     std::sort(old_snapshot_files.begin(), old_snapshot_files.end());
-    if (old_snapshot_files.size() > snapshot_retention_count - 1) {
-      auto num_to_erase = old_snapshot_files.size() - (snapshot_retention_count - 1);
-      for (size_t i = 0; i < num_to_erase; ++i) {
-        const auto &[start_timestamp, snapshot_path] = old_snapshot_files[i];
-        file_retainer->DeleteFile(snapshot_path);
-      }
-      old_snapshot_files.erase(old_snapshot_files.begin(), old_snapshot_files.begin() + num_to_erase);
+    for (auto it = old_snapshot_files.rbegin(); it != old_snapshot_files.rend(); ++it) {
+      if (retained_bases.size() >= snapshot_retention_count) break;
+      const auto &[start_timestamp, base_start_timestamp, snapshot_path] = *it;
+      if (start_timestamp == base_start_timestamp) retained_bases.insert(start_timestamp);
     }
+    std::erase_if(old_snapshot_files, [&](const auto &snapshot_file) {
+      const auto &[start_timestamp, base_start_timestamp, snapshot_path] = snapshot_file;
+      if (retained_bases.contains(base_start_timestamp)) return false;
+      file_retainer->DeleteFile(snapshot_path);
+      return true;
+    });
   }
 
   // Ensure that only the absolutely necessary WAL files exist.
-  if (old_snapshot_files.size() == snapshot_retention_count - 1 && utils::DirExists(wal_directory)) {
+  if (retained_bases.size() == snapshot_retention_count && utils::DirExists(wal_directory)) {
     std::vector<std::tuple<uint64_t, uint64_t, uint64_t, std::filesystem::path>> wal_files;
     std::error_code error_code;
     for (const auto &item : std::filesystem::directory_iterator(wal_directory, error_code)) {
@@ -989,7 +1337,7 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     std::sort(wal_files.begin(), wal_files.end());
     uint64_t snapshot_start_timestamp = transaction->start_timestamp;
     if (!old_snapshot_files.empty()) {
-      snapshot_start_timestamp = old_snapshot_files.front().first;
+      snapshot_start_timestamp = std::get<0>(old_snapshot_files.front());
     }
     std::optional<uint64_t> pos = 0;
     for (uint64_t i = 0; i < wal_files.size(); ++i) {
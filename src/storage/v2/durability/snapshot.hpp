@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/constraints.hpp"
@@ -30,6 +31,13 @@ namespace storage::durability {
 
 /// Structure used to hold information about a snapshot.
 struct SnapshotInfo {
+  /// Part of the edges/vertices section that can be decoded independently of
+  /// the rest of the section.
+  struct Batch {
+    uint64_t offset;
+    uint64_t count;
+  };
+
   uint64_t offset_edges;
   uint64_t offset_vertices;
   uint64_t offset_indices;
@@ -37,12 +45,29 @@ struct SnapshotInfo {
   uint64_t offset_mapper;
   uint64_t offset_epoch_history;
   uint64_t offset_metadata;
+  uint64_t offset_batches;
+  uint64_t offset_deleted;
 
   std::string uuid;
   std::string epoch_id;
   uint64_t start_timestamp;
   uint64_t edges_count;
   uint64_t vertices_count;
+
+  // Start timestamps of the full snapshot the chain is based on and of the
+  // previous snapshot in the chain. Both are equal to `start_timestamp` for
+  // full snapshots.
+  uint64_t base_start_timestamp;
+  uint64_t previous_start_timestamp;
+
+  /// Incremental snapshots contain only the objects that were changed since
+  /// the previous snapshot in their chain.
+  bool IsIncremental() const { return base_start_timestamp != start_timestamp; }
+
+  // Snapshots older than `kSnapshotBatchesVersion` have a single batch per
+  // section.
+  std::vector<Batch> edge_batches;
+  std::vector<Batch> vertex_batches;
 };
 
 /// Structure used to hold information about the snapshot that has been
@@ -53,23 +78,41 @@ struct RecoveredSnapshot {
   RecoveredIndicesAndConstraints indices_constraints;
 };
 
+/// Objects changed since the previous snapshot, used to create an incremental
+/// snapshot. The gids are sorted and unique.
+struct SnapshotChanges {
+  uint64_t base_start_timestamp;
+  uint64_t previous_start_timestamp;
+  std::vector<Gid> vertices;
+  std::vector<Gid> edges;
+};
+
 /// Function used to read information about the snapshot file.
 /// @throw RecoveryFailure
 SnapshotInfo ReadSnapshotInfo(const std::filesystem::path &path);
 
-/// Function used to load the snapshot data into the storage.
+/// Function used to load the snapshot data into the storage. The batches of
+/// the snapshot are loaded on `config.durability.snapshot_thread_count`
+/// threads. An incremental snapshot is applied on top of the data loaded from
+/// the previous snapshot in its chain, the returned `next_*_id`s have to be
+/// combined with the ones recovered from the previous snapshots.
 /// @throw RecoveryFailure
 RecoveredSnapshot LoadSnapshot(const std::filesystem::path &path, utils::SkipList<Vertex> *vertices,
                                utils::SkipList<Edge> *edges,
                                std::deque<std::pair<std::string, uint64_t>> *epoch_history,
-                               NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count, Config::Items items);
+                               NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count, const Config &config);
 
-/// Function used to create a snapshot using the given transaction.
+/// Function used to create a snapshot using the given transaction. The edges
+/// and vertices are encoded in batches of `config.durability.items_per_batch`
+/// objects on `config.durability.snapshot_thread_count` threads. If `changes`
+/// is given, an incremental snapshot that contains only the changed objects
+/// is created. `snapshot_retention_count` full snapshots are kept together
+/// with the incremental snapshots based on them.
 void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snapshot_directory,
                     const std::filesystem::path &wal_directory, uint64_t snapshot_retention_count,
                     utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
-                    Indices *indices, Constraints *constraints, Config::Items items, const std::string &uuid,
+                    Indices *indices, Constraints *constraints, const Config &config, const std::string &uuid,
                     std::string_view epoch_id, const std::deque<std::pair<std::string, uint64_t>> &epoch_history,
-                    utils::FileRetainer *file_retainer);
+                    utils::FileRetainer *file_retainer, const SnapshotChanges *changes = nullptr);
 
 }  // namespace storage::durability
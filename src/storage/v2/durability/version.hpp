@@ -20,10 +20,15 @@ namespace storage::durability {
 // The current version of snapshot and WAL encoding / decoding.
 // IMPORTANT: Please bump this version for every snapshot and/or WAL format
 // change!!!
-const uint64_t kVersion{14};
+const uint64_t kVersion{19};
 
 const uint64_t kOldestSupportedVersion{14};
 const uint64_t kUniqueConstraintVersion{13};
+// Versions 15 and 16 are used by files with a different layout (see the
+// durability integration test fixtures) and can't be read.
+const uint64_t kSnapshotBatchesVersion{17};
+const uint64_t kIncrementalSnapshotVersion{18};
+const uint64_t kWalBlocksVersion{19};
 
 // Magic values written to the start of a snapshot/WAL file to identify it.
 const std::string kSnapshotMagic{"MGsn"};
@@ -32,6 +37,8 @@ const std::string kWalMagic{"MGwl"};
 static_assert(std::is_same_v<uint8_t, unsigned char>);
 
 // Checks whether the loaded snapshot/WAL version is supported.
-inline bool IsVersionSupported(uint64_t version) { return version >= kOldestSupportedVersion && version <= kVersion; }
+inline bool IsVersionSupported(uint64_t version) {
+  return version == kOldestSupportedVersion || (version >= kSnapshotBatchesVersion && version <= kVersion);
+}
 
 }  // namespace storage::durability
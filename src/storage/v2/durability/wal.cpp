@@ -11,14 +11,21 @@
 
 #include "storage/v2/durability/wal.hpp"
 
+#include <cstring>
+
+#include <zlib.h>
+
 #include "storage/v2/delta.hpp"
 #include "storage/v2/durability/exceptions.hpp"
 #include "storage/v2/durability/paths.hpp"
 #include "storage/v2/durability/version.hpp"
 #include "storage/v2/edge.hpp"
 #include "storage/v2/vertex.hpp"
+#include "utils/crc32c.hpp"
+#include "utils/endian.hpp"
 #include "utils/file_locker.hpp"
 #include "utils/logging.hpp"
+#include "utils/parallel.hpp"
 
 namespace storage::durability {
 
@@ -37,7 +44,18 @@ namespace storage::durability {
 //     * sequence number (number indicating the sequence position of this WAL
 //       file)
 //
-// 5) Encoded deltas; each delta is written in the following format:
+// 5) Encoded deltas. Since `kWalBlocksVersion` the deltas are grouped into
+//    blocks of whole transactions, each block is written in the following
+//    format:
+//     * block marker (non-encoded)
+//     * compression of the payload (non-encoded, see `WalBlockCompression`)
+//     * size of the stored payload (non-encoded, little-endian)
+//     * size of the uncompressed payload (non-encoded, little-endian)
+//     * CRC-32C of all of the above and the stored payload (non-encoded,
+//       little-endian)
+//     * payload, the encoded deltas
+//
+//    Each delta is written in the following format:
 //     * commit timestamp
 //     * action (only one of the actions below are encoded)
 //         * vertex create, vertex delete
@@ -75,6 +93,22 @@ namespace storage::durability {
 
 namespace {
 
+// Size of the block header without the checksum.
+constexpr size_t kWalBlockHeaderSize = sizeof(Marker) + sizeof(WalBlockCompression) + 2 * sizeof(uint64_t);
+
+// Compressing tiny blocks doesn't pay off.
+constexpr size_t kWalBlockMinCompressedSize = 512;
+
+void EncodeWalBlockHeader(uint8_t *header, WalBlockCompression compression, uint64_t stored_size,
+                          uint64_t uncompressed_size) {
+  header[0] = static_cast<uint8_t>(Marker::SECTION_DELTA_BLOCK);
+  header[1] = static_cast<uint8_t>(compression);
+  stored_size = utils::HostToLittleEndian(stored_size);
+  uncompressed_size = utils::HostToLittleEndian(uncompressed_size);
+  memcpy(header + 2, &stored_size, sizeof(stored_size));
+  memcpy(header + 2 + sizeof(stored_size), &uncompressed_size, sizeof(uncompressed_size));
+}
+
 Marker OperationToMarker(StorageGlobalOperation operation) {
   switch (operation) {
     case StorageGlobalOperation::LABEL_INDEX_CREATE:
@@ -179,6 +213,9 @@ WalDeltaData::Type MarkerToWalDeltaDataType(Marker marker) {
     case Marker::SECTION_CONSTRAINTS:
     case Marker::SECTION_DELTA:
     case Marker::SECTION_EPOCH_HISTORY:
+    case Marker::SECTION_BATCHES:
+    case Marker::SECTION_DELETED:
+    case Marker::SECTION_DELTA_BLOCK:
     case Marker::SECTION_OFFSETS:
     case Marker::VALUE_FALSE:
     case Marker::VALUE_TRUE:
@@ -317,6 +354,117 @@ WalDeltaData ReadSkipWalDeltaData(BaseDecoder *decoder) {
 
 }  // namespace
 
+WalDeltaDecoder::WalDeltaDecoder(Decoder *file, uint64_t version)
+    : file_(file), blocks_(version >= kWalBlocksVersion), file_size_(file->GetSize()) {}
+
+bool WalDeltaDecoder::LoadBlock() {
+  block_decoder_.reset();
+
+  uint8_t header[kWalBlockHeaderSize];
+  uint32_t crc = 0;
+  if (!file_->Read(header, sizeof(header)) || !file_->Read(reinterpret_cast<uint8_t *>(&crc), sizeof(crc))) {
+    return false;
+  }
+  if (header[0] != static_cast<uint8_t>(Marker::SECTION_DELTA_BLOCK)) return false;
+  const auto compression = static_cast<WalBlockCompression>(header[1]);
+  uint64_t stored_size = 0;
+  uint64_t uncompressed_size = 0;
+  memcpy(&stored_size, header + 2, sizeof(stored_size));
+  memcpy(&uncompressed_size, header + 2 + sizeof(stored_size), sizeof(uncompressed_size));
+  stored_size = utils::LittleEndianToHost(stored_size);
+  uncompressed_size = utils::LittleEndianToHost(uncompressed_size);
+  crc = utils::LittleEndianToHost(crc);
+
+  // Don't trust the sizes before the checksum is verified, a torn block at the
+  // end of the file could otherwise cause a huge allocation.
+  const auto position = file_->GetPosition();
+  if (!file_size_ || !position || stored_size > *file_size_ - *position) return false;
+
+  std::vector<uint8_t> stored(stored_size);
+  if (!file_->Read(stored.data(), stored.size())) return false;
+  if (utils::Crc32c(stored.data(), stored.size(), utils::Crc32c(header, sizeof(header))) != crc) return false;
+
+  switch (compression) {
+    case WalBlockCompression::NONE:
+      if (stored_size != uncompressed_size) return false;
+      block_ = std::move(stored);
+      break;
+    case WalBlockCompression::ZLIB: {
+      block_.resize(uncompressed_size);
+      uLongf size = uncompressed_size;
+      if (uncompress(block_.data(), &size, stored.data(), stored.size()) != Z_OK || size != uncompressed_size) {
+        return false;
+      }
+      break;
+    }
+    default:
+      return false;
+  }
+
+  block_decoder_.emplace(block_.data(), block_.size());
+  return true;
+}
+
+BaseDecoder *WalDeltaDecoder::Current() {
+  if (!blocks_) return file_;
+  // Blocks hold whole deltas, so a new block is loaded only between deltas.
+  while (!block_decoder_ || block_decoder_->Empty()) {
+    if (!LoadBlock()) return nullptr;
+  }
+  return &*block_decoder_;
+}
+
+bool WalDeltaDecoder::Empty() {
+  if (blocks_ && block_decoder_ && !block_decoder_->Empty()) return false;
+  return file_->GetPosition() == file_size_;
+}
+
+std::optional<Marker> WalDeltaDecoder::ReadMarker() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadMarker();
+}
+
+std::optional<bool> WalDeltaDecoder::ReadBool() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadBool();
+}
+
+std::optional<uint64_t> WalDeltaDecoder::ReadUint() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadUint();
+}
+
+std::optional<double> WalDeltaDecoder::ReadDouble() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadDouble();
+}
+
+std::optional<std::string> WalDeltaDecoder::ReadString() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadString();
+}
+
+std::optional<PropertyValue> WalDeltaDecoder::ReadPropertyValue() {
+  auto *decoder = Current();
+  if (!decoder) return std::nullopt;
+  return decoder->ReadPropertyValue();
+}
+
+bool WalDeltaDecoder::SkipString() {
+  auto *decoder = Current();
+  return decoder && decoder->SkipString();
+}
+
+bool WalDeltaDecoder::SkipPropertyValue() {
+  auto *decoder = Current();
+  return decoder && decoder->SkipPropertyValue();
+}
+
 // Function used to read information about the WAL file.
 WalInfo ReadWalInfo(const std::filesystem::path &path) {
   // Check magic and version.
@@ -370,16 +518,17 @@ WalInfo ReadWalInfo(const std::filesystem::path &path) {
 
   // Read deltas.
   info.num_deltas = 0;
-  auto validate_delta = [&wal]() -> std::optional<std::pair<uint64_t, bool>> {
+  wal.SetPosition(info.offset_deltas);
+  WalDeltaDecoder deltas(&wal, *version);
+  auto validate_delta = [&deltas]() -> std::optional<std::pair<uint64_t, bool>> {
     try {
-      auto timestamp = ReadWalDeltaHeader(&wal);
-      auto type = SkipWalDeltaData(&wal);
+      auto timestamp = ReadWalDeltaHeader(&deltas);
+      auto type = SkipWalDeltaData(&deltas);
       return {{timestamp, IsWalDeltaDataTypeTransactionEnd(type)}};
     } catch (const RecoveryFailure &) {
       return std::nullopt;
     }
   };
-  auto size = wal.GetSize();
   // Here we read the whole file and determine the number of valid deltas. A
   // delta is valid only if all of its data can be successfully read. This
   // allows us to recover data from WAL files that are corrupt at the end (eg.
@@ -389,7 +538,7 @@ WalInfo ReadWalInfo(const std::filesystem::path &path) {
   // non-transactional operation).
   std::optional<uint64_t> current_timestamp;
   uint64_t num_deltas = 0;
-  while (wal.GetPosition() != size) {
+  while (!deltas.Empty()) {
     auto ret = validate_delta();
     if (!ret) break;
     auto [timestamp, is_end_of_transaction] = *ret;
@@ -576,6 +725,30 @@ void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, const Delta
   }
 }
 
+namespace {
+// Every encoded delta starts with the `SECTION_DELTA` marker followed by the
+// timestamp encoded with `WriteUint` (type marker + 8 bytes).
+constexpr size_t kDeltaTimestampOffset = 2 * sizeof(Marker);
+}  // namespace
+
+void WalTransactionBuffer::AppendDelta(NameIdMapper *name_id_mapper, Config::Items items, const Delta &delta,
+                                       const Vertex &vertex) {
+  timestamp_offsets_.push_back(encoder_.size() + kDeltaTimestampOffset);
+  EncodeDelta(&encoder_, name_id_mapper, items, delta, vertex, 0);
+}
+
+void WalTransactionBuffer::AppendDelta(NameIdMapper *name_id_mapper, const Delta &delta, const Edge &edge) {
+  timestamp_offsets_.push_back(encoder_.size() + kDeltaTimestampOffset);
+  EncodeDelta(&encoder_, name_id_mapper, delta, edge, 0);
+}
+
+void WalTransactionBuffer::SetTimestamp(uint64_t timestamp) {
+  timestamp = utils::HostToLittleEndian(timestamp);
+  for (auto offset : timestamp_offsets_) {
+    memcpy(encoder_.data() + offset, &timestamp, sizeof(timestamp));
+  }
+}
+
 void EncodeTransactionEnd(BaseEncoder *encoder, uint64_t timestamp) {
   encoder->WriteMarker(Marker::SECTION_DELTA);
   encoder->WriteUint(timestamp);
@@ -618,12 +791,9 @@ void EncodeOperation(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Storage
   }
 }
 
-RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConstraints *indices_constraints,
-                     const std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
-                     utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
-                     Config::Items items) {
-  spdlog::info("Trying to load WAL file {}.", path);
-  RecoveryInfo ret;
+DecodedWal DecodeWal(const std::filesystem::path &path, const std::optional<uint64_t> last_loaded_timestamp) {
+  spdlog::info("Trying to decode WAL file {}.", path);
+  DecodedWal ret;
 
   Decoder wal;
   auto version = wal.Initialize(path, kWalMagic);
@@ -631,48 +801,190 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
   if (!IsVersionSupported(*version)) throw RecoveryFailure("Invalid WAL version!");
 
   // Read wal info.
-  auto info = ReadWalInfo(path);
-  ret.last_commit_timestamp = info.to_timestamp;
+  ret.info = ReadWalInfo(path);
+
+  // Check timestamp.
+  if (last_loaded_timestamp && ret.info.to_timestamp <= *last_loaded_timestamp) {
+    return ret;
+  }
+
+  // Read deltas.
+  wal.SetPosition(ret.info.offset_deltas);
+  WalDeltaDecoder deltas(&wal, *version);
+  for (uint64_t i = 0; i < ret.info.num_deltas; ++i) {
+    // Read WAL delta header to find out the delta timestamp.
+    auto timestamp = ReadWalDeltaHeader(&deltas);
+
+    if (!last_loaded_timestamp || timestamp > *last_loaded_timestamp) {
+      ret.deltas.emplace_back(timestamp, ReadWalDeltaData(&deltas));
+    } else {
+      SkipWalDeltaData(&deltas);
+    }
+  }
+
+  return ret;
+}
+
+RecoveryInfo ApplyWal(const DecodedWal &wal, RecoveredIndicesAndConstraints *indices_constraints,
+                      const std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
+                      utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
+                      Config::Items items, uint64_t thread_count) {
+  RecoveryInfo ret;
+  ret.last_commit_timestamp = wal.info.to_timestamp;
 
   // Check timestamp.
-  if (last_loaded_timestamp && info.to_timestamp <= *last_loaded_timestamp) {
+  if (last_loaded_timestamp && wal.info.to_timestamp <= *last_loaded_timestamp) {
     spdlog::info("Skip loading WAL file because it is too old.");
     return ret;
   }
 
-  // Recover deltas.
-  wal.SetPosition(info.offset_deltas);
+  thread_count = std::max(thread_count, static_cast<uint64_t>(1));
+  const auto partition_of = [thread_count](Gid gid) { return gid.AsUint() % thread_count; };
+
+  // Positions (in `wal.deltas`) of the deltas that are applied by each
+  // partition. A vertex is changed only by the partition of its gid, so the
+  // edge create/delete deltas are applied by the partition of the from vertex
+  // (out edges) and by the partition of the to vertex (in edges).
+  std::vector<std::vector<uint64_t>> partitions(thread_count);
+  std::vector<Gid> deleted_vertices;
+  std::vector<Gid> deleted_edges;
+  uint64_t created_edges_count = 0;
+  uint64_t deleted_edges_count = 0;
   uint64_t deltas_applied = 0;
+
+  // Create the new objects and apply the non-transactional operations.
   auto edge_acc = edges->access();
   auto vertex_acc = vertices->access();
-  spdlog::info("WAL file contains {} deltas.", info.num_deltas);
-  for (uint64_t i = 0; i < info.num_deltas; ++i) {
-    // Read WAL delta header to find out the delta timestamp.
-    auto timestamp = ReadWalDeltaHeader(&wal);
+  spdlog::info("WAL file contains {} deltas.", wal.info.num_deltas);
+  for (uint64_t i = 0; i < wal.deltas.size(); ++i) {
+    const auto &[timestamp, delta] = wal.deltas[i];
+    if (last_loaded_timestamp && timestamp <= *last_loaded_timestamp) continue;
 
-    if (!last_loaded_timestamp || timestamp > *last_loaded_timestamp) {
-      // This delta should be loaded.
-      auto delta = ReadWalDeltaData(&wal);
-      switch (delta.type) {
-        case WalDeltaData::Type::VERTEX_CREATE: {
-          auto [vertex, inserted] = vertex_acc.insert(Vertex{delta.vertex_create_delete.gid, nullptr});
-          if (!inserted) throw RecoveryFailure("The vertex must be inserted here!");
+    switch (delta.type) {
+      case WalDeltaData::Type::VERTEX_CREATE: {
+        auto [vertex, inserted] = vertex_acc.insert(Vertex{delta.vertex_create_delete.gid, nullptr});
+        if (!inserted) throw RecoveryFailure("The vertex must be inserted here!");
 
-          ret.next_vertex_id = std::max(ret.next_vertex_id, delta.vertex_create_delete.gid.AsUint() + 1);
+        ret.next_vertex_id = std::max(ret.next_vertex_id, delta.vertex_create_delete.gid.AsUint() + 1);
 
-          break;
+        break;
+      }
+      case WalDeltaData::Type::VERTEX_DELETE: {
+        deleted_vertices.push_back(delta.vertex_create_delete.gid);
+        break;
+      }
+      case WalDeltaData::Type::VERTEX_ADD_LABEL:
+      case WalDeltaData::Type::VERTEX_REMOVE_LABEL: {
+        partitions[partition_of(delta.vertex_add_remove_label.gid)].push_back(i);
+        break;
+      }
+      case WalDeltaData::Type::VERTEX_SET_PROPERTY: {
+        partitions[partition_of(delta.vertex_edge_set_property.gid)].push_back(i);
+        break;
+      }
+      case WalDeltaData::Type::EDGE_CREATE:
+      case WalDeltaData::Type::EDGE_DELETE: {
+        auto edge_gid = delta.edge_create_delete.gid;
+        if (delta.type == WalDeltaData::Type::EDGE_CREATE) {
+          if (items.properties_on_edges) {
+            auto [edge, inserted] = edge_acc.insert(Edge{edge_gid, nullptr});
+            if (!inserted) throw RecoveryFailure("The edge must be inserted here!");
+          }
+          ret.next_edge_id = std::max(ret.next_edge_id, edge_gid.AsUint() + 1);
+          ++created_edges_count;
+        } else {
+          if (items.properties_on_edges) deleted_edges.push_back(edge_gid);
+          ++deleted_edges_count;
         }
-        case WalDeltaData::Type::VERTEX_DELETE: {
-          auto vertex = vertex_acc.find(delta.vertex_create_delete.gid);
-          if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
-          if (!vertex->in_edges.empty() || !vertex->out_edges.empty())
-            throw RecoveryFailure("The vertex can't be deleted because it still has edges!");
 
-          if (!vertex_acc.remove(delta.vertex_create_delete.gid))
-            throw RecoveryFailure("The vertex must be removed here!");
+        const auto from_partition = partition_of(delta.edge_create_delete.from_vertex);
+        const auto to_partition = partition_of(delta.edge_create_delete.to_vertex);
+        partitions[from_partition].push_back(i);
+        if (to_partition != from_partition) partitions[to_partition].push_back(i);
 
-          break;
+        break;
+      }
+      case WalDeltaData::Type::EDGE_SET_PROPERTY: {
+        if (!items.properties_on_edges)
+          throw RecoveryFailure(
+              "The WAL has properties on edges, but the storage is "
+              "configured without properties on edges!");
+        partitions[partition_of(delta.vertex_edge_set_property.gid)].push_back(i);
+        break;
+      }
+      case WalDeltaData::Type::TRANSACTION_END:
+        break;
+      case WalDeltaData::Type::LABEL_INDEX_CREATE: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
+        AddRecoveredIndexConstraint(&indices_constraints->indices.label, label_id, "The label index already exists!");
+        break;
+      }
+      case WalDeltaData::Type::LABEL_INDEX_DROP: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
+        RemoveRecoveredIndexConstraint(&indices_constraints->indices.label, label_id,
+                                       "The label index doesn't exist!");
+        break;
+      }
+      case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+        auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+        AddRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
+                                    "The label property index already exists!");
+        break;
+      }
+      case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+        auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+        RemoveRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
+                                       "The label property index doesn't exist!");
+        break;
+      }
+      case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+        auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+        AddRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
+                                    "The existence constraint already exists!");
+        break;
+      }
+      case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+        auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+        RemoveRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
+                                       "The existence constraint doesn't exist!");
+        break;
+      }
+      case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
+        std::set<PropertyId> property_ids;
+        for (const auto &prop : delta.operation_label_properties.properties) {
+          property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
+        }
+        AddRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
+                                    "The unique constraint already exists!");
+        break;
+      }
+      case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP: {
+        auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
+        std::set<PropertyId> property_ids;
+        for (const auto &prop : delta.operation_label_properties.properties) {
+          property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
         }
+        RemoveRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
+                                       "The unique constraint doesn't exist!");
+        break;
+      }
+    }
+    ret.next_timestamp = std::max(ret.next_timestamp, timestamp + 1);
+    ++deltas_applied;
+  }
+
+  // Apply the changes of the objects, each partition in its own thread.
+  utils::RunInParallel(thread_count, thread_count, [&](uint64_t partition) {
+    auto edge_acc = edges->access();
+    auto vertex_acc = vertices->access();
+    for (auto i : partitions[partition]) {
+      const auto &delta = wal.deltas[i].second;
+      switch (delta.type) {
         case WalDeltaData::Type::VERTEX_ADD_LABEL:
         case WalDeltaData::Type::VERTEX_REMOVE_LABEL: {
           auto vertex = vertex_acc.find(delta.vertex_add_remove_label.gid);
@@ -703,40 +1015,7 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
 
           break;
         }
-        case WalDeltaData::Type::EDGE_CREATE: {
-          auto from_vertex = vertex_acc.find(delta.edge_create_delete.from_vertex);
-          if (from_vertex == vertex_acc.end()) throw RecoveryFailure("The from vertex doesn't exist!");
-          auto to_vertex = vertex_acc.find(delta.edge_create_delete.to_vertex);
-          if (to_vertex == vertex_acc.end()) throw RecoveryFailure("The to vertex doesn't exist!");
-
-          auto edge_gid = delta.edge_create_delete.gid;
-          auto edge_type_id = EdgeTypeId::FromUint(name_id_mapper->NameToId(delta.edge_create_delete.edge_type));
-          EdgeRef edge_ref(edge_gid);
-          if (items.properties_on_edges) {
-            auto [edge, inserted] = edge_acc.insert(Edge{edge_gid, nullptr});
-            if (!inserted) throw RecoveryFailure("The edge must be inserted here!");
-            edge_ref = EdgeRef(&*edge);
-          }
-          {
-            std::tuple<EdgeTypeId, Vertex *, EdgeRef> link{edge_type_id, &*to_vertex, edge_ref};
-            auto it = std::find(from_vertex->out_edges.begin(), from_vertex->out_edges.end(), link);
-            if (it != from_vertex->out_edges.end()) throw RecoveryFailure("The from vertex already has this edge!");
-            from_vertex->out_edges.push_back(link);
-          }
-          {
-            std::tuple<EdgeTypeId, Vertex *, EdgeRef> link{edge_type_id, &*from_vertex, edge_ref};
-            auto it = std::find(to_vertex->in_edges.begin(), to_vertex->in_edges.end(), link);
-            if (it != to_vertex->in_edges.end()) throw RecoveryFailure("The to vertex already has this edge!");
-            to_vertex->in_edges.push_back(link);
-          }
-
-          ret.next_edge_id = std::max(ret.next_edge_id, edge_gid.AsUint() + 1);
-
-          // Increment edge count.
-          edge_count->fetch_add(1, std::memory_order_acq_rel);
-
-          break;
-        }
+        case WalDeltaData::Type::EDGE_CREATE:
         case WalDeltaData::Type::EDGE_DELETE: {
           auto from_vertex = vertex_acc.find(delta.edge_create_delete.from_vertex);
           if (from_vertex == vertex_acc.end()) throw RecoveryFailure("The from vertex doesn't exist!");
@@ -751,34 +1030,36 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
             if (edge == edge_acc.end()) throw RecoveryFailure("The edge doesn't exist!");
             edge_ref = EdgeRef(&*edge);
           }
-          {
+
+          const bool create = delta.type == WalDeltaData::Type::EDGE_CREATE;
+          if (partition_of(from_vertex->gid) == partition) {
             std::tuple<EdgeTypeId, Vertex *, EdgeRef> link{edge_type_id, &*to_vertex, edge_ref};
             auto it = std::find(from_vertex->out_edges.begin(), from_vertex->out_edges.end(), link);
-            if (it == from_vertex->out_edges.end()) throw RecoveryFailure("The from vertex doesn't have this edge!");
-            std::swap(*it, from_vertex->out_edges.back());
-            from_vertex->out_edges.pop_back();
+            if (create) {
+              if (it != from_vertex->out_edges.end()) throw RecoveryFailure("The from vertex already has this edge!");
+              from_vertex->out_edges.push_back(link);
+            } else {
+              if (it == from_vertex->out_edges.end()) throw RecoveryFailure("The from vertex doesn't have this edge!");
+              std::swap(*it, from_vertex->out_edges.back());
+              from_vertex->out_edges.pop_back();
+            }
           }
-          {
+          if (partition_of(to_vertex->gid) == partition) {
             std::tuple<EdgeTypeId, Vertex *, EdgeRef> link{edge_type_id, &*from_vertex, edge_ref};
             auto it = std::find(to_vertex->in_edges.begin(), to_vertex->in_edges.end(), link);
-            if (it == to_vertex->in_edges.end()) throw RecoveryFailure("The to vertex doesn't have this edge!");
-            std::swap(*it, to_vertex->in_edges.back());
-            to_vertex->in_edges.pop_back();
-          }
-          if (items.properties_on_edges) {
-            if (!edge_acc.remove(edge_gid)) throw RecoveryFailure("The edge must be removed here!");
+            if (create) {
+              if (it != to_vertex->in_edges.end()) throw RecoveryFailure("The to vertex already has this edge!");
+              to_vertex->in_edges.push_back(link);
+            } else {
+              if (it == to_vertex->in_edges.end()) throw RecoveryFailure("The to vertex doesn't have this edge!");
+              std::swap(*it, to_vertex->in_edges.back());
+              to_vertex->in_edges.pop_back();
+            }
           }
 
-          // Decrement edge count.
-          edge_count->fetch_add(-1, std::memory_order_acq_rel);
-
           break;
         }
         case WalDeltaData::Type::EDGE_SET_PROPERTY: {
-          if (!items.properties_on_edges)
-            throw RecoveryFailure(
-                "The WAL has properties on edges, but the storage is "
-                "configured without properties on edges!");
           auto edge = edge_acc.find(delta.vertex_edge_set_property.gid);
           if (edge == edge_acc.end()) throw RecoveryFailure("The edge doesn't exist!");
           auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.vertex_edge_set_property.property));
@@ -786,87 +1067,52 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
           edge->properties.SetProperty(property_id, property_value);
           break;
         }
-        case WalDeltaData::Type::TRANSACTION_END:
-          break;
-        case WalDeltaData::Type::LABEL_INDEX_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
-          AddRecoveredIndexConstraint(&indices_constraints->indices.label, label_id, "The label index already exists!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_INDEX_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
-          RemoveRecoveredIndexConstraint(&indices_constraints->indices.label, label_id,
-                                         "The label index doesn't exist!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          AddRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
-                                      "The label property index already exists!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          RemoveRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
-                                         "The label property index doesn't exist!");
-          break;
-        }
-        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          AddRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
-                                      "The existence constraint already exists!");
-          break;
-        }
-        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          RemoveRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
-                                         "The existence constraint doesn't exist!");
-          break;
-        }
-        case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
-          std::set<PropertyId> property_ids;
-          for (const auto &prop : delta.operation_label_properties.properties) {
-            property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
-          }
-          AddRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
-                                      "The unique constraint already exists!");
-          break;
-        }
-        case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
-          std::set<PropertyId> property_ids;
-          for (const auto &prop : delta.operation_label_properties.properties) {
-            property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
-          }
-          RemoveRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
-                                         "The unique constraint doesn't exist!");
-          break;
-        }
+        default:
+          throw RecoveryFailure("Invalid WAL delta in a partition!");
       }
-      ret.next_timestamp = std::max(ret.next_timestamp, timestamp + 1);
-      ++deltas_applied;
-    } else {
-      // This delta should be skipped.
-      SkipWalDeltaData(&wal);
     }
+  });
+
+  // Remove the deleted objects. Nothing can refer to a deleted object after
+  // its deletion, so it's enough to check the vertex edges at the end.
+  for (const auto &gid : deleted_edges) {
+    if (!edge_acc.remove(gid)) throw RecoveryFailure("The edge must be removed here!");
   }
+  for (const auto &gid : deleted_vertices) {
+    auto vertex = vertex_acc.find(gid);
+    if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
+    if (!vertex->in_edges.empty() || !vertex->out_edges.empty())
+      throw RecoveryFailure("The vertex can't be deleted because it still has edges!");
+
+    if (!vertex_acc.remove(gid)) throw RecoveryFailure("The vertex must be removed here!");
+  }
+
+  // Update edge count.
+  edge_count->fetch_add(created_edges_count, std::memory_order_acq_rel);
+  edge_count->fetch_sub(deleted_edges_count, std::memory_order_acq_rel);
 
   spdlog::info("Applied {} deltas from WAL. Skipped {} deltas, because they were too old.", deltas_applied,
-               info.num_deltas - deltas_applied);
+               wal.info.num_deltas - deltas_applied);
 
   return ret;
 }
 
+RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConstraints *indices_constraints,
+                     const std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
+                     utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
+                     Config::Items items, uint64_t thread_count) {
+  spdlog::info("Trying to load WAL file {}.", path);
+  return ApplyWal(DecodeWal(path, last_loaded_timestamp), indices_constraints, last_loaded_timestamp, vertices, edges,
+                  name_id_mapper, edge_count, items, thread_count);
+}
+
 WalFile::WalFile(const std::filesystem::path &wal_directory, const std::string_view uuid,
                  const std::string_view epoch_id, Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num,
-                 utils::FileRetainer *file_retainer)
+                 utils::FileRetainer *file_retainer, uint64_t block_size, WalBlockCompression compression)
     : items_(items),
       name_id_mapper_(name_id_mapper),
+      block_size_(block_size),
+      compression_(compression),
       path_(wal_directory / MakeWalName()),
       from_timestamp_(0),
       to_timestamp_(0),
@@ -908,20 +1154,30 @@ WalFile::WalFile(const std::filesystem::path &wal_directory, const std::string_v
 
 WalFile::WalFile(std::filesystem::path current_wal_path, Config::Items items, NameIdMapper *name_id_mapper,
                  uint64_t seq_num, uint64_t from_timestamp, uint64_t to_timestamp, uint64_t count,
-                 utils::FileRetainer *file_retainer)
+                 utils::FileRetainer *file_retainer, uint64_t block_size, WalBlockCompression compression)
     : items_(items),
       name_id_mapper_(name_id_mapper),
+      block_size_(block_size),
+      compression_(compression),
       path_(std::move(current_wal_path)),
       from_timestamp_(from_timestamp),
       to_timestamp_(to_timestamp),
       count_(count),
       seq_num_(seq_num),
       file_retainer_(file_retainer) {
+  // Deltas are appended in the format of the existing file.
+  {
+    Decoder wal;
+    auto version = wal.Initialize(path_, kWalMagic);
+    MG_ASSERT(version, "Couldn't read the version of the WAL file {}!", path_);
+    blocks_ = *version >= kWalBlocksVersion;
+  }
   wal_.OpenExisting(path_);
 }
 
 void WalFile::FinalizeWal() {
   if (count_ != 0) {
+    WriteBlock();
     wal_.Finalize();
     // Rename file.
     std::filesystem::path new_path(path_);
@@ -935,6 +1191,7 @@ void WalFile::FinalizeWal() {
 }
 
 void WalFile::DeleteWal() {
+  block_.clear();
   wal_.Close();
   file_retainer_->DeleteFile(path_);
 }
@@ -943,33 +1200,104 @@ WalFile::~WalFile() {
   if (count_ == 0) {
     // Remove empty WAL file.
     utils::DeleteFile(path_);
+  } else {
+    // The file itself is closed (and flushed) by the encoder.
+    WriteBlock();
   }
 }
 
 void WalFile::AppendDelta(const Delta &delta, const Vertex &vertex, uint64_t timestamp) {
-  EncodeDelta(&wal_, name_id_mapper_, items_, delta, vertex, timestamp);
+  if (blocks_) {
+    EncodeDelta(&block_, name_id_mapper_, items_, delta, vertex, timestamp);
+  } else {
+    EncodeDelta(&wal_, name_id_mapper_, items_, delta, vertex, timestamp);
+  }
   UpdateStats(timestamp);
 }
 
 void WalFile::AppendDelta(const Delta &delta, const Edge &edge, uint64_t timestamp) {
-  EncodeDelta(&wal_, name_id_mapper_, delta, edge, timestamp);
+  if (blocks_) {
+    EncodeDelta(&block_, name_id_mapper_, delta, edge, timestamp);
+  } else {
+    EncodeDelta(&wal_, name_id_mapper_, delta, edge, timestamp);
+  }
   UpdateStats(timestamp);
 }
 
+void WalFile::AppendDeltas(const WalTransactionBuffer &buffer, uint64_t timestamp) {
+  if (blocks_) {
+    block_.Write(buffer.data(), buffer.size());
+  } else {
+    wal_.Write(buffer.data(), buffer.size());
+  }
+  for (uint64_t i = 0; i < buffer.DeltaCount(); ++i) {
+    UpdateStats(timestamp);
+  }
+}
+
 void WalFile::AppendTransactionEnd(uint64_t timestamp) {
-  EncodeTransactionEnd(&wal_, timestamp);
+  if (blocks_) {
+    EncodeTransactionEnd(&block_, timestamp);
+  } else {
+    EncodeTransactionEnd(&wal_, timestamp);
+  }
   UpdateStats(timestamp);
+  MaybeWriteBlock();
 }
 
 void WalFile::AppendOperation(StorageGlobalOperation operation, LabelId label, const std::set<PropertyId> &properties,
                               uint64_t timestamp) {
-  EncodeOperation(&wal_, name_id_mapper_, operation, label, properties, timestamp);
+  if (blocks_) {
+    EncodeOperation(&block_, name_id_mapper_, operation, label, properties, timestamp);
+  } else {
+    EncodeOperation(&wal_, name_id_mapper_, operation, label, properties, timestamp);
+  }
   UpdateStats(timestamp);
+  MaybeWriteBlock();
 }
 
-void WalFile::Sync() { wal_.Sync(); }
+void WalFile::MaybeWriteBlock() {
+  if (block_.size() >= block_size_) WriteBlock();
+}
 
-uint64_t WalFile::GetSize() { return wal_.GetSize(); }
+void WalFile::WriteBlock() {
+  if (block_.size() == 0) return;
+
+  auto compression = WalBlockCompression::NONE;
+  const uint8_t *payload = block_.data();
+  uint64_t payload_size = block_.size();
+  if (compression_ == WalBlockCompression::ZLIB && block_.size() >= kWalBlockMinCompressedSize) {
+    compressed_.resize(compressBound(block_.size()));
+    uLongf compressed_size = compressed_.size();
+    // Store the block uncompressed if the compression doesn't reduce its size.
+    if (compress2(compressed_.data(), &compressed_size, block_.data(), block_.size(), Z_BEST_SPEED) == Z_OK &&
+        compressed_size < block_.size()) {
+      compression = WalBlockCompression::ZLIB;
+      payload = compressed_.data();
+      payload_size = compressed_size;
+    }
+  }
+
+  uint8_t header[kWalBlockHeaderSize];
+  EncodeWalBlockHeader(header, compression, payload_size, block_.size());
+  uint32_t crc = utils::HostToLittleEndian(utils::Crc32c(payload, payload_size, utils::Crc32c(header, sizeof(header))));
+  wal_.Write(header, sizeof(header));
+  wal_.Write(reinterpret_cast<const uint8_t *>(&crc), sizeof(crc));
+  wal_.Write(payload, payload_size);
+  block_.clear();
+}
+
+void WalFile::Sync() {
+  WriteBlock();
+  wal_.Sync();
+}
+
+int WalFile::DuplicateDescriptor() {
+  WriteBlock();
+  return wal_.DuplicateDescriptor();
+}
+
+uint64_t WalFile::GetSize() { return wal_.GetSize() + block_.size(); }
 
 uint64_t WalFile::SequenceNumber() const { return seq_num_; }
 
@@ -979,7 +1307,12 @@ void WalFile::UpdateStats(uint64_t timestamp) {
   count_ += 1;
 }
 
-void WalFile::DisableFlushing() { wal_.DisableFlushing(); }
+void WalFile::DisableFlushing() {
+  // The replication reads the file and the internal buffer of the encoder, all
+  // of the collected deltas have to be there.
+  WriteBlock();
+  wal_.DisableFlushing();
+}
 
 void WalFile::EnableFlushing() { wal_.EnableFlushing(); }
 
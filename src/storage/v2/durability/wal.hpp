@@ -13,8 +13,11 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <optional>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/delta.hpp"
@@ -152,6 +155,46 @@ constexpr bool IsWalDeltaDataTypeTransactionEnd(const WalDeltaData::Type type) {
   }
 }
 
+/// Compression of the payload of a WAL delta block.
+enum class WalBlockCompression : uint8_t {
+  NONE = 0,
+  ZLIB = 1,
+};
+
+/// Decoder used to read the deltas of a WAL file positioned at
+/// `WalInfo::offset_deltas`. Starting with `kWalBlocksVersion` the deltas are
+/// stored in checksummed and optionally compressed blocks, this decoder
+/// verifies and unpacks the blocks transparently. Deltas of older WAL files
+/// are read directly from the file. A corrupted or incomplete block is
+/// reported the same way as a corrupted delta, i.e. by failing the read.
+class WalDeltaDecoder final : public BaseDecoder {
+ public:
+  WalDeltaDecoder(Decoder *file, uint64_t version);
+
+  std::optional<Marker> ReadMarker() override;
+  std::optional<bool> ReadBool() override;
+  std::optional<uint64_t> ReadUint() override;
+  std::optional<double> ReadDouble() override;
+  std::optional<std::string> ReadString() override;
+  std::optional<PropertyValue> ReadPropertyValue() override;
+
+  bool SkipString() override;
+  bool SkipPropertyValue() override;
+
+  /// Returns true if all of the deltas were read.
+  bool Empty();
+
+ private:
+  BaseDecoder *Current();
+  bool LoadBlock();
+
+  Decoder *file_;
+  bool blocks_;
+  std::optional<uint64_t> file_size_;
+  std::vector<uint8_t> block_;
+  std::optional<BufferDecoder> block_decoder_;
+};
+
 /// Function used to read information about the WAL file.
 /// @throw RecoveryFailure
 WalInfo ReadWalInfo(const std::filesystem::path &path);
@@ -188,20 +231,75 @@ void EncodeTransactionEnd(BaseEncoder *encoder, uint64_t timestamp);
 void EncodeOperation(BaseEncoder *encoder, NameIdMapper *name_id_mapper, StorageGlobalOperation operation,
                      LabelId label, const std::set<PropertyId> &properties, uint64_t timestamp);
 
+/// Structure used to hold the deltas of a WAL file that were read into memory.
+struct DecodedWal {
+  WalInfo info;
+  // Commit timestamp and data of every delta that should be loaded, in the
+  // order in which they are stored in the WAL file.
+  std::vector<std::pair<uint64_t, WalDeltaData>> deltas;
+};
+
+/// Function used to read the deltas of the WAL file into memory. Deltas that
+/// were committed at or before `last_loaded_timestamp` are skipped. Multiple
+/// WAL files can be decoded concurrently.
+/// @throw RecoveryFailure
+DecodedWal DecodeWal(const std::filesystem::path &path, std::optional<uint64_t> last_loaded_timestamp);
+
+/// Function used to apply the decoded WAL deltas to the storage. Deltas that
+/// were committed at or before `last_loaded_timestamp` are skipped.
+///
+/// Objects are created serially in the WAL order. The changes of existing
+/// objects are then partitioned by the gid of the changed object and applied
+/// on up to `thread_count` threads, the changes of a single object are applied
+/// in the WAL order. Deletions of objects are applied last.
+/// @throw RecoveryFailure
+RecoveryInfo ApplyWal(const DecodedWal &wal, RecoveredIndicesAndConstraints *indices_constraints,
+                      std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
+                      utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
+                      Config::Items items, uint64_t thread_count);
+
 /// Function used to load the WAL data into the storage.
 /// @throw RecoveryFailure
 RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConstraints *indices_constraints,
                      std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
                      utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
-                     Config::Items items);
+                     Config::Items items, uint64_t thread_count = 1);
+
+/// Deltas of a single transaction encoded in memory before the transaction
+/// gets its commit timestamp. This allows the (expensive) encoding to be done
+/// without holding the engine lock, the timestamp is filled in afterwards by
+/// `SetTimestamp`.
+class WalTransactionBuffer {
+ public:
+  void AppendDelta(NameIdMapper *name_id_mapper, Config::Items items, const Delta &delta, const Vertex &vertex);
+  void AppendDelta(NameIdMapper *name_id_mapper, const Delta &delta, const Edge &edge);
+
+  void SetTimestamp(uint64_t timestamp);
+
+  const uint8_t *data() const { return encoder_.data(); }
+  size_t size() const { return encoder_.size(); }
+  uint64_t DeltaCount() const { return timestamp_offsets_.size(); }
+
+ private:
+  BufferEncoder encoder_;
+  std::vector<size_t> timestamp_offsets_;
+};
 
 /// WalFile class used to append deltas and operations to the WAL file.
+///
+/// The deltas are collected in memory and written to the file as a single
+/// block once the collected transactions reach `block_size` bytes (or when the
+/// file is synced, flushed for replication or finalized). A block always holds
+/// whole transactions. Each block is protected by a CRC-32C checksum and is
+/// optionally compressed.
 class WalFile {
  public:
   WalFile(const std::filesystem::path &wal_directory, std::string_view uuid, std::string_view epoch_id,
-          Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num, utils::FileRetainer *file_retainer);
+          Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num, utils::FileRetainer *file_retainer,
+          uint64_t block_size = 0, WalBlockCompression compression = WalBlockCompression::NONE);
   WalFile(std::filesystem::path current_wal_path, Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num,
-          uint64_t from_timestamp, uint64_t to_timestamp, uint64_t count, utils::FileRetainer *file_retainer);
+          uint64_t from_timestamp, uint64_t to_timestamp, uint64_t count, utils::FileRetainer *file_retainer,
+          uint64_t block_size = 0, WalBlockCompression compression = WalBlockCompression::NONE);
 
   WalFile(const WalFile &) = delete;
   WalFile(WalFile &&) = delete;
@@ -213,6 +311,10 @@ class WalFile {
   void AppendDelta(const Delta &delta, const Vertex &vertex, uint64_t timestamp);
   void AppendDelta(const Delta &delta, const Edge &edge, uint64_t timestamp);
 
+  /// Append all deltas from the buffer, the buffer must already have the
+  /// `timestamp` set.
+  void AppendDeltas(const WalTransactionBuffer &buffer, uint64_t timestamp);
+
   void AppendTransactionEnd(uint64_t timestamp);
 
   void AppendOperation(StorageGlobalOperation operation, LabelId label, const std::set<PropertyId> &properties,
@@ -220,6 +322,10 @@ class WalFile {
 
   void Sync();
 
+  // Flush the internal buffer and duplicate the file descriptor, see
+  // `utils::OutputFile::DuplicateDescriptor`.
+  int DuplicateDescriptor();
+
   uint64_t GetSize();
 
   uint64_t SequenceNumber() const;
@@ -248,9 +354,22 @@ class WalFile {
  private:
   void UpdateStats(uint64_t timestamp);
 
+  // Write the block if it reached the block size. Must be called only at the
+  // end of a transaction.
+  void MaybeWriteBlock();
+  // Write the collected deltas to the file as a single block.
+  void WriteBlock();
+
   Config::Items items_;
   NameIdMapper *name_id_mapper_;
   Encoder wal_;
+  // Deltas of the current block, used only if `blocks_` is set, i.e. for WAL
+  // files of version `kWalBlocksVersion` or newer.
+  bool blocks_{true};
+  BufferEncoder block_;
+  uint64_t block_size_;
+  WalBlockCompression compression_;
+  std::vector<uint8_t> compressed_;
   std::filesystem::path path_;
   uint64_t from_timestamp_;
   uint64_t to_timestamp_;
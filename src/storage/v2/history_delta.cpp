@@ -1,6 +1,8 @@
 #include "storage/v2/history_delta.hpp"
 #include "query/db_accessor.hpp"
+#include <algorithm>
 #include <cstring>
+#include <tuple>
 #include <fmt/format.h>
 
 #include <stdlib.h>
@@ -8,6 +10,8 @@
 #include "utils/settings.hpp"
 #include <json/json.hpp>
 #include "query/serialization/property_value.hpp"
+#include "storage/v2/hybrid_clock.hpp"
+#include "utils/logging.hpp"
 namespace history_delta {
 
 namespace {
@@ -132,7 +136,7 @@ std::tuple<uint64_t,int64_t,int64_t> string_convert_to_uint(std::string res,bool
     size_t pos = res.find(":");
     auto get_size=length-2*size-3-pos;
     auto gid_str=res.substr(pos+1,get_size);//3:4 12 20-2*8
-    auto gid=(uint64_t)std::stoi(gid_str);
+    auto gid=(uint64_t)std::stoull(gid_str);
     //处理时间
     auto redo_str1=res.substr(length-size);//12:
     auto redo_str2=res.substr(length-2*size-1,size);//3:12
@@ -206,50 +210,121 @@ const std::string kVertexEdgePrefix = "VE:";
 const std::string kVertexTimePrefix="VT:";
 const std::string kEdgeTimePrefix="ET:";
 
+const std::string kMigratedTimestampKey = "MT:";
 
-History_delta::History_delta(const std::string &storage_directory) : storage_(storage_directory) {}
+// Encoding of the timestamps in the history keys, see `CheckTimestampEncoding`.
+const std::string kTimestampEncodingKey = "TE:";
+const std::string kLogicalEncoding = "logical";
+const std::string kHybridEncoding = "hybrid";
 
-History_delta::History_delta(const std::string &storage_directory,bool realTimeFlag) : storage_(storage_directory) {
+// Hybrid clock timestamps are never smaller than the lower bound of
+// 2000-01-01, raw milliseconds and logical commit timestamps always are.
+constexpr uint64_t kMinHybridTimestamp = storage::HybridClock::LowerBound(946684800000ULL);
+
+
+History_delta::History_delta(const std::string &storage_directory) : storage_(storage_directory) { GetTimeTableAll(); }
+
+History_delta::History_delta(const std::string &storage_directory,bool realTimeFlag,uint64_t ingest_batch_size)
+    : ingest_batch_size_(ingest_batch_size), storage_(storage_directory) {
   realTimeFlagConstant=realTimeFlag;
+  GetTimeTableAll();
+  CheckTimestampEncoding();
+}
+
+std::optional<uint64_t> History_delta::SampleTimestamp() const {
+  if (auto latest = LatestTimestamp(); latest != 0) return latest;
+  // Stores written before the lifetime index was persisted only have the
+  // timestamps in the record keys.
+  for (const auto &prefix : {kVertexDeltaPrefix, kEdgeDeltaPrefix, kVertexAnchorPrefix, kEdgeAnchorPrefix}) {
+    auto it = storage_.starts(prefix);
+    if (!it.IsValid() || !it->first.starts_with(prefix)) continue;
+    auto [gid, ts, te] = string_convert_to_uint(it->first, realTimeFlagConstant);
+    return std::max<uint64_t>(ts < 0 ? -ts : ts, te < 0 ? -te : te);
+  }
+  return std::nullopt;
+}
+
+void History_delta::CheckTimestampEncoding() {
+  const auto &expected = realTimeFlagConstant ? kHybridEncoding : kLogicalEncoding;
+  auto encoding = storage_.Get(kTimestampEncodingKey);
+  if (!encoding) {
+    // The store was created before the encoding was recorded. Logical stores
+    // have the same format as before, real-time stores used to be stamped with
+    // raw milliseconds which can't be told apart from the hybrid timestamps
+    // at query time.
+    auto sample = SampleTimestamp();
+    if (!sample) {
+      encoding = expected;
+    } else {
+      encoding = *sample >= kMinHybridTimestamp ? kHybridEncoding : kLogicalEncoding;
+      if (realTimeFlagConstant && *encoding == kLogicalEncoding) {
+        LOG_FATAL(
+            "The history store was written with millisecond (or logical) timestamps, but real-time history is now "
+            "stamped with hybrid clock timestamps. Start with an empty history store or without --real-time-flag.");
+      }
+    }
+    if (!storage_.Put(kTimestampEncodingKey, *encoding)) {
+      LOG_FATAL("Couldn't save the timestamp encoding of the history store!");
+    }
+  }
+  if (*encoding != expected) {
+    LOG_FATAL("The history store is stamped with {} timestamps, but the storage is configured for {} timestamps. "
+              "Start with {} --real-time-flag.",
+              *encoding, expected, realTimeFlagConstant ? "no" : "the");
+  }
 }
 
 
 
+std::optional<std::pair<int64_t, nlohmann::json>> History_delta::SeekAnchor(const std::string &prefix, uint64_t gid,
+                                                                            uint64_t time) const {
+  // Anchor keys are ordered by the ascending anchor timestamp, so the seek
+  // lands on the oldest anchor that was taken at or after `time`.
+  auto anchor_prefix = prefix + std::to_string(gid) + ":" + uint_convert_to_string((int64_t)time, realTimeFlagConstant);
+  auto it = storage_.starts(anchor_prefix);
+  if (!it.IsValid()) return std::nullopt;
+  auto [anchor_gid, anchor_ts, anchor_te] = string_convert_to_uint(it->first, realTimeFlagConstant);
+  if (anchor_gid != gid || anchor_ts < (int64_t)time) return std::nullopt;
+  return std::make_pair(anchor_ts, nlohmann::json::parse(it->second));
+}
+
+bool History_delta::EdgeHistoryIntersects(uint64_t gid, uint64_t c_ts, uint64_t c_te) const {
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  auto it = edge_time_table_.find(gid);
+  // Stores written before the index was persisted have no entries for their
+  // edges, so a missing entry doesn't prove anything.
+  if (it == edge_time_table_.end()) return true;
+  const auto &[min_ts, max_te] = it->second;
+  return min_ts <= c_te && max_te >= c_ts;
+}
+
 std::pair<std::vector<nlohmann::json>,bool> History_delta::GetEdgeInfo(uint64_t c_ts,uint64_t c_te,std::string type,uint64_t gid){
   std::vector<nlohmann::json> history_Delta;
   bool anchor_flag=false;
+  //0、the lifetime index tells us there is nothing to read
+  if(!EdgeHistoryIntersects(gid,c_ts,c_te)){
+    return std::make_pair(history_Delta,anchor_flag);
+  }
   auto tmp_info=nlohmann::json::object();
-  //1、在VA段查找最邻近的record
-  auto anchor_prefix=kEdgeAnchorPrefix+std::to_string(gid)+":"+uint_convert_to_string((int64_t)c_te,realTimeFlagConstant);
-  auto iter_begin=storage_.starts(anchor_prefix);
-  auto iter_end=storage_.last(anchor_prefix);
-
-  auto prefixs=kEdgeDeltaPrefix+std::to_string(gid);
+  // The trailing ':' makes sure that the seek doesn't land on an edge whose
+  // gid only starts with the digits of `gid`.
+  auto prefixs=kEdgeDeltaPrefix+std::to_string(gid)+":";
   auto vd_iter_begin=storage_.starts(prefixs);
   auto vd_iter_end=storage_.last(prefixs);//null
   bool need_combine=true;
 
-  while(iter_begin!=iter_end){//1.2. VA中找到了，筛选VD数据段
-    auto key=iter_begin->first;
-    auto parts = splits(key, ":");
-    if(parts[1] != std::to_string(gid)){
-      ++iter_begin;
-      break;
-    }
+  //1、在EA段查找最邻近的anchor, then seek ED directly to the anchored version
+  if(auto anchor=SeekAnchor(kEdgeAnchorPrefix,gid,c_te)){
     anchor_flag=true;
-    tmp_info=nlohmann::json::parse(iter_begin->second);
-    auto va_ts=(int64_t)(std::get<1>(string_convert_to_uint(key,realTimeFlagConstant)));
-    if(va_ts>=c_te){
-      va_ts=va_ts>0?-va_ts:va_ts;
-      auto va_ts_str=uint_convert_to_string(va_ts,realTimeFlagConstant);
-      auto delta_prefix=kEdgeDeltaPrefix+std::to_string(gid)+":"+va_ts_str;
-      vd_iter_begin=storage_.starts(delta_prefix);
-      vd_iter_end=storage_.last(delta_prefix);
-      break;
-    }else  anchor_flag=false;
-    ++iter_begin;
+    auto va_ts=anchor->first;
+    tmp_info=std::move(anchor->second);
+    va_ts=va_ts>0?-va_ts:va_ts;
+    auto delta_prefix=kEdgeDeltaPrefix+std::to_string(gid)+":"+uint_convert_to_string(va_ts,realTimeFlagConstant);
+    vd_iter_begin=storage_.starts(delta_prefix);
+    vd_iter_end=storage_.last(delta_prefix);
   }
 
+  //2、获取delta数据
   for(;vd_iter_begin!=vd_iter_end;++vd_iter_begin){
     auto [egde_gid,ts,te]=string_convert_to_uint(vd_iter_begin->first,realTimeFlagConstant);
     auto object_ts=(uint64_t)-ts;//版本的开始时间
@@ -270,25 +345,110 @@ std::pair<std::vector<nlohmann::json>,bool> History_delta::GetEdgeInfo(uint64_t
   return std::make_pair(history_Delta,anchor_flag);
 }
 
+std::optional<nlohmann::json> History_delta::GetEdgeVersion(uint64_t gid, uint64_t time) {
+  auto [versions, anchor_flag] = GetEdgeInfo(time, time, "as of", gid);
+  if (versions.empty()) return std::nullopt;
+  return std::move(versions.front());
+}
+
+bool History_delta::VisitVertexPropertyVersions(uint64_t gid, const std::string &property, uint64_t c_ts,
+                                                uint64_t c_te, const storage::PropertyValue &newer_value,
+                                                const PropertyVersionVisitor &visitor) const {
+  auto value = SerializePropertyValue(newer_value);
+  auto property_of = [&property](const nlohmann::json &record) {
+    auto props = record.find("SP");
+    if (props == record.end()) return nlohmann::json();
+    auto prop = props->find(property);
+    return prop == props->end() ? nlohmann::json() : *prop;
+  };
+
+  // The trailing ':' makes sure that the seek doesn't land on a vertex whose
+  // gid only starts with the digits of `gid`.
+  auto prefix = kVertexDeltaPrefix + std::to_string(gid) + ":";
+  auto it = storage_.starts(prefix);
+  auto end = storage_.last(prefix);
+  // The anchor holds the complete state, so the newer records don't have to
+  // be read at all.
+  if (auto anchor = SeekAnchor(kVertexAnchorPrefix, gid, c_te)) {
+    value = property_of(anchor->second);
+    auto va_ts = anchor->first > 0 ? -anchor->first : anchor->first;
+    it = storage_.starts(prefix + uint_convert_to_string(va_ts, realTimeFlagConstant));
+  }
+
+  for (; it != end; ++it) {
+    auto [record_gid, ts, te] = string_convert_to_uint(it->first, realTimeFlagConstant);
+    auto object_ts = (uint64_t)-ts;
+    auto object_te = (uint64_t)-te;
+    if (record_gid != gid) break;
+    if (object_te < c_ts) break;
+    auto record = nlohmann::json::parse(it->second);
+    // A recreated object is stored completely, any other record only holds the
+    // before-images of the changed properties.
+    if (record.contains("R")) {
+      value = property_of(record);
+    } else if (auto props = record.find("SP"); props != record.end() && props->contains(property)) {
+      value = (*props)[property];
+    }
+    if (TemporalCheck(object_ts, object_te, c_ts, c_te, "from to")) {
+      if (!visitor(object_ts, object_te, query::serialization::DeserializePropertyValue(value))) return false;
+    }
+  }
+  return true;
+}
+
+uint64_t History_delta::LatestTimestamp() const {
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  uint64_t latest = 0;
+  for (const auto &[gid, lifetime] : vertex_time_table_) latest = std::max(latest, lifetime.second);
+  for (const auto &[gid, lifetime] : edge_time_table_) latest = std::max(latest, lifetime.second);
+  return latest;
+}
+
+std::optional<std::pair<uint64_t, uint64_t>> History_delta::VertexHistorySpan(uint64_t gid) const {
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  auto it = vertex_time_table_.find(gid);
+  if (it == vertex_time_table_.end()) return std::nullopt;
+  return it->second;
+}
 
 void History_delta::GetTimeTableAll(){
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
   for(auto it=storage_.starts(kVertexTimePrefix);it!=storage_.last(kVertexTimePrefix);++it){
-    auto gid=(uint64_t)std::stoi(it->first.substr(3));
+    auto gid=(uint64_t)std::stoull(it->first.substr(3));
     auto split_info=splits(it->second,":");
-    auto min_ts=(uint64_t)std::stoi(split_info[0]);
-    auto max_te=(uint64_t)std::stoi(split_info[1]);
+    auto min_ts=(uint64_t)std::stoull(split_info[0]);
+    auto max_te=(uint64_t)std::stoull(split_info[1]);
     vertex_time_table_[gid]=std::make_pair(min_ts,max_te);
   }
   //save edge time table
   for(auto it=storage_.starts(kEdgeTimePrefix);it!=storage_.last(kEdgeTimePrefix);++it){
-    auto gid=(uint64_t)std::stoi(it->first.substr(3));
+    auto gid=(uint64_t)std::stoull(it->first.substr(3));
     auto split_info=splits(it->second,":");
-    auto min_ts=(uint64_t)std::stoi(split_info[0]);
-    auto max_te=(uint64_t)std::stoi(split_info[1]);
+    auto min_ts=(uint64_t)std::stoull(split_info[0]);
+    auto max_te=(uint64_t)std::stoull(split_info[1]);
     edge_time_table_[gid]=std::make_pair(min_ts,max_te);
   }
 }
 
+void History_delta::SaveTimeTableAll(){
+  std::map<std::string,std::string> time_data;
+  {
+    std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+    for(const auto &[gid,value]:vertex_time_tmp_){
+      time_data[kVertexTimePrefix+std::to_string(gid)]=std::to_string(value.first)+":"+std::to_string(value.second);
+    }
+    for(const auto &[gid,value]:edge_time_tmp_){
+      time_data[kEdgeTimePrefix+std::to_string(gid)]=std::to_string(value.first)+":"+std::to_string(value.second);
+    }
+    vertex_time_tmp_.clear();
+    edge_time_tmp_.clear();
+  }
+  if(time_data.empty()) return;
+  if(!storage_.PutMultiple(time_data)){
+    std::cout<<"Couldn't save time table!"<<std::endl;
+  }
+}
+
 std::pair<std::vector<nlohmann::json>,bool> History_delta::GetVertexInfo(storage::Gid gid,uint64_t c_ts,uint64_t c_te,std::string type){
     std::vector<nlohmann::json> history_Delta;
     bool anchor_flag=false;
@@ -355,7 +515,8 @@ std::pair<std::vector< std::tuple< std::map<storage::PropertyId,storage::Propert
   bool delta_is_edge=false;
   uint64_t transaction_ts=0;
   uint64_t transaction_te=0;
-  while (vertex_deltas != nullptr) {
+  // Migrated deltas (and everything older) are read from the history store.
+  while (vertex_deltas != nullptr && !vertex_deltas->migrated.load(std::memory_order_acquire)) {
     delta_is_edge=false;
     switch (vertex_deltas->action) {
       case storage::Delta::Action::ADD_OUT_EDGE:
@@ -401,7 +562,7 @@ std::vector<nlohmann::json> History_delta::GetDeleteEdgeInfo(uint64_t c_ts,uint6
     std::vector<nlohmann::json> history_Delta;
     bool anchor_flag=false;
     //1. VD找到数据
-    auto prefixs=kVertexEdgePrefix+std::to_string(vertex_gid);
+    auto prefixs=kVertexEdgePrefix+std::to_string(vertex_gid)+":";
     auto vd_iter_begin=storage_.starts(prefixs);
     auto vd_iter_end=storage_.last(prefixs);//null
     bool need_combine=true;
@@ -436,7 +597,7 @@ void History_delta::SaveDeltaAll() {
   for(auto [key,value]:gid_delta_){
     gid_data_tmp[key]=value.dump();
   }
-  success=storage_.PutMultiple(gid_data_tmp);
+  success=WriteRecords(gid_data_tmp);
   if (!success) {
     std::cout<<"Couldn't save delta!"<<std::endl;
   }
@@ -444,8 +605,144 @@ void History_delta::SaveDeltaAll() {
 }
 
 
+void History_delta::StageMigration(const std::map<std::string, std::string> &anchors,
+                                   std::map<std::string, std::string> *batch) {
+  for (const auto &[key, value] : anchors) {
+    batch->insert_or_assign(key, value);
+  }
+  for (const auto &[key, value] : gid_delta_) {
+    batch->insert_or_assign(key, value.dump());
+  }
+  gid_delta_.clear();
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  // The pending entries already include the older lifetimes, so the newer
+  // transactions of the batch simply replace them.
+  for (const auto &[gid, value] : vertex_time_tmp_) {
+    batch->insert_or_assign(kVertexTimePrefix + std::to_string(gid),
+                            std::to_string(value.first) + ":" + std::to_string(value.second));
+  }
+  for (const auto &[gid, value] : edge_time_tmp_) {
+    batch->insert_or_assign(kEdgeTimePrefix + std::to_string(gid),
+                            std::to_string(value.first) + ":" + std::to_string(value.second));
+  }
+  vertex_time_tmp_.clear();
+  edge_time_tmp_.clear();
+}
+
+bool History_delta::SaveMigrationBatch(const std::map<std::string, std::string> &batch) {
+  if (batch.empty()) return true;
+  if (!WriteRecords(batch)) {
+    spdlog::error("Couldn't save the history of the migrated transactions!");
+    return false;
+  }
+  return true;
+}
+
+bool History_delta::WriteRecords(const std::map<std::string, std::string> &records) {
+  // The migrated history is append-only and already sorted, large batches skip
+  // the memtable and the compaction of the flushed memtables.
+  if (ingest_batch_size_ > 0 && records.size() >= ingest_batch_size_) {
+    return storage_.IngestMultiple(records);
+  }
+  return storage_.PutMultiple(records);
+}
+
+bool History_delta::ApplyMigration(const std::map<std::string, std::string> &records, uint64_t migrated_timestamp) {
+  std::map<std::string, std::string> data(records);
+  data[kMigratedTimestampKey] = std::to_string(migrated_timestamp);
+  if (!WriteRecords(data)) {
+    spdlog::error("Couldn't save the replicated history!");
+    return false;
+  }
+  // The time table entries of the main instance are already merged with the
+  // older lifetimes, so they simply replace the local ones.
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  for (const auto &[key, value] : records) {
+    const bool vertex = key.starts_with(kVertexTimePrefix);
+    if (!vertex && !key.starts_with(kEdgeTimePrefix)) continue;
+    auto gid = (uint64_t)std::stoull(key.substr(3));
+    auto split_info = splits(value, ":");
+    auto &table = vertex ? vertex_time_table_ : edge_time_table_;
+    table[gid] = std::make_pair((uint64_t)std::stoull(split_info[0]), (uint64_t)std::stoull(split_info[1]));
+  }
+  return true;
+}
+
+bool History_delta::ImportVersions(std::vector<ImportedVersion> vertices, std::vector<ImportedVersion> edges) {
+  std::map<std::string, std::string> data;
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> vertex_lifetimes;
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> edge_lifetimes;
+  auto merge_lifetime = [](auto *table, uint64_t gid, const std::pair<uint64_t, uint64_t> &lifetime) {
+    auto [iter, inserted] = table->try_emplace(gid, lifetime);
+    if (inserted) return;
+    auto &value = iter->second;
+    if (value.first == 0 || lifetime.first < value.first) value.first = lifetime.first;
+    value.second = std::max(value.second, lifetime.second);
+  };
+  for (auto [versions, prefix, lifetimes] : {std::make_tuple(&vertices, kVertexDeltaPrefix, &vertex_lifetimes),
+                                             std::make_tuple(&edges, kEdgeDeltaPrefix, &edge_lifetimes)}) {
+    std::sort(versions->begin(), versions->end(), [](const auto &a, const auto &b) { return a.gid < b.gid; });
+    for (auto first = versions->begin(); first != versions->end();) {
+      auto last = std::find_if(first, versions->end(), [&](const auto &version) { return version.gid != first->gid; });
+      auto properties = nlohmann::json::object();
+      for (auto it = first; it != last; ++it) {
+        for (const auto &[name, value] : it->data["SP"].items()) properties.emplace(name, nullptr);
+      }
+      for (auto it = first; it != last; ++it) {
+        auto &version = it->data;
+        for (const auto &[name, value] : properties.items()) version["SP"].emplace(name, value);
+        version["TT_TS"] = it->tt_ts;
+        version["TT_TE"] = it->tt_te;
+        auto key = prefix + std::to_string(it->gid) + ":" +
+                   uint_convert_to_string((int64_t)-it->tt_ts, realTimeFlagConstant) + ":" +
+                   uint_convert_to_string((int64_t)-it->tt_te, realTimeFlagConstant);
+        data[key] = version.dump();
+        merge_lifetime(lifetimes, it->gid, std::make_pair(it->tt_ts, it->tt_te));
+      }
+      first = last;
+    }
+  }
+  {
+    // The lifetime index entries replace the stored ones, so they have to
+    // cover the already stored history of the objects as well.
+    std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+    for (auto [lifetimes, time_prefix, table] :
+         {std::make_tuple(&vertex_lifetimes, kVertexTimePrefix, &vertex_time_table_),
+          std::make_tuple(&edge_lifetimes, kEdgeTimePrefix, &edge_time_table_)}) {
+      for (auto &[gid, lifetime] : *lifetimes) {
+        if (auto it = table->find(gid); it != table->end()) merge_lifetime(lifetimes, gid, it->second);
+        data[time_prefix + std::to_string(gid)] = std::to_string(lifetime.first) + ":" + std::to_string(lifetime.second);
+      }
+    }
+  }
+  if (!storage_.IngestMultiple(data)) {
+    spdlog::error("Couldn't save the imported history!");
+    return false;
+  }
+  std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+  for (const auto &[gid, lifetime] : vertex_lifetimes) merge_lifetime(&vertex_time_table_, gid, lifetime);
+  for (const auto &[gid, lifetime] : edge_lifetimes) merge_lifetime(&edge_time_table_, gid, lifetime);
+  return true;
+}
+
+uint64_t History_delta::MigratedTimestamp() const {
+  auto value = storage_.Get(kMigratedTimestampKey);
+  if (!value) return 0;
+  return std::stoull(*value);
+}
+
+void History_delta::SaveMigratedTimestamp(uint64_t timestamp) {
+  if (!storage_.Put(kMigratedTimestampKey, std::to_string(timestamp))) {
+    spdlog::error("Couldn't save the history migration timestamp!");
+  }
+}
+
+bool History_delta::CreateCheckpoint(const std::filesystem::path &checkpoint_directory) {
+  return storage_.CreateCheckpoint(checkpoint_directory);
+}
+
 void History_delta::SaveAnchorAll(std::map<std::string, std::string> &value){
-  bool success=storage_.PutMultiple(value);
+  bool success=WriteRecords(value);
   if (!success) {
     std::cout<<"Couldn't save delta!"<<std::endl;
   }
@@ -510,32 +807,19 @@ void History_delta::SaveDelta(storage::Gid gid,const std::optional<storage::Gid>
     data["Tid"]=(delta.to_gid)->AsUint();
   }
   auto prefix=(to_gid)?kEdgeDeltaPrefix:(edge_flag?kVertexEdgePrefix:kVertexDeltaPrefix);
-  //save hash index
-  auto vertex_gid=gid.AsUint();
-  if(prefix=="VD:"){
-    auto iter=vertex_time_table_.find(vertex_gid);
-    if(iter==vertex_time_table_.end()){
-      vertex_time_table_[vertex_gid]=std::make_pair(start,commit);
-    }else{
-      auto &value=vertex_time_table_[vertex_gid];
-      value.second=commit;
-      if(value.first==0){
-        value.first=start;
-      }
-    }
-  }   
-  // //save hash index
-  if(prefix=="ED:"){
-    auto iter=edge_time_table_.find(vertex_gid);
-    if(iter==edge_time_table_.end()){
-      edge_time_table_[vertex_gid]=std::make_pair(start,commit);
-    }else{
-      auto &value=edge_time_table_[vertex_gid];
-      value.second=commit;
-      if(value.first==0){
-        value.first=start;
-      }
+  //save hash index, vertices and edges are indexed the same way
+  auto object_gid=gid.AsUint();
+  if(prefix==kVertexDeltaPrefix || prefix==kEdgeDeltaPrefix){
+    std::lock_guard<utils::SpinLock> guard(time_table_lock_);
+    auto &table=prefix==kVertexDeltaPrefix?vertex_time_table_:edge_time_table_;
+    auto &tmp=prefix==kVertexDeltaPrefix?vertex_time_tmp_:edge_time_tmp_;
+    auto [iter,inserted]=table.try_emplace(object_gid,start,commit);
+    if(!inserted){
+      auto &value=iter->second;
+      if(value.first==0 || start<value.first) value.first=start;
+      value.second=std::max(value.second,commit);
     }
+    tmp[object_gid]=iter->second;
   }
 
   std::string start_str=uint_convert_to_string((int64_t)-start,realTimeFlagConstant);
@@ -570,8 +854,15 @@ bool History_delta::RemoveOldHistory(const std::chrono::milliseconds &retention_
   auto now_time = std::chrono::system_clock::now();
   auto now_time_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now_time.time_since_epoch()).count();
   int64_t clean_timestamp = now_time_milliseconds-retention_period.count() ;
+  // Real-time history is stamped with hybrid clock timestamps.
+  if (realTimeFlagConstant) clean_timestamp = (int64_t)storage::HybridClock::LowerBound(clean_timestamp);
   std::vector<std::string> delete_keys;
   for (auto it = storage_.begin(); it != storage_.end(); ++it) {
+    // The lifetime index entries and the metadata keys don't carry a
+    // timestamp in their key.
+    if (it->first.rfind(kVertexTimePrefix, 0) == 0 || it->first.rfind(kEdgeTimePrefix, 0) == 0 ||
+        it->first == kMigratedTimestampKey || it->first == kTimestampEncodingKey)
+      continue;
     auto [gid,ts,te]=string_convert_to_uint(it->first,realTimeFlagConstant);
     te=te>0?te:-te;
     if(te<=clean_timestamp){
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <vector>
@@ -10,6 +12,7 @@
 #include "utils/settings.hpp"
 #include "storage/v2/name_id_mapper.hpp"
 #include "storage/v2/delta.hpp"
+#include "utils/spin_lock.hpp"
 #include <json/json.hpp>
 
 namespace history_delta {
@@ -31,22 +34,106 @@ struct historyContextOnce{
     std::vector<storage::LabelId> remove_labels;
 };
 
+/// Records written to the history store by a single GC run together with the
+/// migration timestamps before and after the run. Shipped to the replicas so
+/// that their history stores are identical to the one on the main instance.
+struct MigrationBatch {
+  uint64_t previous_migrated_timestamp;
+  uint64_t migrated_timestamp;
+  std::map<std::string, std::string> records;
+};
+
+/// Historical version of an object loaded by the bulk importer. `data` holds
+/// the complete state of the object during [tt_ts, tt_te): "SP" and "L" for
+/// vertices, "SP", "Fid" and "Tid" for edges.
+struct ImportedVersion {
+  uint64_t gid;
+  uint64_t tt_ts;
+  uint64_t tt_te;
+  nlohmann::json data;
+};
+
+/// Visitor of the versions of a single property. Called with the version
+/// interval [tt_ts, tt_te) and the value of the property in that version (Null
+/// if the object didn't have the property). Returning false stops the visit.
+using PropertyVersionVisitor = std::function<bool(uint64_t, uint64_t, const storage::PropertyValue &)>;
+
 class History_delta final {
  public:
 
    explicit History_delta(const std::string &storage_directory);
 
-   explicit History_delta(const std::string &storage_directory,bool realTimeFlag);
+   /// Migration batches with at least `ingest_batch_size` records are written
+   /// as table files that are ingested into the history store, smaller ones
+   /// through the write ahead log and the memtable. 0 disables the ingestion.
+   explicit History_delta(const std::string &storage_directory,bool realTimeFlag,uint64_t ingest_batch_size = 0);
 
   void GetDelta(const std::string &gid_name) const;
 
   std::pair<std::vector<nlohmann::json>,bool> GetVertexInfo(storage::Gid gid,uint64_t c_ts,uint64_t c_te,std::string type);
   std::pair<std::vector<nlohmann::json>,bool> GetEdgeInfo(uint64_t c_ts,uint64_t c_te,std::string type,uint64_t gid);
   std::vector<nlohmann::json> GetDeleteEdgeInfo(uint64_t c_ts,uint64_t c_te,std::string type,uint64_t gid);
+
+  /// Returns the (merged) historical version of the edge that was valid at
+  /// `time`, or std::nullopt if no historical version covers that time.
+  std::optional<nlohmann::json> GetEdgeVersion(uint64_t gid, uint64_t time);
+
+  /// Visits the historical versions of the vertex property `property` that
+  /// intersect [c_ts, c_te], from the newest to the oldest one. Only the value
+  /// of the property is carried from record to record, so the versions are
+  /// never merged into full copies of the vertex. `newer_value` is the value in
+  /// the oldest version that is still kept in memory. Returns false if the
+  /// visitor stopped the visit.
+  bool VisitVertexPropertyVersions(uint64_t gid, const std::string &property, uint64_t c_ts, uint64_t c_te,
+                                   const storage::PropertyValue &newer_value,
+                                   const PropertyVersionVisitor &visitor) const;
+
+  /// Returns false only if the lifetime index proves that the edge has no
+  /// historical version intersecting [c_ts, c_te].
+  bool EdgeHistoryIntersects(uint64_t gid, uint64_t c_ts, uint64_t c_te) const;
+
+  /// Returns the newest timestamp recorded in the lifetime index, 0 if the
+  /// history is empty.
+  uint64_t LatestTimestamp() const;
+
+  /// Returns the interval [min_ts, max_te] covered by the historical versions
+  /// of the vertex, std::nullopt if the vertex has no history.
+  std::optional<std::pair<uint64_t, uint64_t>> VertexHistorySpan(uint64_t gid) const;
+
   void GetTimeTableAll();
+  void SaveTimeTableAll();
   void SaveDeltaAll();
   void SaveAnchorAll(std::map<std::string, std::string> &value);
 
+  /// Moves the pending deltas, the given anchors and the pending time table
+  /// entries of a single transaction into `batch`. The records are written by
+  /// `SaveMigrationBatch`, so the history of a transaction is either completely
+  /// stored or not at all.
+  void StageMigration(const std::map<std::string, std::string> &anchors, std::map<std::string, std::string> *batch);
+
+  /// Persists the staged records of one or more transactions in one atomic
+  /// write.
+  bool SaveMigrationBatch(const std::map<std::string, std::string> &batch);
+
+  /// Writes the records of a `MigrationBatch` received from the main instance
+  /// together with the new migration timestamp in one atomic write.
+  bool ApplyMigration(const std::map<std::string, std::string> &records, uint64_t migrated_timestamp);
+
+  /// Writes the imported versions together with their lifetime index entries
+  /// straight into the table files of the history store. The versions of an
+  /// object are completed with null values of the properties it didn't have,
+  /// because the readers fill the missing properties from the newer versions.
+  bool ImportVersions(std::vector<ImportedVersion> vertices, std::vector<ImportedVersion> edges);
+
+  /// Commit timestamp (of the storage, not a history timestamp) up to which
+  /// all committed transactions are in the history store, 0 if unknown.
+  uint64_t MigratedTimestamp() const;
+  void SaveMigratedTimestamp(uint64_t timestamp);
+
+  /// Creates a point-in-time copy of the history store, see
+  /// `kvstore::KVStore::CreateCheckpoint`.
+  bool CreateCheckpoint(const std::filesystem::path &checkpoint_directory);
+
   void SaveDelta(storage::Gid gid,const std::optional<storage::Gid> to_gid,const uint64_t start,const uint64_t commit,storage::Delta& delta,storage::NameIdMapper &name_id_mapper);
   void SaveVertexAnchor(storage::Gid gid,const uint64_t start,std::vector<storage::LabelId> &labels,std::map<storage::PropertyId, storage::PropertyValue> &maybe_properties,storage::NameIdMapper &name_id_mapper);
   void SaveEdgeAnchor(storage::Gid gid,const uint64_t start,std::map<storage::PropertyId, storage::PropertyValue> &maybe_properties,storage::NameIdMapper &name_id_mapper);
@@ -61,11 +148,32 @@ class History_delta final {
   bool RemoveOldHistory(const std::chrono::milliseconds &retention_period);
 
  private:
+  // Seeks the first anchor of the object `gid` taken at or after `time`.
+  // Returns the anchor timestamp and the anchored state.
+  std::optional<std::pair<int64_t, nlohmann::json>> SeekAnchor(const std::string &prefix, uint64_t gid,
+                                                               uint64_t time) const;
+
+  // Makes sure that the timestamps in the store are encoded the way the
+  // storage is configured (logical or hybrid clock timestamps) and records the
+  // encoding of new stores. Terminates if the encodings differ, because
+  // mixing them returns wrong results for every history query.
+  void CheckTimestampEncoding();
+
+  // Returns a timestamp of some historical record, std::nullopt if the store
+  // is empty.
+  std::optional<uint64_t> SampleTimestamp() const;
+
+  // Writes the records in one atomic write, see `ingest_batch_size_`.
+  bool WriteRecords(const std::map<std::string, std::string> &records);
+
   bool realTimeFlagConstant=false;
+  uint64_t ingest_batch_size_{0};
+  // Protects the time tables, they are updated by the GC and read by queries.
+  mutable utils::SpinLock time_table_lock_;
   //hash index 用来存储object的min_ts max_te
   std::map<uint64_t,std::pair<uint64_t,uint64_t>> vertex_time_table_;//存储顶点的id，历史开始时间，历史结束时间
   std::map<uint64_t,std::pair<uint64_t,uint64_t>> edge_time_table_;//存储边的id，历史开始时间，历史结束时间
-  //hash index 只存储当前事务
+  //hash index 只存储当前事务, entries that still have to be persisted
   std::map<uint64_t,std::pair<uint64_t,uint64_t>> vertex_time_tmp_;//存储顶点的id，历史开始时间，历史结束时间
   std::map<uint64_t,std::pair<uint64_t,uint64_t>> edge_time_tmp_;//存储边的id，历史开始时间，历史结束时间
   //gid,delta-num: <json>
@@ -0,0 +1,79 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace storage {
+
+/// Hybrid logical clock used to stamp commits when the storage runs with
+/// real-time history (`Config::Items::realTimeFlag`).
+///
+/// A timestamp keeps the wall-clock milliseconds in the upper bits and a
+/// logical counter in the lower `kLogicalBits` bits. Every call to `Now` returns
+/// a value strictly greater than all previously returned (or observed) values,
+/// so commits in the same millisecond get distinct timestamps and the clock
+/// never goes backwards even if the system clock does. If more than
+/// 2^kLogicalBits commits happen in a single millisecond the counter carries
+/// into the physical part, i.e. the clock runs slightly ahead of the wall clock
+/// until it catches up.
+///
+/// All timestamps fit into a positive int64_t which is required by the
+/// inverted timestamp keys of the history store.
+class HybridClock final {
+ public:
+  static constexpr uint64_t kLogicalBits = 16;
+  static constexpr uint64_t kLogicalMask = (1ULL << kLogicalBits) - 1;
+
+  /// Smallest timestamp that can be assigned in the millisecond `millis`.
+  static constexpr uint64_t LowerBound(uint64_t millis) { return millis << kLogicalBits; }
+
+  /// Largest timestamp that can be assigned in the millisecond `millis`.
+  static constexpr uint64_t UpperBound(uint64_t millis) { return LowerBound(millis) | kLogicalMask; }
+
+  /// Wall-clock milliseconds of the timestamp.
+  static constexpr uint64_t ToMillis(uint64_t timestamp) { return timestamp >> kLogicalBits; }
+
+  static uint64_t WallClockMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// Returns a new timestamp, strictly greater than any previous one.
+  uint64_t Now() {
+    const auto physical = LowerBound(WallClockMillis());
+    auto last = last_.load(std::memory_order_acquire);
+    uint64_t next;
+    do {
+      next = std::max(last + 1, physical);
+    } while (!last_.compare_exchange_weak(last, next, std::memory_order_acq_rel, std::memory_order_acquire));
+    return next;
+  }
+
+  /// Makes sure that all following timestamps are greater than `timestamp`.
+  /// Used to keep the clock monotonic across restarts.
+  void Observe(uint64_t timestamp) {
+    auto last = last_.load(std::memory_order_acquire);
+    while (last < timestamp &&
+           !last_.compare_exchange_weak(last, timestamp, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> last_{0};
+};
+
+}  // namespace storage
@@ -17,11 +17,36 @@
 #include "utils/bound.hpp"
 #include "utils/logging.hpp"
 #include "utils/memory_tracker.hpp"
+#include "utils/parallel.hpp"
 
 namespace storage {
 
 namespace {
 
+/// Calls `visitor(vertex)` for every vertex. If `parallel_exec_info` is given
+/// the vertex batches are visited on multiple threads, every batch with its own
+/// visitor created by `make_visitor()`.
+template <typename TMakeVisitor>
+void VisitVertices(utils::SkipList<Vertex>::Accessor &vertices,
+                   const std::optional<ParallelizedIndexCreationInfo> &parallel_exec_info,
+                   const TMakeVisitor &make_visitor) {
+  if (!parallel_exec_info || parallel_exec_info->batch_starts.size() <= 1) {
+    auto visitor = make_visitor();
+    for (Vertex &vertex : vertices) {
+      visitor(vertex);
+    }
+    return;
+  }
+  const auto &batch_starts = parallel_exec_info->batch_starts;
+  utils::RunInParallel(parallel_exec_info->thread_count, batch_starts.size(), [&](uint64_t batch) {
+    auto visitor = make_visitor();
+    for (auto it = vertices.find_equal_or_greater(batch_starts[batch]); it != vertices.end(); ++it) {
+      if (batch + 1 < batch_starts.size() && it->gid >= batch_starts[batch + 1]) break;
+      visitor(*it);
+    }
+  });
+}
+
 /// Traverses deltas visible from transaction with start timestamp greater than
 /// the provided timestamp, and calls the provided callback function for each
 /// delta. If the callback ever returns true, traversal is stopped and the
@@ -270,7 +295,8 @@ void LabelIndex::UpdateOnAddLabel(LabelId label, Vertex *vertex, const Transacti
   acc.insert(Entry{vertex, tx.start_timestamp});
 }
 
-bool LabelIndex::CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor vertices) {
+bool LabelIndex::CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor vertices,
+                             const std::optional<ParallelizedIndexCreationInfo> &parallel_exec_info) {
   utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
   auto [it, emplaced] = index_.emplace(std::piecewise_construct, std::forward_as_tuple(label), std::forward_as_tuple());
   if (!emplaced) {
@@ -278,13 +304,14 @@ bool LabelIndex::CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor ve
     return false;
   }
   try {
-    auto acc = it->second.access();
-    for (Vertex &vertex : vertices) {
-      if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
-        continue;
-      }
-      acc.insert(Entry{&vertex, 0});
-    }
+    VisitVertices(vertices, parallel_exec_info, [&] {
+      return [acc = it->second.access(), label](Vertex &vertex) mutable {
+        if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
+          return;
+        }
+        acc.insert(Entry{&vertex, 0});
+      };
+    });
   } catch (const utils::OutOfMemoryException &) {
     utils::MemoryTracker::OutOfMemoryExceptionBlocker oom_exception_blocker;
     index_.erase(it);
@@ -416,7 +443,8 @@ void LabelPropertyIndex::UpdateOnSetProperty(PropertyId property, const Property
   }
 }
 
-bool LabelPropertyIndex::CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex>::Accessor vertices) {
+bool LabelPropertyIndex::CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex>::Accessor vertices,
+                                     const std::optional<ParallelizedIndexCreationInfo> &parallel_exec_info) {
   utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
   auto [it, emplaced] =
       index_.emplace(std::piecewise_construct, std::forward_as_tuple(label, property), std::forward_as_tuple());
@@ -425,17 +453,18 @@ bool LabelPropertyIndex::CreateIndex(LabelId label, PropertyId property, utils::
     return false;
   }
   try {
-    auto acc = it->second.access();
-    for (Vertex &vertex : vertices) {
-      if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
-        continue;
-      }
-      auto value = vertex.properties.GetProperty(property);
-      if (value.IsNull()) {
-        continue;
-      }
-      acc.insert(Entry{std::move(value), &vertex, 0});
-    }
+    VisitVertices(vertices, parallel_exec_info, [&] {
+      return [acc = it->second.access(), label, property](Vertex &vertex) mutable {
+        if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
+          return;
+        }
+        auto value = vertex.properties.GetProperty(property);
+        if (value.IsNull()) {
+          return;
+        }
+        acc.insert(Entry{std::move(value), &vertex, 0});
+      };
+    });
   } catch (const utils::OutOfMemoryException &) {
     utils::MemoryTracker::OutOfMemoryExceptionBlocker oom_exception_blocker;
     index_.erase(it);
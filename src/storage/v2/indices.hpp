@@ -14,6 +14,7 @@
 #include <optional>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/property_value.hpp"
@@ -28,6 +29,14 @@ namespace storage {
 struct Indices;
 struct Constraints;
 
+/// Describes how the vertices are scanned on multiple threads when an index is
+/// created during recovery. Batch `i` contains the vertices with gids in
+/// [batch_starts[i], batch_starts[i + 1]).
+struct ParallelizedIndexCreationInfo {
+  std::vector<Gid> batch_starts;
+  uint64_t thread_count;
+};
+
 class LabelIndex {
  private:
   struct Entry {
@@ -58,7 +67,8 @@ class LabelIndex {
   void UpdateOnAddLabel(LabelId label, Vertex *vertex, const Transaction &tx);
 
   /// @throw std::bad_alloc
-  bool CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor vertices);
+  bool CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor vertices,
+                   const std::optional<ParallelizedIndexCreationInfo> &parallel_exec_info = std::nullopt);
 
   /// Returns false if there was no index to drop
   bool DropIndex(LabelId label) { return index_.erase(label) > 0; }
@@ -156,7 +166,8 @@ class LabelPropertyIndex {
   void UpdateOnSetProperty(PropertyId property, const PropertyValue &value, Vertex *vertex, const Transaction &tx);
 
   /// @throw std::bad_alloc
-  bool CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex>::Accessor vertices);
+  bool CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex>::Accessor vertices,
+                   const std::optional<ParallelizedIndexCreationInfo> &parallel_exec_info = std::nullopt);
 
   bool DropIndex(LabelId label, PropertyId property) { return index_.erase({label, property}) > 0; }
 
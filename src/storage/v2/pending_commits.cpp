@@ -0,0 +1,95 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "storage/v2/pending_commits.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace storage {
+
+PendingCommits::PendingCommits() {
+  for (auto &slot : slots_) slot.store(kFree, std::memory_order_relaxed);
+  for (auto &visible : visible_) visible.store(true, std::memory_order_relaxed);
+}
+
+size_t PendingCommits::Claim() {
+  while (true) {
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+      auto expected = kFree;
+      if (slots_[slot].load(std::memory_order_relaxed) != kFree ||
+          !slots_[slot].compare_exchange_strong(expected, kClaimed, std::memory_order_acq_rel)) {
+        continue;
+      }
+      auto used = used_slots_.load(std::memory_order_relaxed);
+      while (used <= slot && !used_slots_.compare_exchange_weak(used, slot + 1, std::memory_order_release)) {
+      }
+      return slot;
+    }
+    // More committers than slots, one of them frees its slot soon.
+    std::this_thread::yield();
+  }
+}
+
+void PendingCommits::SetTimestamp(size_t slot, uint64_t commit_timestamp) {
+  visible_[slot].store(false);
+  slots_[slot].store(commit_timestamp, std::memory_order_release);
+}
+
+void PendingCommits::MarkVisible(size_t slot) {
+  visible_[slot].store(true);
+  NotifyWaiters();
+}
+
+void PendingCommits::Release(size_t slot) {
+  const bool was_visible = visible_[slot].exchange(true);
+  slots_[slot].store(kFree, std::memory_order_release);
+  if (!was_visible) NotifyWaiters();
+}
+
+void PendingCommits::WaitUntilVisible(uint64_t start_timestamp) {
+  if (AllVisible(start_timestamp)) return;
+  waiters_.fetch_add(1);
+  {
+    std::unique_lock guard(waiters_lock_);
+    waiters_cv_.wait(guard, [&] { return AllVisible(start_timestamp); });
+  }
+  waiters_.fetch_sub(1);
+}
+
+bool PendingCommits::AllVisible(uint64_t start_timestamp) const {
+  const auto used = used_slots_.load(std::memory_order_acquire);
+  for (size_t slot = 0; slot < used; ++slot) {
+    // A slot reused by a newer commit may make this wait for it as well,
+    // which only costs time.
+    if (slots_[slot].load(std::memory_order_acquire) < start_timestamp && !visible_[slot].load()) return false;
+  }
+  return true;
+}
+
+void PendingCommits::NotifyWaiters() {
+  // Pairs with the increment in `WaitUntilVisible`: either the waiter sees
+  // the visible slot or it's counted here.
+  if (waiters_.load() == 0) return;
+  std::lock_guard guard(waiters_lock_);
+  waiters_cv_.notify_all();
+}
+
+uint64_t PendingCommits::Oldest(uint64_t upper_bound) const {
+  const auto used = used_slots_.load(std::memory_order_acquire);
+  uint64_t oldest = upper_bound;
+  for (size_t slot = 0; slot < used; ++slot) {
+    oldest = std::min(oldest, slots_[slot].load(std::memory_order_acquire));
+  }
+  return oldest;
+}
+
+}  // namespace storage
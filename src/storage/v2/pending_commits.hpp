@@ -0,0 +1,93 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file pending_commits.hpp
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+namespace storage {
+
+/// Commit timestamps of the transactions which are committing and weren't
+/// handed over to the GC yet.
+///
+/// Every committer owns a slot which it claims before taking the engine lock
+/// and frees once it's done, so the commit path doesn't take any lock here.
+/// The commit timestamp is written to the slot while holding the engine lock,
+/// right after it's taken, so every commit timestamp below the engine's
+/// current timestamp which isn't in a slot belongs to a finished commit.
+///
+/// A commit can be published (its timestamp stored in the transaction) while
+/// holding the engine lock and still be kept invisible until the committer
+/// marks it visible, e.g. once the SYNC replicas confirmed it. The
+/// transactions which start in the meantime, and could see it, wait in
+/// `WaitUntilVisible`.
+class PendingCommits final {
+ public:
+  PendingCommits();
+
+  PendingCommits(const PendingCommits &) = delete;
+  PendingCommits &operator=(const PendingCommits &) = delete;
+  PendingCommits(PendingCommits &&) = delete;
+  PendingCommits &operator=(PendingCommits &&) = delete;
+
+  ~PendingCommits() = default;
+
+  /// Claims a free slot. Waits if all of them are taken.
+  size_t Claim();
+
+  /// Sets the commit timestamp of the claimed slot. The commit isn't visible
+  /// until `MarkVisible` is called. Must be called while holding the engine
+  /// lock.
+  void SetTimestamp(size_t slot, uint64_t commit_timestamp);
+
+  /// Lets the transactions which wait for the commit in the slot continue.
+  void MarkVisible(size_t slot);
+
+  /// Frees the slot, its commit timestamp (if it was set) is no longer
+  /// pending. Marks the commit visible if it wasn't already.
+  void Release(size_t slot);
+
+  /// Blocks until all commits with a timestamp below `start_timestamp` are
+  /// visible. Must be called without holding the engine lock.
+  void WaitUntilVisible(uint64_t start_timestamp);
+
+  /// Returns the oldest pending commit timestamp below `upper_bound`, or
+  /// `upper_bound` if there is none.
+  uint64_t Oldest(uint64_t upper_bound) const;
+
+ private:
+  static constexpr size_t kSlots = 1024;
+  static constexpr uint64_t kFree = std::numeric_limits<uint64_t>::max();
+  static constexpr uint64_t kClaimed = kFree - 1;
+
+  bool AllVisible(uint64_t start_timestamp) const;
+  void NotifyWaiters();
+
+  // Commit timestamp in the slot, `kFree` or `kClaimed`.
+  std::array<std::atomic<uint64_t>, kSlots> slots_{};
+  std::array<std::atomic<bool>, kSlots> visible_{};
+  // Number of slots which were ever claimed, the later ones are always free.
+  std::atomic<size_t> used_slots_{0};
+
+  // Transactions blocked in `WaitUntilVisible`, committers only take
+  // `waiters_lock_` if there are any.
+  std::atomic<size_t> waiters_{0};
+  std::mutex waiters_lock_;
+  std::condition_variable waiters_cv_;
+};
+
+}  // namespace storage
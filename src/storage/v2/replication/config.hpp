@@ -10,6 +10,7 @@
 // licenses/APL.txt.
 
 #pragma once
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -17,6 +18,14 @@ namespace storage::replication {
 struct ReplicationClientConfig {
   std::optional<double> timeout;
 
+  // Transactions that are queued while the previous frame is sent are
+  // coalesced into a single frame of at most this many transactions/bytes.
+  uint64_t max_batch_transactions{1024};
+  uint64_t max_batch_bytes{16 * 1024 * 1024};
+  // If more transactions are waiting to be sent, the replica is recovered
+  // from the durability files instead.
+  uint64_t max_queued_transactions{16384};
+
   struct SSL {
     std::string key_file = "";
     std::string cert_file = "";
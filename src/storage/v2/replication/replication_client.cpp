@@ -15,6 +15,7 @@
 #include <type_traits>
 
 #include "storage/v2/durability/durability.hpp"
+#include "storage/v2/durability/paths.hpp"
 #include "storage/v2/replication/config.hpp"
 #include "storage/v2/replication/enums.hpp"
 #include "storage/v2/transaction.hpp"
@@ -33,7 +34,12 @@ template <typename>
 Storage::ReplicationClient::ReplicationClient(std::string name, Storage *storage, const io::network::Endpoint &endpoint,
                                               const replication::ReplicationMode mode,
                                               const replication::ReplicationClientConfig &config)
-    : name_(std::move(name)), storage_(storage), mode_(mode) {
+    : name_(std::move(name)),
+      storage_(storage),
+      mode_(mode),
+      max_batch_transactions_(std::max<uint64_t>(config.max_batch_transactions, 1)),
+      max_batch_bytes_(config.max_batch_bytes),
+      max_queued_transactions_(std::max<uint64_t>(config.max_queued_transactions, 1)) {
   if (config.ssl) {
     rpc_context_.emplace(config.ssl->key_file, config.ssl->cert_file);
   } else {
@@ -45,10 +51,18 @@ Storage::ReplicationClient::ReplicationClient(std::string name, Storage *storage
 
   if (config.timeout && replica_state_ != replication::ReplicaState::INVALID) {
     timeout_.emplace(*config.timeout);
-    timeout_dispatcher_.emplace();
   }
 }
 
+Storage::ReplicationClient::~ReplicationClient() {
+  history_thread_pool_.Shutdown();
+  thread_pool_.Shutdown();
+  // Release the committers that are still waiting for this replica.
+  std::lock_guard queue_guard(queue_lock_);
+  in_flight_ = 0;
+  DropQueuedTransactions();
+}
+
 /// @throws rpc::RpcFailedException
 void Storage::ReplicationClient::InitializeClient() {
   uint64_t current_commit_timestamp{kTimestampInitialId};
@@ -98,6 +112,12 @@ void Storage::ReplicationClient::InitializeClient() {
     }
     thread_pool_.AddTask([=, this] { this->RecoverReplica(current_commit_timestamp); });
   }
+
+  // The history store is recovered independently of the data.
+  history_recovery_pending_ = true;
+  history_thread_pool_.AddTask([this, replica_migrated_timestamp = response.history_migrated_timestamp] {
+    this->RecoverHistory(replica_migrated_timestamp);
+  });
 }
 
 void Storage::ReplicationClient::TryInitializeClient() {
@@ -138,133 +158,264 @@ WalFilesRes Storage::ReplicationClient::TransferWalFiles(const std::vector<std::
   return stream.AwaitResponse();
 }
 
-void Storage::ReplicationClient::StartTransactionReplication(const uint64_t current_wal_seq_num) {
-  std::unique_lock guard(client_lock_);
-  const auto status = replica_state_.load();
-  switch (status) {
-    case replication::ReplicaState::RECOVERY:
-      spdlog::debug("Replica {} is behind MAIN instance", name_);
-      return;
-    case replication::ReplicaState::REPLICATING:
-      spdlog::debug("Replica {} missed a transaction", name_);
-      // We missed a transaction because we're still replicating
-      // the previous transaction so we need to go to RECOVERY
-      // state to catch up with the missing transaction
-      // We cannot queue the recovery process here because
-      // an error can happen while we're replicating the previous
-      // transaction after which the client should go to
-      // INVALID state before starting the recovery process
-      replica_state_.store(replication::ReplicaState::RECOVERY);
-      return;
-    case replication::ReplicaState::INVALID:
-      HandleRpcFailure();
-      return;
-    case replication::ReplicaState::READY:
-      MG_ASSERT(!replica_stream_);
-      try {
-        replica_stream_.emplace(ReplicaStream{this, storage_->last_commit_timestamp_.load(), current_wal_seq_num});
-        replica_state_.store(replication::ReplicaState::REPLICATING);
-      } catch (const rpc::RpcFailedException &) {
+void Storage::ReplicationClient::ReplicateHistory(std::shared_ptr<const history_delta::MigrationBatch> batch) {
+  // Called by the GC while holding `gc_lock_`.
+  if (history_recovery_pending_ || replica_state_ == replication::ReplicaState::INVALID) {
+    history_batch_dropped_ = true;
+    return;
+  }
+  history_thread_pool_.AddTask([this, batch = std::move(batch)] {
+    // A failure of a previous batch already scheduled the recovery which
+    // covers this batch.
+    if (history_recovery_pending_ || history_batch_dropped_) return;
+    try {
+      auto response = TransferHistoryBatch(*batch);
+      if (!response.success) {
+        spdlog::debug("Replica {} is missing a part of the history", name_);
+        history_batch_dropped_ = true;
+        history_recovery_pending_ = true;
+        history_thread_pool_.AddTask([this, replica_migrated_timestamp = response.current_migrated_timestamp] {
+          this->RecoverHistory(replica_migrated_timestamp);
+        });
+      }
+    } catch (const rpc::RpcFailedException &) {
+      history_batch_dropped_ = true;
+      {
+        std::unique_lock client_guard{client_lock_};
         replica_state_.store(replication::ReplicaState::INVALID);
-        HandleRpcFailure();
       }
-      return;
+      HandleRpcFailure();
+    }
+  });
+}
+
+HistoryBatchRes Storage::ReplicationClient::TransferHistoryBatch(const history_delta::MigrationBatch &batch) {
+  auto stream{rpc_client_->Stream<HistoryBatchRpc>(batch.previous_migrated_timestamp, batch.migrated_timestamp,
+                                                   batch.records.size())};
+  replication::Encoder encoder(stream.GetBuilder());
+  for (const auto &[key, value] : batch.records) {
+    encoder.WriteString(key);
+    encoder.WriteString(value);
   }
+  return stream.AwaitResponse();
 }
 
-void Storage::ReplicationClient::IfStreamingTransaction(const std::function<void(ReplicaStream &handler)> &callback) {
-  // We can only check the state because it guarantees to be only
-  // valid during a single transaction replication (if the assumption
-  // that this and other transaction replication functions can only be
-  // called from a one thread stands)
-  if (replica_state_ != replication::ReplicaState::REPLICATING) {
-    return;
+HistoryCheckpointRes Storage::ReplicationClient::TransferHistoryCheckpoint(
+    const std::filesystem::path &checkpoint_directory, const uint64_t migrated_timestamp) {
+  std::vector<std::filesystem::path> files;
+  for (const auto &item : std::filesystem::directory_iterator(checkpoint_directory)) {
+    if (item.is_regular_file()) files.push_back(item.path());
+  }
+  auto stream{rpc_client_->Stream<HistoryCheckpointRpc>(migrated_timestamp, files.size())};
+  replication::Encoder encoder(stream.GetBuilder());
+  for (const auto &file : files) {
+    spdlog::debug("Sending history checkpoint file: {}", file);
+    encoder.WriteFile(file);
+  }
+  return stream.AwaitResponse();
+}
+
+void Storage::ReplicationClient::RecoverHistory(const uint64_t replica_migrated_timestamp) {
+  const auto checkpoint_directory = storage_->config_.durability.storage_directory /
+                                    durability::kHistoryReplicationDirectory / fmt::format("to_{}", name_);
+  uint64_t migrated_timestamp = 0;
+  {
+    // Taking the checkpoint under the GC lock guarantees that every batch
+    // created afterwards continues exactly where the checkpoint ends.
+    std::lock_guard<std::mutex> gc_guard(storage_->gc_lock_);
+    history_recovery_pending_ = false;
+    if (!history_batch_dropped_ && replica_migrated_timestamp == storage_->history_watermark_) {
+      spdlog::debug("History of replica '{}' is up to date", name_);
+      return;
+    }
+    std::error_code error_code;
+    std::filesystem::remove_all(checkpoint_directory, error_code);
+    utils::EnsureDirOrDie(checkpoint_directory.parent_path());
+    if (!storage_->saved_history_deltas_->CreateCheckpoint(checkpoint_directory)) {
+      spdlog::error("Couldn't create the history store checkpoint for replica {}.", name_);
+      // Stop sending the batches, the replica history is recovered after the
+      // next reconnect.
+      history_batch_dropped_ = true;
+      return;
+    }
+    migrated_timestamp = storage_->history_watermark_;
+    history_batch_dropped_ = false;
   }
 
   try {
-    callback(*replica_stream_);
+    spdlog::debug("Sending the history store checkpoint to replica {}", name_);
+    auto response = TransferHistoryCheckpoint(checkpoint_directory, migrated_timestamp);
+    if (!response.success) {
+      spdlog::error("Replica {} couldn't load the history store checkpoint.", name_);
+      history_batch_dropped_ = true;
+    }
   } catch (const rpc::RpcFailedException &) {
+    history_batch_dropped_ = true;
     {
       std::unique_lock client_guard{client_lock_};
       replica_state_.store(replication::ReplicaState::INVALID);
     }
     HandleRpcFailure();
   }
+  std::error_code error_code;
+  std::filesystem::remove_all(checkpoint_directory, error_code);
 }
 
-void Storage::ReplicationClient::FinalizeTransactionReplication() {
-  // We can only check the state because it guarantees to be only
-  // valid during a single transaction replication (if the assumption
-  // that this and other transaction replication functions can only be
-  // called from a one thread stands)
-  if (replica_state_ != replication::ReplicaState::REPLICATING) {
+void Storage::ReplicationClient::ReplicateTransaction(const std::shared_ptr<ReplicatedTransaction> &transaction) {
+  std::unique_lock client_guard(client_lock_);
+  switch (replica_state_.load()) {
+    case replication::ReplicaState::RECOVERY:
+      spdlog::debug("Replica {} is behind MAIN instance", name_);
+      return;
+    case replication::ReplicaState::INVALID:
+      HandleRpcFailure();
+      return;
+    case replication::ReplicaState::READY:
+    case replication::ReplicaState::REPLICATING:
+      break;
+  }
+
+  std::lock_guard queue_guard(queue_lock_);
+  if (queue_.size() >= max_queued_transactions_) {
+    spdlog::debug("Replica {} is too far behind", name_);
+    // The replica catches up using the durability files once the transactions
+    // that are being sent are confirmed.
+    replica_state_.store(replication::ReplicaState::RECOVERY);
+    DropQueuedTransactions();
     return;
   }
 
-  if (mode_ == replication::ReplicationMode::ASYNC) {
-    thread_pool_.AddTask([this] { this->FinalizeTransactionReplicationInternal(); });
-  } else if (timeout_) {
-    MG_ASSERT(mode_ == replication::ReplicationMode::SYNC, "Only SYNC replica can have a timeout.");
-    MG_ASSERT(timeout_dispatcher_, "Timeout thread is missing");
-    timeout_dispatcher_->WaitForTaskToFinish();
+  const bool sync = mode_ == replication::ReplicationMode::SYNC;
+  if (sync) {
+    std::lock_guard sync_guard(transaction->sync_lock);
+    ++transaction->pending_sync_replicas;
+    if (timeout_ && (!transaction->sync_timeout || *timeout_ < *transaction->sync_timeout)) {
+      transaction->sync_timeout = timeout_;
+    }
+  }
+  queue_.push_back({transaction, sync});
+  replica_state_.store(replication::ReplicaState::REPLICATING);
+  if (!sender_scheduled_) {
+    sender_scheduled_ = true;
+    thread_pool_.AddTask([this] { this->SendQueuedTransactions(); });
+  }
+}
 
-    timeout_dispatcher_->active = true;
-    thread_pool_.AddTask([&, this] {
-      this->FinalizeTransactionReplicationInternal();
-      std::unique_lock main_guard(timeout_dispatcher_->main_lock);
-      // TimerThread can finish waiting for timeout
-      timeout_dispatcher_->active = false;
-      // Notify the main thread
-      timeout_dispatcher_->main_cv.notify_one();
-    });
+void Storage::ReplicationClient::CheckSyncTimeout() {
+  std::lock_guard queue_guard(queue_lock_);
+  if (mode_ != replication::ReplicationMode::SYNC || !timeout_ || queue_.empty()) return;
+  const auto timeout =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(*timeout_));
+  if (std::chrono::steady_clock::now() - queue_.front().transaction->queued_at < timeout) return;
+
+  spdlog::warn("Replica {} didn't confirm a transaction in time, it's now replicated asynchronously", name_);
+  mode_ = replication::ReplicationMode::ASYNC;
+  timeout_.reset();
+  for (auto &queued : queue_) {
+    if (!queued.sync) continue;
+    queued.sync = false;
+    queued.transaction->ReleaseSyncReplica();
+  }
+}
 
-    timeout_dispatcher_->StartTimeoutTask(*timeout_);
+uint64_t Storage::ReplicationClient::PendingTransactions() {
+  std::lock_guard queue_guard(queue_lock_);
+  return queue_.size();
+}
 
-    // Wait until one of the threads notifies us that they finished executing
-    // Both threads should first set the active flag to false
-    {
-      std::unique_lock main_guard(timeout_dispatcher_->main_lock);
-      timeout_dispatcher_->main_cv.wait(main_guard, [&] { return !timeout_dispatcher_->active.load(); });
-    }
+uint64_t Storage::ReplicationClient::LagMillis() {
+  std::lock_guard queue_guard(queue_lock_);
+  if (queue_.empty()) return 0;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                               queue_.front().transaction->queued_at)
+      .count();
+}
 
-    // TODO (antonio2368): Document and/or polish SEMI-SYNC to ASYNC fallback.
-    if (replica_state_ == replication::ReplicaState::REPLICATING) {
-      mode_ = replication::ReplicationMode::ASYNC;
-      timeout_.reset();
-      // This can only happen if we timeouted so we are sure that
-      // Timeout task finished
-      // We need to delete timeout dispatcher AFTER the replication
-      // finished because it tries to acquire the timeout lock
-      // and acces the `active` variable`
-      thread_pool_.AddTask([this] { timeout_dispatcher_.reset(); });
-    }
-  } else {
-    FinalizeTransactionReplicationInternal();
+void Storage::ReplicationClient::DropQueuedTransactions() {
+  const auto first_dropped = queue_.begin() + static_cast<std::ptrdiff_t>(in_flight_);
+  for (auto it = first_dropped; it != queue_.end(); ++it) {
+    if (it->sync) it->transaction->ReleaseSyncReplica();
   }
+  queue_.erase(first_dropped, queue_.end());
 }
 
-void Storage::ReplicationClient::FinalizeTransactionReplicationInternal() {
-  MG_ASSERT(replica_stream_, "Missing stream for transaction deltas");
-  try {
-    auto response = replica_stream_->Finalize();
-    replica_stream_.reset();
-    std::unique_lock client_guard(client_lock_);
-    if (!response.success || replica_state_ == replication::ReplicaState::RECOVERY) {
-      replica_state_.store(replication::ReplicaState::RECOVERY);
-      thread_pool_.AddTask([&, this] { this->RecoverReplica(response.current_commit_timestamp); });
-    } else {
-      replica_state_.store(replication::ReplicaState::READY);
-    }
-  } catch (const rpc::RpcFailedException &) {
-    replica_stream_.reset();
+void Storage::ReplicationClient::SendQueuedTransactions() {
+  std::vector<std::shared_ptr<ReplicatedTransaction>> transactions;
+  while (true) {
+    transactions.clear();
     {
+      std::lock_guard queue_guard(queue_lock_);
+      if (queue_.empty()) {
+        sender_scheduled_ = false;
+        return;
+      }
+      uint64_t batch_bytes = 0;
+      for (const auto &queued : queue_) {
+        const auto size = queued.transaction->Size();
+        if (transactions.size() == max_batch_transactions_ ||
+            (!transactions.empty() && batch_bytes + size > max_batch_bytes_)) {
+          break;
+        }
+        batch_bytes += size;
+        transactions.push_back(queued.transaction);
+      }
+      in_flight_ = transactions.size();
+    }
+
+    try {
+      auto response = TransferTransactions(transactions);
       std::unique_lock client_guard(client_lock_);
-      replica_state_.store(replication::ReplicaState::INVALID);
+      std::lock_guard queue_guard(queue_lock_);
+      for (; in_flight_ > 0; --in_flight_) {
+        if (queue_.front().sync) queue_.front().transaction->ReleaseSyncReplica();
+        queue_.pop_front();
+      }
+      if (!response.success || replica_state_ == replication::ReplicaState::RECOVERY) {
+        replica_state_.store(replication::ReplicaState::RECOVERY);
+        DropQueuedTransactions();
+        sender_scheduled_ = false;
+        thread_pool_.AddTask([this, replica_commit = response.current_commit_timestamp] {
+          this->RecoverReplica(replica_commit);
+        });
+        return;
+      }
+      if (queue_.empty()) {
+        replica_state_.store(replication::ReplicaState::READY);
+        sender_scheduled_ = false;
+        return;
+      }
+    } catch (const rpc::RpcFailedException &) {
+      {
+        std::unique_lock client_guard(client_lock_);
+        std::lock_guard queue_guard(queue_lock_);
+        replica_state_.store(replication::ReplicaState::INVALID);
+        in_flight_ = 0;
+        DropQueuedTransactions();
+        sender_scheduled_ = false;
+      }
+      HandleRpcFailure();
+      return;
     }
-    HandleRpcFailure();
   }
 }
 
+AppendDeltasRes Storage::ReplicationClient::TransferTransactions(
+    const std::vector<std::shared_ptr<ReplicatedTransaction>> &transactions) {
+  auto stream{
+      rpc_client_->Stream<AppendDeltasRpc>(transactions.front()->previous_commit_timestamp, transactions.size())};
+  replication::Encoder encoder(stream.GetBuilder());
+  for (const auto &transaction : transactions) {
+    encoder.WriteUint(transaction->wal_seq_num);
+    encoder.WriteString(transaction->epoch_id);
+    encoder.WriteUint(transaction->Size());
+    // The records are already encoded in the WAL format so they are sent as
+    // they are.
+    if (transaction->deltas) encoder.WriteBuffer(transaction->deltas->data(), transaction->deltas->size());
+    encoder.WriteBuffer(transaction->end.data(), transaction->end.size());
+  }
+  return stream.AwaitResponse();
+}
+
 void Storage::ReplicationClient::RecoverReplica(uint64_t replica_commit) {
   while (true) {
     auto file_locker = storage_->file_retainer_.AddLocker();
@@ -381,7 +532,12 @@ std::vector<Storage::ReplicationClient::RecoveryStep> Storage::ReplicationClient
   std::optional<durability::SnapshotDurabilityInfo> latest_snapshot;
   if (!snapshot_files.empty()) {
     std::sort(snapshot_files.begin(), snapshot_files.end());
-    latest_snapshot.emplace(std::move(snapshot_files.back()));
+    // Only a full snapshot can be sent, the incremental snapshots are applied
+    // on top of their chain. The WAL files are kept from the oldest full
+    // snapshot onwards.
+    auto full_snapshot = std::find_if(snapshot_files.rbegin(), snapshot_files.rend(),
+                                      [](const auto &snapshot_file) { return !snapshot_file.IsIncremental(); });
+    if (full_snapshot != snapshot_files.rend()) latest_snapshot.emplace(std::move(*full_snapshot));
   }
 
   std::vector<RecoveryStep> recovery_steps;
@@ -502,66 +658,6 @@ std::vector<Storage::ReplicationClient::RecoveryStep> Storage::ReplicationClient
   return recovery_steps;
 }
 
-////// TimeoutDispatcher //////
-void Storage::ReplicationClient::TimeoutDispatcher::WaitForTaskToFinish() {
-  // Wait for the previous timeout task to finish
-  std::unique_lock main_guard(main_lock);
-  main_cv.wait(main_guard, [&] { return finished; });
-}
-
-void Storage::ReplicationClient::TimeoutDispatcher::StartTimeoutTask(const double timeout) {
-  timeout_pool.AddTask([timeout, this] {
-    finished = false;
-    using std::chrono::steady_clock;
-    const auto timeout_duration =
-        std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(timeout));
-    const auto end_time = steady_clock::now() + timeout_duration;
-    while (active && (steady_clock::now() < end_time)) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-
-    std::unique_lock main_guard(main_lock);
-    finished = true;
-    active = false;
-    main_cv.notify_one();
-  });
-}
-////// ReplicaStream //////
-Storage::ReplicationClient::ReplicaStream::ReplicaStream(ReplicationClient *self,
-                                                         const uint64_t previous_commit_timestamp,
-                                                         const uint64_t current_seq_num)
-    : self_(self), stream_(self_->rpc_client_->Stream<AppendDeltasRpc>(previous_commit_timestamp, current_seq_num)) {
-  replication::Encoder encoder{stream_.GetBuilder()};
-  encoder.WriteString(self_->storage_->epoch_id_);
-}
-
-void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Vertex &vertex,
-                                                            uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
-  EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, self_->storage_->config_.items, delta, vertex,
-              final_commit_timestamp);
-}
-
-void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Edge &edge,
-                                                            uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
-  EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, delta, edge, final_commit_timestamp);
-}
-
-void Storage::ReplicationClient::ReplicaStream::AppendTransactionEnd(uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
-  EncodeTransactionEnd(&encoder, final_commit_timestamp);
-}
-
-void Storage::ReplicationClient::ReplicaStream::AppendOperation(durability::StorageGlobalOperation operation,
-                                                                LabelId label, const std::set<PropertyId> &properties,
-                                                                uint64_t timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
-  EncodeOperation(&encoder, &self_->storage_->name_id_mapper_, operation, label, properties, timestamp);
-}
-
-AppendDeltasRes Storage::ReplicationClient::ReplicaStream::Finalize() { return stream_.AwaitResponse(); }
-
 ////// CurrentWalHandler //////
 Storage::ReplicationClient::CurrentWalHandler::CurrentWalHandler(ReplicationClient *self)
     : self_(self), stream_(self_->rpc_client_->Stream<CurrentWalRpc>()) {}
@@ -13,6 +13,10 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <variant>
 
@@ -20,6 +24,7 @@
 #include "storage/v2/config.hpp"
 #include "storage/v2/delta.hpp"
 #include "storage/v2/durability/wal.hpp"
+#include "storage/v2/history_delta.hpp"
 #include "storage/v2/id_types.hpp"
 #include "storage/v2/mvcc.hpp"
 #include "storage/v2/name_id_mapper.hpp"
@@ -37,38 +42,47 @@
 
 namespace storage {
 
+// WAL records of a committed transaction (or of a global operation) that are
+// sent to the replicas. The records are encoded once, for the WAL file, and
+// the same bytes are shared by all of the replication clients.
+struct Storage::ReplicatedTransaction {
+  uint64_t previous_commit_timestamp;
+  uint64_t wal_seq_num;
+  std::string epoch_id;
+  // Deltas of the transaction, empty for a global operation.
+  std::optional<durability::WalTransactionBuffer> deltas;
+  // The transaction end or the global operation.
+  durability::BufferEncoder end;
+  std::chrono::steady_clock::time_point queued_at{std::chrono::steady_clock::now()};
+
+  uint64_t Size() const { return (deltas ? deltas->size() : 0) + end.size(); }
+
+  // Called by the replication clients when a SYNC replica confirmed the
+  // transaction or won't confirm it anymore.
+  void ReleaseSyncReplica() {
+    std::lock_guard guard(sync_lock);
+    if (--pending_sync_replicas == 0) sync_cv.notify_all();
+  }
+
+  std::mutex sync_lock;
+  std::condition_variable sync_cv;
+  // Number of SYNC replicas the committer has to wait for.
+  uint64_t pending_sync_replicas{0};
+  // Smallest timeout of those replicas, if any of them has one.
+  std::optional<double> sync_timeout;
+};
+
 class Storage::ReplicationClient {
  public:
   ReplicationClient(std::string name, Storage *storage, const io::network::Endpoint &endpoint,
                     replication::ReplicationMode mode, const replication::ReplicationClientConfig &config = {});
 
-  // Handler used for transfering the current transaction.
-  class ReplicaStream {
-   private:
-    friend class ReplicationClient;
-    explicit ReplicaStream(ReplicationClient *self, uint64_t previous_commit_timestamp, uint64_t current_seq_num);
-
-   public:
-    /// @throw rpc::RpcFailedException
-    void AppendDelta(const Delta &delta, const Vertex &vertex, uint64_t final_commit_timestamp);
-
-    /// @throw rpc::RpcFailedException
-    void AppendDelta(const Delta &delta, const Edge &edge, uint64_t final_commit_timestamp);
-
-    /// @throw rpc::RpcFailedException
-    void AppendTransactionEnd(uint64_t final_commit_timestamp);
-
-    /// @throw rpc::RpcFailedException
-    void AppendOperation(durability::StorageGlobalOperation operation, LabelId label,
-                         const std::set<PropertyId> &properties, uint64_t timestamp);
-
-   private:
-    /// @throw rpc::RpcFailedException
-    AppendDeltasRes Finalize();
+  ReplicationClient(const ReplicationClient &) = delete;
+  ReplicationClient(ReplicationClient &&) = delete;
+  ReplicationClient &operator=(const ReplicationClient &) = delete;
+  ReplicationClient &operator=(ReplicationClient &&) = delete;
 
-    ReplicationClient *self_;
-    rpc::Client::StreamHandler<AppendDeltasRpc> stream_;
-  };
+  ~ReplicationClient();
 
   // Handler for transfering the current WAL file whose data is
   // contained in the internal buffer and the file.
@@ -94,16 +108,16 @@ class Storage::ReplicationClient {
     rpc::Client::StreamHandler<CurrentWalRpc> stream_;
   };
 
-  void StartTransactionReplication(uint64_t current_wal_seq_num);
+  // Queues the transaction for replication. Called while holding the engine
+  // lock (or the unique storage lock for the global operations), so the
+  // transactions are queued in the commit order. The queued transactions are
+  // sent on the client thread, the ones queued while a frame is being sent
+  // are coalesced into the next frame.
+  void ReplicateTransaction(const std::shared_ptr<ReplicatedTransaction> &transaction);
 
-  // Replication clients can be removed at any point
-  // so to avoid any complexity of checking if the client was removed whenever
-  // we want to send part of transaction and to avoid adding some GC logic this
-  // function will run a callback if, after previously callling
-  // StartTransactionReplication, stream is created.
-  void IfStreamingTransaction(const std::function<void(ReplicaStream &handler)> &callback);
-
-  void FinalizeTransactionReplication();
+  // If the replica is SYNC with a timeout and didn't confirm a transaction in
+  // time, it falls back to ASYNC and stops holding back the committers.
+  void CheckSyncTimeout();
 
   // Transfer the snapshot file.
   // @param path Path of the snapshot file.
@@ -114,23 +128,62 @@ class Storage::ReplicationClient {
   // Transfer the WAL files
   WalFilesRes TransferWalFiles(const std::vector<std::filesystem::path> &wal_files);
 
+  // Ships the records migrated to the history store by a GC run. The batches
+  // are sent in order on the client thread. If a batch can't be delivered the
+  // replica history is recovered from a history store checkpoint once the
+  // replica is reachable again.
+  void ReplicateHistory(std::shared_ptr<const history_delta::MigrationBatch> batch);
+
   const auto &Name() const { return name_; }
 
   auto State() const { return replica_state_.load(); }
 
-  auto Mode() const { return mode_; }
+  auto Mode() const { return mode_.load(); }
 
   auto Timeout() const { return timeout_; }
 
   const auto &Endpoint() const { return rpc_client_->Endpoint(); }
 
+  // Number of transactions that are queued or sent but not yet confirmed by
+  // the replica.
+  uint64_t PendingTransactions();
+
+  // Milliseconds since the oldest transaction that isn't confirmed by the
+  // replica was queued, 0 if the replica is up to date.
+  uint64_t LagMillis();
+
  private:
-  void FinalizeTransactionReplicationInternal();
+  struct QueuedTransaction {
+    std::shared_ptr<ReplicatedTransaction> transaction;
+    // If the committer is waiting for this replica to confirm the transaction.
+    bool sync;
+  };
+
+  // Sends the queued transactions until the queue is empty.
+  void SendQueuedTransactions();
+
+  /// @throw rpc::RpcFailedException
+  AppendDeltasRes TransferTransactions(const std::vector<std::shared_ptr<ReplicatedTransaction>> &transactions);
+
+  // Drops the queued transactions that are not being sent and releases the
+  // committers waiting for them. Must be called while holding `queue_lock_`.
+  void DropQueuedTransactions();
 
   void RecoverReplica(uint64_t replica_commit);
 
   uint64_t ReplicateCurrentWal();
 
+  HistoryBatchRes TransferHistoryBatch(const history_delta::MigrationBatch &batch);
+
+  // Transfer all files of the history store checkpoint.
+  HistoryCheckpointRes TransferHistoryCheckpoint(const std::filesystem::path &checkpoint_directory,
+                                                 uint64_t migrated_timestamp);
+
+  // Brings the replica history store up to date with the main one by sending
+  // a new checkpoint of the history store, unless the replica is already at
+  // `replica_migrated_timestamp` and no batch was dropped in the meantime.
+  void RecoverHistory(uint64_t replica_migrated_timestamp);
+
   using RecoveryWals = std::vector<std::filesystem::path>;
   struct RecoveryCurrentWal {
     uint64_t current_wal_seq_num;
@@ -155,32 +208,21 @@ class Storage::ReplicationClient {
   std::optional<communication::ClientContext> rpc_context_;
   std::optional<rpc::Client> rpc_client_;
 
-  std::optional<ReplicaStream> replica_stream_;
-  replication::ReplicationMode mode_{replication::ReplicationMode::SYNC};
-
-  // Dispatcher class for timeout tasks
-  struct TimeoutDispatcher {
-    explicit TimeoutDispatcher(){};
-
-    void WaitForTaskToFinish();
-
-    void StartTimeoutTask(double timeout);
-
-    // If the Timeout task should continue waiting
-    std::atomic<bool> active{false};
-
-    std::mutex main_lock;
-    std::condition_variable main_cv;
-
-   private:
-    // if the Timeout task finished executing
-    bool finished{true};
+  std::atomic<replication::ReplicationMode> mode_{replication::ReplicationMode::SYNC};
+  std::optional<double> timeout_;
 
-    utils::ThreadPool timeout_pool{1};
-  };
+  uint64_t max_batch_transactions_;
+  uint64_t max_batch_bytes_;
+  uint64_t max_queued_transactions_;
 
-  std::optional<double> timeout_;
-  std::optional<TimeoutDispatcher> timeout_dispatcher_;
+  // Protects the queue and the replication mode changes.
+  std::mutex queue_lock_;
+  // Transactions waiting for the confirmation of the replica, the first
+  // `in_flight_` of them are currently being sent.
+  std::deque<QueuedTransaction> queue_;
+  uint64_t in_flight_{0};
+  // Set while `SendQueuedTransactions` is queued or running.
+  bool sender_scheduled_{false};
 
   utils::SpinLock client_lock_;
   // This thread pool is used for background tasks so we don't
@@ -197,7 +239,19 @@ class Storage::ReplicationClient {
   //    Not having mulitple possible threads in the same client allows us
   //    to ignore concurrency problems inside the client.
   utils::ThreadPool thread_pool_{1};
+  // Transfers and recovers the history store. `RecoverHistory` waits for the
+  // GC, which may wait for the committers, which wait for the transactions
+  // sent on `thread_pool_`, so the history isn't sent on the same thread. The
+  // RPC client sends one request at a time, and the history is ordered by its
+  // own migration timestamps, independently of the transactions.
+  utils::ThreadPool history_thread_pool_{1};
   std::atomic<replication::ReplicaState> replica_state_{replication::ReplicaState::INVALID};
+
+  // Set while `RecoverHistory` is queued. The batches created in the meantime
+  // are dropped because the checkpoint it sends contains them.
+  std::atomic<bool> history_recovery_pending_{false};
+  // Set if a history batch wasn't delivered to the replica.
+  std::atomic<bool> history_batch_dropped_{false};
 };
 
 }  // namespace storage
@@ -12,6 +12,8 @@
 #include "storage/v2/replication/replication_server.hpp"
 #include <atomic>
 #include <filesystem>
+#include <map>
+#include <mutex>
 
 #include "storage/v2/durability/durability.hpp"
 #include "storage/v2/durability/paths.hpp"
@@ -76,13 +78,26 @@ Storage::ReplicationServer::ReplicationServer(Storage *storage, io::network::End
     spdlog::debug("Received CurrentWalRpc");
     this->CurrentWalHandler(req_reader, res_builder);
   });
+  rpc_server_->Register<HistoryBatchRpc>([this](auto *req_reader, auto *res_builder) {
+    spdlog::debug("Received HistoryBatchRpc");
+    this->HistoryBatchHandler(req_reader, res_builder);
+  });
+  rpc_server_->Register<HistoryCheckpointRpc>([this](auto *req_reader, auto *res_builder) {
+    spdlog::debug("Received HistoryCheckpointRpc");
+    this->HistoryCheckpointHandler(req_reader, res_builder);
+  });
   rpc_server_->Start();
 }
 
 void Storage::ReplicationServer::HeartbeatHandler(slk::Reader *req_reader, slk::Builder *res_builder) {
   HeartbeatReq req;
   slk::Load(&req, req_reader);
-  HeartbeatRes res{true, storage_->last_commit_timestamp_.load(), storage_->epoch_id_};
+  uint64_t history_migrated_timestamp = 0;
+  {
+    std::lock_guard<std::mutex> gc_guard(storage_->gc_lock_);
+    history_migrated_timestamp = storage_->history_watermark_;
+  }
+  HeartbeatRes res{true, storage_->last_commit_timestamp_.load(), storage_->epoch_id_, history_migrated_timestamp};
   slk::Save(res, res_builder);
 }
 
@@ -92,44 +107,47 @@ void Storage::ReplicationServer::AppendDeltasHandler(slk::Reader *req_reader, sl
 
   replication::Decoder decoder(req_reader);
 
-  auto maybe_epoch_id = decoder.ReadString();
-  MG_ASSERT(maybe_epoch_id, "Invalid replication message");
-
-  if (*maybe_epoch_id != storage_->epoch_id_) {
-    storage_->epoch_history_.emplace_back(std::move(storage_->epoch_id_), storage_->last_commit_timestamp_);
-    storage_->epoch_id_ = std::move(*maybe_epoch_id);
-  }
+  // The transactions are applied only if the replica contains all of the
+  // transactions before the first one, otherwise the stream is just emptied.
+  const bool apply = req.previous_commit_timestamp == storage_->last_commit_timestamp_.load();
+  std::vector<uint8_t> buffer;
+  for (uint64_t i = 0; i < req.transactions_count; ++i) {
+    const auto maybe_seq_num = decoder.ReadUint();
+    auto maybe_epoch_id = decoder.ReadString();
+    const auto maybe_size = decoder.ReadUint();
+    MG_ASSERT(maybe_seq_num && maybe_epoch_id && maybe_size, "Invalid replication message");
+    const auto seq_num = *maybe_seq_num;
+
+    const bool epoch_changed = *maybe_epoch_id != storage_->epoch_id_;
+    if (epoch_changed) {
+      storage_->epoch_history_.emplace_back(std::move(storage_->epoch_id_), storage_->last_commit_timestamp_);
+      storage_->epoch_id_ = std::move(*maybe_epoch_id);
+    }
 
-  if (storage_->wal_file_) {
-    if (req.seq_num > storage_->wal_file_->SequenceNumber() || *maybe_epoch_id != storage_->epoch_id_) {
-      storage_->wal_file_->FinalizeWal();
-      storage_->wal_file_.reset();
-      storage_->wal_seq_num_ = req.seq_num;
+    if (storage_->wal_file_) {
+      if (seq_num > storage_->wal_file_->SequenceNumber() || epoch_changed) {
+        storage_->wal_file_->FinalizeWal();
+        storage_->wal_file_.reset();
+        storage_->wal_seq_num_ = seq_num;
+      } else {
+        MG_ASSERT(storage_->wal_file_->SequenceNumber() == seq_num, "Invalid sequence number of current wal file");
+        storage_->wal_seq_num_ = seq_num + 1;
+      }
     } else {
-      MG_ASSERT(storage_->wal_file_->SequenceNumber() == req.seq_num, "Invalid sequence number of current wal file");
-      storage_->wal_seq_num_ = req.seq_num + 1;
+      storage_->wal_seq_num_ = seq_num;
     }
-  } else {
-    storage_->wal_seq_num_ = req.seq_num;
-  }
 
-  if (req.previous_commit_timestamp != storage_->last_commit_timestamp_.load()) {
-    // Empty the stream
-    bool transaction_complete = false;
-    while (!transaction_complete) {
-      SPDLOG_INFO("Skipping delta");
-      const auto [timestamp, delta] = ReadDelta(&decoder);
-      transaction_complete = durability::IsWalDeltaDataTypeTransactionEnd(delta.type);
+    buffer.resize(*maybe_size);
+    decoder.ReadBuffer(buffer.data(), buffer.size());
+    if (!apply) {
+      SPDLOG_INFO("Skipping transaction");
+      continue;
     }
-
-    AppendDeltasRes res{false, storage_->last_commit_timestamp_.load()};
-    slk::Save(res, res_builder);
-    return;
+    durability::BufferDecoder transaction_decoder(buffer.data(), buffer.size());
+    ReadAndApplyDelta(&transaction_decoder);
   }
 
-  ReadAndApplyDelta(&decoder);
-
-  AppendDeltasRes res{true, storage_->last_commit_timestamp_.load()};
+  AppendDeltasRes res{apply, storage_->last_commit_timestamp_.load()};
   slk::Save(res, res_builder);
 }
 
@@ -158,7 +176,7 @@ void Storage::ReplicationServer::SnapshotHandler(slk::Reader *req_reader, slk::B
     spdlog::debug("Loading snapshot");
     auto recovered_snapshot = durability::LoadSnapshot(*maybe_snapshot_path, &storage_->vertices_, &storage_->edges_,
                                                        &storage_->epoch_history_, &storage_->name_id_mapper_,
-                                                       &storage_->edge_count_, storage_->config_.items);
+                                                       &storage_->edge_count_, storage_->config_);
     spdlog::debug("Snapshot loaded successfully");
     // If this step is present it should always be the first step of
     // the recovery so we use the UUID we read from snasphost
@@ -170,7 +188,8 @@ void Storage::ReplicationServer::SnapshotHandler(slk::Reader *req_reader, slk::B
     storage_->timestamp_ = std::max(storage_->timestamp_, recovery_info.next_timestamp);
 
     durability::RecoverIndicesAndConstraints(recovered_snapshot.indices_constraints, &storage_->indices_,
-                                             &storage_->constraints_, &storage_->vertices_);
+                                             &storage_->constraints_, &storage_->vertices_,
+                                             storage_->config_.durability.recovery_thread_count);
   } catch (const durability::RecoveryFailure &e) {
     LOG_FATAL("Couldn't load the snapshot because of: {}", e.what());
   }
@@ -181,9 +200,9 @@ void Storage::ReplicationServer::SnapshotHandler(slk::Reader *req_reader, slk::B
 
   // Delete other durability files
   auto snapshot_files = durability::GetSnapshotFiles(storage_->snapshot_directory_, storage_->uuid_);
-  for (const auto &[path, uuid, _] : snapshot_files) {
-    if (path != *maybe_snapshot_path) {
-      storage_->file_retainer_.DeleteFile(path);
+  for (const auto &snapshot_file : snapshot_files) {
+    if (snapshot_file.path != *maybe_snapshot_path) {
+      storage_->file_retainer_.DeleteFile(snapshot_file.path);
     }
   }
 
@@ -230,6 +249,66 @@ void Storage::ReplicationServer::CurrentWalHandler(slk::Reader *req_reader, slk:
   slk::Save(res, res_builder);
 }
 
+void Storage::ReplicationServer::HistoryBatchHandler(slk::Reader *req_reader, slk::Builder *res_builder) {
+  HistoryBatchReq req;
+  slk::Load(&req, req_reader);
+
+  replication::Decoder decoder(req_reader);
+
+  std::map<std::string, std::string> records;
+  for (uint64_t i = 0; i < req.records_count; ++i) {
+    auto key = decoder.ReadString();
+    auto value = decoder.ReadString();
+    MG_ASSERT(key && value, "Invalid replication message");
+    records.emplace(std::move(*key), std::move(*value));
+  }
+
+  std::lock_guard<std::mutex> gc_guard(storage_->gc_lock_);
+  // The batches must be applied without gaps, otherwise the main instance
+  // sends a checkpoint of its history store.
+  if (req.previous_migrated_timestamp != storage_->history_watermark_ ||
+      !storage_->saved_history_deltas_->ApplyMigration(records, req.migrated_timestamp)) {
+    HistoryBatchRes res{false, storage_->history_watermark_};
+    slk::Save(res, res_builder);
+    return;
+  }
+  storage_->history_watermark_ = req.migrated_timestamp;
+
+  HistoryBatchRes res{true, storage_->history_watermark_};
+  slk::Save(res, res_builder);
+}
+
+void Storage::ReplicationServer::HistoryCheckpointHandler(slk::Reader *req_reader, slk::Builder *res_builder) {
+  HistoryCheckpointReq req;
+  slk::Load(&req, req_reader);
+
+  replication::Decoder decoder(req_reader);
+
+  const auto &storage_directory = storage_->config_.durability.storage_directory;
+  const auto checkpoint_directory = storage_directory / durability::kHistoryReplicationDirectory / "from_main";
+  std::error_code error_code;
+  std::filesystem::remove_all(checkpoint_directory, error_code);
+  utils::EnsureDirOrDie(checkpoint_directory);
+  for (uint64_t i = 0; i < req.files_count; ++i) {
+    MG_ASSERT(decoder.ReadFile(checkpoint_directory), "Failed to load history checkpoint file!");
+  }
+  spdlog::info("Received history store checkpoint saved to {}", checkpoint_directory);
+
+  // Queries read the history store while holding the main lock.
+  std::unique_lock<utils::RWLock> storage_guard(storage_->main_lock_);
+  std::lock_guard<std::mutex> gc_guard(storage_->gc_lock_);
+  const auto history_directory = storage_directory / durability::kHistoryDirectory;
+  storage_->saved_history_deltas_.reset();
+  std::filesystem::remove_all(history_directory, error_code);
+  std::filesystem::rename(checkpoint_directory, history_directory, error_code);
+  MG_ASSERT(!error_code, "Couldn't replace the history store with the received checkpoint: {}", error_code.message());
+  storage_->saved_history_deltas_.emplace(history_directory, storage_->config_.items.realTimeFlag);
+  storage_->history_watermark_ = storage_->saved_history_deltas_->MigratedTimestamp();
+
+  HistoryCheckpointRes res{storage_->history_watermark_ == req.migrated_timestamp, storage_->history_watermark_};
+  slk::Save(res, res_builder);
+}
+
 void Storage::ReplicationServer::LoadWal(replication::Decoder *decoder) {
   const auto temp_wal_directory = std::filesystem::temp_directory_path() / "memgraph" / durability::kWalDirectory;
   utils::EnsureDir(temp_wal_directory);
@@ -262,9 +341,10 @@ void Storage::ReplicationServer::LoadWal(replication::Decoder *decoder) {
     if (!version) throw durability::RecoveryFailure("Couldn't read WAL magic and/or version!");
     if (!durability::IsVersionSupported(*version)) throw durability::RecoveryFailure("Invalid WAL version!");
     wal.SetPosition(wal_info.offset_deltas);
+    durability::WalDeltaDecoder deltas(&wal, *version);
 
     for (size_t i = 0; i < wal_info.num_deltas;) {
-      i += ReadAndApplyDelta(&wal);
+      i += ReadAndApplyDelta(&deltas);
     }
 
     spdlog::debug("{} loaded successfully", *maybe_wal_path);
@@ -122,6 +122,8 @@ bool Decoder::SkipPropertyValue() {
   return true;
 }
 
+void Decoder::ReadBuffer(uint8_t *buffer, const size_t buffer_size) { reader_->Load(buffer, buffer_size); }
+
 std::optional<std::filesystem::path> Decoder::ReadFile(const std::filesystem::path &directory,
                                                        const std::string &suffix) {
   MG_ASSERT(std::filesystem::exists(directory) && std::filesystem::is_directory(directory),
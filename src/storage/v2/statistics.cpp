@@ -0,0 +1,260 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "storage/v2/statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <shared_mutex>
+
+#include <json/json.hpp>
+
+#include "utils/logging.hpp"
+
+namespace storage {
+
+namespace {
+
+// Every label is stored with the statistics of its properties in a single
+// record, the edge types are stored together in another one.
+const std::string kLabelPrefix{"label:"};
+const std::string kEdgeTypesKey{"edge_types"};
+
+nlohmann::json SerializeDegree(const DegreeStatistics &degree) {
+  return {{"average", degree.average}, {"max", degree.max}, {"histogram", degree.histogram}};
+}
+
+DegreeStatistics DeserializeDegree(const nlohmann::json &data) {
+  DegreeStatistics degree;
+  degree.average = data.at("average").get<double>();
+  degree.max = data.at("max").get<uint64_t>();
+  degree.histogram = data.at("histogram").get<std::vector<uint64_t>>();
+  return degree;
+}
+
+nlohmann::json SerializeBound(const PropertyValue &value) {
+  switch (value.type()) {
+    case PropertyValue::Type::Bool:
+      return value.ValueBool();
+    case PropertyValue::Type::Int:
+      return value.ValueInt();
+    case PropertyValue::Type::Double:
+      return value.ValueDouble();
+    case PropertyValue::Type::String:
+      return value.ValueString();
+    default:
+      return nullptr;
+  }
+}
+
+PropertyValue DeserializeBound(const nlohmann::json &data) {
+  if (data.is_boolean()) return PropertyValue(data.get<bool>());
+  if (data.is_number_integer()) return PropertyValue(data.get<int64_t>());
+  if (data.is_number()) return PropertyValue(data.get<double>());
+  if (data.is_string()) return PropertyValue(data.get<std::string>());
+  return PropertyValue();
+}
+
+nlohmann::json SerializeLabel(const LabelStatistics &label, const std::map<std::string, PropertyStatistics> &properties) {
+  auto data = nlohmann::json::object();
+  data["vertex_count"] = label.vertex_count;
+  data["out_degree"] = SerializeDegree(label.out_degree);
+  data["in_degree"] = SerializeDegree(label.in_degree);
+  data["vertices_with_history"] = label.vertices_with_history;
+  data["average_history_span"] = label.average_history_span;
+  auto properties_data = nlohmann::json::object();
+  for (const auto &[name, property] : properties) {
+    auto bounds = nlohmann::json::array();
+    for (const auto &bound : property.bounds) bounds.push_back(SerializeBound(bound));
+    properties_data[name] = {{"count", property.count},
+                             {"distinct_values", property.distinct_values},
+                             {"histogram_count", property.histogram_count},
+                             {"bounds", std::move(bounds)}};
+  }
+  data["properties"] = std::move(properties_data);
+  return data;
+}
+
+nlohmann::json SerializeEdgeType(const EdgeTypeStatistics &edge_type) {
+  return {{"edge_count", edge_type.edge_count},
+          {"source_count", edge_type.source_count},
+          {"destination_count", edge_type.destination_count},
+          {"out_degree", SerializeDegree(edge_type.out_degree)},
+          {"in_degree", SerializeDegree(edge_type.in_degree)}};
+}
+
+EdgeTypeStatistics DeserializeEdgeType(const nlohmann::json &data) {
+  EdgeTypeStatistics edge_type;
+  edge_type.edge_count = data.at("edge_count").get<uint64_t>();
+  edge_type.source_count = data.at("source_count").get<uint64_t>();
+  edge_type.destination_count = data.at("destination_count").get<uint64_t>();
+  edge_type.out_degree = DeserializeDegree(data.at("out_degree"));
+  edge_type.in_degree = DeserializeDegree(data.at("in_degree"));
+  return edge_type;
+}
+
+}  // namespace
+
+void DegreeStatistics::Add(uint64_t degree) {
+  const auto bucket = static_cast<size_t>(std::bit_width(degree));
+  if (histogram.size() <= bucket) histogram.resize(bucket + 1, 0);
+  ++histogram[bucket];
+  average += static_cast<double>(degree);
+  max = std::max(max, degree);
+}
+
+void DegreeStatistics::Finish(uint64_t count) {
+  if (count != 0) average /= static_cast<double>(count);
+}
+
+double PropertyStatistics::EstimateEqual() const {
+  return static_cast<double>(count) / static_cast<double>(std::max<uint64_t>(distinct_values, 1));
+}
+
+std::optional<double> PropertyStatistics::EstimateRange(const std::optional<utils::Bound<PropertyValue>> &lower,
+                                                        const std::optional<utils::Bound<PropertyValue>> &upper) const {
+  if (bounds.empty() || (!lower && !upper)) return std::nullopt;
+  const auto type = bounds.front().type();
+  for (const auto &bound : {lower, upper}) {
+    if (bound && !PropertyValue::AreComparableTypes(bound->value().type(), type)) return std::nullopt;
+  }
+  // Bucket i holds the values in (bounds[i - 1], bounds[i]], the buckets at
+  // both ends of the range are counted as half full.
+  const auto size = bounds.size();
+  size_t first = 0;
+  if (lower) first = std::lower_bound(bounds.begin(), bounds.end(), lower->value()) - bounds.begin();
+  size_t last = size - 1;
+  if (upper) last = std::min<size_t>(std::lower_bound(bounds.begin(), bounds.end(), upper->value()) - bounds.begin(), last);
+  if (first >= size || last < first) return 0.0;
+  double buckets = static_cast<double>(last - first + 1);
+  if (lower && first != 0) buckets -= 0.5;
+  if (upper && last != size - 1) buckets -= 0.5;
+  buckets = std::max(buckets, 0.5);
+  return buckets * static_cast<double>(histogram_count) / static_cast<double>(size);
+}
+
+StatisticsStore::StatisticsStore(const std::filesystem::path &directory) : storage_(directory) {
+  for (auto it = storage_.begin(kLabelPrefix); it != storage_.end(kLabelPrefix); ++it) {
+    try {
+      const auto label = it->first.substr(kLabelPrefix.size());
+      const auto data = nlohmann::json::parse(it->second);
+      LabelStatistics statistics;
+      statistics.vertex_count = data.at("vertex_count").get<uint64_t>();
+      statistics.out_degree = DeserializeDegree(data.at("out_degree"));
+      statistics.in_degree = DeserializeDegree(data.at("in_degree"));
+      statistics.vertices_with_history = data.at("vertices_with_history").get<uint64_t>();
+      statistics.average_history_span = data.at("average_history_span").get<double>();
+      for (const auto &[name, property_data] : data.at("properties").items()) {
+        PropertyStatistics property;
+        property.count = property_data.at("count").get<uint64_t>();
+        property.distinct_values = property_data.at("distinct_values").get<uint64_t>();
+        property.histogram_count = property_data.at("histogram_count").get<uint64_t>();
+        for (const auto &bound : property_data.at("bounds")) property.bounds.push_back(DeserializeBound(bound));
+        properties_.emplace(std::make_pair(label, name), std::move(property));
+      }
+      labels_.emplace(label, std::move(statistics));
+    } catch (const nlohmann::json::exception &e) {
+      spdlog::warn("Couldn't load the statistics stored under {}: {}", it->first, e.what());
+    }
+  }
+  if (auto edge_types = storage_.Get(kEdgeTypesKey)) {
+    try {
+      for (const auto &[name, data] : nlohmann::json::parse(*edge_types).items()) {
+        auto statistics = DeserializeEdgeType(data);
+        analyzed_edge_count_ += statistics.edge_count;
+        edge_types_.emplace(name, std::move(statistics));
+      }
+    } catch (const nlohmann::json::exception &e) {
+      spdlog::warn("Couldn't load the edge type statistics: {}", e.what());
+      edge_types_.clear();
+      analyzed_edge_count_ = 0;
+    }
+  }
+}
+
+std::optional<LabelStatistics> StatisticsStore::GetLabelStatistics(const std::string &label) const {
+  std::shared_lock<utils::RWLock> guard(lock_);
+  auto it = labels_.find(label);
+  if (it == labels_.end()) return std::nullopt;
+  return it->second;
+}
+
+std::optional<EdgeTypeStatistics> StatisticsStore::GetEdgeTypeStatistics(const std::string &edge_type) const {
+  std::shared_lock<utils::RWLock> guard(lock_);
+  auto it = edge_types_.find(edge_type);
+  if (it == edge_types_.end()) return std::nullopt;
+  return it->second;
+}
+
+std::optional<PropertyStatistics> StatisticsStore::GetPropertyStatistics(const std::string &label,
+                                                                         const std::string &property) const {
+  std::shared_lock<utils::RWLock> guard(lock_);
+  auto it = properties_.find(std::make_pair(label, property));
+  if (it == properties_.end()) return std::nullopt;
+  return it->second;
+}
+
+uint64_t StatisticsStore::AnalyzedEdgeCount() const {
+  std::shared_lock<utils::RWLock> guard(lock_);
+  return analyzed_edge_count_;
+}
+
+void StatisticsStore::SetLabelStatistics(const std::string &label, const LabelStatistics &statistics,
+                                         const std::map<std::string, PropertyStatistics> &properties) {
+  std::lock_guard<utils::RWLock> guard(lock_);
+  if (!storage_.Put(kLabelPrefix + label, SerializeLabel(statistics, properties).dump())) {
+    spdlog::warn("Couldn't persist the statistics of the label {}", label);
+  }
+  labels_[label] = statistics;
+  auto it = properties_.lower_bound(std::make_pair(label, std::string()));
+  while (it != properties_.end() && it->first.first == label) it = properties_.erase(it);
+  for (const auto &[name, property] : properties) properties_.emplace(std::make_pair(label, name), property);
+}
+
+void StatisticsStore::SetEdgeTypeStatistics(const std::map<std::string, EdgeTypeStatistics> &edge_types) {
+  std::lock_guard<utils::RWLock> guard(lock_);
+  auto data = nlohmann::json::object();
+  analyzed_edge_count_ = 0;
+  for (const auto &[name, statistics] : edge_types) {
+    data[name] = SerializeEdgeType(statistics);
+    analyzed_edge_count_ += statistics.edge_count;
+  }
+  if (!storage_.Put(kEdgeTypesKey, data.dump())) spdlog::warn("Couldn't persist the edge type statistics");
+  edge_types_ = edge_types;
+}
+
+void StatisticsStore::ClearLabelStatistics(const std::string &label) {
+  std::lock_guard<utils::RWLock> guard(lock_);
+  storage_.Delete(kLabelPrefix + label);
+  labels_.erase(label);
+  auto it = properties_.lower_bound(std::make_pair(label, std::string()));
+  while (it != properties_.end() && it->first.first == label) it = properties_.erase(it);
+}
+
+void StatisticsStore::Clear() {
+  std::lock_guard<utils::RWLock> guard(lock_);
+  storage_.DeletePrefix();
+  labels_.clear();
+  edge_types_.clear();
+  properties_.clear();
+  analyzed_edge_count_ = 0;
+}
+
+std::vector<std::string> StatisticsStore::AnalyzedLabels() const {
+  std::shared_lock<utils::RWLock> guard(lock_);
+  std::vector<std::string> labels;
+  labels.reserve(labels_.size());
+  for (const auto &[label, statistics] : labels_) labels.push_back(label);
+  return labels;
+}
+
+}  // namespace storage
@@ -0,0 +1,123 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kvstore/kvstore.hpp"
+#include "storage/v2/property_value.hpp"
+#include "utils/bound.hpp"
+#include "utils/rw_lock.hpp"
+
+namespace storage {
+
+/// Distribution of the number of edges of a set of vertices. Bucket 0 of the
+/// histogram counts the vertices without edges and bucket i > 0 the vertices
+/// with a degree in [2^(i - 1), 2^i).
+struct DegreeStatistics {
+  double average{0};
+  uint64_t max{0};
+  std::vector<uint64_t> histogram;
+
+  void Add(uint64_t degree);
+  /// Turns the sum of the added degrees into the average.
+  void Finish(uint64_t count);
+};
+
+/// Statistics of the vertices with a label, collected by `ANALYZE GRAPH`.
+struct LabelStatistics {
+  uint64_t vertex_count{0};
+  DegreeStatistics out_degree;
+  DegreeStatistics in_degree;
+  // Vertices that have versions in the history store and the average length
+  // of the time those versions span.
+  uint64_t vertices_with_history{0};
+  double average_history_span{0};
+};
+
+/// Statistics of the edges of an edge type. The degrees are computed over the
+/// vertices that have at least one edge of the type in that direction.
+struct EdgeTypeStatistics {
+  uint64_t edge_count{0};
+  uint64_t source_count{0};
+  uint64_t destination_count{0};
+  DegreeStatistics out_degree;
+  DegreeStatistics in_degree;
+};
+
+/// Statistics of the values of a property of the vertices with a label.
+///
+/// `bounds` is an equi-depth histogram of the boolean, numeric and string
+/// values: every bucket holds `histogram_count / bounds.size()` values and
+/// `bounds[i]` is the largest value in bucket i. Other values (lists, maps,
+/// temporal types) are only counted.
+struct PropertyStatistics {
+  uint64_t count{0};
+  uint64_t distinct_values{0};
+  uint64_t histogram_count{0};
+  std::vector<PropertyValue> bounds;
+
+  /// Estimated number of values equal to some value.
+  double EstimateEqual() const;
+
+  /// Estimated number of values in the range, std::nullopt if the histogram
+  /// doesn't cover the type of the bounds.
+  std::optional<double> EstimateRange(const std::optional<utils::Bound<PropertyValue>> &lower,
+                                      const std::optional<utils::Bound<PropertyValue>> &upper) const;
+};
+
+/// Statistics about the graph used by the planner. The statistics are stored
+/// by the names of the labels, edge types and properties, so they stay valid
+/// across restarts, and are persisted in a `kvstore::KVStore` in the storage
+/// directory.
+///
+/// The statistics are only an estimate: they are never updated by the
+/// transactions and are refreshed by `ANALYZE GRAPH`.
+class StatisticsStore final {
+ public:
+  explicit StatisticsStore(const std::filesystem::path &directory);
+
+  std::optional<LabelStatistics> GetLabelStatistics(const std::string &label) const;
+  std::optional<EdgeTypeStatistics> GetEdgeTypeStatistics(const std::string &edge_type) const;
+  std::optional<PropertyStatistics> GetPropertyStatistics(const std::string &label, const std::string &property) const;
+
+  /// Number of edges of all the analyzed edge types, 0 if there are none.
+  uint64_t AnalyzedEdgeCount() const;
+
+  /// Replaces the statistics of the label, including the statistics of all its
+  /// properties.
+  void SetLabelStatistics(const std::string &label, const LabelStatistics &statistics,
+                          const std::map<std::string, PropertyStatistics> &properties);
+  /// Replaces the statistics of all edge types.
+  void SetEdgeTypeStatistics(const std::map<std::string, EdgeTypeStatistics> &edge_types);
+
+  /// Removes the statistics of the label and its properties.
+  void ClearLabelStatistics(const std::string &label);
+  void Clear();
+
+  std::vector<std::string> AnalyzedLabels() const;
+
+ private:
+  mutable utils::RWLock lock_{utils::RWLock::Priority::WRITE};
+  std::map<std::string, LabelStatistics> labels_;
+  std::map<std::string, EdgeTypeStatistics> edge_types_;
+  std::map<std::pair<std::string, std::string>, PropertyStatistics> properties_;
+  uint64_t analyzed_edge_count_{0};
+  kvstore::KVStore storage_;
+};
+
+}  // namespace storage
@@ -14,6 +14,7 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <variant>
 
 #include <fstream>
@@ -174,6 +175,55 @@ using OOMExceptionEnabler = utils::MemoryTracker::OutOfMemoryExceptionEnabler;
 
 namespace {
 [[maybe_unused]] constexpr uint16_t kEpochHistoryRetention = 1000;
+// Number of records after which the GC writes the migrated history if the
+// table file ingestion is disabled.
+constexpr uint64_t kHistoryMigrationBatchSize = 10000;
+
+// Returns true if any delta of the transaction has at least `limit` newer
+// deltas in its version chain. The chain is only read, so no locks are needed.
+bool HasDeepDelta(const Transaction &transaction, uint64_t limit) {
+  for (const auto &delta : transaction.deltas) {
+    uint64_t depth = 0;
+    for (auto prev = delta.prev.Get(); prev.type == PreviousPtr::Type::DELTA; prev = prev.delta->prev.Get()) {
+      if (++depth >= limit) return true;
+    }
+  }
+  return false;
+}
+
+// If the history store is missing, restores it from the newest checkpoint
+// that was taken together with a snapshot.
+void RestoreHistoryCheckpoint(const std::filesystem::path &storage_directory) {
+  const auto history_directory = storage_directory / durability::kHistoryDirectory;
+  const auto checkpoint_directory = storage_directory / durability::kHistoryCheckpointDirectory;
+  if (utils::DirExists(history_directory) || !utils::DirExists(checkpoint_directory)) return;
+
+  std::optional<std::pair<uint64_t, std::filesystem::path>> newest;
+  std::error_code error_code;
+  for (const auto &item : std::filesystem::directory_iterator(checkpoint_directory, error_code)) {
+    if (!item.is_directory()) continue;
+    auto timestamp = durability::ParseHistoryCheckpointName(item.path().filename());
+    if (timestamp && (!newest || *timestamp > newest->first)) newest.emplace(*timestamp, item.path());
+  }
+  if (error_code || !newest) return;
+
+  spdlog::info("Restoring the history store from the checkpoint {}.", newest->second);
+  std::filesystem::copy(newest->second, history_directory, std::filesystem::copy_options::recursive, error_code);
+  MG_ASSERT(!error_code, "Couldn't restore the history store from {} because of: {}", newest->second,
+            error_code.message());
+}
+
+// Merges the gids recorded by the commits into a sorted vector without
+// duplicates.
+std::vector<Gid> MergeChangedGids(const std::vector<std::vector<Gid>> &recorded) {
+  std::vector<Gid> gids;
+  for (const auto &item : recorded) {
+    gids.insert(gids.end(), item.begin(), item.end());
+  }
+  std::sort(gids.begin(), gids.end());
+  gids.erase(std::unique(gids.begin(), gids.end()), gids.end());
+  return gids;
+}
 }  // namespace
 
 auto AdvanceToVisibleVertex(utils::SkipList<Vertex>::Iterator it, utils::SkipList<Vertex>::Iterator end,
@@ -432,9 +482,13 @@ Storage::Storage(Config config)
       global_locker_(file_retainer_.AddLocker()) {
         //hjm begin
       // saved_history_deltas_.init(config_.durability.storage_directory/"history_deltas");
-         saved_history_deltas_.emplace(config_.durability.storage_directory/"history_deltas",config_.items.realTimeFlag);
-        //recover kv's time_table index
-        // saved_history_deltas_->GetTimeTableAll(); //hjm begin timetable
+         if (config_.durability.recover_on_startup) RestoreHistoryCheckpoint(config_.durability.storage_directory);
+         saved_history_deltas_.emplace(config_.durability.storage_directory / durability::kHistoryDirectory,
+                                       config_.items.realTimeFlag, config_.gc.history_ingest_batch_size);
+         history_watermark_ = saved_history_deltas_->MigratedTimestamp();
+         statistics_.emplace(config_.durability.storage_directory / durability::kStatisticsDirectory);
+        // The history store recovers its time table (lifetime) index on construction.
+        if (config_.items.realTimeFlag) history_clock_.Observe(saved_history_deltas_->LatestTimestamp());
         //hjm end
   if (config_.durability.snapshot_wal_mode != Config::Durability::SnapshotWalMode::DISABLED ||
       config_.durability.snapshot_on_exit || config_.durability.recover_on_startup) {
@@ -464,7 +518,7 @@ Storage::Storage(Config config)
   if (config_.durability.recover_on_startup) {
     auto info = durability::RecoverData(snapshot_directory_, wal_directory_, &uuid_, &epoch_id_, &epoch_history_,
                                         &vertices_, &edges_, &edge_count_, &name_id_mapper_, &indices_, &constraints_,
-                                        config_.items, &wal_seq_num_);
+                                        config_, &wal_seq_num_);
     if (info) {
       vertex_id_ = info->next_vertex_id;
       edge_id_ = info->next_edge_id;
@@ -473,6 +527,16 @@ Storage::Storage(Config config)
         last_commit_timestamp_ = *info->last_commit_timestamp;
       }
     }
+    // The history store is written by the GC, independently of the snapshots
+    // and WAL files. Everything committed up to the migration timestamp is
+    // already in it, newer transactions were recovered without their
+    // overwritten versions.
+    if (const auto recovered_timestamp = timestamp_; recovered_timestamp > history_watermark_ + 1) {
+      spdlog::warn(
+          "The history store contains all transactions committed up to timestamp {}, the history of the "
+          "transactions recovered after it may be incomplete.",
+          history_watermark_);
+    }
   } else if (config_.durability.snapshot_wal_mode != Config::Durability::SnapshotWalMode::DISABLED ||
              config_.durability.snapshot_on_exit) {
     bool files_moved = false;
@@ -502,6 +566,9 @@ Storage::Storage(Config config)
           "those files into a .backup directory inside the storage directory.");
     }
   }
+  // The recovered data can be older than the history store (e.g. if the WAL
+  // was disabled), the new commits must not reuse the migrated timestamps.
+  timestamp_ = std::max(timestamp_, history_watermark_ + 1);
   //hjm begin rocksdb retention
   if (config_.rocksdb_retention.retention_on_startup){
     reclaim_rocksdb_runner_.Run("Rocksdb GC", config_.rocksdb_retention.retention_interval, [this] { this->ReclaimHistoryRentention(config_.rocksdb_retention.retention_period); });
@@ -572,11 +639,13 @@ Storage::Accessor::Accessor(Accessor &&other) noexcept
       storage_guard_(std::move(other.storage_guard_)),
       transaction_(std::move(other.transaction_)),
       commit_timestamp_(other.commit_timestamp_),
+      commit_slot_(other.commit_slot_),
       is_transaction_active_(other.is_transaction_active_),
       config_(other.config_) {
   // Don't allow the other accessor to abort our transaction in destructor.
   other.is_transaction_active_ = false;
   other.commit_timestamp_.reset();
+  other.commit_slot_.reset();
 }
 
 Storage::Accessor::~Accessor() {
@@ -591,6 +660,47 @@ bool Storage::ReclaimHistoryRentention(const std::chrono::milliseconds &retentio
   return saved_history_deltas_->RemoveOldHistory(retention_period);
 }
 
+bool Storage::ImportHistory(std::vector<history_delta::ImportedVersion> vertex_versions,
+                            std::vector<history_delta::ImportedVersion> edge_versions,
+                            const std::vector<std::pair<Gid, uint64_t>> &vertex_starts,
+                            const std::vector<std::pair<Gid, uint64_t>> &edge_starts) {
+  uint64_t latest = 0;
+  for (const auto *versions : {&vertex_versions, &edge_versions}) {
+    for (const auto &version : *versions) latest = std::max(latest, version.tt_te);
+  }
+  if (!saved_history_deltas_->ImportVersions(std::move(vertex_versions), std::move(edge_versions))) return false;
+
+  auto vertices = vertices_.access();
+  for (const auto &[gid, start] : vertex_starts) {
+    auto it = vertices.find(gid);
+    if (it == vertices.end()) continue;
+    it->transaction_st = start;
+    latest = std::max(latest, start);
+  }
+  auto edges = edges_.access();
+  for (const auto &[gid, start] : edge_starts) {
+    auto it = edges.find(gid);
+    if (it == edges.end()) continue;
+    it->transaction_st = start;
+    latest = std::max(latest, start);
+  }
+
+  if (config_.items.realTimeFlag) {
+    history_clock_.Observe(latest);
+  } else {
+    // The logical history timestamps are the commit timestamps. There are no
+    // active transactions, so the commit log can simply start over instead of
+    // allocating its blocks for the whole skipped range.
+    std::lock_guard<std::mutex> gc_guard(gc_lock_);
+    std::lock_guard<utils::SpinLock> guard(engine_lock_);
+    if (latest + 1 > timestamp_) {
+      timestamp_ = latest + 1;
+      commit_log_.emplace(timestamp_);
+    }
+  }
+  return true;
+}
+
 storage::HistoryVertex Storage::Accessor::CreateHistoryVertexFromKV(const storage::HistoryVertex vertex_,nlohmann::json gid_delta_,history_delta::historyContext &historyContext_){
   //properties
   auto maybe_labels= vertex_.labels;
@@ -674,7 +784,8 @@ storage::HistoryEdge Storage::Accessor::CreateHistoryEdgeFromKV(const EdgeAccess
   auto to_gid=another.ToVertex().Gid();
   //还原到最近的dead info
   auto deltas=another.edge_.ptr->delta;
-  while (deltas != nullptr) {
+  // Migrated deltas (and everything older) are already part of the history.
+  while (deltas != nullptr && !deltas->migrated.load(std::memory_order_acquire)) {
     switch (deltas->action) {
       case storage::Delta::Action::SET_PROPERTY: {
         auto property_value =deltas->property.value;
@@ -744,6 +855,103 @@ storage::HistoryEdge Storage::Accessor::CreateHistoryEdgeFromKV(storage::History
   return history_edge;
 }
 
+void Storage::Accessor::VisitVertexPropertyVersions(Gid gid, PropertyId property, uint64_t c_ts, uint64_t c_te,
+                                                    const history_delta::PropertyVersionVisitor &visitor) {
+  const auto hybrid_clock = storage_->UsesHybridClock();
+  if (hybrid_clock) {
+    c_ts = HybridClock::LowerBound(c_ts);
+    c_te = HybridClock::UpperBound(c_te);
+  }
+  auto visit = [&](uint64_t tt_ts, uint64_t tt_te, const PropertyValue &value) {
+    tt_ts = std::max(tt_ts, c_ts);
+    tt_te = std::min(tt_te, c_te);
+    if (hybrid_clock) {
+      tt_ts = HybridClock::ToMillis(tt_ts);
+      tt_te = HybridClock::ToMillis(tt_te);
+    }
+    return visitor(tt_ts, tt_te, value);
+  };
+
+  // The accessor keeps the vertex alive while its delta chain is read.
+  auto acc = storage_->vertices_.access();
+  auto it = acc.find(gid);
+  PropertyValue value;
+  bool exists = false;
+  bool created = false;
+  uint64_t version_ts = 0;
+  Delta *delta = nullptr;
+  if (it != acc.end()) {
+    std::lock_guard<utils::SpinLock> guard(it->lock);
+    value = it->properties.GetProperty(property);
+    exists = !it->deleted;
+    version_ts = it->transaction_st;
+    delta = it->delta;
+  }
+
+  auto apply = [&](const Delta &current) {
+    switch (current.action) {
+      case Delta::Action::SET_PROPERTY:
+        if (current.property.key == property) value = current.property.value;
+        return true;
+      case Delta::Action::ADD_LABEL:
+      case Delta::Action::REMOVE_LABEL:
+        return true;
+      case Delta::Action::RECREATE_OBJECT:
+        exists = true;
+        return true;
+      case Delta::Action::DELETE_OBJECT:
+        exists = false;
+        created = true;
+        return true;
+      case Delta::Action::ADD_IN_EDGE:
+      case Delta::Action::ADD_OUT_EDGE:
+      case Delta::Action::REMOVE_IN_EDGE:
+      case Delta::Action::REMOVE_OUT_EDGE:
+        // Changes of the adjacency don't start a new version of the vertex.
+        return false;
+    }
+    return false;
+  };
+
+  // Only the committed versions are visited.
+  while (delta != nullptr && delta->timestamp->load(std::memory_order_acquire) >= kTransactionInitialId) {
+    apply(*delta);
+    delta = delta->next.load(std::memory_order_acquire);
+  }
+  if (exists && version_ts < c_te &&
+      !visit(version_ts, static_cast<uint64_t>(std::numeric_limits<int64_t>::max()), value)) {
+    return;
+  }
+
+  // All deltas of a transaction are next to each other in the chain and
+  // together they restore the version that the transaction replaced.
+  while (delta != nullptr && !delta->migrated.load(std::memory_order_acquire)) {
+    const auto commit = delta->commit_timestamp;
+    uint64_t start = commit;
+    bool changed = false;
+    for (; delta != nullptr && !delta->migrated.load(std::memory_order_acquire) && delta->commit_timestamp == commit;
+         delta = delta->next.load(std::memory_order_acquire)) {
+      if (apply(*delta)) {
+        changed = true;
+        if (delta->action != Delta::Action::DELETE_OBJECT) start = delta->transaction_st;
+      }
+    }
+    if (!changed) continue;
+    // The older versions end before the window starts.
+    if (commit <= c_ts) return;
+    if (exists && start < commit && start < c_te && !visit(start, commit, value)) return;
+  }
+
+  // The migrated part of the history starts where the chain ends, unless the
+  // vertex was created after the last migration.
+  if (created || !storage_->saved_history_deltas_) return;
+  storage_->saved_history_deltas_->VisitVertexPropertyVersions(
+      gid.AsUint(), storage_->name_id_mapper_.IdToName(property.AsUint()), c_ts, c_te, value,
+      [&](uint64_t tt_ts, uint64_t tt_te, const PropertyValue &history_value) {
+        return tt_ts >= tt_te || visit(tt_ts, tt_te, history_value);
+      });
+}
+
 Result<std::vector<EdgeAccessor>> Storage::Accessor::Edges(std::vector<std::tuple<EdgeTypeId, Vertex *, EdgeRef>> &edges_,const std::vector<EdgeTypeId> &edge_types,storage::Gid gid,bool from,std::optional<storage::Gid> existing_gid){
     std::vector<std::tuple<EdgeTypeId, Vertex *, EdgeRef>> edges;
     {
@@ -1535,6 +1743,7 @@ utils::BasicResult<ConstraintViolation, void> Storage::Accessor::Commit(
   
   std::set<storage::Vertex *> commit_vertices;
   std::set<storage::Edge *> commit_edges;
+  uint64_t history_timestamp = 0;
 
   if (transaction_.deltas.empty()) {
     // We don't have to update the commit timestamp here because no one reads
@@ -1566,10 +1775,39 @@ utils::BasicResult<ConstraintViolation, void> Storage::Accessor::Commit(
     // Save these so we can mark them used in the commit log.
     uint64_t start_timestamp = transaction_.start_timestamp;
 
+    // Replica can log only the write transaction received from Main
+    // so the Wal files are consistent
+    const bool write_wal = storage_->replication_role_ == ReplicationRole::MAIN || desired_commit_timestamp.has_value();
+    // Encode the WAL records before taking the engine lock, only the commit
+    // timestamp is filled in while holding it.
+    auto wal_buffer = write_wal ? storage_->EncodeForWal(transaction_) : std::nullopt;
+    uint64_t wal_sequence = 0;
+    // Objects changed by the transaction, recorded for the next incremental
+    // snapshot. Every changed object has exactly one delta that points to it.
+    std::vector<Gid> changed_vertices;
+    std::vector<Gid> changed_edges;
+    if (storage_->replication_role_ == ReplicationRole::MAIN && storage_->IncrementalSnapshotsEnabled()) {
+      for (const auto &delta : transaction_.deltas) {
+        auto prev = delta.prev.Get();
+        if (prev.type == PreviousPtr::Type::VERTEX) {
+          changed_vertices.push_back(prev.vertex->gid);
+        } else if (prev.type == PreviousPtr::Type::EDGE) {
+          changed_edges.push_back(prev.edge->gid);
+        }
+      }
+    }
+    std::shared_ptr<ReplicatedTransaction> replicated;
+    // Claimed before taking the engine lock because it may have to wait for
+    // a free slot.
+    commit_slot_ = storage_->pending_commits_.Claim();
+
     {
       std::unique_lock<utils::SpinLock> engine_guard(storage_->engine_lock_);
       commit_timestamp_.emplace(storage_->CommitTimestamp(desired_commit_timestamp));
-      
+      // Taken under the engine lock so that the history timestamps are ordered
+      // the same way as the commit timestamps.
+      history_timestamp = config_.realTimeFlag ? storage_->history_clock_.Now() : *commit_timestamp_;
+
       // Before committing and validating vertices against unique constraints,
       // we have to update unique constraints with the vertices that are going
       // to be validated/committed.
@@ -1604,35 +1842,31 @@ utils::BasicResult<ConstraintViolation, void> Storage::Accessor::Commit(
         // Write transaction to WAL while holding the engine lock to make sure
         // that committed transactions are sorted by the commit timestamp in the
         // WAL files. We supply the new commit timestamp to the function so that
-        // it knows what will be the final commit timestamp. The WAL must be
-        // written before actually committing the transaction (before setting
-        // the commit timestamp) so that no other transaction can see the
-        // modifications before they are written to disk.
-        // Replica can log only the write transaction received from Main
-        // so the Wal files are consistent
+        // it knows what will be the final commit timestamp. With group commit
+        // the records are only synced after the engine lock is released, the
+        // commit is kept invisible until then (see below) so that no other
+        // transaction can see the modifications before they are on disk.
+        if (wal_buffer) {
+          wal_sequence = storage_->AppendToWal(&*wal_buffer, *commit_timestamp_, &replicated);
+        }
+        // TODO: update all deltas to have a local copy of the commit
+        // timestamp
+        MG_ASSERT(transaction_.commit_timestamp != nullptr, "Invalid database state!");
+        transaction_.commit_timestamp->store(*commit_timestamp_, std::memory_order_release);
+        storage_->pending_commits_.SetTimestamp(*commit_slot_, *commit_timestamp_);
+        // Replica can only update the last commit timestamp with
+        // the commits received from main.
         if (storage_->replication_role_ == ReplicationRole::MAIN || desired_commit_timestamp.has_value()) {
-          storage_->AppendToWal(transaction_, *commit_timestamp_);
+          // Update the last commit timestamp
+          storage_->last_commit_timestamp_.store(*commit_timestamp_);
+        }
+        if (!changed_vertices.empty() || !changed_edges.empty()) {
+          storage_->RecordSnapshotChanges(std::move(changed_vertices), std::move(changed_edges));
         }
 
-        // Take committed_transactions lock while holding the engine lock to
-        // make sure that committed transactions are sorted by the commit
-        // timestamp in the list.
-        storage_->committed_transactions_.WithLock([&](auto &committed_transactions) {
-          // TODO: release lock, and update all deltas to have a local copy
-          // of the commit timestamp
-          MG_ASSERT(transaction_.commit_timestamp != nullptr, "Invalid database state!");
-          transaction_.commit_timestamp->store(*commit_timestamp_, std::memory_order_release);
-          // Replica can only update the last commit timestamp with
-          // the commits received from main.
-          if (storage_->replication_role_ == ReplicationRole::MAIN || desired_commit_timestamp.has_value()) {
-            // Update the last commit timestamp
-            storage_->last_commit_timestamp_.store(*commit_timestamp_);
-          }
-
-          // Release engine lock because we don't have to hold it anymore
-          // and emplace back could take a long time.
-          engine_guard.unlock();
-        });
+        // Release engine lock because we don't have to hold it anymore. The
+        // transaction is handed over to the GC in `FinalizeTransaction`.
+        engine_guard.unlock();
 
         storage_->commit_log_->MarkFinished(start_timestamp);
       }
@@ -1642,90 +1876,57 @@ utils::BasicResult<ConstraintViolation, void> Storage::Accessor::Commit(
       Abort();
       return *unique_constraint_violation;
     }
+
+    // The transaction must not become visible before its WAL records are
+    // synced and the SYNC replicas confirmed it. Its commit timestamp is
+    // already set, but the transactions which start afterwards wait in
+    // `CreateTransaction` until the commit is marked visible, so the sync and
+    // the replicas are waited for without holding the engine lock and the
+    // other commits aren't held back. The ASYNC replicas don't hold the commit
+    // back.
+    if (wal_sequence != 0 && storage_->config_.durability.wal_group_commit) {
+      storage_->WaitForWalSync(wal_sequence);
+    }
+    if (replicated) {
+      storage_->WaitForSyncReplicas(replicated.get());
+    }
+    storage_->pending_commits_.MarkVisible(*commit_slot_);
   }
 
   //transactionid->commit_time
-  auto time_flag=config_.realTimeFlag;
-
-  if(!time_flag){
-    for (auto &delta : transaction_.deltas) {
-      auto commit_timestamp = transaction_.commit_timestamp->load(std::memory_order_acquire);
-      if(delta.transaction_st==0 ){
-        delta.transaction_st=commit_timestamp+1;
-      }
-      delta.commit_timestamp=commit_timestamp;
-      auto prev = delta.prev.Get();
-      switch (prev.type) {
-        case storage::PreviousPtr::Type::VERTEX: {
-          storage::Vertex *vertex = prev.vertex;
-          if(vertex->deleted){
-            storage_->hjm_deleted_vertices_.emplace_back(vertex->gid.AsUint());
-            storage_->hjm_deleted_vertices.emplace_back(vertex);
-            my_deleted_vertices.push_back(vertex->gid);
-            // vertex->tt_te=0; //wzy 0512
-          }else{
-            auto gid=vertex->gid;
-            if(transaction_.v_changed.count(gid)){
-              vertex->transaction_st=*commit_timestamp_;
-            }
-            if(transaction_.ve_changed.count(gid))vertex->ve_tt_ts=*commit_timestamp_;
-          }
-          break;
-        }
-        case storage::PreviousPtr::Type::EDGE: {
-          storage::Edge *edge = prev.edge;
-          edge->transaction_st=*commit_timestamp_;
-          if(edge->deleted)  my_deleted_edges.push_back(edge->gid);
-          break;
-        }
-        case storage::PreviousPtr::Type::DELTA: {
-          break;
-        }
-        case storage::PreviousPtr::Type::NULLPTR: {
-        }
-      }
+  // In the real-time mode the history is stamped with the hybrid clock
+  // timestamp taken together with the commit timestamp, otherwise with the
+  // logical commit timestamp itself.
+  for (auto &delta : transaction_.deltas) {
+    if (delta.transaction_st == 0) {
+      delta.transaction_st = config_.realTimeFlag ? history_timestamp : history_timestamp + 1;
     }
-    
-    
-  }else{//set realtime
-    auto now_time = std::chrono::system_clock::now();
-    auto real_commit_timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now_time.time_since_epoch()).count();
-    for (auto &delta : transaction_.deltas) {
-      if(delta.transaction_st==0 ){
-        delta.transaction_st=real_commit_timestamp;
-      }
-      delta.commit_timestamp=real_commit_timestamp;
-      auto prev = delta.prev.Get();
-      switch (prev.type) {
-        case storage::PreviousPtr::Type::VERTEX: {
-          storage::Vertex *vertex = prev.vertex;
-          if(vertex->deleted){
-            storage_->hjm_deleted_vertices_.emplace_back(vertex->gid.AsUint());
-            storage_->hjm_deleted_vertices.emplace_back(vertex);
-            my_deleted_vertices.push_back(vertex->gid);
-          }else{
-            auto gid=vertex->gid;
-            if(transaction_.v_changed.count(gid)){
-              vertex->transaction_st=real_commit_timestamp;
-            }
-            if(transaction_.ve_changed.count(gid))vertex->ve_tt_ts=real_commit_timestamp;
-          }
-          break;
-        }
-        case storage::PreviousPtr::Type::EDGE: {
-          storage::Edge *edge = prev.edge;
-          edge->transaction_st=real_commit_timestamp;
-          if(edge->deleted)  my_deleted_edges.push_back(edge->gid);
-          break;
-        }
-        case storage::PreviousPtr::Type::DELTA: {
-          break;
-        }
-        case storage::PreviousPtr::Type::NULLPTR: {
+    delta.commit_timestamp = history_timestamp;
+    auto prev = delta.prev.Get();
+    switch (prev.type) {
+      case storage::PreviousPtr::Type::VERTEX: {
+        storage::Vertex *vertex = prev.vertex;
+        if (vertex->deleted) {
+          storage_->hjm_deleted_vertices_.emplace_back(vertex->gid.AsUint());
+          storage_->hjm_deleted_vertices.emplace_back(vertex);
+          my_deleted_vertices.push_back(vertex->gid);
+        } else {
+          auto gid = vertex->gid;
+          if (transaction_.v_changed.count(gid)) vertex->transaction_st = history_timestamp;
+          if (transaction_.ve_changed.count(gid)) vertex->ve_tt_ts = history_timestamp;
         }
+        break;
+      }
+      case storage::PreviousPtr::Type::EDGE: {
+        storage::Edge *edge = prev.edge;
+        edge->transaction_st = history_timestamp;
+        if (edge->deleted) my_deleted_edges.push_back(edge->gid);
+        break;
       }
+      case storage::PreviousPtr::Type::DELTA:
+      case storage::PreviousPtr::Type::NULLPTR:
+        break;
     }
-
   }
 
   storage_->transaction_tables_.WithLock(
@@ -1932,11 +2133,17 @@ void Storage::Accessor::Abort() {
 
 void Storage::Accessor::FinalizeTransaction() {
   if (commit_timestamp_) {
+    // The transaction is handed over to the GC before its commit timestamp is
+    // marked as finished, the GC relies on that when it advances the history
+    // migration timestamp.
+    storage_->committed_transactions_.Emplace(std::move(transaction_));
     storage_->commit_log_->MarkFinished(*commit_timestamp_);
-    storage_->committed_transactions_.WithLock(
-        [&](auto &committed_transactions) { committed_transactions.emplace_back(std::move(transaction_)); });
     commit_timestamp_.reset();
   }
+  if (commit_slot_) {
+    storage_->pending_commits_.Release(*commit_slot_);
+    commit_slot_.reset();
+  }
 }
 
 const std::string &Storage::LabelToName(LabelId label) const { return name_id_mapper_.IdToName(label.AsUint()); }
@@ -2116,6 +2323,9 @@ Transaction Storage::CreateTransaction(IsolationLevel isolation_level) {
       start_timestamp = timestamp_++;
     }
   }
+  // The commits with a smaller timestamp are part of the snapshot, wait
+  // until all of them may be seen (see `Accessor::Commit`).
+  pending_commits_.WaitUntilVisible(start_timestamp);
   return {transaction_id, start_timestamp, isolation_level};
 }
 
@@ -2159,7 +2369,7 @@ void Storage::CollectGarbage() {
   // We don't move undo buffers of unlinked transactions to garbage_undo_buffers
   // list immediately, because we would have to repeatedly take
   // garbage_undo_buffers lock.
-  std::list<std::pair<uint64_t, std::list<Delta>>> unlinked_undo_buffers;
+  std::list<std::pair<uint64_t, DeltaBuffer>> unlinked_undo_buffers;
 
   // We will only free vertices deleted up until now in this GC cycle, and we
   // will do it after cleaning-up the indices. That way we are sure that all
@@ -2174,7 +2384,18 @@ void Storage::CollectGarbage() {
   // should be run when there were any items that were cleaned up (there were
   // updates between this run of the GC and the previous run of the GC). This
   // eliminates high CPU usage when the GC doesn't have to clean up anything.
-  bool run_index_cleanup = !committed_transactions_->empty() || !garbage_undo_buffers_->empty();
+  // Every transaction with a commit timestamp below `handed_over_timestamp` is
+  // taken over below. The ones above it may still be on their way to the GC.
+  uint64_t handed_over_timestamp = 0;
+  {
+    std::lock_guard<utils::SpinLock> guard(engine_lock_);
+    handed_over_timestamp = timestamp_;
+  }
+  handed_over_timestamp = pending_commits_.Oldest(handed_over_timestamp);
+  // Take over all transactions committed since the last run in one go, the
+  // committers never wait for the GC.
+  committed_transactions_.DrainTo(&gc_committed_transactions_);
+  bool run_index_cleanup = !gc_committed_transactions_.empty() || !garbage_undo_buffers_->empty();
 
   //hjm add begin;
   std::list<std::pair<Gid, LabelId>> saved_deltas;
@@ -2184,22 +2405,48 @@ void Storage::CollectGarbage() {
   std::ofstream ofs_vertex;
   ofs_edge.open("/home/hjm/history_info/history_edge.txt",std::ios::out|std::ios::app);
   ofs_vertex.open("/home/hjm/history_info/history_vertex.txt",std::ios::out|std::ios::app);
-  while (true) {
-    // We don't want to hold the lock on commited transactions for too long,
-    // because that prevents other transactions from committing.
-    Transaction *transaction;
-    {
-      auto committed_transactions_ptr = committed_transactions_.Lock();
-      if (committed_transactions_ptr->empty()) {
-        break;
+  // Copies the deltas and anchors of a committed transaction to the history
+  // store. Every transaction is migrated only once, either early (see
+  // `Config::Gc::history_chain_length_limit`) or right before its deltas are
+  // unlinked.
+  // A replica receives its history from the main instance (see
+  // `ReplicationClient::ReplicateHistory`), so it doesn't migrate its own
+  // deltas. The main instance collects the records for its replicas.
+  const bool is_replica = replication_role_.load() == ReplicationRole::REPLICA;
+  const bool replicate_history =
+      !is_replica && !replication_clients_.WithLock([](const auto &clients) { return clients.empty(); });
+  const auto previous_history_watermark = history_watermark_;
+  std::map<std::string, std::string> migrated_records;
+  // The records of the migrated transactions are collected and written in
+  // batches (see `flush_history`). The deltas of a transaction are marked as
+  // migrated, and unlinked, only after its batch is written.
+  std::map<std::string, std::string> staged_records;
+  std::vector<Transaction *> staged_transactions;
+  const uint64_t history_batch_size = config_.gc.history_ingest_batch_size > 0
+                                          ? config_.gc.history_ingest_batch_size
+                                          : kHistoryMigrationBatchSize;
+  auto flush_history = [&] {
+    saved_history_deltas_->SaveMigrationBatch(staged_records);
+    if (replicate_history) {
+      for (auto &[key, value] : staged_records) {
+        migrated_records.insert_or_assign(key, std::move(value));
       }
-      transaction = &committed_transactions_ptr->front();
     }
-    auto commit_timestamp = transaction->commit_timestamp->load(std::memory_order_acquire);
-    if (commit_timestamp >= oldest_active_start_timestamp) {
-      break;
+    staged_records.clear();
+    for (auto *transaction : staged_transactions) {
+      for (Delta &delta : transaction->deltas) {
+        delta.migrated.store(true, std::memory_order_release);
+      }
+      transaction->history_migrated = true;
+    }
+    staged_transactions.clear();
+  };
+  auto migrate_history = [&](Transaction *transaction) {
+    if (transaction->history_migrated) return;
+    if (is_replica) {
+      transaction->history_migrated = true;
+      return;
     }
-    std::list<std::pair<uint64_t, std::list<Delta>>> saved_buffers;
     std::list<std::tuple<Gid,uint64_t,uint64_t>> saved_gids;
 
     for (Delta &a : transaction->deltas){
@@ -2250,7 +2497,7 @@ void Storage::CollectGarbage() {
       auto prefix=saved_history_deltas_->getPrefix(gid,ts,true);
       gid_anchor_all_[prefix]=data.dump();
     }
-    
+  
     //hjm begin prinf edge
     for(auto key:transaction->prinfEdge_){
       uint64_t ts=key.tt_ts_;
@@ -2274,7 +2521,7 @@ void Storage::CollectGarbage() {
       auto write_string=gid+"####"+print_fgid+"####"+print_tgid+"####"+print_ts+"####"+label+"####"+props+"\n";
       ofs_edge<<write_string;
     }
-   
+ 
     for(auto key:transaction->prinfVertex_){
       auto gid=key.gid_;
       uint64_t ts=key.tt_ts_;
@@ -2297,13 +2544,29 @@ void Storage::CollectGarbage() {
       auto write_string=std::to_string(gid)+"####"+std::to_string(ts)+"####"+labels+"####"+props+"\n";
       ofs_vertex<<write_string;
     }
-    
+  
     //hjm end
     // saved_history_deltas_->GetAll();
-    saved_history_deltas_->SaveDeltaAll();
-    saved_history_deltas_->SaveAnchorAll(gid_anchor_all_);
+    saved_history_deltas_->StageMigration(gid_anchor_all_, &staged_records);
+    staged_transactions.push_back(transaction);
+    if (staged_records.size() >= history_batch_size) flush_history();
+  };
 
-    // saved_history_deltas_->SaveTimeTableAll();
+  // The history of the transactions has to be stored before their deltas are
+  // unlinked.
+  for (auto &transaction : gc_committed_transactions_) {
+    if (transaction.commit_timestamp->load(std::memory_order_acquire) >= oldest_active_start_timestamp) break;
+    migrate_history(&transaction);
+  }
+  flush_history();
+
+  while (!gc_committed_transactions_.empty()) {
+    // `gc_committed_transactions_` is protected by `gc_lock_`.
+    Transaction *transaction = &gc_committed_transactions_.front();
+    auto commit_timestamp = transaction->commit_timestamp->load(std::memory_order_acquire);
+    if (commit_timestamp >= oldest_active_start_timestamp) {
+      break;
+    }
     std::list<Gid> current_deleted_edges1;
     std::list<Gid> current_deleted_vertices1;
     recover_deleted_vertices_->swap(current_deleted_vertices1);
@@ -2430,12 +2693,68 @@ void Storage::CollectGarbage() {
       }
     }
 
-    committed_transactions_.WithLock([&](auto &committed_transactions) {
-      unlinked_undo_buffers.emplace_back(0, std::move(transaction->deltas));
-      committed_transactions.pop_front();
-    });
+    unlinked_undo_buffers.emplace_back(0, std::move(transaction->deltas));
+    gc_committed_transactions_.pop_front();
   }
   
+  // Transactions that are still needed by an active transaction keep their
+  // deltas in the version chains. If the chains get too long, copy the oldest
+  // committed versions to the history store now, so that temporal reads can
+  // stop walking the chain at them. The readers stop at the first migrated
+  // delta, so every older version has to be in the history store as well:
+  // together with the newest transaction that has a deep delta, all unmigrated
+  // transactions with a smaller commit timestamp are migrated. The queue isn't
+  // sorted by the commit timestamp (transactions are pushed after the engine
+  // lock is released) and may miss transactions that are still being handed
+  // over, so only the ones below `handed_over_timestamp` are considered. The
+  // deltas themselves are still unlinked and freed only when no active
+  // transaction can see them.
+  if (const auto limit = config_.gc.history_chain_length_limit; limit > 0) {
+    std::vector<Transaction *> candidates;
+    for (auto &transaction : gc_committed_transactions_) {
+      if (transaction.history_migrated) continue;
+      if (transaction.commit_timestamp->load(std::memory_order_acquire) >= handed_over_timestamp) continue;
+      candidates.push_back(&transaction);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Transaction *lhs, const Transaction *rhs) {
+      return lhs->commit_timestamp->load(std::memory_order_acquire) <
+             rhs->commit_timestamp->load(std::memory_order_acquire);
+    });
+    auto newest_deep = std::find_if(candidates.rbegin(), candidates.rend(),
+                                    [limit](const Transaction *transaction) { return HasDeepDelta(*transaction, limit); });
+    for (auto it = candidates.begin(); it != newest_deep.base(); ++it) {
+      migrate_history(*it);
+    }
+    flush_history();
+  }
+
+  // Advance the migration timestamp: all transactions committed before the
+  // oldest active timestamp were handed over to the GC (see
+  // `FinalizeTransaction`), so only the ones that are still waiting in
+  // `gc_committed_transactions_` can be missing from the history store.
+  if (!is_replica && oldest_active_start_timestamp > 0) {
+    auto history_watermark = oldest_active_start_timestamp - 1;
+    for (const auto &transaction : gc_committed_transactions_) {
+      if (transaction.history_migrated) continue;
+      history_watermark =
+          std::min(history_watermark, transaction.commit_timestamp->load(std::memory_order_acquire) - 1);
+    }
+    if (history_watermark > history_watermark_) {
+      saved_history_deltas_->SaveMigratedTimestamp(history_watermark);
+      history_watermark_ = history_watermark;
+    }
+  }
+
+  if (replicate_history && (!migrated_records.empty() || history_watermark_ != previous_history_watermark)) {
+    auto batch = std::make_shared<const history_delta::MigrationBatch>(history_delta::MigrationBatch{
+        previous_history_watermark, history_watermark_, std::move(migrated_records)});
+    replication_clients_.WithLock([&](auto &clients) {
+      for (auto &client : clients) {
+        client->ReplicateHistory(batch);
+      }
+    });
+  }
+
   // saved_history_deltas_->GetAll();
   //hjm begin
   ofs_edge.close();
@@ -2536,14 +2855,19 @@ bool Storage::InitializeWalFile() {
     return false;
   if (!wal_file_) {
     wal_file_.emplace(wal_directory_, uuid_, epoch_id_, config_.items, &name_id_mapper_, wal_seq_num_++,
-                      &file_retainer_);
+                      &file_retainer_, config_.durability.wal_block_size_kibibytes * 1024,
+                      config_.durability.wal_compression ? durability::WalBlockCompression::ZLIB
+                                                         : durability::WalBlockCompression::NONE);
   }
   return true;
 }
 
 void Storage::FinalizeWalFile() {
   ++wal_unsynced_transactions_;
-  if (wal_unsynced_transactions_ >= config_.durability.wal_file_flush_every_n_tx) {
+  // With group commit the committers sync the WAL themselves, see
+  // `WaitForWalSync`.
+  if (!config_.durability.wal_group_commit &&
+      wal_unsynced_transactions_ >= config_.durability.wal_file_flush_every_n_tx) {
     wal_file_->Sync();
     wal_unsynced_transactions_ = 0;
   }
@@ -2560,22 +2884,17 @@ void Storage::FinalizeWalFile() {
   }
 }
 
-void Storage::AppendToWal(const Transaction &transaction, uint64_t final_commit_timestamp) {
-  if (!InitializeWalFile()) return;
-  // Traverse deltas and append them to the WAL file.
-  // A single transaction will always be contained in a single WAL file.
+namespace {
+// Calls `func(delta, parent)` for every delta of the (not yet committed)
+// transaction that has to be written to the WAL, in the order in which the
+// deltas have to be written.
+template <typename TFunc>
+void ForEachWalDelta(const Transaction &transaction, TFunc &&func) {
   auto current_commit_timestamp = transaction.commit_timestamp->load(std::memory_order_acquire);
 
-  if (replication_role_.load() == ReplicationRole::MAIN) {
-    replication_clients_.WithLock([&](auto &clients) {
-      for (auto &client : clients) {
-        client->StartTransactionReplication(wal_file_->SequenceNumber());
-      }
-    });
-  }
-
   // Helper lambda that traverses the delta chain on order to find the first
-  // delta that should be processed and then appends all discovered deltas.
+  // delta that should be processed and then applies `func` to all discovered
+  // deltas.
   auto find_and_apply_deltas = [&](const auto *delta, const auto &parent, auto filter) {
     while (true) {
       auto older = delta->next.load(std::memory_order_acquire);
@@ -2584,13 +2903,7 @@ void Storage::AppendToWal(const Transaction &transaction, uint64_t final_commit_
     }
     while (true) {
       if (filter(delta->action)) {
-        wal_file_->AppendDelta(*delta, parent, final_commit_timestamp);
-        replication_clients_.WithLock([&](auto &clients) {
-          for (auto &client : clients) {
-            client->IfStreamingTransaction(
-                [&](auto &stream) { stream.AppendDelta(*delta, parent, final_commit_timestamp); });
-          }
-        });
+        func(*delta, parent);
       }
       auto prev = delta->prev.Get();
       MG_ASSERT(prev.type != PreviousPtr::Type::NULLPTR, "Invalid pointer!");
@@ -2723,38 +3036,139 @@ void Storage::AppendToWal(const Transaction &transaction, uint64_t final_commit_
       }
     });
   }
+}
+}  // namespace
+
+std::optional<durability::WalTransactionBuffer> Storage::EncodeForWal(const Transaction &transaction) {
+  if (config_.durability.snapshot_wal_mode != Config::Durability::SnapshotWalMode::PERIODIC_SNAPSHOT_WITH_WAL)
+    return std::nullopt;
+  durability::WalTransactionBuffer buffer;
+  ForEachWalDelta(transaction, [&](const Delta &delta, const auto &parent) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(parent)>, Vertex>) {
+      buffer.AppendDelta(&name_id_mapper_, config_.items, delta, parent);
+    } else {
+      buffer.AppendDelta(&name_id_mapper_, delta, parent);
+    }
+  });
+  return buffer;
+}
+
+uint64_t Storage::AppendToWal(durability::WalTransactionBuffer *buffer, uint64_t final_commit_timestamp,
+                              std::shared_ptr<ReplicatedTransaction> *replicated) {
+  if (!InitializeWalFile()) return 0;
+  // A single transaction will always be contained in a single WAL file.
+  buffer->SetTimestamp(final_commit_timestamp);
+  wal_file_->AppendDeltas(*buffer, final_commit_timestamp);
 
   // Add a delta that indicates that the transaction is fully written to the WAL
   // file.
   wal_file_->AppendTransactionEnd(final_commit_timestamp);
 
+  // The replicas receive the same encoded records, the buffer isn't used
+  // afterwards.
+  *replicated = QueueForReplication(
+      buffer, [&](auto *encoder) { durability::EncodeTransactionEnd(encoder, final_commit_timestamp); },
+      final_commit_timestamp);
+
   FinalizeWalFile();
 
-  replication_clients_.WithLock([&](auto &clients) {
+  const auto sequence = ++wal_appended_transactions_;
+  if (config_.durability.wal_group_commit) wal_group_cv_.notify_one();
+  return sequence;
+}
+
+std::shared_ptr<Storage::ReplicatedTransaction> Storage::QueueForReplication(
+    durability::WalTransactionBuffer *deltas, const std::function<void(durability::BaseEncoder *)> &encode_end,
+    uint64_t final_commit_timestamp) {
+  if (replication_role_.load() != ReplicationRole::MAIN) return nullptr;
+  return replication_clients_.WithLock([&](auto &clients) -> std::shared_ptr<ReplicatedTransaction> {
+    if (clients.empty()) return nullptr;
+    auto transaction = std::make_shared<ReplicatedTransaction>();
+    transaction->previous_commit_timestamp = last_commit_timestamp_.load();
+    transaction->wal_seq_num = wal_file_->SequenceNumber();
+    transaction->epoch_id = epoch_id_;
+    if (deltas) transaction->deltas.emplace(std::move(*deltas));
+    encode_end(&transaction->end);
     for (auto &client : clients) {
-      client->IfStreamingTransaction([&](auto &stream) { stream.AppendTransactionEnd(final_commit_timestamp); });
-      client->FinalizeTransactionReplication();
+      client->ReplicateTransaction(transaction);
     }
+    return transaction;
   });
 }
 
+void Storage::WaitForSyncReplicas(ReplicatedTransaction *transaction) {
+  std::unique_lock guard(transaction->sync_lock);
+  while (transaction->pending_sync_replicas > 0) {
+    if (!transaction->sync_timeout) {
+      transaction->sync_cv.wait(guard);
+      continue;
+    }
+    const auto timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(*transaction->sync_timeout));
+    if (transaction->sync_cv.wait_for(guard, timeout) == std::cv_status::no_timeout) continue;
+    // The replicas that didn't confirm the transaction in time fall back to
+    // ASYNC and release the transaction.
+    guard.unlock();
+    replication_clients_.WithLock([](auto &clients) {
+      for (auto &client : clients) {
+        client->CheckSyncTimeout();
+      }
+    });
+    guard.lock();
+  }
+}
+
+void Storage::WaitForWalSync(uint64_t sequence) {
+  std::unique_lock guard(wal_sync_lock_);
+  while (wal_synced_transactions_ < sequence) {
+    if (wal_sync_in_progress_) {
+      wal_synced_cv_.wait(guard);
+      continue;
+    }
+    // Become the leader of the next group. Give the other committers a chance
+    // to join the group, but don't wait longer than the configured delay.
+    wal_sync_in_progress_ = true;
+    wal_group_cv_.wait_for(guard, config_.durability.wal_group_commit_max_delay, [&] {
+      return wal_appended_transactions_.load(std::memory_order_acquire) - wal_synced_transactions_ >=
+             config_.durability.wal_group_commit_max_batch;
+    });
+    guard.unlock();
+
+    // Only flushing the buffer and duplicating the descriptor are done under
+    // the engine lock, the sync itself doesn't block the committers. The
+    // finalized WAL files are already synced.
+    uint64_t target = 0;
+    int fd = -1;
+    std::filesystem::path path;
+    {
+      std::lock_guard<utils::SpinLock> engine_guard(engine_lock_);
+      target = wal_appended_transactions_.load(std::memory_order_acquire);
+      if (wal_file_) {
+        fd = wal_file_->DuplicateDescriptor();
+        path = wal_file_->Path();
+      }
+    }
+    if (fd != -1) utils::SyncAndCloseDescriptor(fd, path);
+
+    guard.lock();
+    wal_synced_transactions_ = std::max(wal_synced_transactions_, target);
+    wal_sync_in_progress_ = false;
+    wal_synced_cv_.notify_all();
+  }
+}
+
 void Storage::AppendToWal(durability::StorageGlobalOperation operation, LabelId label,
                           const std::set<PropertyId> &properties, uint64_t final_commit_timestamp) {
   if (!InitializeWalFile()) return;
   wal_file_->AppendOperation(operation, label, properties, final_commit_timestamp);
-  {
-    if (replication_role_.load() == ReplicationRole::MAIN) {
-      replication_clients_.WithLock([&](auto &clients) {
-        for (auto &client : clients) {
-          client->StartTransactionReplication(wal_file_->SequenceNumber());
-          client->IfStreamingTransaction(
-              [&](auto &stream) { stream.AppendOperation(operation, label, properties, final_commit_timestamp); });
-          client->FinalizeTransactionReplication();
-        }
-      });
-    }
-  }
+  auto replicated = QueueForReplication(
+      nullptr,
+      [&](auto *encoder) {
+        durability::EncodeOperation(encoder, &name_id_mapper_, operation, label, properties, final_commit_timestamp);
+      },
+      final_commit_timestamp);
   FinalizeWalFile();
+  if (replicated) WaitForSyncReplicas(replicated.get());
 }
 
 utils::BasicResult<Storage::CreateSnapshotError> Storage::CreateSnapshot() {
@@ -2767,20 +3181,102 @@ utils::BasicResult<Storage::CreateSnapshotError> Storage::CreateSnapshot() {
   // Take master RW lock (for reading).
   std::shared_lock<utils::RWLock> storage_guard(main_lock_);
 
+  // Take the objects changed since the previous snapshot. The transaction is
+  // started afterwards so that all of them are visible to it.
+  std::vector<std::vector<Gid>> changed_vertices;
+  std::vector<std::vector<Gid>> changed_edges;
+  bool changes_complete = false;
+  {
+    std::lock_guard<utils::SpinLock> engine_guard(engine_lock_);
+    changed_vertices.swap(snapshot_changed_vertices_);
+    changed_edges.swap(snapshot_changed_edges_);
+    changes_complete = snapshot_changes_complete_;
+    snapshot_changes_count_ = 0;
+    snapshot_changes_complete_ = IncrementalSnapshotsEnabled();
+  }
+
   // Create the transaction used to create the snapshot.
   auto transaction = CreateTransaction(IsolationLevel::SNAPSHOT_ISOLATION);
 
+  // Every `snapshot_incremental_chain_length` incremental snapshots the chain
+  // is compacted into a new full snapshot.
+  std::optional<durability::SnapshotChanges> changes;
+  if (changes_complete && snapshot_chain_base_ &&
+      snapshot_chain_length_ < config_.durability.snapshot_incremental_chain_length) {
+    changes.emplace(durability::SnapshotChanges{*snapshot_chain_base_, snapshot_chain_previous_,
+                                                MergeChangedGids(changed_vertices), MergeChangedGids(changed_edges)});
+  }
+  // The chain is restarted if the snapshot isn't created.
+  auto chain_base = std::exchange(snapshot_chain_base_, std::nullopt);
+
   // Create snapshot.
   durability::CreateSnapshot(&transaction, snapshot_directory_, wal_directory_,
                              config_.durability.snapshot_retention_count, &vertices_, &edges_, &name_id_mapper_,
-                             &indices_, &constraints_, config_.items, uuid_, epoch_id_, epoch_history_,
-                             &file_retainer_);
+                             &indices_, &constraints_, config_, uuid_, epoch_id_, epoch_history_, &file_retainer_,
+                             changes ? &*changes : nullptr);
+  CreateHistoryCheckpoint(transaction.start_timestamp);
+  if (changes) {
+    snapshot_chain_base_ = chain_base;
+    ++snapshot_chain_length_;
+  } else {
+    snapshot_chain_base_ = transaction.start_timestamp;
+    snapshot_chain_length_ = 0;
+  }
+  snapshot_chain_previous_ = transaction.start_timestamp;
 
   // Finalize snapshot transaction.
   commit_log_->MarkFinished(transaction.start_timestamp);
   return {};
 }
 
+bool Storage::IncrementalSnapshotsEnabled() const {
+  return config_.durability.snapshot_incremental_chain_length > 0 &&
+         config_.durability.snapshot_wal_mode != Config::Durability::SnapshotWalMode::DISABLED;
+}
+
+void Storage::RecordSnapshotChanges(std::vector<Gid> vertices, std::vector<Gid> edges) {
+  if (!snapshot_changes_complete_) return;
+  // An incremental snapshot of more than half of the objects isn't worth it,
+  // the recording stops and the next snapshot is full. The recorded changes
+  // are released by the snapshot, outside of the engine lock.
+  snapshot_changes_count_ += vertices.size() + edges.size();
+  if (snapshot_changes_count_ > (vertices_.size() + edges_.size()) / 2) {
+    snapshot_changes_complete_ = false;
+    return;
+  }
+  if (!vertices.empty()) snapshot_changed_vertices_.push_back(std::move(vertices));
+  if (!edges.empty()) snapshot_changed_edges_.push_back(std::move(edges));
+}
+
+void Storage::CreateHistoryCheckpoint(uint64_t snapshot_start_timestamp) {
+  const auto checkpoint_directory = config_.durability.storage_directory / durability::kHistoryCheckpointDirectory;
+  utils::EnsureDirOrDie(checkpoint_directory);
+  const auto path = checkpoint_directory / durability::MakeHistoryCheckpointName(snapshot_start_timestamp);
+  if (!saved_history_deltas_->CreateCheckpoint(path)) {
+    spdlog::warn("Couldn't create the history store checkpoint {}.", path);
+  }
+
+  // Keep only the checkpoints of the retained snapshots.
+  std::set<uint64_t> snapshot_timestamps;
+  for (const auto &snapshot : durability::GetSnapshotFiles(snapshot_directory_, uuid_)) {
+    snapshot_timestamps.insert(snapshot.start_timestamp);
+  }
+  std::error_code error_code;
+  for (const auto &item : std::filesystem::directory_iterator(checkpoint_directory, error_code)) {
+    auto timestamp = durability::ParseHistoryCheckpointName(item.path().filename());
+    if (!timestamp || snapshot_timestamps.contains(*timestamp)) continue;
+    std::error_code remove_error_code;
+    std::filesystem::remove_all(item.path(), remove_error_code);
+    if (remove_error_code) {
+      spdlog::warn("Couldn't remove the history store checkpoint {} because of: {}", item.path(),
+                   remove_error_code.message());
+    }
+  }
+  if (error_code) {
+    spdlog::warn("Couldn't clean up the history store checkpoints because of: {}", error_code.message());
+  }
+}
+
 bool Storage::LockPath() {
   auto locker_accessor = global_locker_.Access();
   return locker_accessor.AddPath(config_.durability.storage_directory);
@@ -2842,6 +3338,10 @@ bool Storage::SetMainReplicationRole() {
   // This should be always called first so we finalize everything
   replication_server_.reset(nullptr);
 
+  // The history received from the previous main instance could be ahead of
+  // the local clock.
+  if (config_.items.realTimeFlag) history_clock_.Observe(saved_history_deltas_->LatestTimestamp());
+
   {
     std::unique_lock engine_guard{engine_lock_};
     if (wal_file_) {
@@ -2855,6 +3355,10 @@ bool Storage::SetMainReplicationRole() {
     }
     epoch_history_.emplace_back(std::move(epoch_id_), last_commit_timestamp_);
     epoch_id_ = utils::GenerateUUID();
+
+    // The data was changed by the previous main instance, the next snapshot
+    // has to be full.
+    snapshot_changes_complete_ = false;
   }
 
   replication_role_.store(ReplicationRole::MAIN);
@@ -2921,7 +3425,9 @@ std::vector<Storage::ReplicaInfo> Storage::ReplicasInfo() {
     replica_info.reserve(clients.size());
     std::transform(clients.begin(), clients.end(), std::back_inserter(replica_info),
                    [](const auto &client) -> ReplicaInfo {
-                     return {client->Name(), client->Mode(), client->Timeout(), client->Endpoint(), client->State()};
+                     return {client->Name(),     client->Mode(),  client->Timeout(),
+                             client->Endpoint(), client->State(), client->PendingTransactions(),
+                             client->LagMillis()};
                    });
     return replica_info;
   });
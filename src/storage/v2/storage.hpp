@@ -12,7 +12,10 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <variant>
@@ -27,15 +30,19 @@
 #include "storage/v2/durability/wal.hpp"
 #include "storage/v2/edge.hpp"
 #include "storage/v2/edge_accessor.hpp"
+#include "storage/v2/hybrid_clock.hpp"
 #include "storage/v2/indices.hpp"
 #include "storage/v2/isolation_level.hpp"
 #include "storage/v2/mvcc.hpp"
 #include "storage/v2/name_id_mapper.hpp"
+#include "storage/v2/pending_commits.hpp"
 #include "storage/v2/result.hpp"
+#include "storage/v2/statistics.hpp"
 #include "storage/v2/transaction.hpp"
 #include "storage/v2/vertex.hpp"
 #include "storage/v2/vertex_accessor.hpp"
 #include "utils/file_locker.hpp"
+#include "utils/mpsc_queue.hpp"
 #include "utils/on_scope_exit.hpp"
 #include "utils/rw_lock.hpp"
 #include "utils/scheduler.hpp"
@@ -228,6 +235,15 @@ class Storage final {
     storage::HistoryVertex CreateHistoryVertexFromKV(const VertexAccessor &another,nlohmann::json gid_delta_,history_delta::historyContext &historyContext_);
     storage::HistoryEdge CreateHistoryEdgeFromKV(const EdgeAccessor &another,nlohmann::json gid_delta_);
     storage::HistoryEdge CreateHistoryEdgeFromKV(storage::HistoryEdge edge_,nlohmann::json gid_delta_);
+
+    /// Visits the committed versions of the property `property` of the vertex
+    /// `gid` that intersect [c_ts, c_te], from the newest to the oldest one: the
+    /// version in memory, the versions restored from its delta chain and then the
+    /// versions in the history store. The bounds are given the same way as in
+    /// the history queries and the visitor receives the version intervals
+    /// clipped to them. No copies of the vertex are made.
+    void VisitVertexPropertyVersions(Gid gid, PropertyId property, uint64_t c_ts, uint64_t c_te,
+                                     const history_delta::PropertyVersionVisitor &visitor);
     Result<std::vector<EdgeAccessor>> Edges(std::vector<std::tuple<EdgeTypeId, Vertex *, EdgeRef>> &edges_,const std::vector<EdgeTypeId> &edge_types,storage::Gid gid,bool from,std::optional<storage::Gid> existing_gid);
     Gid IdToGid(const uint64_t key);
     std::optional<VertexAccessor> FindDeleteVertex(Gid gid, View view);
@@ -342,6 +358,25 @@ class Storage final {
       return storage_->indices_.label_property_index.ApproximateVertexCount(label, property, lower, upper);
     }
 
+    /// Return approximate number of all edges in the database.
+    int64_t ApproximateEdgeCount() const { return storage_->edge_count_.load(std::memory_order_acquire); }
+
+    /// Statistics collected by `ANALYZE GRAPH`, std::nullopt if the label, the
+    /// edge type or the property wasn't analyzed.
+    std::optional<LabelStatistics> GetLabelStatistics(LabelId label) const {
+      return storage_->statistics_->GetLabelStatistics(LabelToName(label));
+    }
+
+    std::optional<EdgeTypeStatistics> GetEdgeTypeStatistics(EdgeTypeId edge_type) const {
+      return storage_->statistics_->GetEdgeTypeStatistics(EdgeTypeToName(edge_type));
+    }
+
+    std::optional<PropertyStatistics> GetPropertyStatistics(LabelId label, PropertyId property) const {
+      return storage_->statistics_->GetPropertyStatistics(LabelToName(label), PropertyToName(property));
+    }
+
+    StatisticsStore &Statistics() { return *storage_->statistics_; }
+
     /// @return Accessor to the deleted vertex if a deletion took place, std::nullopt otherwise
     /// @throw std::bad_alloc
     Result<std::optional<VertexAccessor>> DeleteVertex(VertexAccessor *vertex);
@@ -410,6 +445,8 @@ class Storage final {
     std::shared_lock<utils::RWLock> storage_guard_;
     Transaction transaction_;
     std::optional<uint64_t> commit_timestamp_;
+    // Slot of `pending_commits_` owned by the committing transaction.
+    std::optional<size_t> commit_slot_;
     bool is_transaction_active_;
     Config::Items config_;
   };
@@ -484,6 +521,10 @@ class Storage final {
 
   StorageInfo GetInfo() const;
 
+  /// Returns true if the history is stamped with hybrid clock timestamps
+  /// (see `HybridClock`) instead of the logical commit timestamps.
+  bool UsesHybridClock() const { return config_.items.realTimeFlag; }
+
   bool LockPath();
   bool UnlockPath();
 
@@ -511,6 +552,10 @@ class Storage final {
     std::optional<double> timeout;
     io::network::Endpoint endpoint;
     replication::ReplicaState state;
+    // Transactions not yet confirmed by the replica.
+    uint64_t pending_transactions;
+    // Age of the oldest transaction not yet confirmed by the replica.
+    uint64_t lag_ms;
   };
 
   std::vector<ReplicaInfo> ReplicasInfo();
@@ -528,6 +573,17 @@ class Storage final {
   //use for aeong retention period clean
   bool ReclaimHistoryRentention(const std::chrono::milliseconds &retention_period);
 
+  /// Writes versions loaded by the bulk importer into the history store and
+  /// starts the current versions of the given objects at the given history
+  /// timestamps. The clock is moved past all of the imported timestamps so
+  /// that the following commits are stamped after them.
+  /// Must be called only while there are no active transactions.
+  /// @return false if the history couldn't be written
+  bool ImportHistory(std::vector<history_delta::ImportedVersion> vertex_versions,
+                     std::vector<history_delta::ImportedVersion> edge_versions,
+                     const std::vector<std::pair<Gid, uint64_t>> &vertex_starts,
+                     const std::vector<std::pair<Gid, uint64_t>> &edge_starts);
+
  private:
   Transaction CreateTransaction(IsolationLevel isolation_level);
 
@@ -548,12 +604,49 @@ class Storage final {
   bool InitializeWalFile();
   void FinalizeWalFile();
 
-  void AppendToWal(const Transaction &transaction, uint64_t final_commit_timestamp);
+  /// Encodes the WAL records of the transaction, doesn't need the engine lock.
+  /// Returns std::nullopt if the WAL is disabled.
+  std::optional<durability::WalTransactionBuffer> EncodeForWal(const Transaction &transaction);
+  struct ReplicatedTransaction;
+  /// Appends the encoded transaction to the WAL and queues it for the
+  /// replicas. Must be called while holding the engine lock. Returns the group
+  /// commit sequence number of the transaction, see `WaitForWalSync`. If the
+  /// transaction was queued for any replica, `replicated` is set to it, see
+  /// `WaitForSyncReplicas`.
+  uint64_t AppendToWal(durability::WalTransactionBuffer *buffer, uint64_t final_commit_timestamp,
+                       std::shared_ptr<ReplicatedTransaction> *replicated);
+  /// Blocks until all SYNC replicas confirmed the transaction, failed or fell
+  /// back to ASYNC because of their timeout. Must be called without holding
+  /// the engine lock, the replication clients take it (e.g. in
+  /// `InitializeClient` and while recovering the replica).
+  void WaitForSyncReplicas(ReplicatedTransaction *transaction);
+  /// Blocks until the WAL records of the transaction with the given group
+  /// commit sequence number are synced. Must be called without holding the
+  /// engine lock.
+  void WaitForWalSync(uint64_t sequence);
   void AppendToWal(durability::StorageGlobalOperation operation, LabelId label, const std::set<PropertyId> &properties,
                    uint64_t final_commit_timestamp);
+  /// Queues the WAL records for all replicas, `encode_end` encodes the
+  /// transaction end or the global operation. The deltas are moved out of the
+  /// buffer. Returns nullptr if there are no replicas.
+  std::shared_ptr<ReplicatedTransaction> QueueForReplication(
+      durability::WalTransactionBuffer *deltas, const std::function<void(durability::BaseEncoder *)> &encode_end,
+      uint64_t final_commit_timestamp);
 
   uint64_t CommitTimestamp(std::optional<uint64_t> desired_commit_timestamp = {});
 
+  /// Creates a checkpoint of the history store that belongs to the snapshot
+  /// with the given start timestamp and removes the checkpoints of the
+  /// snapshots that no longer exist.
+  void CreateHistoryCheckpoint(uint64_t snapshot_start_timestamp);
+
+  /// Whether the committed transactions record the objects they changed for
+  /// the incremental snapshots.
+  bool IncrementalSnapshotsEnabled() const;
+  /// Records the objects changed by a committed transaction for the next
+  /// incremental snapshot. Must be called while holding the engine lock.
+  void RecordSnapshotChanges(std::vector<Gid> vertices, std::vector<Gid> edges);
+
   // Main storage lock.
   //
   // Accessors take a shared lock when starting, so it is possible to block
@@ -588,13 +681,26 @@ class Storage final {
   utils::SpinLock engine_lock_;
   uint64_t timestamp_{kTimestampInitialId};
   uint64_t transaction_id_{kTransactionInitialId};
+  // Source of the history timestamps in the real-time mode. MVCC keeps using
+  // the dense logical `timestamp_` because the commit log is indexed by it.
+  HybridClock history_clock_;
   // TODO: This isn't really a commit log, it doesn't even care if a
   // transaction commited or aborted. We could probably combine this with
   // `timestamp_` in a sensible unit, something like TransactionClock or
   // whatever.
   std::optional<CommitLog> commit_log_;
 
-  utils::Synchronized<std::list<Transaction>, utils::SpinLock> committed_transactions_;
+  // Committed transactions waiting for the GC. Committers push without
+  // taking any lock, the GC moves them to `gc_committed_transactions_` in
+  // batches.
+  utils::MpscQueue<Transaction> committed_transactions_;
+  // Committed transactions owned by the GC, only accessed while holding
+  // `gc_lock_`.
+  std::list<Transaction> gc_committed_transactions_;
+  // Commit timestamps of the transactions that committed but weren't pushed
+  // to `committed_transactions_` yet, and the gate which keeps the new
+  // transactions waiting until the commits before them are visible.
+  PendingCommits pending_commits_;
   IsolationLevel isolation_level_;
 
   Config config_;
@@ -603,6 +709,11 @@ class Storage final {
 
   //aeong historical store
   std::optional<history_delta::History_delta> saved_history_deltas_;//{"history_delta"};
+  // Planner statistics collected by `ANALYZE GRAPH`.
+  std::optional<StatisticsStore> statistics_;
+  // All transactions committed up to this (MVCC) timestamp are in the history
+  // store. Persisted in the history store, protected by `gc_lock_`.
+  uint64_t history_watermark_{0};
   utils::Synchronized<std::map<uint64_t,uint64_t>, utils::SpinLock> transaction_tables_;//store transactionid commit_timestamp
   std::vector<uint64_t> hjm_deleted_vertices_;
   std::list<storage::Vertex*>  hjm_deleted_vertices;
@@ -610,7 +721,7 @@ class Storage final {
   utils::Synchronized<std::list<Gid>, utils::SpinLock> recover_deleted_edges_;
 
   // Undo buffers that were unlinked and now are waiting to be freed.
-  utils::Synchronized<std::list<std::pair<uint64_t, std::list<Delta>>>, utils::SpinLock> garbage_undo_buffers_;
+  utils::Synchronized<std::list<std::pair<uint64_t, DeltaBuffer>>, utils::SpinLock> garbage_undo_buffers_;
 
   // Vertices that are logically deleted but still have to be removed from
   // indices before removing them from the main storage.
@@ -634,6 +745,23 @@ class Storage final {
   utils::Scheduler snapshot_runner_;
   utils::SpinLock snapshot_lock_;
 
+  // Objects changed since the last snapshot, used to create the incremental
+  // snapshots. The commits record them while holding `engine_lock_` and the
+  // snapshot takes them before starting its transaction, so all of the taken
+  // changes are visible to it. If the changes aren't complete (before the
+  // first snapshot, after a role change or if there are too many of them),
+  // the next snapshot is full.
+  std::vector<std::vector<Gid>> snapshot_changed_vertices_;
+  std::vector<std::vector<Gid>> snapshot_changed_edges_;
+  uint64_t snapshot_changes_count_{0};
+  bool snapshot_changes_complete_{false};
+  // Start timestamps of the full snapshot the current chain of incremental
+  // snapshots is based on and of the last snapshot in the chain. Protected by
+  // `snapshot_lock_`.
+  std::optional<uint64_t> snapshot_chain_base_;
+  uint64_t snapshot_chain_previous_{0};
+  uint64_t snapshot_chain_length_{0};
+
   //aeong reclaim rocksdb runner
   utils::Scheduler reclaim_rocksdb_runner_;
 
@@ -665,6 +793,18 @@ class Storage final {
   std::optional<durability::WalFile> wal_file_;
   uint64_t wal_unsynced_transactions_{0};
 
+  // Group commit state, see `Config::Durability::wal_group_commit`.
+  // `wal_appended_transactions_` is written while holding the engine lock, the
+  // rest is protected by `wal_sync_lock_`.
+  std::atomic<uint64_t> wal_appended_transactions_{0};
+  std::mutex wal_sync_lock_;
+  uint64_t wal_synced_transactions_{0};
+  bool wal_sync_in_progress_{false};
+  // The leader waits on `wal_group_cv_` for the group to fill up, the other
+  // members of the group wait on `wal_synced_cv_`.
+  std::condition_variable wal_group_cv_;
+  std::condition_variable wal_synced_cv_;
+
   utils::FileRetainer file_retainer_;
 
   // Global locker that is used for clients file locking
@@ -16,9 +16,13 @@
 #include <list>
 #include <memory>
 #include <set>
+#include "utils/memory.hpp"
+#include "utils/pmr/map.hpp"
+#include "utils/pmr/unordered_set.hpp"
 #include "utils/skip_list.hpp"
 
 #include "storage/v2/delta.hpp"
+#include "storage/v2/delta_buffer.hpp"
 #include "storage/v2/edge.hpp"
 #include "storage/v2/isolation_level.hpp"
 #include "storage/v2/property_value.hpp"
@@ -67,14 +71,25 @@ struct prinfVertex{
 };
 
 struct Transaction {
+  // Initial size of the arena used for the bookkeeping structures of the
+  // transaction (changed gids and anchors). The arena doesn't allocate until
+  // the transaction writes something.
+  static constexpr size_t kSideMemoryInitialSize = 1024;
+
   Transaction(uint64_t transaction_id, uint64_t start_timestamp, IsolationLevel isolation_level)
       : transaction_id(transaction_id),
         start_timestamp(start_timestamp),
         command_id(0),
         must_abort(false),
-        isolation_level(isolation_level) {
-        }
-
+        isolation_level(isolation_level),
+        side_memory(std::make_unique<utils::MonotonicBufferResource>(kSideMemoryInitialSize)),
+        v_changed(side_memory.get()),
+        ve_changed(side_memory.get()),
+        gid_anchor_vertex_(side_memory.get()),
+        gid_anchor_edge_(side_memory.get()) {}
+
+  // The arena is owned through a `unique_ptr` so that its address (which is
+  // stored in the allocators of the containers below) survives the move.
   Transaction(Transaction &&other) noexcept
       : transaction_id(other.transaction_id),
         start_timestamp(other.start_timestamp),
@@ -82,14 +97,15 @@ struct Transaction {
         command_id(other.command_id),
         deltas(std::move(other.deltas)),
         must_abort(other.must_abort),
-        isolation_level(other.isolation_level) {
-          gid_anchor_edge_=other.gid_anchor_edge_;
-          gid_anchor_vertex_=other.gid_anchor_vertex_;
-          prinfEdge_=other.prinfEdge_;
-          prinfVertex_=other.prinfVertex_;
-          v_changed=other.v_changed;
-          ve_changed=other.ve_changed;
-        }
+        isolation_level(other.isolation_level),
+        history_migrated(other.history_migrated),
+        side_memory(std::move(other.side_memory)),
+        v_changed(std::move(other.v_changed)),
+        ve_changed(std::move(other.ve_changed)),
+        gid_anchor_vertex_(std::move(other.gid_anchor_vertex_)),
+        gid_anchor_edge_(std::move(other.gid_anchor_edge_)),
+        prinfEdge_(std::move(other.prinfEdge_)),
+        prinfVertex_(std::move(other.prinfVertex_)) {}
 
   Transaction(const Transaction &) = delete;
   Transaction &operator=(const Transaction &) = delete;
@@ -111,15 +127,20 @@ struct Transaction {
   // `commited_transactions_` list for GC.
   std::unique_ptr<std::atomic<uint64_t>> commit_timestamp;
   uint64_t command_id;
-  std::list<Delta> deltas;
+  DeltaBuffer deltas;
   bool must_abort;
   IsolationLevel isolation_level;
-
-
-  std::set<Gid> v_changed;
-  std::set<Gid> ve_changed;
-  std::map<std::pair<Gid,uint64_t>, std::pair<std::map<PropertyId, PropertyValue>,std::vector<LabelId>>> gid_anchor_vertex_;
-  std::map<std::pair<Gid,uint64_t>, std::map<PropertyId, PropertyValue>> gid_anchor_edge_;
+  // Set by the GC once the deltas and anchors of the (committed) transaction
+  // have been copied to the history store.
+  bool history_migrated{false};
+
+  // Arena backing the per-transaction bookkeeping below. Everything allocated
+  // from it is released at once when the transaction is destroyed.
+  std::unique_ptr<utils::MonotonicBufferResource> side_memory;
+  utils::pmr::unordered_set<Gid> v_changed;
+  utils::pmr::unordered_set<Gid> ve_changed;
+  utils::pmr::map<std::pair<Gid,uint64_t>, std::pair<std::map<PropertyId, PropertyValue>,std::vector<LabelId>>> gid_anchor_vertex_;
+  utils::pmr::map<std::pair<Gid,uint64_t>, std::map<PropertyId, PropertyValue>> gid_anchor_edge_;
   std::vector<prinfEdge> prinfEdge_;
   std::vector<prinfVertex> prinfVertex_;
 
@@ -0,0 +1,77 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "utils/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+constexpr uint32_t kCastagnoliPolynomial = 0x82f63b78;
+
+constexpr std::array<uint32_t, 256> MakeCrc32cTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ kCastagnoliPolynomial : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr auto kCrc32cTable = MakeCrc32cTable();
+
+uint32_t Crc32cSoftware(const uint8_t *data, size_t size, uint32_t crc) {
+  for (size_t i = 0; i < size; ++i) {
+    crc = kCrc32cTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t Crc32cHardware(const uint8_t *data, size_t size, uint32_t crc) {
+  uint64_t crc64 = crc;
+  for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    crc64 = _mm_crc32_u64(crc64, value);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; ++data, --size) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+const bool kHasHardwareCrc32c = __builtin_cpu_supports("sse4.2");
+#endif
+
+}  // namespace
+
+uint32_t Crc32c(const void *data, size_t size, uint32_t crc) {
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+#if defined(__x86_64__)
+  if (kHasHardwareCrc32c) return ~Crc32cHardware(bytes, size, crc);
+#endif
+  return ~Crc32cSoftware(bytes, size, crc);
+}
+
+}  // namespace utils
@@ -0,0 +1,28 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+
+/// Computes the CRC-32C (Castagnoli) checksum of `size` bytes at `data`. The
+/// checksum of consecutive ranges can be computed by passing the result of the
+/// previous call as `crc`.
+///
+/// On x86-64 CPUs with SSE4.2 the `crc32` instruction is used, otherwise the
+/// checksum is computed with a lookup table. The CPU support is detected once at
+/// runtime, so the binary doesn't have to be compiled with `-msse4.2`.
+uint32_t Crc32c(const void *data, size_t size, uint32_t crc = 0);
+
+}  // namespace utils
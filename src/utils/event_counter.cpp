@@ -48,6 +48,7 @@
   M(DistinctOperator, "Number of times Distinct operator was used.")                                       \
   M(UnionOperator, "Number of times Union operator was used.")                                             \
   M(CartesianOperator, "Number of times Cartesian operator was used.")                                     \
+  M(HashJoinOperator, "Number of times HashJoin operator was used.")                                       \
   M(CallProcedureOperator, "Number of times CallProcedure operator was used.")                             \
                                                                                                            \
   M(FailedQuery, "Number of times executing a query failed.")                                              \
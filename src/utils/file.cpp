@@ -555,6 +555,43 @@ size_t OutputFile::GetSize() {
   return SeekFile(Position::RELATIVE_TO_END, 0) + buffer_position_.load();
 }
 
+int OutputFile::DuplicateDescriptor() {
+  FlushBuffer(true);
+  int fd = -1;
+  while (true) {
+    fd = dup(fd_);
+    if (fd == -1 && errno == EINTR) {
+      continue;
+    }
+    break;
+  }
+  MG_ASSERT(fd != -1, "While trying to duplicate the descriptor of {} an error occurred: {} ({})", path_,
+            strerror(errno), errno);
+  return fd;
+}
+
+void SyncAndCloseDescriptor(int fd, const std::filesystem::path &path) {
+  int ret = 0;
+  while (true) {
+    ret = fsync(fd);
+    if (ret == -1 && errno == EINTR) {
+      continue;
+    }
+    break;
+  }
+  // Same as in `OutputFile::Sync`, any error except EINTR is fatal.
+  MG_ASSERT(ret == 0, "While trying to sync {}, an error occurred: {} ({}).", path, strerror(errno), errno);
+  while (true) {
+    ret = close(fd);
+    if (ret == -1 && errno == EINTR) {
+      continue;
+    }
+    break;
+  }
+  MG_ASSERT(ret == 0, "While trying to close a descriptor of {}, an error occurred: {} ({}).", path, strerror(errno),
+            errno);
+}
+
 void OutputFile::TryFlushing() {
   if (std::unique_lock guard(flush_lock_, std::try_to_lock); guard.owns_lock()) {
     FlushBufferInternal();
@@ -253,6 +253,13 @@ class OutputFile {
   /// Get the size of the file.
   size_t GetSize();
 
+  /// Flushes the internal buffer and returns a duplicate of the file
+  /// descriptor. The returned descriptor is owned by the caller and can be
+  /// used with `SyncDescriptor` to sync everything written so far without
+  /// touching this object, e.g. while another thread keeps writing to the
+  /// file. On failure and misuse it crashes the program.
+  int DuplicateDescriptor();
+
  private:
   void FlushBuffer(bool force_flush);
   void FlushBufferInternal();
@@ -269,4 +276,9 @@ class OutputFile {
   utils::RWLock flush_lock_{RWLock::Priority::WRITE};
 };
 
+/// Syncs the file behind the descriptor `fd` (see
+/// `OutputFile::DuplicateDescriptor`) and closes the descriptor. The `path` is
+/// used only for error reporting. On failure it crashes the program.
+void SyncAndCloseDescriptor(int fd, const std::filesystem::path &path);
+
 }  // namespace utils
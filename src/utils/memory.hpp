@@ -544,6 +544,8 @@ class LimitedMemoryResource final : public utils::MemoryResource {
 
   size_t GetAllocatedBytes() const noexcept { return max_allocated_bytes_ - available_bytes_; }
 
+  size_t GetMaxAllocatedBytes() const noexcept { return max_allocated_bytes_; }
+
  private:
   utils::MemoryResource *memory_;
   size_t max_allocated_bytes_;
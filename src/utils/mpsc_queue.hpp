@@ -0,0 +1,89 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace utils {
+
+/// Unbounded multi-producer queue that is drained in batches.
+///
+/// Producers push elements onto a lock-free stack with a single CAS. The
+/// consumer takes the whole stack with one atomic exchange and receives the
+/// elements in the order in which they were pushed. Because elements are never
+/// popped one by one there is no ABA problem.
+///
+/// @tparam TObj type of the stored elements, must be move constructible
+template <typename TObj>
+class MpscQueue final {
+  struct Node {
+    template <typename... TArgs>
+    explicit Node(TArgs &&...args) : obj(std::forward<TArgs>(args)...) {}
+
+    TObj obj;
+    Node *next{nullptr};
+  };
+
+ public:
+  MpscQueue() = default;
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue &operator=(const MpscQueue &) = delete;
+  MpscQueue(MpscQueue &&) = delete;
+  MpscQueue &operator=(MpscQueue &&) = delete;
+
+  ~MpscQueue() { Free(head_.exchange(nullptr, std::memory_order_acquire)); }
+
+  /// Constructs a new element at the back of the queue. Lock-free.
+  /// @throw std::bad_alloc
+  template <typename... TArgs>
+  void Emplace(TArgs &&...args) {
+    auto *node = new Node(std::forward<TArgs>(args)...);
+    node->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+  }
+
+  bool Empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+  /// Moves all elements pushed so far to the back of `container` (which must
+  /// support `emplace_back`), preserving their push order.
+  template <typename TContainer>
+  void DrainTo(TContainer *container) {
+    Node *reversed = nullptr;
+    for (auto *node = head_.exchange(nullptr, std::memory_order_acquire); node != nullptr;) {
+      auto *next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+    while (reversed != nullptr) {
+      auto *next = reversed->next;
+      container->emplace_back(std::move(reversed->obj));
+      delete reversed;
+      reversed = next;
+    }
+  }
+
+ private:
+  static void Free(Node *node) {
+    while (node != nullptr) {
+      auto *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node *> head_{nullptr};
+};
+
+}  // namespace utils
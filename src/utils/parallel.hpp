@@ -0,0 +1,60 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+/// Calls `func(task)` for every task in [0, task_count) on at most
+/// `thread_count` threads (the calling thread included). The tasks are handed
+/// out in increasing order. The first exception thrown by `func` is rethrown
+/// once all of the threads are finished, the tasks that weren't started by
+/// then are skipped.
+template <typename TFunc>
+void RunInParallel(uint64_t thread_count, uint64_t task_count, const TFunc &func) {
+  std::atomic<uint64_t> next_task{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_lock;
+  auto worker = [&] {
+    while (!failed.load(std::memory_order_acquire)) {
+      const auto task = next_task.fetch_add(1, std::memory_order_acq_rel);
+      if (task >= task_count) return;
+      try {
+        func(task);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_lock);
+        if (!error) error = std::current_exception();
+        failed.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint64_t i = 1; i < std::min(thread_count, task_count); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+}  // namespace utils
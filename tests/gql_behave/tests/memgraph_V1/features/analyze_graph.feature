@@ -0,0 +1,199 @@
+Feature: Analyze graph
+
+    # The statistics are kept between the scenarios, so the scenarios which
+    # depend on the existing statistics delete them first.
+
+    Scenario: Analyze all labels
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH ON LABELS *
+            """
+        Then the result should be:
+            | type        | name       | property | count | distinct_values | avg_out_degree | avg_in_degree | with_history |
+            | 'label'     | 'City'     | null     | 1     | null            | 0.0            | 2.0           | 0            |
+            | 'label'     | 'City'     | 'name'   | 1     | 1               | null           | null          | null         |
+            | 'label'     | 'Person'   | null     | 2     | null            | 2.0            | 1.0           | 0            |
+            | 'label'     | 'Person'   | 'name'   | 2     | 2               | null           | null          | null         |
+            | 'label'     | 'Person'   | 'age'    | 2     | 1               | null           | null          | null         |
+            | 'edge_type' | 'KNOWS'    | null     | 2     | null            | 1.0            | 1.0           | null         |
+            | 'edge_type' | 'LIVES_IN' | null     | 2     | null            | 1.0            | 2.0           | null         |
+
+    Scenario: Analyze the given labels
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH ON LABELS :Person
+            """
+        Then the result should be:
+            | type        | name       | property | count | distinct_values | avg_out_degree | avg_in_degree | with_history |
+            | 'label'     | 'Person'   | null     | 2     | null            | 2.0            | 1.0           | 0            |
+            | 'label'     | 'Person'   | 'name'   | 2     | 2               | null           | null          | null         |
+            | 'label'     | 'Person'   | 'age'    | 2     | 1               | null           | null          | null         |
+            | 'edge_type' | 'KNOWS'    | null     | 2     | null            | 1.0            | 1.0           | null         |
+            | 'edge_type' | 'LIVES_IN' | null     | 2     | null            | 1.0            | 2.0           | null         |
+
+    Scenario: Analyze a label without nodes
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH ON LABELS :Missing
+            """
+        Then the result should be:
+            | type        | name       | property | count | distinct_values | avg_out_degree | avg_in_degree | with_history |
+            | 'edge_type' | 'KNOWS'    | null     | 2     | null            | 1.0            | 1.0           | null         |
+            | 'edge_type' | 'LIVES_IN' | null     | 2     | null            | 1.0            | 2.0           | null         |
+
+    Scenario: Analyze the labels without statistics
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH
+            """
+        Then the result should be:
+            | type        | name       | property | count | distinct_values | avg_out_degree | avg_in_degree | with_history |
+            | 'label'     | 'City'     | null     | 1     | null            | 0.0            | 2.0           | 0            |
+            | 'label'     | 'City'     | 'name'   | 1     | 1               | null           | null          | null         |
+            | 'label'     | 'Person'   | null     | 2     | null            | 2.0            | 1.0           | 0            |
+            | 'label'     | 'Person'   | 'name'   | 2     | 2               | null           | null          | null         |
+            | 'label'     | 'Person'   | 'age'    | 2     | 1               | null           | null          | null         |
+            | 'edge_type' | 'KNOWS'    | null     | 2     | null            | 1.0            | 1.0           | null         |
+            | 'edge_type' | 'LIVES_IN' | null     | 2     | null            | 1.0            | 2.0           | null         |
+
+    Scenario: Analyze skips up to date statistics
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        And having executed
+            """
+            ANALYZE GRAPH
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH
+            """
+        Then the result should be empty
+
+    Scenario: Analyze refreshes statistics of the changed labels
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        And having executed
+            """
+            ANALYZE GRAPH
+            """
+        And having executed
+            """
+            CREATE (:Person {name: 'c'})
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH
+            """
+        Then the result should be:
+            | type    | name     | property | count | distinct_values | avg_out_degree     | avg_in_degree      | with_history |
+            | 'label' | 'Person' | null     | 3     | null            | 1.3333333333333333 | 0.6666666666666666 | 0            |
+            | 'label' | 'Person' | 'name'   | 3     | 3               | null               | null               | null         |
+            | 'label' | 'Person' | 'age'    | 2     | 1               | null               | null               | null         |
+
+    Scenario: Delete the statistics of the given labels
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH ON LABELS *
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH ON LABELS :Person, :City DELETE STATISTICS
+            """
+        Then the result should be:
+            | label    |
+            | 'Person' |
+            | 'City'   |
+
+    Scenario: Delete all statistics
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        And having executed
+            """
+            ANALYZE GRAPH ON LABELS *
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        Then the result should be:
+            | label    |
+            | 'City'   |
+            | 'Person' |
+
+    Scenario: Delete statistics which don't exist
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        And having executed
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH DELETE STATISTICS
+            """
+        Then the result should be empty
+
+    Scenario: Analyze without labels after ON LABELS
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a:Person {name: 'a', age: 30}), (b:Person {name: 'b', age: 30}), (d:City {name: 'x'}), (a)-[:LIVES_IN]->(d), (b)-[:LIVES_IN]->(d), (a)-[:KNOWS]->(b), (b)-[:KNOWS]->(a)
+            """
+        When executing query:
+            """
+            ANALYZE GRAPH ON LABELS
+            """
+        Then an error should be raised
@@ -0,0 +1,143 @@
+Feature: Batched filter
+
+    # Filters over read-only scans are evaluated over batches of rows. The
+    # nodes are scanned in the order in which they were created, and a row
+    # whose filter raises an error comes after rows which match. The error has
+    # to be raised only when that row is reached, as with the row-wise filter,
+    # which is used when `WITH n` is put between the scan and the filter.
+
+    Scenario: Rows before a failing row are returned
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id > 0 AND 10 / n.y > 1 RETURN n.id LIMIT 2
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: Rows before a failing row are returned with the row-wise plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n WHERE n.id > 0 AND 10 / n.y > 1 RETURN n.id LIMIT 2
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: The error of a row is raised when the row is reached
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id > 0 AND 10 / n.y > 1 RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: The error of a row is raised when the row is reached with the row-wise plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n WHERE n.id > 0 AND 10 / n.y > 1 RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: The error of the first candidate row is raised
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id > 2 AND 10 / n.y > 1 RETURN n.id LIMIT 1
+            """
+        Then an error should be raised
+
+    Scenario: A false conjunct skips the failing conjuncts after it
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, y: 1}), ({id: 2, y: 2}), ({id: 3, y: 0}), ({id: 4, y: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.y > 0 AND 10 / n.y > 1 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+            | 4    |
+
+    Scenario: Rows before a row with an incomparable property are returned
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1}), ({id: 2}), ({id: 3}), ({id: 'x'})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id > 0 RETURN n.id LIMIT 2
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: Rows before a row with an incomparable property are returned with the row-wise plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1}), ({id: 2}), ({id: 3}), ({id: 'x'})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n WHERE n.id > 0 RETURN n.id LIMIT 2
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: The error of a row with an incomparable property is raised when the row is reached
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1}), ({id: 2}), ({id: 3}), ({id: 'x'})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id > 0 RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: The error of a row with an incomparable property is raised when the row is reached with the row-wise plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1}), ({id: 2}), ({id: 3}), ({id: 'x'})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n WHERE n.id > 0 RETURN n.id
+            """
+        Then an error should be raised
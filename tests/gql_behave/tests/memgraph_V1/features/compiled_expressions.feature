@@ -0,0 +1,403 @@
+Feature: Compiled expressions
+
+    # Filters and projections of cached plans are compiled. Each scenario is
+    # repeated with the expression wrapped in `coalesce`, which isn't compiled,
+    # so it's evaluated by the interpreter and has to give the same result.
+
+    Scenario: Filter: Equality of integers and doubles
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.x = 1 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: Equality of integers and doubles with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.x = 1) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: Equality of a double and an integer
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.x = 2 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+
+    Scenario: Filter: Equality of a double and an integer with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.x = 2) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+
+    Scenario: Filter: Inequality of mixed types
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.x <> 1 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+            | 3    |
+
+    Scenario: Filter: Inequality of mixed types with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.x <> 1) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+            | 3    |
+
+    Scenario: Filter: Arithmetic with nulls
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.x + n.y > 3 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: Arithmetic with nulls with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.x + n.y > 3) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: OR with nulls
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.b OR n.x = 1 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 4    |
+
+    Scenario: Filter: OR with nulls with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.b OR n.x = 1) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 4    |
+
+    Scenario: Filter: AND with nulls
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.b AND n.x = 1 RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: AND with nulls with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.b AND n.x = 1) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+
+    Scenario: Filter: NOT of null
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE NOT n.b RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+
+    Scenario: Filter: NOT of null with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(NOT n.b) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+
+    Scenario: Filter: IS NULL
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.y IS NULL RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 3    |
+            | 4    |
+
+    Scenario: Filter: IS NULL with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.y IS NULL) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 3    |
+            | 4    |
+
+    Scenario: Filter: IS NOT NULL
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.y IS NOT NULL RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: Filter: IS NOT NULL with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.y IS NOT NULL) RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 1    |
+            | 2    |
+
+    Scenario: Filter: String comparison
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.s >= 'b' RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+            | 3    |
+
+    Scenario: Filter: String comparison with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.s >= 'b') RETURN n.id
+            """
+        Then the result should be:
+            | n.id |
+            | 2    |
+            | 3    |
+
+    Scenario: Filter: Comparison of incomparable types
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.x > 0 RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: Filter: Comparison of incomparable types with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.x > 0) RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: Filter: Division by zero
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id / (n.id - 1) > 0 RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: Filter: Division by zero with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE coalesce(n.id / (n.id - 1) > 0) RETURN n.id
+            """
+        Then an error should be raised
+
+    Scenario: Projection of mixed types and nulls
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id <> 3 RETURN n.id AS id, n.x + 1 AS a, n.x = 1 AS e, n.y * 2 AS m, n.b AND true AS b ORDER BY id
+            """
+        Then the result should be, in order:
+            | id | a    | e     | m    | b     |
+            | 1  | 2    | true  | 5.0  | true  |
+            | 2  | 3.0  | false | 1.0  | false |
+            | 4  | null | null  | null | null  |
+
+    Scenario: Projection of mixed types and nulls with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id <> 3 RETURN n.id AS id, coalesce(n.x + 1) AS a, coalesce(n.x = 1) AS e, coalesce(n.y * 2) AS m, coalesce(n.b AND true) AS b ORDER BY id
+            """
+        Then the result should be, in order:
+            | id | a    | e     | m    | b     |
+            | 1  | 2    | true  | 5.0  | true  |
+            | 2  | 3.0  | false | 1.0  | false |
+            | 4  | null | null  | null | null  |
+
+    Scenario: Projection of integer division and modulo
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id = 1 RETURN (n.id + 6) / 2 AS d, -(n.id + 6) % 3 AS m, (n.id + 6) / 2.0 AS f
+            """
+        Then the result should be:
+            | d | m  | f   |
+            | 3 | -1 | 3.5 |
+
+    Scenario: Projection of integer division and modulo with the interpreter
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({id: 1, x: 1, y: 2.5, s: 'a', b: true}), ({id: 2, x: 2.0, y: 0.5, s: 'b', b: false}), ({id: 3, x: '1', s: 'c'}), ({id: 4, b: true})
+            """
+        When executing query:
+            """
+            MATCH (n) WHERE n.id = 1 RETURN coalesce((n.id + 6) / 2) AS d, coalesce(-(n.id + 6) % 3) AS m, coalesce((n.id + 6) / 2.0) AS f
+            """
+        Then the result should be:
+            | d | m  | f   |
+            | 3 | -1 | 3.5 |
@@ -0,0 +1,280 @@
+Feature: Factorized expansion
+
+    # Aggregations which don't use the last expanded node count its edges
+    # instead of pulling a row for each of them, and DISTINCT visits the ends
+    # of the edges once. The graph has a cycle, a self-loop and parallel
+    # edges, so the uniqueness of the edges in a pattern matters. Each
+    # scenario is repeated with the last node used in the aggregation or the
+    # DISTINCT, which pulls every row.
+
+    Scenario: Count two hops by the start node
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN x.id AS x, count(*) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 5 |
+            | 2 | 2 |
+            | 3 | 3 |
+
+    Scenario: Count two hops by the start node with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN x.id AS x, count(z) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 5 |
+            | 2 | 2 |
+            | 3 | 3 |
+
+    Scenario: Count two hops by the middle node
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN y.id AS y, count(*) AS c
+            """
+        Then the result should be:
+            | y | c |
+            | 1 | 3 |
+            | 2 | 5 |
+            | 3 | 2 |
+
+    Scenario: Count two hops by the middle node with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN y.id AS y, count(z) AS c
+            """
+        Then the result should be:
+            | y | c |
+            | 1 | 3 |
+            | 2 | 5 |
+            | 3 | 2 |
+
+    Scenario: Count three hops by the start node
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z)-->(w) RETURN x.id AS x, count(*) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 6 |
+            | 2 | 4 |
+            | 3 | 4 |
+
+    Scenario: Count three hops by the start node with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z)-->(w) RETURN x.id AS x, count(w) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 6 |
+            | 2 | 4 |
+            | 3 | 4 |
+
+    Scenario: Count two hops of an edge type
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-[:R]->(y)-[:R]->(z) RETURN x.id AS x, count(*) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 3 |
+            | 2 | 2 |
+            | 3 | 2 |
+
+    Scenario: Count two hops of an edge type with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-[:R]->(y)-[:R]->(z) RETURN x.id AS x, count(z) AS c
+            """
+        Then the result should be:
+            | x | c |
+            | 1 | 3 |
+            | 2 | 2 |
+            | 3 | 2 |
+
+    Scenario: Count two undirected hops
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)--(y)--(z) RETURN x.id AS x, count(*) AS c
+            """
+        Then the result should be:
+            | x | c  |
+            | 1 | 10 |
+            | 2 | 11 |
+            | 3 | 9  |
+
+    Scenario: Count two undirected hops with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)--(y)--(z) RETURN x.id AS x, count(z) AS c
+            """
+        Then the result should be:
+            | x | c  |
+            | 1 | 10 |
+            | 2 | 11 |
+            | 3 | 9  |
+
+    Scenario: Weighted aggregations of two hops
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN count(*) AS c, sum(x.id) AS s, avg(x.id) AS a, min(x.id) AS mn, max(x.id) AS mx
+            """
+        Then the result should be:
+            | c  | s  | a   | mn | mx |
+            | 10 | 18 | 1.8 | 1  | 3  |
+
+    Scenario: Weighted aggregations of two hops with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) RETURN count(z) AS c, sum(x.id + 0 * z.id) AS s, avg(x.id + 0 * z.id) AS a, min(x.id + 0 * z.id) AS mn, max(x.id + 0 * z.id) AS mx
+            """
+        Then the result should be:
+            | c  | s  | a   | mn | mx |
+            | 10 | 18 | 1.8 | 1  | 3  |
+
+    Scenario: Distinct ends of two hops
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) WITH DISTINCT x, z RETURN x.id AS x, z.id AS z
+            """
+        Then the result should be:
+            | x | z |
+            | 1 | 1 |
+            | 1 | 2 |
+            | 1 | 3 |
+            | 2 | 1 |
+            | 2 | 3 |
+            | 3 | 2 |
+            | 3 | 3 |
+
+    Scenario: Distinct ends of two hops with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)-->(y)-->(z) WITH DISTINCT x, z, 1 AS one RETURN x.id AS x, z.id AS z
+            """
+        Then the result should be:
+            | x | z |
+            | 1 | 1 |
+            | 1 | 2 |
+            | 1 | 3 |
+            | 2 | 1 |
+            | 2 | 3 |
+            | 3 | 2 |
+            | 3 | 3 |
+
+    Scenario: Distinct ends of two undirected hops
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)--(y)--(z) WITH DISTINCT x, z RETURN x.id AS x, z.id AS z
+            """
+        Then the result should be:
+            | x | z |
+            | 1 | 1 |
+            | 1 | 2 |
+            | 1 | 3 |
+            | 2 | 1 |
+            | 2 | 2 |
+            | 2 | 3 |
+            | 3 | 1 |
+            | 3 | 2 |
+            | 3 | 3 |
+
+    Scenario: Distinct ends of two undirected hops with the flat plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (a {id: 1}), (b {id: 2}), (c {id: 3}), (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(c), (c)-[:R]->(a), (b)-[:R]->(b), (a)-[:S]->(b)
+            """
+        When executing query:
+            """
+            MATCH (x)--(y)--(z) WITH DISTINCT x, z, 1 AS one RETURN x.id AS x, z.id AS z
+            """
+        Then the result should be:
+            | x | z |
+            | 1 | 1 |
+            | 1 | 2 |
+            | 1 | 3 |
+            | 2 | 1 |
+            | 2 | 2 |
+            | 2 | 3 |
+            | 3 | 1 |
+            | 3 | 2 |
+            | 3 | 3 |
@@ -0,0 +1,202 @@
+Feature: Hash join
+
+    # Every equality between two disconnected patterns is planned as a HashJoin.
+    # Each scenario is repeated with `NOT x <> y`, which isn't recognized as a
+    # join key and is planned as nested scans followed by a Filter, so both plans
+    # have to return the same rows.
+
+    Scenario: Join on integer and double keys
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2.0}), (:A {name: 'a3', k: '1'}),
+                   (:B {name: 'b1', k: 1.0}), (:B {name: 'b2', k: 2}), (:B {name: 'b3', k: 1}), (:B {name: 'b4', k: 3})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE a.k = b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b3' |
+            | 'a2' | 'b2' |
+
+    Scenario: Join on integer and double keys with the Filter plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2.0}), (:A {name: 'a3', k: '1'}),
+                   (:B {name: 'b1', k: 1.0}), (:B {name: 'b2', k: 2}), (:B {name: 'b3', k: 1}), (:B {name: 'b4', k: 3})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE NOT a.k <> b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b3' |
+            | 'a2' | 'b2' |
+
+    Scenario: Join on keys with null values
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2'}), (:A {name: 'a3', k: [1, null]}),
+                   (:B {name: 'b1', k: 1}), (:B {name: 'b2'}), (:B {name: 'b3', k: [1, null]})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE a.k = b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+
+    Scenario: Join on keys with null values with the Filter plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2'}), (:A {name: 'a3', k: [1, null]}),
+                   (:B {name: 'b1', k: 1}), (:B {name: 'b2'}), (:B {name: 'b3', k: [1, null]})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE NOT a.k <> b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+
+    Scenario: Join on multiple keys
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1, j: 'x'}), (:A {name: 'a2', k: 1, j: 'y'}), (:A {name: 'a3', k: 2, j: 'x'}),
+                   (:B {name: 'b1', k: 1, j: 'x'}), (:B {name: 'b2', k: 1, j: 'x'}), (:B {name: 'b3', k: 2, j: 'y'}),
+                   (:B {name: 'b4', k: 1})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE a.k = b.k AND b.j = a.j RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b2' |
+
+    Scenario: Join on multiple keys with the Filter plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1, j: 'x'}), (:A {name: 'a2', k: 1, j: 'y'}), (:A {name: 'a3', k: 2, j: 'x'}),
+                   (:B {name: 'b1', k: 1, j: 'x'}), (:B {name: 'b2', k: 1, j: 'x'}), (:B {name: 'b3', k: 2, j: 'y'}),
+                   (:B {name: 'b4', k: 1})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE NOT a.k <> b.k AND NOT b.j <> a.j RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b2' |
+
+    Scenario: Join with an additional filter on the joined pattern
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2}),
+                   (:B {name: 'b1', k: 1, x: 5}), (:B {name: 'b2', k: 1, x: 0}), (:B {name: 'b3', k: 2, x: 5})
+            """
+        When executing query:
+            """
+            MATCH (a:A), (b:B) WHERE a.k = b.k AND b.x > 1 AND a.name <> 'a2' RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+
+    Scenario: Join inside of an optional match
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2}), (:A {name: 'a3'}),
+                   (:B {name: 'b1', k: 1}), (:B {name: 'b2', k: 1.0}), (:B {name: 'b3', k: 3})
+            """
+        When executing query:
+            """
+            MATCH (a:A) OPTIONAL MATCH (b:B) WHERE a.k = b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b2' |
+            | 'a2' | null |
+            | 'a3' | null |
+
+    Scenario: Join inside of an optional match with the Filter plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2}), (:A {name: 'a3'}),
+                   (:B {name: 'b1', k: 1}), (:B {name: 'b2', k: 1.0}), (:B {name: 'b3', k: 3})
+            """
+        When executing query:
+            """
+            MATCH (a:A) OPTIONAL MATCH (b:B) WHERE NOT a.k <> b.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a1' | 'b1' |
+            | 'a1' | 'b2' |
+            | 'a2' | null |
+            | 'a3' | null |
+
+    Scenario: Joined patterns keep their edges unique
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:S)-[:T {name: 'r1'}]->(:N {k: 1}), (:S)-[:T {name: 'r2'}]->(:N {k: 1}),
+                   (:S)-[:T {name: 'r3'}]->(:N {k: 2})
+            """
+        When executing query:
+            """
+            MATCH (:S)-[r1]->(x), (:S)-[r2]->(y) WHERE x.k = y.k RETURN r1.name AS r1, r2.name AS r2
+            """
+        Then the result should be:
+            | r1   | r2   |
+            | 'r1' | 'r2' |
+            | 'r2' | 'r1' |
+
+    Scenario: Joined patterns keep their edges unique with the Filter plan
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:S)-[:T {name: 'r1'}]->(:N {k: 1}), (:S)-[:T {name: 'r2'}]->(:N {k: 1}),
+                   (:S)-[:T {name: 'r3'}]->(:N {k: 2})
+            """
+        When executing query:
+            """
+            MATCH (:S)-[r1]->(x), (:S)-[r2]->(y) WHERE NOT x.k <> y.k RETURN r1.name AS r1, r2.name AS r2
+            """
+        Then the result should be:
+            | r1   | r2   |
+            | 'r1' | 'r2' |
+            | 'r2' | 'r1' |
+
+    Scenario: Join with a pattern bound in a previous clause
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:A {name: 'a1', k: 1}), (:A {name: 'a2', k: 2}), (:B {name: 'b1', k: 2}), (:B {name: 'b2', k: 2})
+            """
+        When executing query:
+            """
+            MATCH (a:A) WITH a WHERE a.k > 1 MATCH (b:B) WHERE b.k = a.k RETURN a.name AS a, b.name AS b
+            """
+        Then the result should be:
+            | a    | b    |
+            | 'a2' | 'b1' |
+            | 'a2' | 'b2' |
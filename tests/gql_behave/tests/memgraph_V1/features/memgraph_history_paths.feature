@@ -0,0 +1,182 @@
+Feature: History shortest paths
+
+  # The graph is changed after it's created, so the history store and the
+  # delta chains have older versions of it. `TT AS OF` a time after all of the
+  # changes has to give the same paths as the query over the current graph,
+  # and `TT AS OF` a time before any of them has to give no paths.
+
+  Scenario: Test match BFS as of now
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[*bfs]->(m) TT AS 1000000000000000000 RETURN m.a
+          """
+      Then the result should be:
+          | m.a |
+          | '1' |
+          | '3' |
+
+  Scenario: Test match BFS as of now on the current graph
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[*bfs]->(m) RETURN m.a
+          """
+      Then the result should be:
+          | m.a |
+          | '1' |
+          | '3' |
+
+  Scenario: Test match BFS between two nodes as of now
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[e *bfs]->(m {a:'3'}) TT AS 1000000000000000000 RETURN size(e) AS l
+          """
+      Then the result should be:
+          | l |
+          | 1 |
+
+  Scenario: Test match BFS between two nodes as of now on the current graph
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[e *bfs]->(m {a:'3'}) RETURN size(e) AS l
+          """
+      Then the result should be:
+          | l |
+          | 1 |
+
+  Scenario: Test match BFS as of a time before the graph was created
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[*bfs]->(m) TT AS 0 RETURN m.a
+          """
+      Then the result should be empty
+
+  Scenario: Test match wShortest as of now
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[le *wShortest (e, n | e.w) w]->(m) TT AS 1000000000000000000 RETURN m.a, size(le) AS l
+          """
+      Then the result should be:
+          | m.a | l |
+          | '1' | 1 |
+          | '3' | 1 |
+
+  Scenario: Test match wShortest as of now on the current graph
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[le *wShortest (e, n | e.w) w]->(m) RETURN m.a, size(le) AS l
+          """
+      Then the result should be:
+          | m.a | l |
+          | '1' | 1 |
+          | '3' | 1 |
+
+  Scenario: Test match wShortest as of a time before the graph was created
+      Given an empty graph
+      And having executed:
+          """
+          CREATE (n {a:'0'})-[:r {w: 1}]->({a:'1'})-[:r {w: 1}]->({a:'2'})-[:r {w: 5}]->({a:'3'})
+          """
+      And having executed:
+          """
+          MATCH ({a:'1'})-[e]->({a:'2'}) DELETE e
+          """
+      And having executed:
+          """
+          MATCH (n {a:'0'}), (m {a:'3'}) CREATE (n)-[:r {w: 10}]->(m)
+          """
+      When executing query:
+          """
+          MATCH (n {a:'0'})-[le *wShortest (e, n | e.w) w]->(m) TT AS 0 RETURN m.a
+          """
+      Then the result should be empty
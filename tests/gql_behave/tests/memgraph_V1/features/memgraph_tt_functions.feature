@@ -0,0 +1,249 @@
+Feature: Temporal aggregation functions
+
+    # The balance of the first account is changed twice. The functions are
+    # called with a window from 0 to a time after all of the changes, so the
+    # results don't depend on the commit timestamps. Every version of the node
+    # is a version of each of its properties, even if it didn't change them.
+
+    Scenario: ttVersionCount over the whole history
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account) RETURN n.id AS id, ttVersionCount(n, 'balance', 0, 1000000000000000000) AS c
+            """
+        Then the result should be:
+            | id | c |
+            | 1  | 3 |
+            | 2  | 1 |
+
+    Scenario: ttMin, ttMax, ttFirst and ttLast over the whole history
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttMin(n, 'balance', 0, 1000000000000000000) AS mn, ttMax(n, 'balance', 0, 1000000000000000000) AS mx, ttFirst(n, 'balance', 0, 1000000000000000000) AS f, ttLast(n, 'balance', 0, 1000000000000000000) AS l
+            """
+        Then the result should be:
+            | mn | mx | f  | l  |
+            | 10 | 30 | 10 | 30 |
+
+    Scenario: ttChanges over the whole history
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN [c IN ttChanges(n, 'balance', 0, 1000000000000000000) | c.value] AS changes
+            """
+        Then the result should be:
+            | changes  |
+            | [20, 30] |
+
+    Scenario: ttAvg of a value that never changed
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttAvg(n, 'limit', 0, 1000000000000000000) AS a
+            """
+        Then the result should be:
+            | a   |
+            | 5.0 |
+
+    Scenario: ttAvg is weighted by the duration of the values
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) WITH ttAvg(n, 'balance', 0, 1000000000000000000) AS a RETURN a > 29.9 AND a <= 30 AS weighted
+            """
+        Then the result should be:
+            | weighted |
+            | true     |
+
+    Scenario: Temporal functions over a window before the node was created
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttVersionCount(n, 'balance', 0, 0) AS c, ttLast(n, 'balance', 0, 0) AS l, ttAvg(n, 'balance', 0, 0) AS a
+            """
+        Then the result should be:
+            | c | l    | a    |
+            | 0 | null | null |
+
+    Scenario: Temporal functions of a missing property
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttVersionCount(n, 'missing', 0, 1000000000000000000) AS c, ttMax(n, 'missing', 0, 1000000000000000000) AS mx
+            """
+        Then the result should be:
+            | c | mx   |
+            | 3 | null |
+
+    Scenario: Temporal functions of null
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            OPTIONAL MATCH (n:Missing) RETURN ttVersionCount(n, 'balance', 0, 1000000000000000000) AS c, ttChanges(n, 'balance', 0, 1000000000000000000) AS ch
+            """
+        Then the result should be:
+            | c    | ch   |
+            | null | null |
+
+    Scenario: Temporal functions inside of an aggregation
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account) RETURN sum(ttMax(n, 'balance', 0, 1000000000000000000)) AS s, sum(ttVersionCount(n, 'balance', 0, 1000000000000000000)) AS c
+            """
+        Then the result should be:
+            | s   | c |
+            | 130 | 4 |
+
+    Scenario: ttAvg of a non-numeric value
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 'closed'
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttAvg(n, 'balance', 0, 1000000000000000000) AS a
+            """
+        Then an error should be raised
+
+    Scenario: Temporal functions with a negative bound
+        Given an empty graph
+        And having executed
+            """
+            CREATE (:Account {id: 1, balance: 10, limit: 5}), (:Account {id: 2, balance: 100, limit: 5})
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 20
+            """
+        And having executed
+            """
+            MATCH (n:Account {id: 1}) SET n.balance = 30
+            """
+        When executing query:
+            """
+            MATCH (n:Account {id: 1}) RETURN ttVersionCount(n, 'balance', -1, 10) AS c
+            """
+        Then an error should be raised
@@ -0,0 +1,182 @@
+Feature: Order by with limit
+
+    # ORDER BY followed by LIMIT keeps only the best SKIP + LIMIT rows. The
+    # scenarios "with the full sort plan" put SKIP and LIMIT in a separate
+    # WITH, which sorts all of the rows instead.
+
+    Scenario: Top-K with SKIP and LIMIT
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v SKIP 1 LIMIT 3
+            """
+        Then the result should be, in order:
+            | v |
+            | 3 |
+            | 3 |
+            | 5 |
+
+    Scenario: Top-K with SKIP and LIMIT with the full sort plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n.v AS v ORDER BY v WITH v SKIP 1 LIMIT 3 RETURN v
+            """
+        Then the result should be, in order:
+            | v |
+            | 3 |
+            | 3 |
+            | 5 |
+
+    Scenario: Top-K in descending order keeps nulls first
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v DESC LIMIT 3
+            """
+        Then the result should be, in order:
+            | v    |
+            | null |
+            | 9    |
+            | 8    |
+
+    Scenario: Top-K in descending order keeps nulls first with the full sort plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n.v AS v ORDER BY v DESC WITH v LIMIT 3 RETURN v
+            """
+        Then the result should be, in order:
+            | v    |
+            | null |
+            | 9    |
+            | 8    |
+
+    Scenario: Top-K with SKIP reaching the end
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v SKIP 6 LIMIT 5
+            """
+        Then the result should be, in order:
+            | v    |
+            | 9    |
+            | null |
+
+    Scenario: Top-K with SKIP past the end
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v SKIP 10 LIMIT 5
+            """
+        Then the result should be empty
+
+    Scenario: Top-K with LIMIT 0
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v LIMIT 0
+            """
+        Then the result should be empty
+
+    Scenario: Top-K with SKIP and LIMIT whose sum overflows
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v SKIP 1 LIMIT 9223372036854775807
+            """
+        Then the result should be, in order:
+            | v    |
+            | 3    |
+            | 3    |
+            | 5    |
+            | 7    |
+            | 8    |
+            | 9    |
+            | null |
+
+    Scenario: Top-K with a negative LIMIT
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v LIMIT -1
+            """
+        Then an error should be raised
+
+    Scenario: Top-K with a negative SKIP
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.v AS v ORDER BY v SKIP -1 LIMIT 2
+            """
+        Then an error should be raised
+
+    Scenario: Top-K with several sort keys
+        Given an empty graph
+        And having executed
+            """
+            CREATE ({g: 1, v: 5}), ({g: 2, v: 4}), ({g: 1, v: 3}), ({g: 2, v: 9}), ({g: 2, v: 1})
+            """
+        When executing query:
+            """
+            MATCH (n) RETURN n.g AS g, n.v AS v ORDER BY g, v DESC SKIP 1 LIMIT 3
+            """
+        Then the result should be, in order:
+            | g | v |
+            | 1 | 3 |
+            | 2 | 9 |
+            | 2 | 4 |
+
+    Scenario: Top-K in WITH followed by an aggregation
+        Given an empty graph
+        And having executed
+            """
+            UNWIND [5, 3, 9, 1, 7, 3, null, 8] AS v CREATE ({v: v})
+            """
+        When executing query:
+            """
+            MATCH (n) WITH n ORDER BY n.v LIMIT 3 RETURN sum(n.v) AS s
+            """
+        Then the result should be:
+            | s |
+            | 7 |
@@ -0,0 +1,163 @@
+Feature: Parallel aggregation
+
+    # The suite runs with more than one aggregation worker and small morsels,
+    # so aggregations over a label scan are split between the workers. Each
+    # scenario is repeated with `WITH n` between the scan and the aggregation,
+    # which makes the aggregation run serially, so both plans have to return
+    # the same rows.
+
+    Scenario: Grouped aggregations
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) RETURN n.g AS g, count(*) AS c, count(n.v) AS cv, sum(n.v) AS s, avg(n.v) AS a, min(n.v) AS mn, max(n.v) AS mx
+            """
+        Then the result should be:
+            | g    | c | cv | s    | a      | mn  | mx  |
+            | 0    | 7 | 6  | 63   | 10.5   | 3   | 18  |
+            | 1    | 8 | 8  | 70.5 | 8.8125 | 0.5 | 19  |
+            | 2    | 7 | 7  | 77   | 11.0   | 2   | 20  |
+            | null | 1 | 1  | 100  | 100.0  | 100 | 100 |
+
+    Scenario: Grouped aggregations with the serial plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WITH n RETURN n.g AS g, count(*) AS c, count(n.v) AS cv, sum(n.v) AS s, avg(n.v) AS a, min(n.v) AS mn, max(n.v) AS mx
+            """
+        Then the result should be:
+            | g    | c | cv | s    | a      | mn  | mx  |
+            | 0    | 7 | 6  | 63   | 10.5   | 3   | 18  |
+            | 1    | 8 | 8  | 70.5 | 8.8125 | 0.5 | 19  |
+            | 2    | 7 | 7  | 77   | 11.0   | 2   | 20  |
+            | null | 1 | 1  | 100  | 100.0  | 100 | 100 |
+
+    Scenario: Grouped aggregations over a filter
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WHERE n.v > 10 RETURN n.g AS g, count(*) AS c, sum(n.v) AS s
+            """
+        Then the result should be:
+            | g    | c | s   |
+            | 0    | 3 | 45  |
+            | 1    | 3 | 48  |
+            | 2    | 4 | 62  |
+            | null | 1 | 100 |
+
+    Scenario: Grouped aggregations over a filter with the serial plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WITH n WHERE n.v > 10 RETURN n.g AS g, count(*) AS c, sum(n.v) AS s
+            """
+        Then the result should be:
+            | g    | c | s   |
+            | 0    | 3 | 45  |
+            | 1    | 3 | 48  |
+            | 2    | 4 | 62  |
+            | null | 1 | 100 |
+
+    Scenario: Aggregations without grouping
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) RETURN count(*) AS c, sum(n.d) AS s, avg(n.d) AS a, min(n.d) AS mn, max(n.d) AS mx
+            """
+        Then the result should be:
+            | c  | s     | a    | mn  | mx   |
+            | 23 | 105.0 | 5.25 | 0.5 | 10.0 |
+
+    Scenario: Aggregations without grouping with the serial plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WITH n RETURN count(*) AS c, sum(n.d) AS s, avg(n.d) AS a, min(n.d) AS mn, max(n.d) AS mx
+            """
+        Then the result should be:
+            | c  | s     | a    | mn  | mx   |
+            | 23 | 105.0 | 5.25 | 0.5 | 10.0 |
+
+    Scenario: Aggregations over no rows
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WHERE n.v > 1000 RETURN count(*) AS c, sum(n.v) AS s, avg(n.v) AS a, min(n.v) AS mn, max(n.v) AS mx
+            """
+        Then the result should be:
+            | c | s | a    | mn   | mx   |
+            | 0 | 0 | null | null | null |
+
+    Scenario: Aggregations over no rows with the serial plan
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 20) AS i CREATE (:Item {g: i % 3, v: i, d: i * 0.5})
+            """
+        And having executed
+            """
+            CREATE (:Item {g: 0}), (:Item {g: 1, v: 0.5}), (:Item {v: 100})
+            """
+        When executing query:
+            """
+            MATCH (n:Item) WITH n WHERE n.v > 1000 RETURN count(*) AS c, sum(n.v) AS s, avg(n.v) AS a, min(n.v) AS mn, max(n.v) AS mx
+            """
+        Then the result should be:
+            | c | s | a    | mn   | mx   |
+            | 0 | 0 | null | null | null |
@@ -0,0 +1,168 @@
+Feature: Spilling to temporary files
+
+    # The suite runs with tiny limits on the number of groups and rows which
+    # aggregations, DISTINCT and ORDER BY keep in memory, so they write most
+    # of them to temporary files and read them back. NaN and infinite doubles
+    # can't be written, so the rows which contain them stay in memory.
+
+    Scenario: Grouped aggregations spill their groups
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) RETURN n.g AS g, count(*) AS c, sum(n.v) AS s, avg(n.v) AS a, min(n.v) AS mn, max(n.v) AS mx
+            """
+        Then the result should be:
+            | g | c | s  | a    | mn | mx |
+            | 0 | 4 | 70 | 17.5 | 7  | 28 |
+            | 1 | 5 | 75 | 15.0 | 1  | 29 |
+            | 2 | 5 | 80 | 16.0 | 2  | 30 |
+            | 3 | 4 | 54 | 13.5 | 3  | 24 |
+            | 4 | 4 | 58 | 14.5 | 4  | 25 |
+            | 5 | 4 | 62 | 15.5 | 5  | 26 |
+            | 6 | 4 | 66 | 16.5 | 6  | 27 |
+
+    Scenario: Grouped collect spills its groups
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) WHERE n.v <= 12 RETURN n.s AS s, collect(n.v) AS vs
+            """
+        Then the result should be (ignoring element order for lists):
+            | s   | vs         |
+            | '0' | [4, 8, 12] |
+            | '1' | [1, 5, 9]  |
+            | '2' | [2, 6, 10] |
+            | '3' | [3, 7, 11] |
+
+    Scenario: Aggregations grouped by nodes spill the nodes
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) WITH n, count(*) AS c RETURN sum(c) AS total, count(n) AS nodes, sum(n.v) AS s
+            """
+        Then the result should be:
+            | total | nodes | s   |
+            | 30    | 30    | 465 |
+
+    Scenario: Distinct spills its rows
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) RETURN DISTINCT n.s AS s, n.g % 2 AS p
+            """
+        Then the result should be:
+            | s   | p |
+            | '0' | 0 |
+            | '0' | 1 |
+            | '1' | 0 |
+            | '1' | 1 |
+            | '2' | 0 |
+            | '2' | 1 |
+            | '3' | 0 |
+            | '3' | 1 |
+
+    Scenario: Order by spills sorted runs
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) WHERE n.v > 22 RETURN n.v AS v ORDER BY n.g, n.v DESC
+            """
+        Then the result should be, in order:
+            | v  |
+            | 28 |
+            | 29 |
+            | 30 |
+            | 23 |
+            | 24 |
+            | 25 |
+            | 26 |
+            | 27 |
+
+    Scenario: Order by spills rows with nodes
+        Given an empty graph
+        And having executed
+            """
+            UNWIND range(1, 30) AS i CREATE (:S {g: i % 7, v: i, s: toString(i % 4)})
+            """
+        When executing query:
+            """
+            MATCH (n:S) WHERE n.v % 5 = 0 WITH n ORDER BY n.v DESC RETURN n.v AS v
+            """
+        Then the result should be, in order:
+            | v  |
+            | 30 |
+            | 25 |
+            | 20 |
+            | 15 |
+            | 10 |
+            | 5  |
+
+    Scenario: Infinite group keys stay in memory
+        Given an empty graph
+        When executing query:
+            """
+            UNWIND range(1, 12) AS i WITH CASE WHEN i <= 4 THEN 1.0 / 0.0 ELSE toFloat(i % 3) END AS x WITH x, count(*) AS c RETURN x > 100 AS inf, CASE WHEN x > 100 THEN -1 ELSE toInteger(x) END AS k, c
+            """
+        Then the result should be:
+            | inf   | k  | c |
+            | true  | -1 | 4 |
+            | false | 0  | 3 |
+            | false | 1  | 2 |
+            | false | 2  | 3 |
+
+    Scenario: NaN aggregation values stay in memory
+        Given an empty graph
+        When executing query:
+            """
+            UNWIND range(1, 12) AS i WITH i % 4 AS g, CASE WHEN i = 1 THEN 0.0 / 0.0 ELSE 1.0 * i END AS x RETURN g, sum(x) <> sum(x) AS nan
+            """
+        Then the result should be:
+            | g | nan   |
+            | 0 | false |
+            | 1 | true  |
+            | 2 | false |
+            | 3 | false |
+
+    Scenario: Infinite distinct values stay in memory
+        Given an empty graph
+        When executing query:
+            """
+            UNWIND [1.0 / 0.0, 1.0, 1.0 / 0.0, 2.0, 1.0, -1.0 / 0.0] AS x WITH DISTINCT x RETURN count(*) AS c
+            """
+        Then the result should be:
+            | c |
+            | 4 |
+
+    Scenario: Infinite sort keys stay in memory
+        Given an empty graph
+        When executing query:
+            """
+            UNWIND [3.0, 1.0 / 0.0, 1.0, -1.0 / 0.0, 2.0] AS x RETURN x > 100 AS big, x < -100 AS small, x < 100 AND x > -100 AS finite ORDER BY x
+            """
+        Then the result should be, in order:
+            | big   | small | finite |
+            | false | true  | false  |
+            | false | false | true   |
+            | false | false | true   |
+            | false | false | true   |
+            | true  | false | false  |
@@ -0,0 +1,9 @@
+// The replica is registered on an empty main instance, so it receives the
+// history of both FREE MEMORY runs as batches.
+CREATE (:Account {id: 1, balance: 0}), (:Account {id: 2, balance: 0});
+MATCH (n:Account {id: 1}) SET n.balance = 10;
+MATCH (n:Account {id: 1}) SET n.balance = 20;
+MATCH (n:Account {id: 2}) SET n.balance = 5;
+FREE MEMORY;
+MATCH (n:Account {id: 1}) SET n.balance = 30;
+FREE MEMORY;
@@ -0,0 +1,4 @@
+// This batch has to continue where the checkpoint ends.
+MATCH (n:Account {id: 2}) SET n.balance = 6;
+MATCH (n:Account {id: 1}) SET n.balance = 30;
+FREE MEMORY;
@@ -0,0 +1,7 @@
+// The history is migrated before the replica is registered, so the replica
+// receives it as a checkpoint of the history store of the main instance.
+CREATE (:Account {id: 1, balance: 0}), (:Account {id: 2, balance: 0});
+MATCH (n:Account {id: 1}) SET n.balance = 10;
+MATCH (n:Account {id: 2}) SET n.balance = 5;
+MATCH (n:Account {id: 1}) SET n.balance = 20;
+FREE MEMORY;
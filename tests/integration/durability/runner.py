@@ -0,0 +1,390 @@
+#!/usr/bin/python3 -u
+
+# Copyright 2021 Memgraph Ltd.
+#
+# Use of this software is governed by the Business Source License
+# included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+# License, and you may not use this file except in compliance with the Business Source License.
+#
+# As of the Change Date specified in that file, in accordance with
+# the Business Source License, use of this software will be governed
+# by the Apache License, Version 2.0, included in the file
+# licenses/APL.txt.
+
+import argparse
+import atexit
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import yaml
+
+SCRIPT_DIR = os.path.dirname(os.path.realpath(__file__))
+PROJECT_DIR = os.path.normpath(os.path.join(SCRIPT_DIR, "..", "..", ".."))
+TESTS_DIR = os.path.join(SCRIPT_DIR, "tests")
+REPLICATION_TESTS_DIR = os.path.join(SCRIPT_DIR, "replication")
+
+SNAPSHOT_FILE_NAME = "snapshot.bin"
+WAL_FILE_NAME = "wal.bin"
+
+DUMP_SNAPSHOT_FILE_NAME = "expected_snapshot.cypher"
+DUMP_WAL_FILE_NAME = "expected_wal.cypher"
+
+# Test directories without binary files are generated by running the queries
+# from `create_dataset.cypher` on a memgraph started with the flags from
+# `flags.txt` (one per line), so they always use the current format.
+CREATE_DATASET_FILE_NAME = "create_dataset.cypher"
+FLAGS_FILE_NAME = "flags.txt"
+
+# Optional list of queries (e.g. temporal queries over the history store) whose
+# results on the recovered database are compared with the expected files.
+QUERIES_FILE_NAME = "queries.yaml"
+
+# Files of these versions were written by a memgraph whose encoding used the
+# same version numbers for a different layout. They have to be rejected, so
+# the recovered database is empty.
+UNSUPPORTED_VERSIONS = ["v15", "v16"]
+
+# A replication test runs `before_replica.cypher` on the main instance,
+# registers the replica and runs `after_replica.cypher`. Then the replica has
+# to return the expected results of the queries from `queries.yaml`, both
+# while running and after a restart from its own data directory.
+BEFORE_REPLICA_FILE_NAME = "before_replica.cypher"
+AFTER_REPLICA_FILE_NAME = "after_replica.cypher"
+MAIN_PORT = 7687
+REPLICA_PORT = 7688
+REPLICA_REPLICATION_PORT = 10000
+# The history is sent to the replica in the background.
+REPLICATION_TIMEOUT_SEC = 10
+
+SIGNAL_SIGTERM = 15
+
+
+def wait_for_server(port, delay=0.1):
+    cmd = ["nc", "-z", "-w", "1", "127.0.0.1", str(port)]
+    while subprocess.call(cmd) != 0:
+        time.sleep(0.01)
+    time.sleep(delay)
+
+
+def sorted_content(file_path):
+    with open(file_path, "r") as fin:
+        return sorted(list(map(lambda x: x.strip(), fin.readlines())))
+
+
+def list_to_string(data):
+    ret = "[\n"
+    for row in data:
+        ret += "    " + row + "\n"
+    ret += "]"
+    return ret
+
+
+def start_memgraph(memgraph_args, port=MAIN_PORT):
+    memgraph = subprocess.Popen(memgraph_args)
+    time.sleep(0.1)
+    assert memgraph.poll() is None, "Memgraph process died prematurely!"
+    wait_for_server(port)
+
+    # Register cleanup function
+    @atexit.register
+    def cleanup():
+        if memgraph.poll() is None:
+            pid = memgraph.pid
+            try:
+                os.kill(pid, SIGNAL_SIGTERM)
+            except os.OSError:
+                assert False
+            time.sleep(1)
+
+    return memgraph
+
+
+def stop_memgraph(memgraph):
+    pid = memgraph.pid
+    try:
+        os.kill(pid, SIGNAL_SIGTERM)
+    except os.OSError:
+        assert False
+    memgraph.wait()
+
+
+def read_flags(test_directory):
+    with open(os.path.join(test_directory, FLAGS_FILE_NAME), "r") as fin:
+        return [line.strip() for line in fin if line.strip()]
+
+
+def read_queries(file_path):
+    queries = []
+    if not os.path.isfile(file_path):
+        return queries
+    with open(file_path, "r") as fin:
+        for line in fin:
+            line = line.strip()
+            if not line or line.startswith("//"):
+                continue
+            queries.append(line.rstrip(";"))
+    return queries
+
+
+def run_tester(tester_binary, query, port=MAIN_PORT):
+    args = [tester_binary, "--port", str(port), "--query=" + query]
+    output = subprocess.run(args, stdout=subprocess.PIPE, check=True).stdout.decode("utf-8")
+    return sorted(list(map(lambda x: x.strip(), output.strip().split("\n"))))
+
+
+def read_expected_queries(test_directory):
+    queries_file = os.path.join(test_directory, QUERIES_FILE_NAME)
+    if not os.path.isfile(queries_file):
+        return []
+    with open(queries_file, "r") as fin:
+        return yaml.safe_load(fin)
+
+
+def check_queries(tester_binary, test_directory, queries, write_expected, port=MAIN_PORT):
+    for query in queries:
+        rows_got = run_tester(tester_binary, query["query"], port)
+        expected_file = os.path.join(test_directory, query["expected"])
+        if write_expected:
+            with open(expected_file, "w") as expected:
+                expected.write("\n".join(rows_got) + "\n")
+            continue
+        rows_expected = sorted_content(expected_file)
+        assert rows_got == rows_expected, "Expected\n{}\nto be equal to\n{}\nfor query: {}".format(
+            list_to_string(rows_got), list_to_string(rows_expected), query["query"]
+        )
+
+
+def generate_data(memgraph_binary, tester_binary, test_directory, test_type, data_directory):
+    """
+    Writes the durability files of the dataset into the data directory. The
+    snapshot test keeps only the snapshots (the last one is created on exit)
+    and the WAL test keeps only the WAL files.
+    """
+    flags = read_flags(test_directory)
+    memgraph_args = [
+        memgraph_binary,
+        "--storage-properties-on-edges",
+        "--storage-wal-enabled",
+        "--storage-snapshot-interval-sec=3600",
+        "--storage-snapshot-on-exit=" + str(test_type == "SNAPSHOT").lower(),
+        "--data-directory",
+        data_directory,
+    ] + flags
+
+    memgraph = start_memgraph(memgraph_args)
+    for query in read_queries(os.path.join(test_directory, CREATE_DATASET_FILE_NAME)):
+        if test_type == "WAL" and query == "CREATE SNAPSHOT":
+            continue
+        subprocess.run([tester_binary, "--query=" + query], stdout=subprocess.DEVNULL, check=True)
+    stop_memgraph(memgraph)
+
+    shutil.rmtree(os.path.join(data_directory, "wal" if test_type == "SNAPSHOT" else "snapshots"), ignore_errors=True)
+
+
+def execute_test(memgraph_binary, dump_binary, tester_binary, test_directory, test_type, write_expected):
+    assert test_type in ["SNAPSHOT", "WAL"], "Test type should be either 'SNAPSHOT' or 'WAL'."
+    print("\033[1;36m~~ Executing test {} ({}) ~~\033[0m".format(os.path.relpath(test_directory, TESTS_DIR), test_type))
+
+    working_data_directory = tempfile.TemporaryDirectory()
+    if not os.path.isfile(os.path.join(test_directory, SNAPSHOT_FILE_NAME)):
+        generate_data(memgraph_binary, tester_binary, test_directory, test_type, working_data_directory.name)
+    elif test_type == "SNAPSHOT":
+        snapshots_dir = os.path.join(working_data_directory.name, "snapshots")
+        os.makedirs(snapshots_dir)
+        shutil.copy(os.path.join(test_directory, SNAPSHOT_FILE_NAME), snapshots_dir)
+    else:
+        wal_dir = os.path.join(working_data_directory.name, "wal")
+        os.makedirs(wal_dir)
+        shutil.copy(os.path.join(test_directory, WAL_FILE_NAME), wal_dir)
+
+    memgraph_args = [
+        memgraph_binary,
+        "--storage-recover-on-startup",
+        "--storage-properties-on-edges",
+        "--data-directory",
+        working_data_directory.name,
+    ]
+
+    # Start the memgraph binary
+    memgraph = start_memgraph(memgraph_args)
+
+    # Execute `database dump`
+    dump_output_file = tempfile.NamedTemporaryFile()
+    dump_args = [dump_binary, "--use-ssl=false"]
+    subprocess.run(dump_args, stdout=dump_output_file, check=True)
+
+    unsupported = os.path.basename(os.path.dirname(test_directory)) in UNSUPPORTED_VERSIONS
+    if not unsupported:
+        check_queries(tester_binary, test_directory, read_expected_queries(test_directory), write_expected)
+
+    # Shutdown the memgraph binary
+    stop_memgraph(memgraph)
+
+    dump_file_name = DUMP_SNAPSHOT_FILE_NAME if test_type == "SNAPSHOT" else DUMP_WAL_FILE_NAME
+
+    if unsupported:
+        queries_got = sorted_content(dump_output_file.name)
+        assert queries_got == [], "Expected the unsupported files to be rejected, got\n{}".format(
+            list_to_string(queries_got)
+        )
+    elif write_expected:
+        with open(dump_output_file.name, "r") as dump:
+            queries_got = dump.readlines()
+        # Write dump files
+        expected_dump_file = os.path.join(test_directory, dump_file_name)
+        with open(expected_dump_file, "w") as expected:
+            expected.writelines(queries_got)
+    else:
+        # Compare dump files
+        expected_dump_file = os.path.join(test_directory, dump_file_name)
+        assert os.path.exists(expected_dump_file), "Could not find expected dump path {}".format(expected_dump_file)
+        queries_got = sorted_content(dump_output_file.name)
+        queries_expected = sorted_content(expected_dump_file)
+        assert queries_got == queries_expected, "Expected\n{}\nto be equal to\n" "{}".format(
+            list_to_string(queries_got), list_to_string(queries_expected)
+        )
+
+    print("\033[1;32m~~ Test successful ~~\033[0m\n")
+
+
+def wait_for_queries(tester_binary, test_directory, queries, port):
+    """
+    Checks the queries until they return the expected results or the time
+    runs out. The in-memory versions are freed before each check, so the older
+    versions have to come from the history store.
+    """
+    deadline = time.time() + REPLICATION_TIMEOUT_SEC
+    while True:
+        run_tester(tester_binary, "FREE MEMORY", port)
+        try:
+            check_queries(tester_binary, test_directory, queries, False, port)
+            return
+        except AssertionError:
+            if time.time() > deadline:
+                raise
+        time.sleep(0.1)
+
+
+def execute_replication_test(memgraph_binary, tester_binary, test_directory, write_expected):
+    print("\033[1;36m~~ Executing replication test {} ~~\033[0m".format(os.path.basename(test_directory)))
+
+    main_data_directory = tempfile.TemporaryDirectory()
+    replica_data_directory = tempfile.TemporaryDirectory()
+    common_args = [
+        memgraph_binary,
+        "--storage-properties-on-edges",
+        "--storage-wal-enabled",
+        "--storage-snapshot-interval-sec=3600",
+    ] + read_flags(test_directory)
+    replica_args = common_args + ["--bolt-port", str(REPLICA_PORT), "--data-directory", replica_data_directory.name]
+
+    replica = start_memgraph(replica_args, REPLICA_PORT)
+    run_tester(
+        tester_binary, "SET REPLICATION ROLE TO REPLICA WITH PORT {}".format(REPLICA_REPLICATION_PORT), REPLICA_PORT
+    )
+    main = start_memgraph(common_args + ["--data-directory", main_data_directory.name])
+
+    for query in read_queries(os.path.join(test_directory, BEFORE_REPLICA_FILE_NAME)):
+        run_tester(tester_binary, query)
+    run_tester(tester_binary, 'REGISTER REPLICA replica SYNC TO "127.0.0.1:{}"'.format(REPLICA_REPLICATION_PORT))
+    for query in read_queries(os.path.join(test_directory, AFTER_REPLICA_FILE_NAME)):
+        run_tester(tester_binary, query)
+
+    # The main instance is the reference for the expected results.
+    queries = read_expected_queries(test_directory)
+    check_queries(tester_binary, test_directory, queries, write_expected)
+    wait_for_queries(tester_binary, test_directory, queries, REPLICA_PORT)
+
+    stop_memgraph(main)
+    stop_memgraph(replica)
+
+    # The replica keeps the received history in its own history store.
+    replica = start_memgraph(replica_args + ["--storage-recover-on-startup"], REPLICA_PORT)
+    check_queries(tester_binary, test_directory, queries, False, REPLICA_PORT)
+    stop_memgraph(replica)
+
+    print("\033[1;32m~~ Test successful ~~\033[0m\n")
+
+
+def find_replication_test_directories(directory):
+    """
+    Finds all replication test directories. Test directory is a directory
+    below the given directory which contains 'flags.txt' and 'queries.yaml'.
+    """
+    test_dirs = []
+    if not os.path.isdir(directory):
+        return test_dirs
+    for test_dir in sorted(os.listdir(directory)):
+        test_dir_path = os.path.join(directory, test_dir)
+        if not os.path.isdir(test_dir_path):
+            continue
+        flags_file = os.path.join(test_dir_path, FLAGS_FILE_NAME)
+        queries_file = os.path.join(test_dir_path, QUERIES_FILE_NAME)
+        if not os.path.isfile(flags_file) or not os.path.isfile(queries_file):
+            raise Exception("Missing data in replication test directory '{}'".format(test_dir_path))
+        test_dirs.append(test_dir_path)
+    return test_dirs
+
+
+def find_test_directories(directory):
+    """
+    Finds all test directories. Test directory is a directory two levels below
+    the given directory which contains files 'snapshot.bin', 'wal.bin' (or
+    'create_dataset.cypher' and 'flags.txt' instead of them) and the expected
+    dumps.
+    """
+    test_dirs = []
+    for entry_version in os.listdir(directory):
+        entry_version_path = os.path.join(directory, entry_version)
+        if not os.path.isdir(entry_version_path):
+            continue
+        for test_dir in os.listdir(entry_version_path):
+            test_dir_path = os.path.join(entry_version_path, test_dir)
+            if not os.path.isdir(test_dir_path):
+                continue
+            snapshot_file = os.path.join(test_dir_path, SNAPSHOT_FILE_NAME)
+            wal_file = os.path.join(test_dir_path, WAL_FILE_NAME)
+            dump_snapshot_file = os.path.join(test_dir_path, DUMP_SNAPSHOT_FILE_NAME)
+            dump_wal_file = os.path.join(test_dir_path, DUMP_WAL_FILE_NAME)
+            create_dataset_file = os.path.join(test_dir_path, CREATE_DATASET_FILE_NAME)
+            flags_file = os.path.join(test_dir_path, FLAGS_FILE_NAME)
+            has_data = (os.path.isfile(snapshot_file) and os.path.isfile(wal_file)) or (
+                os.path.isfile(create_dataset_file) and os.path.isfile(flags_file)
+            )
+            if has_data and os.path.isfile(dump_snapshot_file) and os.path.isfile(dump_wal_file):
+                test_dirs.append(test_dir_path)
+            else:
+                raise Exception("Missing data in test directory '{}'".format(test_dir_path))
+    return test_dirs
+
+
+if __name__ == "__main__":
+    memgraph_binary = os.path.join(PROJECT_DIR, "build", "memgraph")
+    dump_binary = os.path.join(PROJECT_DIR, "build", "tools", "src", "mg_dump")
+    # Used to run the queries of the generated tests.
+    tester_binary = os.path.join(PROJECT_DIR, "build", "tests", "integration", "mg_import_csv", "tester")
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--memgraph", default=memgraph_binary)
+    parser.add_argument("--dump", default=dump_binary)
+    parser.add_argument("--tester", default=tester_binary)
+    parser.add_argument(
+        "--write-expected", action="store_true", help="Overwrite the expected cypher with results from current run"
+    )
+    args = parser.parse_args()
+
+    test_directories = find_test_directories(TESTS_DIR)
+    assert len(test_directories) > 0, "No tests have been found!"
+
+    for test_directory in test_directories:
+        execute_test(args.memgraph, args.dump, args.tester, test_directory, "SNAPSHOT", args.write_expected)
+        execute_test(args.memgraph, args.dump, args.tester, test_directory, "WAL", args.write_expected)
+
+    for test_directory in find_replication_test_directories(REPLICATION_TESTS_DIR):
+        execute_replication_test(args.memgraph, args.tester, test_directory, args.write_expected)
+
+    sys.exit(0)
@@ -0,0 +1,16 @@
+// Seven vertices and five edges are split into batches of two items.
+CREATE INDEX ON :Person;
+CREATE INDEX ON :Person(name);
+CREATE CONSTRAINT ON (p:Person) ASSERT p.name IS UNIQUE;
+CREATE (:Person {name: 'p0'});
+CREATE (:Person {name: 'p1'});
+CREATE (:Person {name: 'p2'});
+CREATE (:Person {name: 'p3'});
+CREATE (:Person {name: 'p4'});
+CREATE (:Person {name: 'p5'});
+CREATE (:Person {name: 'p6'});
+MATCH (a:Person), (b:Person) WHERE a.name = 'p0' AND b.name = 'p1' CREATE (a)-[:KNOWS {since: 2001}]->(b);
+MATCH (a:Person), (b:Person) WHERE a.name = 'p1' AND b.name = 'p2' CREATE (a)-[:KNOWS {since: 2002}]->(b);
+MATCH (a:Person), (b:Person) WHERE a.name = 'p2' AND b.name = 'p3' CREATE (a)-[:KNOWS {since: 2003}]->(b);
+MATCH (a:Person), (b:Person) WHERE a.name = 'p3' AND b.name = 'p4' CREATE (a)-[:KNOWS {since: 2004}]->(b);
+MATCH (a:Person), (b:Person) WHERE a.name = 'p4' AND b.name = 'p5' CREATE (a)-[:KNOWS {since: 2005}]->(b);
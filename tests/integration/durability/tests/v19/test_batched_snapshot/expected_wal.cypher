@@ -0,0 +1,18 @@
+CREATE INDEX ON :`Person`;
+CREATE INDEX ON :`Person`(`name`);
+CREATE CONSTRAINT ON (u:`Person`) ASSERT u.`name` IS UNIQUE;
+CREATE INDEX ON :__mg_vertex__(__mg_id__);
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 0, `name`: "p0"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 1, `name`: "p1"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 2, `name`: "p2"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 3, `name`: "p3"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 4, `name`: "p4"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 5, `name`: "p5"});
+CREATE (:__mg_vertex__:`Person` {__mg_id__: 6, `name`: "p6"});
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 0 AND v.__mg_id__ = 1 CREATE (u)-[:`KNOWS` {`since`: 2001}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 1 AND v.__mg_id__ = 2 CREATE (u)-[:`KNOWS` {`since`: 2002}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 2 AND v.__mg_id__ = 3 CREATE (u)-[:`KNOWS` {`since`: 2003}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 3 AND v.__mg_id__ = 4 CREATE (u)-[:`KNOWS` {`since`: 2004}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 4 AND v.__mg_id__ = 5 CREATE (u)-[:`KNOWS` {`since`: 2005}]->(v);
+DROP INDEX ON :__mg_vertex__(__mg_id__);
+MATCH (u) REMOVE u:__mg_vertex__, u.__mg_id__;
@@ -0,0 +1,16 @@
+// The history is migrated by FREE MEMORY only. Each run has enough records
+// for several ingested table files, the rest goes through the write batch.
+// The second run ingests files over the history of the first one.
+CREATE INDEX ON :Account(id);
+CREATE (:Account {id: 1, balance: 0}), (:Account {id: 2, balance: 0}), (:Account {id: 3, balance: 0});
+MATCH (n:Account {id: 1}) SET n.balance = 10;
+MATCH (n:Account {id: 2}) SET n.balance = 5;
+MATCH (n:Account {id: 1}) SET n.balance = 20;
+MATCH (n:Account {id: 2}) SET n.balance = 6;
+MATCH (n:Account {id: 1}) SET n.balance = 30;
+MATCH (n:Account {id: 2}) SET n.balance = 7;
+FREE MEMORY;
+MATCH (n:Account {id: 1}) SET n.balance = 40;
+MATCH (n:Account {id: 1}) SET n.balance = 50;
+MATCH (n:Account {id: 1}) SET n.balance = 60;
+FREE MEMORY;
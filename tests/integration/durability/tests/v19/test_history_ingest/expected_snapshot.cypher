@@ -0,0 +1,7 @@
+CREATE INDEX ON :`Account`(`id`);
+CREATE INDEX ON :__mg_vertex__(__mg_id__);
+CREATE (:__mg_vertex__:`Account` {__mg_id__: 0, `id`: 1, `balance`: 60});
+CREATE (:__mg_vertex__:`Account` {__mg_id__: 1, `id`: 2, `balance`: 7});
+CREATE (:__mg_vertex__:`Account` {__mg_id__: 2, `id`: 3, `balance`: 0});
+DROP INDEX ON :__mg_vertex__(__mg_id__);
+MATCH (u) REMOVE u:__mg_vertex__, u.__mg_id__;
@@ -0,0 +1,17 @@
+// A full snapshot followed by incremental snapshots with created, updated
+// and deleted objects. The last incremental snapshot is created on exit.
+CREATE INDEX ON :Item(value);
+CREATE (:Item {value: 0});
+CREATE (:Item {value: 1});
+CREATE (:Item {value: 2});
+CREATE (:Item {value: 3});
+CREATE SNAPSHOT;
+MATCH (a:Item), (b:Item) WHERE a.value = 0 AND b.value = 1 CREATE (a)-[:NEXT]->(b);
+MATCH (a:Item), (b:Item) WHERE a.value = 1 AND b.value = 2 CREATE (a)-[:NEXT]->(b);
+MATCH (n:Item) WHERE n.value = 3 SET n.value = 30;
+CREATE SNAPSHOT;
+MATCH (n:Item) WHERE n.value = 2 DETACH DELETE n;
+CREATE (:Item {value: 4});
+CREATE SNAPSHOT;
+MATCH (n:Item) WHERE n.value = 4 SET n:Last;
+CREATE (:Item {value: 5});
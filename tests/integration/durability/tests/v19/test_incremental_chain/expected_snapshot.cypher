@@ -0,0 +1,10 @@
+CREATE INDEX ON :`Item`(`value`);
+CREATE INDEX ON :__mg_vertex__(__mg_id__);
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 0, `value`: 0});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 1, `value`: 1});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 3, `value`: 30});
+CREATE (:__mg_vertex__:`Item`:`Last` {__mg_id__: 4, `value`: 4});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 5, `value`: 5});
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 0 AND v.__mg_id__ = 1 CREATE (u)-[:`NEXT`]->(v);
+DROP INDEX ON :__mg_vertex__(__mg_id__);
+MATCH (u) REMOVE u:__mg_vertex__, u.__mg_id__;
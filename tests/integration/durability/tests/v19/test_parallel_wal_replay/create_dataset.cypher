@@ -0,0 +1,18 @@
+// Small WAL files, so the files are replayed in parallel windows. The
+// transactions change many objects at once, which are split into per-gid
+// partitions, and delete vertices together with their edges, which is done
+// in the final serial pass of a file.
+CREATE INDEX ON :Item(id);
+UNWIND range(0, 11) AS i CREATE (:Item {id: i, value: 0});
+MATCH (n:Item) SET n.value = n.id * 10;
+MATCH (a:Item), (b:Item) WHERE b.id = a.id + 1 CREATE (a)-[:NEXT {w: a.id}]->(b);
+MATCH ()-[r:NEXT]->() SET r.w = r.w + 100;
+MATCH (n:Item) WHERE n.id % 2 = 0 SET n:Even;
+MATCH (n:Item {id: 3}) SET n.value = -1 WITH n DETACH DELETE n;
+MATCH (:Item {id: 6})-[r:NEXT]->(:Item {id: 7}) DELETE r;
+MATCH (n:Item {id: 7})-[r]-() DELETE r, n;
+MATCH (n:Item {id: 9}) DETACH DELETE n CREATE (:Item {id: 9, value: 900});
+MATCH (a:Item {id: 8}), (b:Item {id: 9}) CREATE (a)-[:NEXT {w: 999}]->(b);
+MATCH (n:Item {id: 11}) REMOVE n.value;
+MATCH (n:Item {id: 0}) SET n.value = 1 SET n.value = 2;
+CREATE CONSTRAINT ON (n:Item) ASSERT n.id IS UNIQUE;
@@ -0,0 +1,21 @@
+CREATE INDEX ON :`Item`(`id`);
+CREATE CONSTRAINT ON (u:`Item`) ASSERT u.`id` IS UNIQUE;
+CREATE INDEX ON :__mg_vertex__(__mg_id__);
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 0, `id`: 0, `value`: 2});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 1, `id`: 1, `value`: 10});
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 2, `id`: 2, `value`: 20});
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 4, `id`: 4, `value`: 40});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 5, `id`: 5, `value`: 50});
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 6, `id`: 6, `value`: 60});
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 8, `id`: 8, `value`: 80});
+CREATE (:__mg_vertex__:`Item`:`Even` {__mg_id__: 10, `id`: 10, `value`: 100});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 11, `id`: 11});
+CREATE (:__mg_vertex__:`Item` {__mg_id__: 12, `id`: 9, `value`: 900});
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 0 AND v.__mg_id__ = 1 CREATE (u)-[:`NEXT` {`w`: 100}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 1 AND v.__mg_id__ = 2 CREATE (u)-[:`NEXT` {`w`: 101}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 4 AND v.__mg_id__ = 5 CREATE (u)-[:`NEXT` {`w`: 104}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 5 AND v.__mg_id__ = 6 CREATE (u)-[:`NEXT` {`w`: 105}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 10 AND v.__mg_id__ = 11 CREATE (u)-[:`NEXT` {`w`: 110}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 8 AND v.__mg_id__ = 12 CREATE (u)-[:`NEXT` {`w`: 999}]->(v);
+DROP INDEX ON :__mg_vertex__(__mg_id__);
+MATCH (u) REMOVE u:__mg_vertex__, u.__mg_id__;
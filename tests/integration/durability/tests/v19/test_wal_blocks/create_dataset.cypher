@@ -0,0 +1,97 @@
+// Enough transactions to fill several compressed blocks and WAL files.
+CREATE INDEX ON :Block;
+CREATE CONSTRAINT ON (b:Block) ASSERT EXISTS (b.id);
+CREATE (:Block {id: 0, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 1, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 2, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 3, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 4, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 5, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 6, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 7, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 8, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 9, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 10, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 11, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 12, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 13, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 14, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 15, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 16, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 17, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 18, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 19, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 20, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 21, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 22, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 23, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 24, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 25, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 26, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 27, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 28, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 29, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 30, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 31, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 32, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 33, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 34, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 35, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 36, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 37, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 38, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+CREATE (:Block {id: 39, text: 'xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'});
+MATCH (a:Block), (b:Block) WHERE a.id = 0 AND b.id = 1 CREATE (a)-[:LINK {weight: 0}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 1 AND b.id = 2 CREATE (a)-[:LINK {weight: 1}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 2 AND b.id = 3 CREATE (a)-[:LINK {weight: 2}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 3 AND b.id = 4 CREATE (a)-[:LINK {weight: 3}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 4 AND b.id = 5 CREATE (a)-[:LINK {weight: 4}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 5 AND b.id = 6 CREATE (a)-[:LINK {weight: 5}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 6 AND b.id = 7 CREATE (a)-[:LINK {weight: 6}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 7 AND b.id = 8 CREATE (a)-[:LINK {weight: 7}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 8 AND b.id = 9 CREATE (a)-[:LINK {weight: 8}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 9 AND b.id = 10 CREATE (a)-[:LINK {weight: 9}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 10 AND b.id = 11 CREATE (a)-[:LINK {weight: 10}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 11 AND b.id = 12 CREATE (a)-[:LINK {weight: 11}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 12 AND b.id = 13 CREATE (a)-[:LINK {weight: 12}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 13 AND b.id = 14 CREATE (a)-[:LINK {weight: 13}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 14 AND b.id = 15 CREATE (a)-[:LINK {weight: 14}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 15 AND b.id = 16 CREATE (a)-[:LINK {weight: 15}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 16 AND b.id = 17 CREATE (a)-[:LINK {weight: 16}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 17 AND b.id = 18 CREATE (a)-[:LINK {weight: 17}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 18 AND b.id = 19 CREATE (a)-[:LINK {weight: 18}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 19 AND b.id = 20 CREATE (a)-[:LINK {weight: 19}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 20 AND b.id = 21 CREATE (a)-[:LINK {weight: 20}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 21 AND b.id = 22 CREATE (a)-[:LINK {weight: 21}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 22 AND b.id = 23 CREATE (a)-[:LINK {weight: 22}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 23 AND b.id = 24 CREATE (a)-[:LINK {weight: 23}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 24 AND b.id = 25 CREATE (a)-[:LINK {weight: 24}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 25 AND b.id = 26 CREATE (a)-[:LINK {weight: 25}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 26 AND b.id = 27 CREATE (a)-[:LINK {weight: 26}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 27 AND b.id = 28 CREATE (a)-[:LINK {weight: 27}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 28 AND b.id = 29 CREATE (a)-[:LINK {weight: 28}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 29 AND b.id = 30 CREATE (a)-[:LINK {weight: 29}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 30 AND b.id = 31 CREATE (a)-[:LINK {weight: 30}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 31 AND b.id = 32 CREATE (a)-[:LINK {weight: 31}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 32 AND b.id = 33 CREATE (a)-[:LINK {weight: 32}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 33 AND b.id = 34 CREATE (a)-[:LINK {weight: 33}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 34 AND b.id = 35 CREATE (a)-[:LINK {weight: 34}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 35 AND b.id = 36 CREATE (a)-[:LINK {weight: 35}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 36 AND b.id = 37 CREATE (a)-[:LINK {weight: 36}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 37 AND b.id = 38 CREATE (a)-[:LINK {weight: 37}]->(b);
+MATCH (a:Block), (b:Block) WHERE a.id = 38 AND b.id = 39 CREATE (a)-[:LINK {weight: 38}]->(b);
+MATCH (n:Block) WHERE n.id = 0 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 4 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 8 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 12 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 16 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 20 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 24 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 28 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 32 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 36 SET n.text = 'updated';
+MATCH (n:Block) WHERE n.id = 1 DETACH DELETE n;
+MATCH (n:Block) WHERE n.id = 9 DETACH DELETE n;
+MATCH (n:Block) WHERE n.id = 17 DETACH DELETE n;
+MATCH (n:Block) WHERE n.id = 25 DETACH DELETE n;
+MATCH (n:Block) WHERE n.id = 33 DETACH DELETE n;
@@ -0,0 +1,69 @@
+CREATE INDEX ON :`Block`;
+CREATE CONSTRAINT ON (u:`Block`) ASSERT EXISTS (u.`id`);
+CREATE INDEX ON :__mg_vertex__(__mg_id__);
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 0, `id`: 0, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 2, `id`: 2, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 3, `id`: 3, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 4, `id`: 4, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 5, `id`: 5, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 6, `id`: 6, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 7, `id`: 7, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 8, `id`: 8, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 10, `id`: 10, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 11, `id`: 11, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 12, `id`: 12, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 13, `id`: 13, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 14, `id`: 14, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 15, `id`: 15, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 16, `id`: 16, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 18, `id`: 18, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 19, `id`: 19, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 20, `id`: 20, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 21, `id`: 21, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 22, `id`: 22, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 23, `id`: 23, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 24, `id`: 24, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 26, `id`: 26, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 27, `id`: 27, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 28, `id`: 28, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 29, `id`: 29, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 30, `id`: 30, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 31, `id`: 31, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 32, `id`: 32, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 34, `id`: 34, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 35, `id`: 35, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 36, `id`: 36, `text`: "updated"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 37, `id`: 37, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 38, `id`: 38, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+CREATE (:__mg_vertex__:`Block` {__mg_id__: 39, `id`: 39, `text`: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 2 AND v.__mg_id__ = 3 CREATE (u)-[:`LINK` {`weight`: 2}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 3 AND v.__mg_id__ = 4 CREATE (u)-[:`LINK` {`weight`: 3}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 4 AND v.__mg_id__ = 5 CREATE (u)-[:`LINK` {`weight`: 4}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 5 AND v.__mg_id__ = 6 CREATE (u)-[:`LINK` {`weight`: 5}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 6 AND v.__mg_id__ = 7 CREATE (u)-[:`LINK` {`weight`: 6}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 7 AND v.__mg_id__ = 8 CREATE (u)-[:`LINK` {`weight`: 7}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 10 AND v.__mg_id__ = 11 CREATE (u)-[:`LINK` {`weight`: 10}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 11 AND v.__mg_id__ = 12 CREATE (u)-[:`LINK` {`weight`: 11}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 12 AND v.__mg_id__ = 13 CREATE (u)-[:`LINK` {`weight`: 12}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 13 AND v.__mg_id__ = 14 CREATE (u)-[:`LINK` {`weight`: 13}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 14 AND v.__mg_id__ = 15 CREATE (u)-[:`LINK` {`weight`: 14}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 15 AND v.__mg_id__ = 16 CREATE (u)-[:`LINK` {`weight`: 15}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 18 AND v.__mg_id__ = 19 CREATE (u)-[:`LINK` {`weight`: 18}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 19 AND v.__mg_id__ = 20 CREATE (u)-[:`LINK` {`weight`: 19}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 20 AND v.__mg_id__ = 21 CREATE (u)-[:`LINK` {`weight`: 20}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 21 AND v.__mg_id__ = 22 CREATE (u)-[:`LINK` {`weight`: 21}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 22 AND v.__mg_id__ = 23 CREATE (u)-[:`LINK` {`weight`: 22}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 23 AND v.__mg_id__ = 24 CREATE (u)-[:`LINK` {`weight`: 23}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 26 AND v.__mg_id__ = 27 CREATE (u)-[:`LINK` {`weight`: 26}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 27 AND v.__mg_id__ = 28 CREATE (u)-[:`LINK` {`weight`: 27}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 28 AND v.__mg_id__ = 29 CREATE (u)-[:`LINK` {`weight`: 28}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 29 AND v.__mg_id__ = 30 CREATE (u)-[:`LINK` {`weight`: 29}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 30 AND v.__mg_id__ = 31 CREATE (u)-[:`LINK` {`weight`: 30}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 31 AND v.__mg_id__ = 32 CREATE (u)-[:`LINK` {`weight`: 31}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 34 AND v.__mg_id__ = 35 CREATE (u)-[:`LINK` {`weight`: 34}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 35 AND v.__mg_id__ = 36 CREATE (u)-[:`LINK` {`weight`: 35}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 36 AND v.__mg_id__ = 37 CREATE (u)-[:`LINK` {`weight`: 36}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 37 AND v.__mg_id__ = 38 CREATE (u)-[:`LINK` {`weight`: 37}]->(v);
+MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 38 AND v.__mg_id__ = 39 CREATE (u)-[:`LINK` {`weight`: 38}]->(v);
+DROP INDEX ON :__mg_vertex__(__mg_id__);
+MATCH (u) REMOVE u:__mg_vertex__, u.__mg_id__;
@@ -0,0 +1,59 @@
+// Copyright 2022 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <gflags/gflags.h>
+
+#include "communication/bolt/client.hpp"
+#include "io/network/endpoint.hpp"
+#include "io/network/utils.hpp"
+#include "utils/logging.hpp"
+
+DEFINE_string(address, "127.0.0.1", "Server address");
+DEFINE_int32(port, 7687, "Server port");
+DEFINE_string(username, "", "Username for the database");
+DEFINE_string(password, "", "Password for the database");
+DEFINE_bool(use_ssl, false, "Set to true to connect with SSL to the server.");
+DEFINE_string(query, "DUMP DATABASE", "Query whose results are written to stdout.");
+
+/**
+ * Executes the query ("DUMP DATABASE" by default) and outputs all results to
+ * stdout, one row per line with the values separated by ", ". On any errors it
+ * exits with a non-zero exit code.
+ */
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, char **argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  memgraph::logging::RedirectToStderr();
+
+  memgraph::communication::SSLInit sslInit;
+
+  memgraph::io::network::Endpoint endpoint(memgraph::io::network::ResolveHostname(FLAGS_address), FLAGS_port);
+
+  memgraph::communication::ClientContext context(FLAGS_use_ssl);
+  memgraph::communication::bolt::Client client(context);
+
+  client.Connect(endpoint, FLAGS_username, FLAGS_password);
+  auto ret = client.Execute(FLAGS_query, {});
+  for (const auto &row : ret.records) {
+    for (size_t i = 0; i < row.size(); ++i) {
+      if (i > 0) std::cout << ", ";
+      // Strings are written as they are, so the dump rows stay valid queries.
+      if (row[i].IsString()) {
+        std::cout << row[i].ValueString();
+      } else {
+        std::cout << row[i];
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  return 0;
+}